@@ -0,0 +1,165 @@
+// bench/Bench.h
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include "../include/PluginPath.h"
+
+// 简单的基准测试注册器，用法与 Test.h 保持一致。
+// 每次测量的结果都会记录下来，可输出为 JSON 以便在不同构建之间比对
+class Bench {
+public:
+    using BenchFunc = std::function<void()>;
+
+    // 单次测量结果：指标按名称排列，如 ns_per_op、p99_ns
+    struct Result {
+        std::string bench;
+        std::string label;
+        uint64_t iterations = 0;
+        std::vector<std::pair<std::string, double>> metrics;
+    };
+
+    static Bench& getInstance() {
+        static Bench instance;
+        return instance;
+    }
+
+    void registerBench(const std::string& benchName, BenchFunc func) {
+        benches_.emplace_back(benchName, func);
+    }
+
+    // filter 非空时只运行名称包含该子串的基准
+    void run(const std::string& filter = {}) {
+        for (const auto& [name, func] : benches_) {
+            if (!filter.empty() && name.find(filter) == std::string::npos) {
+                continue;
+            }
+            out() << "[BENCH] " << name << std::endl;
+            current_ = name;
+            func();
+        }
+    }
+
+    // 插件所在目录，默认为当前目录（apphome/bin）
+    const std::string& pluginDirectory() const { return pluginDirectory_; }
+    void setPluginDirectory(const std::string& directory) { pluginDirectory_ = directory; }
+    // 插件目录下指定插件的动态库路径
+    static std::string pluginPath(const std::string& name) { return ::pluginPath(name, getInstance().pluginDirectory_); }
+
+    // 文本报告的输出流，默认 stdout；JSON 输出到 stdout 时改为 stderr，避免混入 JSON
+    static std::ostream& out() { return *getInstance().textOut_; }
+    void setTextOutput(std::ostream& stream) { textOut_ = &stream; }
+
+    // 记录一条结果并打印
+    static void report(const std::string& label, uint64_t iterations, std::vector<std::pair<std::string, double>> metrics) {
+        std::ostream& text = out();
+        text << "  " << std::left << std::setw(48) << label << std::right << std::fixed << std::setprecision(2);
+        for (const auto& [name, value] : metrics) {
+            text << "  " << name << "=" << value;
+        }
+        text << std::endl;
+        Bench& bench = getInstance();
+        bench.results_.push_back(Result{ bench.current_, label, iterations, std::move(metrics) });
+    }
+
+    // 执行 op 共 iterations 次，输出每次操作的平均耗时
+    template <typename Op>
+    static double measure(const std::string& label, uint64_t iterations, Op&& op) {
+        // 预热
+        for (uint64_t i = 0; i < iterations / 10; ++i) {
+            op(i);
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; ++i) {
+            op(i);
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(iterations);
+        report(label, iterations, { { "ns_per_op", ns } });
+        return ns;
+    }
+
+    // 逐次计时 op，输出延迟百分位（含一次时钟读取的开销）
+    template <typename Op>
+    static void measurePercentiles(const std::string& label, uint64_t iterations, Op&& op) {
+        for (uint64_t i = 0; i < iterations / 10; ++i) {
+            op(i);
+        }
+        std::vector<int64_t> samples(iterations);
+        auto previous = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; ++i) {
+            op(i);
+            auto now = std::chrono::steady_clock::now();
+            samples[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(now - previous).count();
+            previous = now;
+        }
+        std::sort(samples.begin(), samples.end());
+        auto at = [&](double fraction) {
+            return static_cast<double>(samples[std::min(samples.size() - 1, static_cast<size_t>(fraction * samples.size()))]);
+        };
+        double total = 0;
+        for (int64_t sample : samples) {
+            total += static_cast<double>(sample);
+        }
+        report(label, iterations, {
+            { "mean_ns", total / static_cast<double>(iterations) },
+            { "p50_ns", at(0.50) },
+            { "p99_ns", at(0.99) },
+            { "p999_ns", at(0.999) },
+            { "max_ns", static_cast<double>(samples.back()) },
+        });
+    }
+
+    // 以 JSON 输出全部结果
+    void writeJson(std::ostream& out) const {
+        out << "{\n  \"benchmarks\": [";
+        for (size_t i = 0; i < results_.size(); ++i) {
+            const Result& result = results_[i];
+            out << (i == 0 ? "\n" : ",\n") << "    { \"bench\": " << quoted(result.bench)
+                << ", \"label\": " << quoted(result.label)
+                << ", \"iterations\": " << result.iterations;
+            for (const auto& [name, value] : result.metrics) {
+                out << ", " << quoted(name) << ": " << std::fixed << std::setprecision(3) << value;
+            }
+            out << " }";
+        }
+        out << "\n  ]\n}" << std::endl;
+    }
+
+private:
+    Bench() = default;
+    std::vector<std::pair<std::string, BenchFunc>> benches_;
+    std::vector<Result> results_;
+    std::string current_;
+    std::string pluginDirectory_ = ".";
+    std::ostream* textOut_ = &std::cout;
+
+    static std::string quoted(const std::string& text) {
+        std::string escaped = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped + "\"";
+    }
+};
+
+#define BENCH(benchName) \
+    void benchName(); \
+    struct benchName##_Register { \
+        benchName##_Register() { \
+            Bench::getInstance().registerBench(#benchName, benchName); \
+        } \
+    } benchName##_instance; \
+    void benchName()
+
+#endif // BENCH_H
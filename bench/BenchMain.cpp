@@ -0,0 +1,59 @@
+// bench/BenchMain.cpp
+#include "Bench.h"
+#include <fstream>
+#include <string>
+
+namespace {
+
+const char* const kUsage = "Usage: MotsBench [--filter <substring>] [--plugins <directory>] [--json <file>|-]";
+
+} // namespace
+
+// 用法：MotsBench [--filter <子串>] [--plugins <目录>] [--json <文件>|-]
+// JSON 输出到 stdout（--json -）时文本报告改写到 stderr
+int main(int argc, char** argv) {
+    std::string filter;
+    std::string jsonPath;
+    for (int i = 1; i < argc; i += 2) {
+        std::string option = argv[i];
+        if (i + 1 >= argc) {
+            // 末尾缺少取值的选项（含 --help）只打印用法
+            if (option != "--help" && option != "-h") {
+                std::cerr << "Missing value for option: " << option << std::endl;
+            }
+            std::cerr << kUsage << std::endl;
+            return 1;
+        }
+        if (option == "--filter") {
+            filter = argv[i + 1];
+        }
+        else if (option == "--plugins") {
+            Bench::getInstance().setPluginDirectory(argv[i + 1]);
+        }
+        else if (option == "--json") {
+            jsonPath = argv[i + 1];
+        }
+        else {
+            std::cerr << "Unknown option: " << option << "\n" << kUsage << std::endl;
+            return 1;
+        }
+    }
+
+    if (jsonPath == "-") {
+        Bench::getInstance().setTextOutput(std::cerr);
+    }
+    Bench::getInstance().run(filter);
+
+    if (jsonPath == "-") {
+        Bench::getInstance().writeJson(std::cout);
+    }
+    else if (!jsonPath.empty()) {
+        std::ofstream out(jsonPath);
+        if (!out) {
+            std::cerr << "Failed to open JSON output: " << jsonPath << std::endl;
+            return 1;
+        }
+        Bench::getInstance().writeJson(out);
+    }
+    return 0;
+}
@@ -0,0 +1,277 @@
+// bench/EventBench.cpp
+#include "Bench.h"
+#include "../include/Event.h"
+#include "../include/Channel.h"
+#include "../include/EventJournal.h"
+#include <filesystem>
+#include <stdexcept>
+
+namespace {
+
+constexpr uint64_t kIterations = 2000000;
+
+// 构造一个接近行情场景的事件表：大量事件名，每个事件一个订阅者
+void populate(EventManager& manager, std::vector<std::string>& names, uint64_t& counter) {
+    for (int i = 0; i < 1000; ++i) {
+        names.push_back("md.XNAS.SYM" + std::to_string(i) + ".quote");
+        manager.registerEvent("BenchPlugin", names.back(), [&counter](const std::string& data) {
+            counter += data.size();
+        });
+    }
+}
+
+} // namespace
+
+// 比较字符串名称触发与事件标识触发的单次发布成本
+BENCH(BenchTriggerByNameVsId) {
+    EventManager manager;
+    std::vector<std::string> names;
+    uint64_t counter = 0;
+    populate(manager, names, counter);
+
+    std::vector<EventId> ids;
+    for (const auto& name : names) {
+        ids.push_back(manager.resolveEvent(name));
+    }
+
+    const std::string payload = "bid=100.25;ask=100.26";
+    Bench::measure("triggerEvent(const std::string&)", kIterations, [&](uint64_t i) {
+        manager.triggerEvent(names[i % names.size()], payload);
+    });
+    Bench::measure("triggerEvent(EventId)", kIterations, [&](uint64_t i) {
+        manager.triggerEvent(ids[i % ids.size()], payload);
+    });
+
+    if (counter == 0) {
+        Bench::out() << "  (no callbacks invoked)" << std::endl;
+    }
+}
+
+namespace {
+struct BenchQuote {
+    uint32_t symbolId;
+    double bid;
+    double ask;
+};
+}
+
+// 比较“序列化为字符串再解析”与类型化负载按引用传递的成本（4 个订阅者）
+BENCH(BenchTypedPayloadVsString) {
+    EventManager manager;
+    double sink = 0;
+    for (int i = 0; i < 4; ++i) {
+        manager.registerEvent("BenchPlugin", "OnQuoteText", [&sink](const std::string& data) {
+            size_t split = data.find(';');
+            sink += std::stod(data.substr(4, split - 4)) + std::stod(data.substr(split + 5));
+        });
+        manager.registerEvent("BenchPlugin", "OnQuoteTyped", [&sink](const EventPayload& payload) {
+            const BenchQuote* quote = payload.as<BenchQuote>();
+            sink += quote->bid + quote->ask;
+        });
+    }
+    EventId textId = manager.resolveEvent("OnQuoteText");
+    EventId typedId = manager.resolveEvent("OnQuoteTyped");
+
+    Bench::measure("string payload (serialize + parse)", kIterations / 4, [&](uint64_t i) {
+        BenchQuote quote{ 1, 100.0 + static_cast<double>(i % 100), 100.5 };
+        manager.triggerEvent(textId, "bid=" + std::to_string(quote.bid) + ";ask=" + std::to_string(quote.ask));
+    });
+    Bench::measure("typed payload (EventPayload::view)", kIterations / 4, [&](uint64_t i) {
+        BenchQuote quote{ 1, 100.0 + static_cast<double>(i % 100), 100.5 };
+        manager.triggerEvent(typedId, EventPayload::view(quote));
+    });
+
+    if (sink == 0) {
+        Bench::out() << "  (no callbacks invoked)" << std::endl;
+    }
+}
+
+// 扇出成本：一个事件分发到 N 个订阅者，订阅记录连续存放于同一数组
+BENCH(BenchFanOut) {
+    for (int subscribers : { 1, 10, 100 }) {
+        EventManager manager;
+        uint64_t counter = 0;
+        EventId eventId = manager.resolveEvent("OnFanOut");
+        PluginId pluginId = manager.resolvePlugin("BenchPlugin");
+        for (int i = 0; i < subscribers; ++i) {
+            manager.registerEvent(pluginId, eventId, [&counter](const EventPayload&) { ++counter; });
+        }
+        uint64_t value = 42;
+        Bench::measure("fan-out to " + std::to_string(subscribers) + " subscribers", kIterations / subscribers, [&](uint64_t) {
+            manager.triggerEvent(eventId, EventPayload::view(value));
+        });
+    }
+}
+
+// 编译期通道与动态总线的对比：相同的 3 个处理器
+BENCH(BenchChannelVsTriggerEvent) {
+    double sink = 0;
+    auto onQuote = [&sink](const BenchQuote& quote) { sink += quote.bid; };
+    auto onSpread = [&sink](const BenchQuote& quote) { sink += quote.ask - quote.bid; };
+    auto onMid = [&sink](const BenchQuote& quote) { sink += (quote.ask + quote.bid) * 0.5; };
+    auto channel = makeChannel<BenchQuote>(onQuote, onSpread, onMid);
+
+    EventManager manager;
+    EventId quoteId = manager.resolveEvent("OnQuote");
+    PluginId pluginId = manager.resolvePlugin("BenchPlugin");
+    subscribeTyped<BenchQuote>(manager, pluginId, quoteId, onQuote);
+    subscribeTyped<BenchQuote>(manager, pluginId, quoteId, onSpread);
+    subscribeTyped<BenchQuote>(manager, pluginId, quoteId, onMid);
+
+    Bench::measure("Channel<T>::publish (static handlers)", kIterations, [&](uint64_t i) {
+        channel.publish(BenchQuote{ 1, static_cast<double>(i & 127), 200.0 });
+    });
+    Bench::measure("EventManager::triggerEvent (typed payload)", kIterations, [&](uint64_t i) {
+        BenchQuote quote{ 1, static_cast<double>(i & 127), 200.0 };
+        manager.triggerEvent(quoteId, EventPayload::view(quote));
+    });
+
+    if (sink == 0) {
+        Bench::out() << "  (no handlers invoked)" << std::endl;
+    }
+}
+
+// 一个数据包解码出 32 条更新：逐条触发与批量触发（含一个批量订阅者）的对比
+BENCH(BenchBatchedTrigger) {
+    constexpr size_t kBatch = 32;
+    EventManager manager;
+    PluginId pluginId = manager.resolvePlugin("BenchPlugin");
+    std::vector<EventId> ids;
+    uint64_t counter = 0;
+    for (int i = 0; i < 4; ++i) {
+        ids.push_back(manager.resolveEvent("md.batch." + std::to_string(i)));
+        manager.registerEvent(pluginId, ids.back(), [&counter](const EventPayload&) { ++counter; });
+        manager.registerBatchEvent(pluginId, ids.back(), [&counter](const EventBatchView& slice) { counter += slice.size(); });
+    }
+
+    // 按事件分组排列，每个事件一段
+    std::vector<BenchQuote> quotes(kBatch, BenchQuote{ 1, 100.0, 100.5 });
+    std::vector<BatchEvent> batch;
+    for (size_t i = 0; i < kBatch; ++i) {
+        batch.push_back(BatchEvent{ ids[i * ids.size() / kBatch], EventPayload::view(quotes[i]) });
+    }
+    Bench::measure("32 x triggerEvent (per update)", kIterations / kBatch, [&](uint64_t) {
+        for (const auto& event : batch) {
+            manager.triggerEvent(event.eventId, event.payload);
+        }
+    });
+    Bench::measure("triggerEvents (one batch of 32)", kIterations / kBatch, [&](uint64_t) {
+        manager.triggerEvents(batch);
+    });
+
+    if (counter == 0) {
+        Bench::out() << "  (no callbacks invoked)" << std::endl;
+    }
+}
+
+// 日志写入成本：级别过滤、被速率限制、写入线程缓冲区；以及回调每次都抛异常时的触发成本
+BENCH(BenchLogging) {
+    constexpr uint64_t kLogIterations = 200000;
+    std::ostream discard(nullptr);
+    Logger::Options options;
+    options.recordsPerThread = 1 << 16;
+    Logger logger(discard, options);
+    LogChannel& channel = logger.channel("BenchPlugin");
+
+    Bench::measure("logf below channel level", kLogIterations, [&](uint64_t i) {
+        channel.logf(LogLevel::Debug, "tick %llu", static_cast<unsigned long long>(i));
+    });
+    channel.setRateLimit(0, 0);
+    Bench::measure("logf into thread buffer", kLogIterations / 10, [&](uint64_t i) {
+        channel.logf(LogLevel::Info, "tick %llu", static_cast<unsigned long long>(i));
+    });
+    channel.setRateLimit(100, 10);
+    Bench::measure("logf over rate limit", kLogIterations, [&](uint64_t i) {
+        channel.logf(LogLevel::Error, "tick %llu", static_cast<unsigned long long>(i));
+    });
+    logger.flush();
+
+    EventManager manager(logger);
+    manager.registerEvent("BenchPlugin", "OnThrow", [](const EventPayload&) -> void {
+        throw std::runtime_error("rejected");
+    });
+    EventId eventId = manager.resolveEvent("OnThrow");
+    uint64_t value = 1;
+    Bench::measure("trigger with throwing callback (rate limited log)", kLogIterations, [&](uint64_t) {
+        manager.triggerEvent(eventId, EventPayload::view(value));
+    });
+    logger.flush();
+}
+
+// 事件日志：追加一条类型化记录的成本，以及从映射文件按最快速度重放的吞吐
+BENCH(BenchJournal) {
+    std::string path = (std::filesystem::temp_directory_path() / "mots_bench.journal").string();
+    EventManager manager;
+    std::vector<EventId> ids;
+    for (int i = 0; i < 16; ++i) {
+        ids.push_back(manager.resolveEvent("md.journal." + std::to_string(i)));
+    }
+    {
+        JournalWriter writer(manager);
+        if (!writer.open(path, size_t(256) << 20)) {
+            Bench::out() << "  (cannot create " << path << ")" << std::endl;
+            return;
+        }
+        Bench::measure("JournalWriter::append (typed quote)", kIterations, [&](uint64_t i) {
+            BenchQuote quote{ static_cast<uint32_t>(i), 100.0 + static_cast<double>(i % 100), 100.5 };
+            writer.append(ids[i % ids.size()], EventPayload::view(quote));
+        });
+        writer.close();
+    }
+
+    EventManager target;
+    double sink = 0;
+    for (int i = 0; i < 16; ++i) {
+        target.registerEvent("BenchPlugin", "md.journal." + std::to_string(i), [&sink](const EventPayload& payload) {
+            sink += payload.as<BenchQuote>()->bid;
+        });
+    }
+    JournalReader reader;
+    reader.bindType<BenchQuote>();
+    if (reader.open(path)) {
+        ReplayStats stats = reader.replay(target);
+        Bench::report("JournalReader::replay (as fast as possible)", stats.events, {
+            { "ns_per_op", static_cast<double>(stats.elapsed.count()) / static_cast<double>(std::max<uint64_t>(stats.events, 1)) },
+            { "events_per_second", stats.eventsPerSecond() },
+        });
+    }
+    reader.close();
+    std::filesystem::remove(path);
+    if (sink == 0) {
+        Bench::out() << "  (no callbacks invoked)" << std::endl;
+    }
+}
+
+// 通配订阅：具体主题的发布成本不随通配订阅数量变化（订阅者集合已按主题缓存）
+BENCH(BenchWildcardTopics) {
+    EventManager manager;
+    std::vector<std::string> names;
+    uint64_t counter = 0;
+    populate(manager, names, counter);
+    std::vector<EventId> ids;
+    for (const auto& name : names) {
+        ids.push_back(manager.resolveEvent(name));
+    }
+    const std::string payload = "bid=100.25;ask=100.26";
+    Bench::measure("triggerEvent(EventId), exact subscribers only", kIterations, [&](uint64_t i) {
+        manager.triggerEvent(ids[i % ids.size()], payload);
+    });
+
+    // 10000 个不匹配的交易所模式，加一个匹配全部主题的模式
+    PluginId plugin = manager.resolvePlugin("WildcardPlugin");
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 10000; ++i) {
+        manager.registerEvent(plugin, manager.resolveEvent("md.EX" + std::to_string(i) + ".*.quote"),
+            [&counter](const EventPayload&) { ++counter; });
+    }
+    manager.registerEvent(plugin, manager.resolveEvent("md.XNAS.*.quote"), [&counter](const EventPayload&) { ++counter; });
+    double subscribeNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / 10001;
+    Bench::report("subscribe pattern (10001 patterns, 1000 topics)", 10001, { { "ns_per_op", subscribeNs } });
+
+    Bench::measure("triggerEvent(EventId), +10001 wildcard subscriptions", kIterations, [&](uint64_t i) {
+        manager.triggerEvent(ids[i % ids.size()], payload);
+    });
+    Bench::measure("resolveEvent(new topic) against 10001 patterns", 10000, [&](uint64_t i) {
+        manager.resolveEvent("md.XNAS.NEW" + std::to_string(i) + ".quote");
+    });
+}
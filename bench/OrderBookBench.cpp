@@ -0,0 +1,172 @@
+// bench/OrderBookBench.cpp
+#include "Bench.h"
+#include "../include/OrderBook.h"
+#include "../include/PluginManager.h"
+#include <algorithm>
+#include <filesystem>
+
+// 合成逐笔行情下订单簿的持续更新吞吐：直接驱动 OrderBookSet，以及经总线驱动 OrderBookPlugin
+namespace {
+
+enum class UpdateKind : uint8_t { Add, Modify, Cancel };
+
+struct FeedUpdate {
+    UpdateKind kind;
+    OrderAdd add;
+    OrderModify modify;
+    OrderCancel cancel;
+};
+
+// 确定性的合成行情：16 个品种，新委托落在各自中间价两侧 32 档内并偏向一档，改价不越过中间价（买卖不交叉）；
+// 约一半为新增，其余为全部或部分撤单与改单；末尾撤销全部剩余委托，因而可以反复重放
+std::vector<FeedUpdate> makeFeed(size_t updates) {
+    constexpr uint32_t kInstruments = 16;
+    constexpr size_t kMaxLive = 20000;
+    struct Live {
+        uint64_t orderId;
+        int64_t price;
+        uint64_t quantity;
+        int64_t limit;  // 改价不越过中间价，买卖不交叉
+        Side side;
+    };
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    auto next = [&state] {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return state >> 33;
+    };
+    constexpr int64_t kMid = 100000;
+    std::vector<Live> live;
+    std::vector<FeedUpdate> feed;
+    feed.reserve(updates + kMaxLive);
+    uint64_t nextId = 1;
+    while (feed.size() < updates) {
+        FeedUpdate update{};
+        uint64_t action = next() % 100;
+        if (live.empty() || (action < 50 && live.size() < kMaxLive)) {
+            uint32_t instrument = static_cast<uint32_t>(next() % kInstruments);
+            int64_t mid = kMid + instrument * 1000;
+            Side side = next() % 2 ? Side::Buy : Side::Sell;
+            // 偏向靠近一档的价位
+            int64_t offset = 1 + static_cast<int64_t>((next() % 32) * (next() % 32) / 32);
+            int64_t price = side == Side::Buy ? mid - offset : mid + offset;
+            uint64_t quantity = 1 + next() % 500;
+            update.kind = UpdateKind::Add;
+            update.add = OrderAdd{ nextId, instrument, side, price, quantity };
+            live.push_back(Live{ nextId++, price, quantity, side == Side::Buy ? mid - 1 : mid + 1, side });
+        }
+        else {
+            size_t slot = static_cast<size_t>(next() % live.size());
+            Live& order = live[slot];
+            if (action < 85) {
+                // 约三成为部分撤单或成交
+                uint64_t quantity = order.quantity > 1 && next() % 10 < 3 ? 1 + next() % (order.quantity - 1) : 0;
+                update.kind = UpdateKind::Cancel;
+                update.cancel = OrderCancel{ order.orderId, quantity };
+                if (quantity == 0) {
+                    live[slot] = live.back();
+                    live.pop_back();
+                }
+                else {
+                    order.quantity -= quantity;
+                }
+            }
+            else {
+                // 改单：多为减量，偶尔改价一档
+                if (next() % 4 == 0) {
+                    order.price += next() % 2 ? 1 : -1;
+                    order.price = order.side == Side::Buy ? std::min(order.price, order.limit) : std::max(order.price, order.limit);
+                }
+                else if (order.quantity > 1) {
+                    order.quantity -= 1 + next() % (order.quantity - 1);
+                }
+                update.kind = UpdateKind::Modify;
+                update.modify = OrderModify{ order.orderId, order.price, order.quantity };
+            }
+        }
+        feed.push_back(update);
+    }
+    for (const Live& order : live) {
+        FeedUpdate update{};
+        update.kind = UpdateKind::Cancel;
+        update.cancel = OrderCancel{ order.orderId, 0 };
+        feed.push_back(update);
+    }
+    return feed;
+}
+
+// 按一次完整重放计时，输出每秒更新数；首轮为预热，建立节点池与价位数组
+template <typename Replay>
+void measureReplay(const std::string& label, size_t updates, int rounds, Replay&& replay) {
+    replay();
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        replay();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double total = static_cast<double>(updates) * rounds;
+    Bench::report(label, static_cast<uint64_t>(total), {
+        { "updates_per_sec", total / seconds },
+        { "ns_per_update", seconds * 1e9 / total },
+    });
+}
+
+} // namespace
+
+// 直接驱动 OrderBookSet，衡量数据结构本身
+BENCH(BenchOrderBookDirect) {
+    std::vector<FeedUpdate> feed = makeFeed(1000000);
+    OrderBookSet books;
+    uint64_t checksum = 0;
+    measureReplay("OrderBookSet add/modify/cancel", feed.size(), 5, [&] {
+        for (const FeedUpdate& update : feed) {
+            const OrderBook* book = nullptr;
+            switch (update.kind) {
+            case UpdateKind::Add: book = books.add(update.add); break;
+            case UpdateKind::Modify: book = books.modify(update.modify); break;
+            case UpdateKind::Cancel: book = books.cancel(update.cancel); break;
+            }
+            checksum += book ? book->sequence() : 0;
+        }
+    });
+    OrderBookStats stats = books.stats();
+    Bench::out() << "  rejected=" << stats.rejected << " pooledNodes=" << stats.pooledNodes
+        << " checksum=" << checksum << std::endl;
+}
+
+// 经总线发布到 OrderBookPlugin（逐条与每批 64 条），含一档变化的发布与订阅者回调
+BENCH(BenchOrderBookPlugin) {
+    PluginManager manager;
+    if (!manager.loadPlugin(Bench::pluginPath("OrderBookPlugin"))) {
+        Bench::out() << "  (OrderBookPlugin not found, run from apphome/bin or pass --plugins)" << std::endl;
+        return;
+    }
+    uint64_t tops = 0;
+    manager.subscribePluginEvent("OrderBookPlugin", kTopOfBookEvent, [&tops](const EventPayload&) { ++tops; });
+    const EventId ids[] = {
+        manager.resolvePluginEvent(kOrderAddEvent),
+        manager.resolvePluginEvent(kOrderModifyEvent),
+        manager.resolvePluginEvent(kOrderCancelEvent),
+    };
+
+    std::vector<FeedUpdate> feed = makeFeed(1000000);
+    std::vector<BatchEvent> events;
+    events.reserve(feed.size());
+    for (const FeedUpdate& update : feed) {
+        switch (update.kind) {
+        case UpdateKind::Add: events.push_back(BatchEvent{ ids[0], EventPayload::view(update.add) }); break;
+        case UpdateKind::Modify: events.push_back(BatchEvent{ ids[1], EventPayload::view(update.modify) }); break;
+        case UpdateKind::Cancel: events.push_back(BatchEvent{ ids[2], EventPayload::view(update.cancel) }); break;
+        }
+    }
+
+    for (size_t batch : { size_t(1), size_t(64) }) {
+        tops = 0;
+        measureReplay("OrderBookPlugin via bus, batch " + std::to_string(batch), events.size(), 3, [&] {
+            for (size_t i = 0; i < events.size(); i += batch) {
+                manager.triggerPluginEvents(events.data() + i, std::min(batch, events.size() - i));
+            }
+        });
+        Bench::out() << "  top-of-book publishes per update=" << static_cast<double>(tops) / (events.size() * 4.0) << std::endl;
+    }
+}
@@ -0,0 +1,239 @@
+// bench/PluginBench.cpp
+#include "Bench.h"
+#include "../include/PluginManager.h"
+#include <atomic>
+#include <filesystem>
+#include <thread>
+
+// 使用 apphome/bin 中的真实插件测量 PluginManager 的热路径与生命周期
+namespace {
+
+// 加载 SamplePlugin 作为订阅方；失败时提示并跳过该基准
+bool loadSample(PluginManager& manager) {
+    if (!manager.loadPlugin(Bench::pluginPath("SamplePlugin"))) {
+        Bench::out() << "  (SamplePlugin not found, run from apphome/bin or pass --plugins)" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// 单线程 triggerPluginEvent 的延迟分布
+BENCH(BenchTriggerPluginEventLatency) {
+    PluginManager manager;
+    if (!loadSample(manager)) {
+        return;
+    }
+    uint64_t counter = 0;
+    manager.registerPluginEvent("SamplePlugin", "OnLatency", [&counter](const EventPayload&) { ++counter; });
+    EventId eventId = manager.resolvePluginEvent("OnLatency");
+    const std::string payload = "bid=100.25;ask=100.26";
+
+    Bench::measurePercentiles("triggerPluginEvent(name)", 200000, [&](uint64_t) {
+        manager.triggerPluginEvent("OnLatency", payload);
+    });
+    Bench::measurePercentiles("triggerPluginEvent(EventId)", 200000, [&](uint64_t) {
+        manager.triggerPluginEvent(eventId, payload);
+    });
+}
+
+// 扇出到 1、10、1000 个订阅者
+BENCH(BenchPluginFanOut) {
+    for (int subscribers : { 1, 10, 1000 }) {
+        PluginManager manager;
+        if (!loadSample(manager)) {
+            return;
+        }
+        uint64_t counter = 0;
+        EventId eventId = manager.resolvePluginEvent("OnFanOut");
+        for (int i = 0; i < subscribers; ++i) {
+            manager.registerPluginEvent("SamplePlugin", eventId, [&counter](const EventPayload&) { ++counter; });
+        }
+        uint64_t value = 42;
+        Bench::measure("fan-out to " + std::to_string(subscribers) + " subscribers", 2000000 / subscribers, [&](uint64_t) {
+            manager.triggerPluginEvent(eventId, EventPayload::view(value));
+        });
+    }
+}
+
+// 多个发布线程同时触发同一事件时的吞吐伸缩
+BENCH(BenchPublisherScaling) {
+    PluginManager manager;
+    if (!loadSample(manager)) {
+        return;
+    }
+    std::atomic<uint64_t> counter{ 0 };
+    EventId eventId = manager.resolvePluginEvent("OnContended");
+    manager.registerPluginEvent("SamplePlugin", eventId, [&counter](const EventPayload&) {
+        counter.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    constexpr uint64_t kPerThread = 200000;
+    for (size_t threads : { 1, 2, 4, 8 }) {
+        std::atomic<size_t> ready{ 0 };
+        std::atomic<bool> go{ false };
+        std::vector<std::thread> publishers;
+        for (size_t t = 0; t < threads; ++t) {
+            publishers.emplace_back([&] {
+                uint64_t value = 7;
+                ++ready;
+                while (!go.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                for (uint64_t i = 0; i < kPerThread; ++i) {
+                    manager.triggerPluginEvent(eventId, EventPayload::view(value));
+                }
+            });
+        }
+        while (ready.load() < threads) {
+            std::this_thread::yield();
+        }
+        auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& publisher : publishers) {
+            publisher.join();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double total = static_cast<double>(kPerThread * threads);
+        Bench::report(std::to_string(threads) + " publisher threads", kPerThread * threads, {
+            { "events_per_sec", total / seconds },
+            { "ns_per_op_per_thread", seconds * 1e9 / static_cast<double>(kPerThread) },
+        });
+    }
+}
+
+// 订阅/注销的抖动成本：事件上已有 100 个订阅者
+BENCH(BenchSubscriptionChurn) {
+    PluginManager manager;
+    if (!loadSample(manager)) {
+        return;
+    }
+    EventId eventId = manager.resolvePluginEvent("OnChurn");
+    for (int i = 0; i < 100; ++i) {
+        manager.registerPluginEvent("SamplePlugin", eventId, [](const EventPayload&) {});
+    }
+    Bench::measure("subscribe + unsubscribe (100 existing)", 20000, [&](uint64_t) {
+        SubscriptionToken token = manager.subscribePluginEvent("SamplePlugin", eventId, [](const EventPayload&) {});
+        manager.unsubscribePluginEvent(token);
+    });
+}
+
+// 插件加载与卸载：逐个 loadPlugin 与目录并发加载，随后 unloadAll
+BENCH(BenchPluginLifecycle) {
+    constexpr int kRounds = 20;
+    std::vector<std::string> paths = { Bench::pluginPath("SamplePlugin"), Bench::pluginPath("AnotherPlugin") };
+
+    double loadNs = 0;
+    double parallelNs = 0;
+    double unloadNs = 0;
+    size_t plugins = 0;
+    for (int round = 0; round < kRounds; ++round) {
+        PluginManager manager;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& path : paths) {
+            plugins += manager.loadPlugin(path) ? 1 : 0;
+        }
+        auto loaded = std::chrono::steady_clock::now();
+        manager.unloadAll();
+        auto unloaded = std::chrono::steady_clock::now();
+        manager.loadPlugins(paths);
+        auto parallel = std::chrono::steady_clock::now();
+        manager.unloadAll();
+
+        loadNs += std::chrono::duration<double, std::nano>(loaded - start).count();
+        unloadNs += std::chrono::duration<double, std::nano>(unloaded - loaded).count();
+        parallelNs += std::chrono::duration<double, std::nano>(parallel - unloaded).count();
+    }
+    if (plugins == 0) {
+        Bench::out() << "  (no plugins found, run from apphome/bin or pass --plugins)" << std::endl;
+        return;
+    }
+    Bench::report(std::to_string(plugins / kRounds) + " plugins", kRounds, {
+        { "loadPlugin_ns", loadNs / kRounds },
+        { "loadPlugins_ns", parallelNs / kRounds },
+        { "unloadAll_ns", unloadNs / kRounds },
+    });
+}
+
+// AnotherPlugin 的 Ping -> Pong 往返延迟：进程内与子进程隔离（经共享内存环两次跨进程）
+BENCH(BenchIsolatedRoundTrip) {
+    constexpr uint64_t kIterations = 20000;
+    for (bool isolated : { false, true }) {
+        PluginManager manager;
+        if (!loadSample(manager)) {
+            return;
+        }
+        bool loaded = isolated ? manager.loadIsolatedPlugin(Bench::pluginPath("AnotherPlugin"))
+                               : manager.loadPlugin(Bench::pluginPath("AnotherPlugin"));
+        if (!loaded) {
+            Bench::out() << "  (AnotherPlugin" << (isolated ? " or MotsPluginHost" : "") << " not available)" << std::endl;
+            return;
+        }
+        std::atomic<uint64_t> pongs{ 0 };
+        manager.registerPluginEvent("SamplePlugin", "AnotherPlugin.Pong", [&pongs](const EventPayload&) {
+            pongs.fetch_add(1, std::memory_order_release);
+        });
+        EventId pingId = manager.resolvePluginEvent("AnotherPlugin.Ping");
+        const std::string payload = "bid=100.25;ask=100.26";
+        uint64_t expected = 0;
+        Bench::measurePercentiles(isolated ? "ping/pong (isolated process)" : "ping/pong (in-process)", kIterations, [&](uint64_t) {
+            manager.triggerPluginEvent(pingId, payload);
+            ++expected;
+            while (pongs.load(std::memory_order_acquire) < expected) {
+                std::this_thread::yield();
+            }
+        });
+        manager.unloadAll();
+    }
+}
+
+// AnotherPlugin 的 Ping -> Pong 往返延迟：发布线程内联执行与反应器线程执行（持续忙等 / 空闲即阻塞）。
+// 单核机器上忙等的反应器与发布线程争用同一个核，结果只反映调度开销
+BENCH(BenchReactorRoundTrip) {
+    constexpr uint64_t kIterations = 2000;
+    struct Mode {
+        const char* label;
+        ExecutionPolicy policy;
+    };
+    const Mode modes[] = {
+        { "ping/pong (inline)", ExecutionPolicy{} },
+        { "ping/pong (reactor, spinning)", ExecutionPolicy::reactor(-1, std::chrono::microseconds(100000)) },
+        { "ping/pong (reactor, blocking)", ExecutionPolicy::reactor(-1, std::chrono::microseconds(0)) },
+    };
+    for (const Mode& mode : modes) {
+        PluginManager manager;
+        if (!loadSample(manager)) {
+            return;
+        }
+        if (!manager.loadPlugin(Bench::pluginPath("AnotherPlugin"), mode.policy)) {
+            Bench::out() << "  (AnotherPlugin not available)" << std::endl;
+            return;
+        }
+        std::atomic<uint64_t> pongs{ 0 };
+        manager.registerPluginEvent("SamplePlugin", "AnotherPlugin.Pong", [&pongs](const EventPayload&) {
+            pongs.fetch_add(1, std::memory_order_release);
+        });
+        EventId pingId = manager.resolvePluginEvent("AnotherPlugin.Ping");
+        const std::string payload = "bid=100.25;ask=100.26";
+        uint64_t expected = 0;
+        Bench::measurePercentiles(mode.label, kIterations, [&](uint64_t) {
+            manager.triggerPluginEvent(pingId, payload);
+            ++expected;
+            while (pongs.load(std::memory_order_acquire) < expected) {
+                std::this_thread::yield();
+            }
+        });
+        if (mode.policy.mode == ExecutionMode::Reactor) {
+            ReactorStats stats = manager.getReactorStats("AnotherPlugin");
+            Bench::report(std::string(mode.label) + " reactor", stats.events, {
+                { "queue_p50_us", stats.queueLatency.p50Us },
+                { "queue_p99_us", stats.queueLatency.p99Us },
+                { "wakeup_p50_us", stats.wakeupLatency.p50Us },
+                { "sleeps", static_cast<double>(stats.sleeps) },
+                { "spin_ms", stats.spinSeconds * 1000.0 },
+            });
+        }
+        manager.unloadAll();
+    }
+}
@@ -0,0 +1,199 @@
+// include/AsyncEventBus.h
+#ifndef ASYNCEVENTBUS_H
+#define ASYNCEVENTBUS_H
+
+#include "Event.h"
+#include "RingBuffer.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <string_view>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 由分发线程执行的任务（如订阅者邮箱的排空）
+class AsyncTask {
+public:
+    virtual ~AsyncTask() = default;
+    virtual void run() = 0;
+};
+
+// 异步事件：负载必须是拥有型（见 EventPayload::retain）；task 非空时执行任务而非触发事件
+struct AsyncEvent {
+    EventId eventId;
+    EventPayload payload;
+    int64_t enqueueTimeNs = 0;
+    std::shared_ptr<AsyncTask> task;
+    uint32_t keyLane = 0;  // 指定分区键时为键的队列状态下标 + 1，分发后据此释放
+};
+
+// 单个分片（分发线程及其队列）的统计，用于发现热点品种
+struct ShardStats {
+    size_t shard = 0;
+    uint64_t depth = 0;             // 当前排队深度（全部优先级队列）
+    uint64_t maxDepth = 0;          // 历史最大深度
+    uint64_t enqueued = 0;
+    uint64_t dispatched = 0;
+    uint64_t dropped = 0;
+    double meanQueueLatencyUs = 0;  // 入队到开始分发的平均等待
+    double maxQueueLatencyUs = 0;
+};
+
+// 异步事件总线：每个分发线程（分片）拥有一个有界无锁 MPSC 队列。
+// 发布者只做一次入队即返回；分发线程把事件交给 EventManager 的订阅者。
+// 未指定分区键时，同一发布线程固定投递到同一分片，单个发布者发出的事件保持顺序；
+// 指定分区键（如品种代码）时按键哈希路由到固定分片，同一键的事件全局有序，不同键并行处理。
+// 每个分片按优先级类别各有一个队列：事件按其订阅者中的最高类别入队，任务按投递时指定的类别入队，
+// 分发线程总是先排空高优先级的队列（严格优先，持续的高优先级负载会推迟低优先级的事件）。
+// 指定分区键的事件按键选队列：该键仍有未分发的事件时沿用其队列，全部分发后才按新事件的类别切换，
+// 因此同一键的事件（不论类别）始终按发布顺序分发，优先级只在不同键之间生效。
+// 未指定分区键的事件按事件选队列：仍有未分发的副本时沿用其队列，订阅变化不会打乱同一事件的顺序；
+// 不同事件的类别不同时不保证顺序。
+class AsyncEventBus {
+public:
+    explicit AsyncEventBus(EventManager& eventManager);
+    ~AsyncEventBus();
+    AsyncEventBus(const AsyncEventBus&) = delete;
+    AsyncEventBus& operator=(const AsyncEventBus&) = delete;
+
+    // 启动 dispatcherThreads 个分发线程，每个优先级队列容量为 queueCapacity；不得与 publish 并发调用
+    bool start(size_t dispatcherThreads, size_t queueCapacity);
+
+    // 排空所有队列后停止分发线程
+    void stop();
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+
+    // 入队后立即返回；总线未运行或队列已满时返回 false
+    bool publish(EventId eventId, const EventPayload& payload);
+
+    // 按分区键路由到固定分片。block 为 true 时队列满则等待空位（保证不丢、有序）；
+    // 当前线程正是该分片的分发线程时不能等待自己，队列满则返回 false 并计入丢弃数
+    bool publish(EventId eventId, const EventPayload& payload, uint64_t partitionKey, bool block);
+
+    // 把任务投递到分区键对应的分片中 priority 类别的队列；队列满时等待空位。
+    // 总线未运行，或在该分片线程上调用且队列已满时返回 false，由调用方另行执行
+    bool post(std::shared_ptr<AsyncTask> task, uint64_t partitionKey, PriorityClass priority = PriorityClass::Normal);
+
+    static uint64_t partitionOf(std::string_view key) {
+        return std::hash<std::string_view>{}(key);
+    }
+
+    size_t shardCount() const { return dispatchers_.size(); }
+    std::vector<ShardStats> shardStats() const;
+
+    // 等待调用前已入队的事件全部分发完成。
+    // 在分发线程上调用时不等待该线程自身的队列（否则会自锁）。
+    void flush();
+
+    // 因队列已满被拒绝的事件数
+    uint64_t droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // 当前线程是否为某个总线的分发线程
+    static bool onDispatcherThread();
+
+private:
+    struct Dispatcher {
+        explicit Dispatcher(size_t capacity) {
+            for (auto& lane : lanes) {
+                lane = std::make_unique<MpscRingBuffer<AsyncEvent>>(capacity);
+            }
+        }
+
+        MpscRingBuffer<AsyncEvent>& lane(PriorityClass priority) { return *lanes[static_cast<size_t>(priority)]; }
+
+        // 按优先级从高到低取下一个事件
+        bool tryPop(AsyncEvent& event) {
+            for (auto& lane : lanes) {
+                if (lane->tryPop(event)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        size_t depth() const {
+            size_t total = 0;
+            for (const auto& lane : lanes) {
+                total += lane->size();
+            }
+            return total;
+        }
+
+        std::array<std::unique_ptr<MpscRingBuffer<AsyncEvent>>, kPriorityClasses> lanes;
+        std::thread thread;
+        alignas(64) std::atomic<uint64_t> enqueued{ 0 };
+        std::atomic<uint64_t> maxDepth{ 0 };
+        std::atomic<uint64_t> dropped{ 0 };
+        // 以下仅由分发线程写入
+        alignas(64) std::atomic<uint64_t> dispatched{ 0 };
+        std::atomic<int64_t> totalLatencyNs{ 0 };
+        std::atomic<int64_t> maxLatencyNs{ 0 };
+        std::atomic<bool> sleeping{ false };
+        std::mutex wakeMutex;
+        std::condition_variable wakeCondition;
+    };
+
+    // 每个事件当前使用的队列类别（高 32 位）与尚未分发的副本数（低 32 位，含正在入队的），
+    // 合在一个字中以便原子地判断并切换
+    struct LaneState {
+        std::atomic<uint64_t> word{ 0 };
+    };
+    static constexpr uint32_t kSegmentBits = 8;
+    static constexpr uint32_t kSlotsPerSegment = 1u << kSegmentBits;
+    static constexpr uint32_t kMaxSegments = 4096;
+    // 分区键按哈希共用队列状态：冲突的键只会更多地沿用同一队列，不影响各自的顺序
+    static constexpr uint32_t kKeyLaneBits = 12;
+
+    EventManager& eventManager_;
+    std::vector<std::unique_ptr<Dispatcher>> dispatchers_;
+    std::array<std::atomic<LaneState*>, kMaxSegments> lanes_{};
+    std::array<LaneState, 1u << kKeyLaneBits> keyLanes_{};
+    std::mutex lanesMutex_;     // 仅在分配新段时使用
+    std::atomic<bool> running_{ false };
+    std::atomic<bool> stopping_{ false };
+    std::atomic<uint64_t> dropped_{ 0 };
+    std::atomic<uint32_t> nextPublisher_{ 0 };
+    std::atomic<uint32_t> inFlight_{ 0 };   // 已通过运行检查、尚未完成入队的发布者
+
+    // 发布期间登记为在途：与 stop() 的 “清除运行标志 -> 读取在途计数” 构成 Dekker 式同步，
+    // stop() 最后一次排空之后不会再有事件入队
+    class InFlight {
+    public:
+        explicit InFlight(AsyncEventBus& bus) : bus_(bus) {
+            bus_.inFlight_.fetch_add(1, std::memory_order_seq_cst);
+            admitted_ = bus_.running_.load(std::memory_order_seq_cst);
+        }
+        ~InFlight() { bus_.inFlight_.fetch_sub(1, std::memory_order_release); }
+        explicit operator bool() const { return admitted_; }
+        InFlight(const InFlight&) = delete;
+        InFlight& operator=(const InFlight&) = delete;
+
+    private:
+        AsyncEventBus& bus_;
+        bool admitted_ = false;
+    };
+
+    void run(Dispatcher& dispatcher);
+    void wake(Dispatcher& dispatcher);
+    bool enqueue(Dispatcher& dispatcher, PriorityClass priority, AsyncEvent&& event, bool block);
+    // 标识无效时返回 nullptr
+    LaneState* laneStateOf(EventId eventId);
+    static uint32_t keyLaneOf(uint64_t partitionKey);
+    // 登记一个待分发的副本并返回其队列类别（无待分发副本时为 priority），未入队时须调用 releaseLane
+    static PriorityClass acquireLane(LaneState* state, PriorityClass priority);
+    static void releaseLane(LaneState* state);
+    void deliver(Dispatcher& dispatcher, AsyncEvent& event);
+
+    static int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    Dispatcher& dispatcherForThisThread();
+    Dispatcher& dispatcherForKey(uint64_t partitionKey);
+};
+
+#endif // ASYNCEVENTBUS_H
@@ -0,0 +1,80 @@
+// include/Channel.h
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include "Event.h"
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// 编译期类型化通道：处理器集合在编译期确定，publish 直接（可内联地）调用每个处理器，
+// 没有类型擦除、没有字符串查找，也没有 std::function 间接调用。
+// 适用于 行情处理 -> 订单簿构建 -> 信号 这类内部热路径。
+//
+// 与动态总线互通：
+//   - bridgeTo() 之后，publish 同时以零复制的类型化负载转发到 EventManager，
+//     运行时加载的插件可按事件标识订阅；没有动态订阅者时只多一次原子读。
+//   - subscribeTo() 把动态总线上类型为 T 的事件接入本通道的静态处理器。
+template <typename T, typename... Handlers>
+class Channel {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "Channel<T> requires a trivially copyable message type");
+
+    explicit Channel(Handlers... handlers)
+        : handlers_(std::move(handlers)...) {}
+
+    // 发布到编译期处理器，并在已桥接时转发到动态总线
+    void publish(const T& message) {
+        publishStatic(message);
+        if (bus_ && bus_->hasSubscribers(eventId_)) {
+            bus_->triggerEvent(eventId_, EventPayload::view(message));
+        }
+    }
+
+    // 仅发布到编译期处理器
+    void publishStatic(const T& message) {
+        std::apply([&message](Handlers&... handlers) { (handlers(message), ...); }, handlers_);
+    }
+
+    // 把本通道的消息转发到动态总线上的事件
+    void bridgeTo(EventManager& bus, EventId eventId) {
+        bus_ = &bus;
+        eventId_ = eventId;
+    }
+
+    // 把动态总线上的事件（负载类型为 T）接入编译期处理器；
+    // 只进入静态处理器，不会再次转发回总线
+    bool subscribeTo(EventManager& bus, PluginId pluginId, EventId eventId) {
+        return bus.registerEvent(pluginId, eventId, [this](const EventPayload& payload) {
+            if (const T* message = payload.as<T>()) {
+                publishStatic(*message);
+            }
+        }).valid();
+    }
+
+    template <size_t Index>
+    auto& handler() { return std::get<Index>(handlers_); }
+
+private:
+    std::tuple<Handlers...> handlers_;
+    EventManager* bus_ = nullptr;
+    EventId eventId_;
+};
+
+// 便于推导处理器类型：auto channel = makeChannel<Quote>(onQuote, [&](const Quote& q) { ... });
+template <typename T, typename... Handlers>
+Channel<T, std::decay_t<Handlers>...> makeChannel(Handlers&&... handlers) {
+    return Channel<T, std::decay_t<Handlers>...>(std::forward<Handlers>(handlers)...);
+}
+
+// 运行时插件以强类型方式订阅动态总线上的事件；负载类型不符时忽略
+template <typename T, typename F>
+bool subscribeTyped(EventManager& bus, PluginId pluginId, EventId eventId, F handler) {
+    return bus.registerEvent(pluginId, eventId, [handler](const EventPayload& payload) {
+        if (const T* message = payload.as<T>()) {
+            handler(*message);
+        }
+    }).valid();
+}
+
+#endif // CHANNEL_H
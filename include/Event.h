@@ -2,67 +2,611 @@
 #ifndef EVENT_H
 #define EVENT_H
 
+#include "Rcu.h"
+#include "EventPayload.h"
+#include "Stats.h"
+#include "Logger.h"
+#include "TopicTrie.h"
 #include <string>
-#include <unordered_map>
 #include <vector>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <functional>
 #include <mutex>
-#include <algorithm>
-#include <iostream>
+#include <unordered_map>
+#include <cstdint>
+
+// 事件标识：由事件名称解析一次得到，之后直接按下标索引分发表
+struct EventId {
+    static constexpr uint32_t kInvalid = UINT32_MAX;
+
+    uint32_t value = kInvalid;
+
+    bool valid() const { return value != kInvalid; }
+    bool operator==(const EventId& other) const { return value == other.value; }
+    bool operator!=(const EventId& other) const { return value != other.value; }
+};
+
+// 插件标识：插件名称在 EventManager 内解析为小整数，订阅记录只保存该整数
+struct PluginId {
+    static constexpr uint32_t kInvalid = UINT32_MAX;
+
+    uint32_t value = kInvalid;
+
+    bool valid() const { return value != kInvalid; }
+    bool operator==(const PluginId& other) const { return value == other.value; }
+    bool operator!=(const PluginId& other) const { return value != other.value; }
+};
 
-using EventCallback = std::function<void(const std::string&)>;
+// 订阅凭据：由注册返回，可用于 O(1) 定位并注销单个回调
+struct SubscriptionToken {
+    EventId eventId;
+    PluginId pluginId;
+    uint32_t subscriptionId = 0;
 
+    bool valid() const { return eventId.valid() && pluginId.valid(); }
+    explicit operator bool() const { return valid(); }
+};
+
+// 订阅的优先级类别：同一事件的订阅者按类别从高到低执行，同一类别内按注册顺序；
+// 异步分发时每个类别有独立的队列，分发线程总是先排空高优先级的队列
+enum class PriorityClass : uint8_t {
+    Critical,    // 风控检查等关键路径
+    High,
+    Normal,      // 默认
+    BestEffort   // 日志、监控等可以延后的消费者
+};
+
+constexpr size_t kPriorityClasses = 4;
+
+const char* priorityClassName(PriorityClass priority);
+
+// 订阅的调度属性
+struct SubscriptionQos {
+    PriorityClass priority = PriorityClass::Normal;
+    // 从发布到回调返回的时限，超过即计为一次错过；为 0 时不检查
+    std::chrono::microseconds deadline{ 0 };
+};
+
+// 单个插件带截止时间的回调的统计
+struct DeadlineStats {
+    uint64_t checked = 0;       // 执行次数
+    uint64_t missed = 0;        // 超过截止时间的次数
+    double worstOverrunUs = 0;  // 最大超出量
+};
+
+// 每个插件一份的截止时间计数，地址在 EventManager 生命周期内不变；
+// 分发线程、邮箱与反应器可并发记录
+struct DeadlineCounters {
+    std::atomic<uint64_t> checked{ 0 };
+    std::atomic<uint64_t> missed{ 0 };
+    std::atomic<int64_t> worstOverrunNs{ 0 };
+
+    // elapsedNs 为从发布（或入队）到回调返回的时间
+    void record(int64_t elapsedNs, int64_t deadlineNs) {
+        checked.fetch_add(1, std::memory_order_relaxed);
+        int64_t overrun = elapsedNs - deadlineNs;
+        if (overrun > 0) {
+            missed.fetch_add(1, std::memory_order_relaxed);
+            int64_t worst = worstOverrunNs.load(std::memory_order_relaxed);
+            while (overrun > worst &&
+                !worstOverrunNs.compare_exchange_weak(worst, overrun, std::memory_order_relaxed)) {
+            }
+        }
+    }
+
+    DeadlineStats snapshot() const {
+        DeadlineStats stats;
+        stats.checked = checked.load(std::memory_order_relaxed);
+        stats.missed = missed.load(std::memory_order_relaxed);
+        stats.worstOverrunUs = static_cast<double>(worstOverrunNs.load(std::memory_order_relaxed)) / 1000.0;
+        return stats;
+    }
+};
+
+// 订阅记录：插件标识、订阅编号加就地存储的回调，连续存放于订阅者快照中
 struct CallbackInfo {
-    std::string pluginName;
-    EventCallback callback;
+    PluginId pluginId;
+    uint32_t subscriptionId;
+    PayloadCallback callback;
+};
+
+static_assert(sizeof(CallbackInfo) <= 64, "CallbackInfo should fit in one cache line");
+
+// 批量发布中的一条事件
+struct BatchEvent {
+    EventId eventId;
+    EventPayload payload;
+};
+
+// 批量中连续属于同一事件的一段，按引用交给批量订阅者，仅在回调期间有效
+class EventBatchView {
+public:
+    EventBatchView(const BatchEvent* data, size_t size) : data_(data), size_(size) {}
+
+    EventId eventId() const { return data_[0].eventId; }
+    size_t size() const { return size_; }
+    const BatchEvent& operator[](size_t index) const { return data_[index]; }
+    const BatchEvent* begin() const { return data_; }
+    const BatchEvent* end() const { return data_ + size_; }
+
+private:
+    const BatchEvent* data_;
+    size_t size_;
 };
 
+// 批量回调：一次调用处理一段连续的同一事件
+using BatchCallback = InplaceFunction<void(const EventBatchView&), kCallbackCapacity>;
+
+struct BatchCallbackInfo {
+    PluginId pluginId;
+    uint32_t subscriptionId;
+    BatchCallback callback;
+};
+
+static_assert(sizeof(BatchCallbackInfo) <= 64, "BatchCallbackInfo should fit in one cache line");
+
+// 暂存的订阅，由 EventManager::replaceSubscriptions 登记：callback 与 batchCallback 恰好一个非空，
+// subscriptionId 为 reserveSubscription 预留的编号或先前注销的订阅的编号
+struct StagedSubscription {
+    EventId eventId;
+    PayloadCallback callback;
+    BatchCallback batchCallback;
+    SubscriptionQos qos;
+    uint32_t subscriptionId = 0;
+};
+
+// 事件管理器：读多写少。
+// 触发路径只读取不可变的订阅者快照，不加锁、不分配内存，回调在任何锁之外执行；
+// 注册/注销在 mutex_ 下复制并替换快照，旧快照经 EpochDomain 延迟回收。
+// 快照中的订阅者按优先级类别排列，分发时高优先级的回调先执行。
+// 事件名称即分层主题（见 TopicTrie.h）。订阅含 '*' / '#' 的模式时，订阅记录被复制进每个匹配的
+// 具体主题的快照，之后登记的主题在登记时经模式前缀树补齐；因此每个具体主题缓存了完整的订阅者集合，
+// 触发路径与精确匹配完全相同，开销与通配订阅的数量无关。
 class EventManager {
 public:
-    // 注册事件，并关联插件名称
-    void registerEvent(const std::string& pluginName, const std::string& eventName, EventCallback callback) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        callbacks_[eventName].emplace_back(CallbackInfo{ pluginName, callback });
+    // 回调异常与内部错误写入 logger：按插件名称各用一个日志通道
+    explicit EventManager(Logger& logger = Logger::global());
+    ~EventManager();
+    EventManager(const EventManager&) = delete;
+    EventManager& operator=(const EventManager&) = delete;
+
+    // 解析事件名称，首次出现时分配新的事件标识
+    EventId resolveEvent(const std::string& eventName);
+
+    // 仅查找已存在的事件标识，不存在时返回无效标识（无锁）
+    EventId findEvent(const std::string& eventName) const {
+        EpochDomain::ReadGuard guard;
+        return findEventUnguarded(eventName);
     }
 
-    // 注销与插件名称相关的所有事件回调
-    void unregisterPluginCallbacks(const std::string& pluginName) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        for (auto& [eventName, cbList] : callbacks_) {
-            cbList.erase(
-                std::remove_if(cbList.begin(), cbList.end(),
-                    [&](const CallbackInfo& info) {
-                        return info.pluginName == pluginName;
-                    }),
-                cbList.end()
-            );
+    // 发布方按名称查找：主题尚未登记但与某个通配订阅匹配时登记它（每个主题只登记一次），
+    // 使匹配的订阅者能收到首次发布的事件；不匹配任何通配订阅的主题不登记，避免事件表无限增长。
+    // 没有通配订阅时与 findEvent 相同
+    EventId findTopic(const std::string& topicName) {
+        EventId eventId = findEvent(topicName);
+        if (!eventId.valid() && patternSubscriptions_.load(std::memory_order_relaxed) != 0) {
+            eventId = internTopic(topicName);
         }
+        return eventId;
+    }
+
+    // 事件标识对应的名称，未知标识返回空串（加写者锁，不用于热路径）
+    std::string eventName(EventId eventId);
+
+    // 解析插件名称，首次出现时分配新的插件标识
+    PluginId resolvePlugin(const std::string& pluginName);
+
+    // 注册事件，并关联插件名称（字符串回调经适配器转为负载回调）
+    void registerEvent(const std::string& pluginName, const std::string& eventName, EventCallback callback) {
+        registerEvent(pluginName, eventName, adaptEventCallback(std::move(callback)));
+    }
+    void registerEvent(const std::string& pluginName, const std::string& eventName, PayloadCallback callback) {
+        registerEvent(resolvePlugin(pluginName), resolveEvent(eventName), std::move(callback));
+    }
+
+    // 按事件标识注册，返回 false 表示标识无效
+    bool registerEvent(const std::string& pluginName, EventId eventId, EventCallback callback) {
+        return registerEvent(pluginName, eventId, adaptEventCallback(std::move(callback)));
+    }
+    bool registerEvent(const std::string& pluginName, EventId eventId, PayloadCallback callback) {
+        return registerEvent(resolvePlugin(pluginName), eventId, std::move(callback)).valid();
     }
+    // 返回订阅凭据；事件或插件标识无效时返回无效凭据。
+    // eventId 为订阅模式（如 md.XNAS.*.quote）时订阅全部匹配的主题，含之后才出现的主题。
+    // qos 决定回调在同一事件的订阅者中的执行次序，以及是否按截止时间计数
+    SubscriptionToken registerEvent(PluginId pluginId, EventId eventId, PayloadCallback callback,
+        const SubscriptionQos& qos = {});
 
-    // 触发事件
+    // 注册批量回调：批量发布时每段连续的同一事件只调用一次；单条触发时收到长度为 1 的一段
+    SubscriptionToken registerBatchEvent(PluginId pluginId, EventId eventId, BatchCallback callback,
+        const SubscriptionQos& qos = {});
+
+    // 按凭据注销单个回调，只改写该事件的订阅者快照
+    bool unsubscribe(const SubscriptionToken& token);
+
+    // 预留订阅编号并返回凭据（订阅尚未生效），事件或插件标识无效时返回无效凭据
+    SubscriptionToken reserveSubscription(PluginId pluginId, EventId eventId);
+    // 注销 removed 并登记 added，每个受影响的事件只发布一次新快照：
+    // 同一次分发要么只看到注销前的订阅，要么只看到登记后的订阅（热重载据此切换实例）。
+    // 返回与 added 一一对应的凭据，登记失败的为无效凭据
+    std::vector<SubscriptionToken> replaceSubscriptions(PluginId pluginId, const std::vector<SubscriptionToken>& removed,
+        const std::vector<StagedSubscription>& added);
+
+    // 注销与插件相关的所有事件回调；借助每个插件的反向索引，只访问该插件订阅过的事件
+    void unregisterPluginCallbacks(const std::string& pluginName);
+    void unregisterPluginCallbacks(PluginId pluginId);
+
+    // 插件当前的订阅数量
+    size_t subscriptionCount(PluginId pluginId);
+
+    // 插件的截止时间计数，供在分发线程之外执行回调的邮箱与反应器记录；插件标识无效时返回 nullptr
+    DeadlineCounters* deadlineCounters(PluginId pluginId);
+    DeadlineStats deadlineStats(PluginId pluginId);
+
+    // 等待其他线程上正在执行的回调全部返回，卸载插件库之前必须调用
+    void synchronize();
+
+    // 统计快照：按事件、插件与订阅的次数与延迟（编译期关闭统计时返回 enabled=false 的空快照）
+    StatsSnapshot statsSnapshot();
+    // 运行期开关统计记录，默认开启
+    void setStatsEnabled(bool enabled);
+
+    Logger& logger() const { return logger_; }
+
+    // 事件当前是否有订阅者（一次原子读，供发布方跳过无人关心的事件）
+    bool hasSubscribers(EventId eventId) const {
+        const EventSlot* slot = findSlot(eventId);
+        return slot && slot->subscribers.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    // 事件订阅者中的最高优先级类别（一次原子读），异步总线据此选择队列；无订阅者时为 Normal
+    PriorityClass eventPriority(EventId eventId) const {
+        const EventSlot* slot = findSlot(eventId);
+        return slot ? slot->priority.load(std::memory_order_relaxed) : PriorityClass::Normal;
+    }
+
+    // 触发事件（字符串接口，仅做一次查找后转发到标识接口）
     void triggerEvent(const std::string& eventName, const std::string& eventData) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = callbacks_.find(eventName);
-        if (it != callbacks_.end()) {
-            // 复制回调列表以防止在回调中修改原列表
-            auto cbList = it->second;
-            for (auto& cbInfo : cbList) {
-                try {
-                    cbInfo.callback(eventData);
-                }
-                catch (const std::exception& e) {
-                    std::cerr << "Exception in event callback: " << e.what() << std::endl;
+        triggerEvent(eventName, EventPayload::fromString(eventData));
+    }
+    void triggerEvent(const std::string& eventName, const EventPayload& payload) {
+        {
+            EpochDomain::ReadGuard guard;
+            EventId eventId = findEventUnguarded(eventName);
+            if (eventId.valid()) {
+                dispatch(eventId, payload);
+                return;
+            }
+        }
+        // 首次出现的主题：与通配订阅匹配时登记后再分发
+        if (patternSubscriptions_.load(std::memory_order_relaxed) != 0) {
+            EventId eventId = internTopic(eventName);
+            if (eventId.valid()) {
+                triggerEvent(eventId, payload);
+            }
+        }
+    }
+
+    // 触发事件（按标识直接索引，无字符串哈希与比较）
+    void triggerEvent(EventId eventId, const std::string& eventData) {
+        triggerEvent(eventId, EventPayload::fromString(eventData));
+    }
+    void triggerEvent(EventId eventId, const EventPayload& payload) {
+        EpochDomain::ReadGuard guard;
+        dispatch(eventId, payload);
+    }
+
+    // 批量触发：整批只进入一次读临界区；连续的同一事件只查找一次订阅者快照，
+    // 批量订阅者每段只调用一次。普通订阅者仍按批内顺序逐条收到事件
+    void triggerEvents(const BatchEvent* events, size_t count) {
+        EpochDomain::ReadGuard guard;
+        for (size_t begin = 0; begin < count;) {
+            size_t end = begin + 1;
+            while (end < count && events[end].eventId == events[begin].eventId) {
+                ++end;
+            }
+            dispatchRun(events + begin, end - begin);
+            begin = end;
+        }
+    }
+    void triggerEvents(const std::vector<BatchEvent>& events) {
+        triggerEvents(events.data(), events.size());
+    }
+
+    // 由异步总线调用：截止时间从 publishedNs（statsNowNs 时钟的入队时刻）起算，而非分发时刻
+    void deliverEvent(EventId eventId, const EventPayload& payload, int64_t publishedNs) {
+        EpochDomain::ReadGuard guard;
+        dispatch(eventId, payload, publishedNs);
+    }
+
+private:
+    static constexpr uint32_t kSegmentBits = 8;
+    static constexpr uint32_t kSlotsPerSegment = 1u << kSegmentBits;
+    static constexpr uint32_t kMaxSegments = 4096;
+
+    // 不可变的订阅者快照。回调按优先级类别排列（同类别内按注册顺序）；
+    // 调度属性与回调按下标一一对应、分开存放，使订阅记录保持在一条缓存行内
+    struct SubscriberList {
+        std::vector<CallbackInfo> callbacks;
+        std::vector<BatchCallbackInfo> batchCallbacks;
+        std::vector<SubscriptionQos> qos;
+        std::vector<SubscriptionQos> batchQos;
+        bool deadlines = false;  // 存在带截止时间的订阅，分发时需要记录发布时刻
+
+        bool empty() const { return callbacks.empty() && batchCallbacks.empty(); }
+    };
+
+    struct EventSlot {
+        std::atomic<const SubscriberList*> subscribers{ nullptr };
+        std::atomic<PriorityClass> priority{ PriorityClass::Normal };
+    };
+
+    // 每个插件的日志通道与截止时间计数，创建后地址不变
+    struct PluginSlot {
+        LogChannel* log;
+        DeadlineCounters deadlines;
+    };
+
+    struct NameEntry {
+        std::string name;
+        size_t hash;
+        EventId id;
+        bool pattern;  // 含通配层级的订阅模式，不作为具体主题匹配
+    };
+
+    // 通配订阅的原始记录（恰好一条回调）；每个匹配的具体主题的快照中各有一份副本
+    struct PatternSubscription {
+        EventId pattern;
+        SubscriberList entry;
+    };
+
+    // 开放寻址的名称表，读者无锁探测；扩容时整体替换
+    struct NameTable {
+        size_t mask;
+        std::unique_ptr<std::atomic<const NameEntry*>[]> buckets;
+
+        explicit NameTable(size_t capacity)
+            : mask(capacity - 1), buckets(new std::atomic<const NameEntry*>[capacity]) {
+            for (size_t i = 0; i < capacity; ++i) {
+                buckets[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // 分段存储事件槽，扩容时已发布的槽位地址不变
+    std::array<std::atomic<EventSlot*>, kMaxSegments> segments_;
+    std::atomic<uint32_t> eventCount_{ 0 };
+    std::atomic<const NameTable*> names_{ nullptr };
+    std::vector<std::unique_ptr<NameEntry>> nameEntries_;
+    std::unordered_map<std::string, PluginId> pluginIds_;
+    std::vector<std::unique_ptr<PluginSlot>> pluginSlots_;
+    // 反向索引：插件标识 -> (订阅编号 -> 事件标识)
+    std::vector<std::unordered_map<uint32_t, EventId>> pluginSubscriptions_;
+    uint32_t nextSubscriptionId_ = 1;
+    // 订阅编号 -> 通配订阅；模式前缀树（值为订阅编号）与具体主题前缀树（值为事件标识）
+    std::unordered_map<uint32_t, PatternSubscription> patterns_;
+    TopicTrie<uint32_t> patternTrie_;
+    TopicTrie<uint32_t> topicTrie_;
+    bool topicsIndexed_ = false;  // topicTrie_ 在首个通配订阅时建立
+    // 当前通配订阅数量，发布方据此判断未登记的主题是否需要登记
+    std::atomic<size_t> patternSubscriptions_{ 0 };
+    // 通配订阅集合的代数，每新增一个通配订阅更新一次（全局唯一），使未匹配主题的缓存失效
+    std::atomic<uint64_t> patternGeneration_;
+    std::mutex mutex_;  // 仅写者使用
+    // replaceSubscriptions 期间暂不发布的快照（为空表示无订阅者），结束时每个槽位发布一次
+    std::unordered_map<EventSlot*, std::unique_ptr<SubscriberList>> staged_;
+    bool staging_ = false;
+    Logger& logger_;
+    LogChannel& log_;
+    // 插件标识 -> 插件槽位，不可变快照，供分发路径在读临界区内无锁查找
+    std::atomic<const std::vector<PluginSlot*>*> pluginIndex_{ nullptr };
+#if MOTS_ENABLE_STATS
+    mutable StatsRecorder stats_;
+#endif
+
+    EventId findEventUnguarded(const std::string& eventName) const {
+        const NameTable* table = names_.load(std::memory_order_acquire);
+        size_t hash = std::hash<std::string>{}(eventName);
+        for (size_t i = hash & table->mask;; i = (i + 1) & table->mask) {
+            const NameEntry* entry = table->buckets[i].load(std::memory_order_acquire);
+            if (!entry) {
+                return EventId{};
+            }
+            if (entry->hash == hash && entry->name == eventName) {
+                return entry->id;
+            }
+        }
+    }
+
+    const EventSlot* findSlot(EventId eventId) const {
+        if (eventId.value >= eventCount_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        const EventSlot* segment = segments_[eventId.value >> kSegmentBits].load(std::memory_order_acquire);
+        return &segment[eventId.value & (kSlotsPerSegment - 1)];
+    }
+
+    // 分发期间的统计上下文；每个回调只多一次时钟读取（上一个回调的结束即下一个的开始）。
+    // 编译期关闭统计时全部为空操作
+    struct DispatchStats {
+#if MOTS_ENABLE_STATS
+        StatsRecorder::Shard* shard;
+        int64_t start = 0;
+        int64_t clock = 0;
+
+        explicit DispatchStats(StatsRecorder& recorder)
+            : shard(recorder.enabled() ? &recorder.local() : nullptr) {
+            start = clock = shard ? statsNowNs() : 0;
+        }
+        void callback(uint32_t subscriptionId, PluginId pluginId, EventId eventId, bool threw) {
+            if (shard) {
+                int64_t now = statsNowNs();
+                shard->recordCallback(subscriptionId, pluginId.value, eventId.value, now - clock, threw);
+                clock = now;
+            }
+        }
+        void event(EventId eventId, uint64_t triggers) {
+            if (shard) {
+                shard->recordEvent(eventId.value, triggers, clock - start);
+                start = clock;
+            }
+        }
+#else
+        explicit DispatchStats(int) {}
+        void callback(uint32_t, PluginId, EventId, bool) {}
+        void event(EventId, uint64_t) {}
+#endif
+    };
+
+    DispatchStats dispatchStats() const {
+#if MOTS_ENABLE_STATS
+        return DispatchStats(stats_);
+#else
+        return DispatchStats(0);
+#endif
+    }
+
+    // 回调所属插件的槽位（调用方处于读临界区内）
+    PluginSlot* pluginSlot(PluginId pluginId) const {
+        const std::vector<PluginSlot*>* index = pluginIndex_.load(std::memory_order_acquire);
+        return index && pluginId.value < index->size() ? (*index)[pluginId.value] : nullptr;
+    }
+
+    ILogger& pluginLog(PluginId pluginId) const {
+        PluginSlot* slot = pluginSlot(pluginId);
+        return slot ? static_cast<ILogger&>(*slot->log) : log_;
+    }
+
+    // origin 为发布时刻；快照中没有带截止时间的订阅时为 0，不读时钟
+    void checkDeadline(PluginId pluginId, const SubscriptionQos& qos, int64_t origin) const {
+        if (origin != 0 && qos.deadline.count() > 0) {
+            if (PluginSlot* slot = pluginSlot(pluginId)) {
+                slot->deadlines.record(statsNowNs() - origin, qos.deadline.count() * 1000);
+            }
+        }
+    }
+
+    static int64_t deadlineOrigin(const SubscriberList& list, int64_t publishedNs) {
+        return list.deadlines ? (publishedNs != 0 ? publishedNs : statsNowNs()) : 0;
+    }
+
+    // 调用回调并捕获异常，返回是否抛出；异常经插件的日志通道异步输出并受其速率限制
+    template <typename Callback, typename Arg>
+    bool invoke(PluginId pluginId, const Callback& callback, const Arg& arg) const {
+        try {
+            callback(arg);
+            return false;
+        }
+        catch (const std::exception& e) {
+            pluginLog(pluginId).logf(LogLevel::Error, "Exception in event callback: %s", e.what());
+        }
+        catch (...) {
+            pluginLog(pluginId).logf(LogLevel::Error, "Unknown exception in event callback.");
+        }
+        return true;
+    }
+
+    // 按优先级类别从高到低分段执行；每个类别内先逐条调用普通订阅者，再整段调用批量订阅者
+    void deliverRun(const SubscriberList& list, const BatchEvent* events, size_t count, int64_t origin,
+        DispatchStats& stats) const {
+        EventId eventId = events[0].eventId;
+        const size_t singles = list.callbacks.size();
+        const size_t batches = list.batchCallbacks.size();
+        size_t single = 0;
+        size_t batch = 0;
+        while (single < singles || batch < batches) {
+            PriorityClass level = single < singles ? list.qos[single].priority : PriorityClass::BestEffort;
+            if (batch < batches && list.batchQos[batch].priority < level) {
+                level = list.batchQos[batch].priority;
+            }
+            size_t singleEnd = single;
+            while (singleEnd < singles && list.qos[singleEnd].priority == level) {
+                ++singleEnd;
+            }
+            for (size_t e = 0; e < count; ++e) {
+                for (size_t i = single; i < singleEnd; ++i) {
+                    const CallbackInfo& info = list.callbacks[i];
+                    stats.callback(info.subscriptionId, info.pluginId, eventId, invoke(info.pluginId, info.callback, events[e].payload));
+                    checkDeadline(info.pluginId, list.qos[i], origin);
                 }
-                catch (...) {
-                    std::cerr << "Unknown exception in event callback." << std::endl;
+            }
+            single = singleEnd;
+            for (; batch < batches && list.batchQos[batch].priority == level; ++batch) {
+                const BatchCallbackInfo& info = list.batchCallbacks[batch];
+                stats.callback(info.subscriptionId, info.pluginId, eventId, invoke(info.pluginId, info.callback, EventBatchView(events, count)));
+                checkDeadline(info.pluginId, list.batchQos[batch], origin);
+            }
+        }
+    }
+
+    // publishedNs 为 0 时截止时间从本次调用起算
+    void dispatch(EventId eventId, const EventPayload& payload, int64_t publishedNs = 0) const {
+        const EventSlot* slot = findSlot(eventId);
+        if (!slot) {
+            return;
+        }
+        const SubscriberList* list = slot->subscribers.load(std::memory_order_acquire);
+        DispatchStats stats = dispatchStats();
+        if (list) {
+            int64_t origin = deadlineOrigin(*list, publishedNs);
+            if (list->batchCallbacks.empty()) {
+                for (size_t i = 0; i < list->callbacks.size(); ++i) {
+                    const CallbackInfo& info = list->callbacks[i];
+                    stats.callback(info.subscriptionId, info.pluginId, eventId, invoke(info.pluginId, info.callback, payload));
+                    checkDeadline(info.pluginId, list->qos[i], origin);
                 }
             }
+            else {
+                BatchEvent single{ eventId, payload };
+                deliverRun(*list, &single, 1, origin, stats);
+            }
         }
+        stats.event(eventId, 1);
     }
-    
-private:
-    std::unordered_map<std::string, std::vector<CallbackInfo>> callbacks_;
-    std::mutex mutex_;
+
+    // 分发一段连续的同一事件
+    void dispatchRun(const BatchEvent* events, size_t count) const {
+        EventId eventId = events[0].eventId;
+        const EventSlot* slot = findSlot(eventId);
+        if (!slot) {
+            return;
+        }
+        const SubscriberList* list = slot->subscribers.load(std::memory_order_acquire);
+        DispatchStats stats = dispatchStats();
+        if (list) {
+            deliverRun(*list, events, count, deadlineOrigin(*list, 0), stats);
+        }
+        stats.event(eventId, count);
+    }
+
+    // 获取写者锁，并记录等待时间
+    std::unique_lock<std::mutex> lockWriters();
+    EventId internLocked(const std::string& eventName);
+    // 仅当具体主题与某个通配订阅匹配时登记，否则返回无效标识。
+    // 未匹配的主题记入线程局部的有界缓存，此后没有新增通配订阅时再次发布不加写者锁、不查前缀树
+    EventId internTopic(const std::string& topicName);
+    EventSlot& slotLocked(EventId eventId);
+    void appendLocked(EventSlot& slot, CallbackInfo info, const SubscriptionQos& qos);
+    void appendLocked(EventSlot& slot, BatchCallbackInfo info, const SubscriptionQos& qos);
+    void appendLocked(EventSlot& slot, const SubscriberList& entries);
+    template <typename Info>
+    void subscribePatternLocked(EventId pattern, Info info, const SubscriptionQos& qos);
+    // 移除通配订阅及其在各主题中的副本；topics 非空时改为收集匹配的主题，由调用方统一移除
+    void removePatternLocked(uint32_t subscriptionId, PluginId pluginId, std::vector<uint32_t>* topics);
+    // subscriptionId 为 0 时分配新编号
+    template <typename Info, typename Callback>
+    SubscriptionToken subscribeLocked(PluginId pluginId, EventId eventId, Callback callback, const SubscriptionQos& qos,
+        uint32_t subscriptionId = 0);
+    bool unsubscribeLocked(const SubscriptionToken& token);
+    void removeLocked(EventSlot& slot, PluginId pluginId, uint32_t subscriptionId);
+    // 槽位当前的快照，含 replaceSubscriptions 期间尚未发布的
+    const SubscriberList* currentLocked(EventSlot& slot) const;
+    // 发布新快照（为空表示无订阅者），同时更新事件的最高优先级类别
+    void publishLocked(EventSlot& slot, std::unique_ptr<SubscriberList> next);
+    void insertNameLocked(const NameEntry* entry);
 };
 
-#endif // EVENT_H
\ No newline at end of file
+#endif // EVENT_H
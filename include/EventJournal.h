@@ -0,0 +1,261 @@
+// include/EventJournal.h
+#ifndef EVENTJOURNAL_H
+#define EVENTJOURNAL_H
+
+#include "Event.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+// 事件日志文件格式（本机字节序）：
+//   文件头 JournalFileHeader（64 字节），之后为按 16 字节对齐的记录。
+//   每条记录以 JournalRecordHeader 开头，随后是负载字节；length 最后写入，为 0 表示未提交（文件结束）。
+//   事件名称与负载类型名称各以一条定义记录写入一次，事件记录只引用日志内的编号。
+struct JournalFileHeader {
+    char magic[8];          // "MOTSJNL"
+    uint32_t version;
+    uint32_t headerSize;
+    int64_t steadyBaseNs;   // 打开日志时的 steady_clock，与记录时间戳同一时钟
+    int64_t wallBaseNs;     // 同一时刻的 system_clock，用于换算为墙上时间
+    uint64_t reserved[4];
+};
+
+static_assert(sizeof(JournalFileHeader) == 64, "JournalFileHeader layout is part of the file format");
+
+enum class JournalRecordKind : uint8_t {
+    Event = 1,
+    DefineEvent = 2,   // 负载为事件名称
+    DefineType = 3,    // 负载为类型名称（std::type_info::name()）
+};
+
+enum class JournalPayloadKind : uint8_t {
+    Empty = 0,
+    String = 1,        // 字符串负载的内容
+    Bytes = 2,         // EventPayload::fromBytes 的原始字节
+    Typed = 3,         // 平凡可复制对象的对象表示，typeId 指向类型定义
+    Opaque = 4,        // 不可按字节复制的对象，只记录类型
+};
+
+struct JournalRecordHeader {
+    uint32_t length;       // 整条记录字节数（含头与对齐填充）
+    uint32_t payloadSize;
+    uint64_t sequence;
+    int64_t timestampNs;
+    uint32_t eventIndex;   // 记录时的 EventId，由定义记录映射到名称
+    uint16_t typeId;
+    JournalRecordKind kind;
+    JournalPayloadKind payloadKind;
+};
+
+static_assert(sizeof(JournalRecordHeader) == 32, "JournalRecordHeader layout is part of the file format");
+
+constexpr uint32_t kJournalVersion = 1;
+constexpr size_t kJournalAlignment = 16;
+
+struct JournalStats {
+    uint64_t records = 0;    // 已写入的事件记录
+    uint64_t dropped = 0;    // 容量耗尽而未写入的事件
+    size_t bytes = 0;        // 已使用的字节数（含文件头）
+    size_t capacity = 0;
+};
+
+// 只追加的内存映射事件日志。创建时按容量预留并映射整个文件，追加路径只有两次原子加法与内存复制，
+// 不做系统调用也不加锁（仅每个事件、每种负载类型首次出现时写定义记录需加锁）。
+// 多个线程可并发追加；各线程内的记录有序，跨线程的文件顺序与序号可能略有交错。
+// 容量耗尽后的事件计入 dropped 而不阻塞发布方；close() 把文件截断到实际长度
+class JournalWriter {
+public:
+    static constexpr size_t kDefaultCapacity = size_t(256) << 20;
+
+    // 事件名称经 eventManager 查询，错误写入其日志的 "EventJournal" 通道
+    explicit JournalWriter(EventManager& eventManager);
+    ~JournalWriter();
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+
+    // 创建（覆盖）日志文件；prefault 时预先建立全部页映射，避免追加路径上的缺页
+    bool open(const std::string& path, size_t capacityBytes = kDefaultCapacity, bool prefault = true);
+    // 不得与 append 并发调用
+    void close();
+    bool isOpen() const { return base_ != nullptr; }
+
+    // 追加一条事件记录，容量耗尽时返回 false
+    bool append(EventId eventId, const EventPayload& payload);
+
+    JournalStats stats() const;
+
+private:
+    static constexpr uint32_t kSegmentBits = 8;
+    static constexpr uint32_t kSlotsPerSegment = 1u << kSegmentBits;
+    static constexpr uint32_t kMaxSegments = 4096;
+
+    struct TypeEntry {
+        const std::type_info* type;
+        uint16_t id;
+    };
+
+    // 每个事件的定义状态与最近一次负载类型，分段分配，地址不变
+    struct EventState {
+        std::atomic<bool> defined{ false };
+        std::atomic<const TypeEntry*> lastType{ nullptr };
+    };
+
+    EventManager& eventManager_;
+    LogChannel& log_;
+    char* base_ = nullptr;
+    size_t capacity_ = 0;
+    std::string path_;
+#if defined(_WIN32)
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+    std::atomic<size_t> writeOffset_{ 0 };
+    std::atomic<uint64_t> sequence_{ 0 };
+    std::atomic<uint64_t> records_{ 0 };
+    std::atomic<uint64_t> dropped_{ 0 };
+
+    std::array<std::atomic<EventState*>, kMaxSegments> segments_{};
+    std::mutex defineMutex_;  // 定义记录与类型表
+    std::unordered_map<std::type_index, std::unique_ptr<TypeEntry>> types_;
+
+    EventState* stateOf(EventId eventId);
+    bool defineEvent(EventId eventId, EventState& state);
+    const TypeEntry* defineType(const std::type_info& type, EventState& state);
+    bool write(JournalRecordKind kind, JournalPayloadKind payloadKind, uint32_t eventIndex, uint16_t typeId,
+        const void* payload, size_t payloadSize);
+};
+
+// 日志中的一条事件，字节直接指向映射区，仅在回调期间有效
+struct JournalEntry {
+    uint64_t sequence;
+    int64_t timestampNs;
+    std::string_view eventName;
+    JournalPayloadKind payloadKind;
+    std::string_view typeName;   // Typed / Opaque 负载的类型名称
+    std::string_view bytes;
+};
+
+enum class ReplayPace {
+    AsFastAsPossible,
+    Recorded,          // 按记录的时间间隔（除以 speed）重放
+};
+
+struct ReplayOptions {
+    ReplayPace pace = ReplayPace::AsFastAsPossible;
+    double speed = 1.0;
+};
+
+struct ReplayStats {
+    uint64_t events = 0;
+    uint64_t skipped = 0;    // 无法重建负载的事件（Opaque）按空负载送出并计数
+    std::chrono::nanoseconds elapsed{ 0 };
+
+    double eventsPerSecond() const {
+        return elapsed.count() > 0 ? static_cast<double>(events) * 1e9 / static_cast<double>(elapsed.count()) : 0.0;
+    }
+};
+
+// 只读映射日志文件并按记录顺序读取，不复制负载字节。
+// 重放时：已 bindType 的类型化负载以原类型的视图送出（直接指向映射区），
+// 未绑定的类型化负载与原始字节以 EventPayload::fromBytes 送出；
+// 字符串负载复制到一个复用的缓冲区，以保持 string() 接口（不分配内存）
+class JournalReader {
+public:
+    explicit JournalReader(Logger& logger = Logger::global());
+    ~JournalReader();
+    JournalReader(const JournalReader&) = delete;
+    JournalReader& operator=(const JournalReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return base_ != nullptr; }
+    const JournalFileHeader* header() const { return reinterpret_cast<const JournalFileHeader*>(base_); }
+
+    // 让该类型的记录以类型化视图重放（按 type_info::name() 匹配，须与记录方使用同一编译器）
+    template <typename T>
+    void bindType() {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be replayed as views");
+        static_assert(alignof(T) <= kJournalAlignment, "Journal payloads are aligned to kJournalAlignment");
+        boundTypes_[typeid(T).name()] = BoundType{ &typeid(T), sizeof(T) };
+    }
+
+    // 按文件顺序访问每条事件记录，返回事件数量
+    template <typename Visitor>
+    uint64_t forEach(Visitor&& visit) const {
+        std::vector<std::string_view> events;
+        std::vector<std::string_view> types;
+        uint64_t count = 0;
+        for (size_t offset = sizeof(JournalFileHeader); const JournalRecordHeader* record = recordAt(offset);
+            offset += record->length) {
+            std::string_view bytes(reinterpret_cast<const char*>(record + 1), record->payloadSize);
+            if (record->kind == JournalRecordKind::DefineEvent) {
+                define(events, record->eventIndex, bytes);
+            }
+            else if (record->kind == JournalRecordKind::DefineType) {
+                define(types, record->typeId, bytes);
+            }
+            else if (record->kind == JournalRecordKind::Event) {
+                JournalEntry entry{ record->sequence, record->timestampNs, nameAt(events, record->eventIndex),
+                    record->payloadKind, {}, bytes };
+                if (record->payloadKind == JournalPayloadKind::Typed || record->payloadKind == JournalPayloadKind::Opaque) {
+                    entry.typeName = nameAt(types, record->typeId);
+                }
+                visit(entry);
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    // 把全部事件按记录顺序触发到 target（事件名称在 target 中各解析一次）
+    ReplayStats replay(EventManager& target, const ReplayOptions& options = {});
+
+private:
+    LogChannel& log_;
+    const char* base_ = nullptr;
+    size_t size_ = 0;
+#if defined(_WIN32)
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+    struct BoundType {
+        const std::type_info* type;
+        size_t size;
+    };
+    std::unordered_map<std::string, BoundType> boundTypes_;
+
+    // 已提交且完整的记录，越界或未提交时返回 nullptr
+    const JournalRecordHeader* recordAt(size_t offset) const {
+        if (offset + sizeof(JournalRecordHeader) > size_) {
+            return nullptr;
+        }
+        const auto* record = reinterpret_cast<const JournalRecordHeader*>(base_ + offset);
+        if (record->length < sizeof(JournalRecordHeader) || record->length > size_ - offset ||
+            record->payloadSize > record->length - sizeof(JournalRecordHeader)) {
+            return nullptr;
+        }
+        return record;
+    }
+
+    static void define(std::vector<std::string_view>& table, size_t index, std::string_view name) {
+        if (table.size() <= index) {
+            table.resize(index + 1);
+        }
+        table[index] = name;
+    }
+
+    static std::string_view nameAt(const std::vector<std::string_view>& table, size_t index) {
+        return index < table.size() ? table[index] : std::string_view();
+    }
+};
+
+#endif // EVENTJOURNAL_H
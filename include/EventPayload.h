@@ -0,0 +1,211 @@
+// include/EventPayload.h
+#ifndef EVENTPAYLOAD_H
+#define EVENTPAYLOAD_H
+
+#include "InplaceFunction.h"
+#include "PayloadPool.h"
+#include <string>
+#include <string_view>
+#include <memory>
+#include <functional>
+#include <typeinfo>
+#include <type_traits>
+#include <cstring>
+#include <cstddef>
+
+// 事件负载：以指针携带数据，同一个负载对象按引用传给所有订阅者，不复制也不重新解析。
+// 可以是：
+//   - 对调用方对象的非拥有视图（字符串或平凡可复制的结构体），仅在触发调用期间有效；
+//   - 引用计数的不可变对象（make/share），可跨线程保留；
+//   - 负载池中的引用计数块（copyOf/retain），稳态下不调用 malloc。
+class EventPayload {
+public:
+    EventPayload() = default;
+
+    EventPayload(const EventPayload& other)
+        : data_(other.data_), type_(other.type_), size_(other.size_), owner_(other.owner_), block_(other.block_) {
+        if (block_) {
+            block_->retain();
+        }
+    }
+
+    EventPayload(EventPayload&& other) noexcept
+        : data_(other.data_), type_(other.type_), size_(other.size_), owner_(std::move(other.owner_)), block_(other.block_) {
+        other.data_ = nullptr;
+        other.type_ = nullptr;
+        other.size_ = 0;
+        other.block_ = nullptr;
+    }
+
+    EventPayload& operator=(const EventPayload& other) {
+        if (this != &other) {
+            EventPayload copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    EventPayload& operator=(EventPayload&& other) noexcept {
+        if (this != &other) {
+            EventPayload moved(std::move(other));
+            swap(moved);
+        }
+        return *this;
+    }
+
+    ~EventPayload() {
+        if (block_) {
+            block_->release();
+        }
+    }
+
+    void swap(EventPayload& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(type_, other.type_);
+        std::swap(size_, other.size_);
+        owner_.swap(other.owner_);
+        std::swap(block_, other.block_);
+    }
+
+    // 非拥有的字符串视图，兼容旧的 const std::string& 接口
+    static EventPayload fromString(const std::string& data) {
+        EventPayload payload;
+        payload.data_ = &data;
+        payload.type_ = &typeid(std::string);
+        return payload;
+    }
+
+    // 非拥有的类型化视图；要求平凡可复制，以便 retain() 时按字节复制
+    template <typename T>
+    static EventPayload view(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "EventPayload::view requires a trivially copyable type");
+        EventPayload payload;
+        payload.data_ = &value;
+        payload.type_ = &typeid(T);
+        payload.size_ = sizeof(T);
+        return payload;
+    }
+
+    // 按运行期类型构造的非拥有视图（如从事件日志的映射区重建负载）；
+    // 调用方保证 data 处确为 type 类型、大小为 size 的平凡可复制对象
+    static EventPayload view(const void* data, const std::type_info& type, size_t size) {
+        EventPayload payload;
+        payload.data_ = data;
+        payload.type_ = &type;
+        payload.size_ = size;
+        return payload;
+    }
+
+    // 非拥有的原始字节视图，类型为 EventPayload::Bytes，内容经 bytes() 读取
+    struct Bytes {};
+    static EventPayload fromBytes(std::string_view data) {
+        return view(data.data(), typeid(Bytes), data.size());
+    }
+
+    // 引用计数的不可变对象
+    template <typename T, typename... Args>
+    static EventPayload make(Args&&... args) {
+        return share(std::make_shared<const T>(std::forward<Args>(args)...));
+    }
+
+    template <typename T>
+    static EventPayload share(std::shared_ptr<const T> object) {
+        EventPayload payload;
+        payload.data_ = object.get();
+        payload.type_ = &typeid(T);
+        payload.size_ = std::is_trivially_copyable_v<T> ? sizeof(T) : 0;
+        payload.owner_ = std::move(object);
+        return payload;
+    }
+
+    // 复制一份字符串到负载池的引用计数块，以 std::string 负载交给订阅者
+    static EventPayload copyOf(std::string_view data) {
+        EventPayload payload;
+        payload.block_ = PayloadPool::allocateString(data);
+        payload.data_ = PayloadPool::string(payload.block_);
+        payload.type_ = &typeid(std::string);
+        return payload;
+    }
+
+    bool empty() const { return data_ == nullptr; }
+    bool owning() const { return owner_ != nullptr || block_ != nullptr; }
+    const std::type_info* type() const { return type_; }
+
+    template <typename T>
+    bool is() const {
+        return type_ && *type_ == typeid(T);
+    }
+
+    // 类型不匹配时返回 nullptr
+    template <typename T>
+    const T* as() const {
+        return is<T>() ? static_cast<const T*>(data_) : nullptr;
+    }
+
+    const std::string* string() const {
+        return as<std::string>();
+    }
+
+    // 负载的原始字节（字符串为其内容，结构体为其对象表示）
+    std::string_view bytes() const {
+        if (const std::string* text = string()) {
+            return *text;
+        }
+        return std::string_view(static_cast<const char*>(data_), size_);
+    }
+
+    // 供旧接口适配使用：字符串负载应直接取 string()，避免复制
+    std::string toString() const {
+        return std::string(bytes());
+    }
+
+    // 返回可跨越当前触发调用保留的负载；已拥有的负载仅增加引用计数
+    EventPayload retain() const {
+        if (owning() || !data_) {
+            return *this;
+        }
+        if (const std::string* text = string()) {
+            return copyOf(*text);
+        }
+        // 按字节复制平凡可复制的对象，保持类型信息
+        EventPayload payload;
+        payload.block_ = PayloadPool::allocate(size_);
+        void* storage = PayloadPool::data(payload.block_);
+        std::memcpy(storage, data_, size_);
+        payload.data_ = storage;
+        payload.type_ = type_;
+        payload.size_ = size_;
+        return payload;
+    }
+
+private:
+    const void* data_ = nullptr;
+    const std::type_info* type_ = nullptr;
+    size_t size_ = 0;
+    std::shared_ptr<const void> owner_;
+    PayloadBlock* block_ = nullptr;  // 负载池中的块，与 owner_ 至多一个非空
+};
+
+// 旧的字符串回调签名，经适配器继续可用
+using EventCallback = std::function<void(const std::string&)>;
+
+// 回调就地存储的容量：足以容纳一个 std::function 或若干引用捕获，
+// 使每条订阅记录（含插件标识）恰好占用一个 64 字节缓存行
+constexpr size_t kCallbackCapacity = 40;
+
+// 负载回调：直接接收共享的负载对象；捕获超出容量时编译失败
+using PayloadCallback = InplaceFunction<void(const EventPayload&), kCallbackCapacity>;
+
+// 把字符串回调适配为负载回调；字符串负载零复制，其他负载按字节转换
+inline PayloadCallback adaptEventCallback(EventCallback callback) {
+    return [callback = std::move(callback)](const EventPayload& payload) {
+        if (const std::string* text = payload.string()) {
+            callback(*text);
+        }
+        else {
+            callback(payload.toString());
+        }
+    };
+}
+
+#endif // EVENTPAYLOAD_H
@@ -2,12 +2,15 @@
 #ifndef IPLUGIN_H
 #define IPLUGIN_H
 
+#include "EventPayload.h"
 #include <string>
 #include <vector>
 #include <functional>
 
-// 定义事件类型
-using EventCallback = std::function<void(const std::string&)>;
+class ILogger;
+class IPluginHost;
+
+// 事件回调类型（EventCallback / PayloadCallback）定义在 EventPayload.h 中
 
 // 导出宏定义
 #if defined(_WIN32) || defined(_WIN64)
@@ -16,12 +19,19 @@ using EventCallback = std::function<void(const std::string&)>;
     #define PLUGIN_API
 #endif
 
+// 插件接口与早期版本二进制不兼容：新增了 initialize(IPluginHost&)、getDependencies 等虚函数，
+// 并移除了插件私有的 registerEvent / triggerEvent（改经 IPluginHost 订阅与发布）。
+// 按旧头文件编译的插件须按本头文件重新编译
 class IPlugin {
 public:
     virtual ~IPlugin() = default;
 
-    // 插件初始化
-    virtual bool initialize() = 0;
+    // 插件初始化（旧接口）：未覆盖 initialize(IPluginHost&) 的插件由默认实现转到这里
+    virtual bool initialize() { return true; }
+
+    // 在 setLogger 之后由 PluginManager 调用，传入本插件的宿主服务（见 IPluginHost.h）；
+    // host 在 shutdown() 返回前一直有效。默认转到无参的 initialize()，已有插件无需修改
+    virtual bool initialize(IPluginHost& /*host*/) { return initialize(); }
 
     // 插件卸载
     virtual void shutdown() = 0;
@@ -29,11 +39,17 @@ public:
     // 获取插件名称
     virtual std::string getName() const = 0;
 
-    // 注册事件回调
-    virtual void registerEvent(const std::string& eventName, EventCallback callback) = 0;
+    // 声明依赖的插件名称；依赖插件初始化成功后才会初始化本插件
+    virtual std::vector<std::string> getDependencies() const { return {}; }
+
+    // 热重载时导出状态，交给新版本实例的 importState；默认无状态
+    virtual std::string exportState() const { return {}; }
+    // 新版本实例在 initialize() 之后导入旧实例的状态，返回 false 时放弃重载
+    virtual bool importState(const std::string& /*state*/) { return true; }
 
-    // 触发事件
-    virtual void triggerEvent(const std::string& eventName, const std::string& eventData) = 0;
+    // 在 initialize() 之前由 PluginManager 传入本插件的日志通道（见 Logger.h），
+    // 生命周期长于插件实例；写日志不阻塞，级别与速率限制由宿主按插件配置
+    virtual void setLogger(ILogger* /*logger*/) {}
 };
 
 typedef IPlugin* (*CreatePluginFunc)();
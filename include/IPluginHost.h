@@ -0,0 +1,60 @@
+// include/IPluginHost.h
+#ifndef IPLUGINHOST_H
+#define IPLUGINHOST_H
+
+#include "Event.h"
+#include "SubscriberMailbox.h"
+#include "TimerWheel.h"
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+
+// 宿主服务：PluginManager 为每个插件实例创建一个，经 IPlugin::initialize(IPluginHost&) 传入，
+// 生命周期覆盖该实例的 initialize() 到 shutdown()。
+// 插件经它直接在共享的事件总线上解析事件、订阅与发布（与宿主相同的快速路径），不再自建事件表。
+// 经宿主建立的订阅与定时器记在该实例名下：卸载、热重载替换或初始化失败时由宿主统一撤销
+class IPluginHost {
+public:
+    virtual ~IPluginHost() = default;
+
+    virtual const std::string& pluginName() const = 0;
+    virtual PluginId pluginId() const = 0;
+
+    // 解析事件名称为标识；热路径上应缓存标识
+    virtual EventId resolveEvent(const std::string& eventName) = 0;
+
+    // 订阅与注销；实例已被撤销后订阅返回无效凭据
+    virtual SubscriptionToken subscribe(EventId eventId, PayloadCallback callback,
+        const SubscriptionOptions& options = {}) = 0;
+    virtual SubscriptionToken subscribeBatch(EventId eventId, BatchCallback callback) = 0;
+    virtual bool unsubscribe(const SubscriptionToken& token) = 0;
+
+    // 同步发布（与 PluginManager::triggerPluginEvent 相同，日志开启时同样记录）
+    virtual void publish(EventId eventId, const EventPayload& payload) = 0;
+    virtual void publish(const BatchEvent* events, size_t count) = 0;
+    // 异步发布，分发线程未启动时返回 false
+    virtual bool publishAsync(EventId eventId, const EventPayload& payload) = 0;
+    // 按分区键有序分发
+    virtual void publish(EventId eventId, const EventPayload& payload, std::string_view partitionKey) = 0;
+
+    // 本插件的日志通道（与 setLogger 传入的相同）
+    virtual ILogger& logger() = 0;
+
+    // 插件定时器：到期时发布 eventId（负载为 TimerEvent）
+    virtual TimerId scheduleTimer(EventId eventId, std::chrono::nanoseconds delay,
+        std::chrono::nanoseconds period = std::chrono::nanoseconds::zero()) = 0;
+    virtual bool cancelTimer(TimerId timer) = 0;
+
+    // 让该类型的负载在隔离插件的子进程中重建为类型化视图（按类型名称匹配）；
+    // 进程内插件直接共享负载对象，无需绑定
+    template <typename T>
+    void bindType() {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can cross the process boundary");
+        static_assert(alignof(T) <= 8, "Isolated payloads are aligned to 8 bytes");
+        bindType(typeid(T), sizeof(T));
+    }
+    virtual void bindType(const std::type_info& /*type*/, size_t /*size*/) {}
+};
+
+#endif // IPLUGINHOST_H
@@ -0,0 +1,139 @@
+// include/InplaceFunction.h
+#ifndef INPLACEFUNCTION_H
+#define INPLACEFUNCTION_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <functional>
+
+template <typename Signature, size_t Capacity>
+class InplaceFunction;
+
+// 固定容量、就地存储的可调用对象，不做堆分配。
+// 捕获的大小与对齐在编译期检查，超出容量时编译失败而不是退化为堆分配。
+template <typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> {
+public:
+    static constexpr size_t kCapacity = Capacity;
+    static constexpr size_t kAlignment = alignof(void*);
+
+    InplaceFunction() noexcept = default;
+    InplaceFunction(std::nullptr_t) noexcept {}
+
+    template <typename F,
+        typename Decayed = std::decay_t<F>,
+        typename = std::enable_if_t<!std::is_same_v<Decayed, InplaceFunction> &&
+            std::is_invocable_r_v<R, Decayed&, Args...>>>
+    InplaceFunction(F&& callable) {
+        static_assert(sizeof(Decayed) <= Capacity, "Callable capture is too large for InplaceFunction; capture less or by reference");
+        static_assert(alignof(Decayed) <= kAlignment, "Callable alignment is too strict for InplaceFunction");
+        static_assert(std::is_copy_constructible_v<Decayed>, "InplaceFunction requires a copyable callable");
+        if constexpr (std::is_pointer_v<Decayed> || std::is_member_pointer_v<Decayed> ||
+            std::is_same_v<Decayed, std::function<R(Args...)>>) {
+            if (!callable) {
+                return;
+            }
+        }
+        ::new (static_cast<void*>(storage_)) Decayed(std::forward<F>(callable));
+        invoke_ = &invokeImpl<Decayed>;
+        manage_ = &manageImpl<Decayed>;
+    }
+
+    InplaceFunction(const InplaceFunction& other) {
+        copyFrom(other);
+    }
+
+    InplaceFunction(InplaceFunction&& other) noexcept {
+        moveFrom(other);
+    }
+
+    InplaceFunction& operator=(const InplaceFunction& other) {
+        if (this != &other) {
+            reset();
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    InplaceFunction& operator=(InplaceFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    ~InplaceFunction() {
+        reset();
+    }
+
+    explicit operator bool() const noexcept { return invoke_ != nullptr; }
+
+    R operator()(Args... args) const {
+        if (!invoke_) {
+            throw std::bad_function_call();
+        }
+        return invoke_(storage_, std::forward<Args>(args)...);
+    }
+
+private:
+    enum class Operation { Copy, Move, Destroy };
+
+    using Invoker = R (*)(void*, Args&&...);
+    using Manager = void (*)(Operation, void*, void*);
+
+    Invoker invoke_ = nullptr;
+    Manager manage_ = nullptr;
+    alignas(kAlignment) mutable unsigned char storage_[Capacity];
+
+    template <typename F>
+    static R invokeImpl(void* storage, Args&&... args) {
+        return (*static_cast<F*>(storage))(std::forward<Args>(args)...);
+    }
+
+    template <typename F>
+    static void manageImpl(Operation operation, void* destination, void* source) {
+        switch (operation) {
+        case Operation::Copy:
+            ::new (destination) F(*static_cast<const F*>(source));
+            break;
+        case Operation::Move:
+            ::new (destination) F(std::move(*static_cast<F*>(source)));
+            static_cast<F*>(source)->~F();
+            break;
+        case Operation::Destroy:
+            static_cast<F*>(destination)->~F();
+            break;
+        }
+    }
+
+    void copyFrom(const InplaceFunction& other) {
+        if (other.invoke_) {
+            other.manage_(Operation::Copy, storage_, other.storage_);
+            invoke_ = other.invoke_;
+            manage_ = other.manage_;
+        }
+    }
+
+    void moveFrom(InplaceFunction& other) noexcept {
+        if (other.invoke_) {
+            other.manage_(Operation::Move, storage_, other.storage_);
+            invoke_ = other.invoke_;
+            manage_ = other.manage_;
+            other.invoke_ = nullptr;
+            other.manage_ = nullptr;
+        }
+    }
+
+    void reset() noexcept {
+        if (invoke_) {
+            manage_(Operation::Destroy, storage_, nullptr);
+            invoke_ = nullptr;
+            manage_ = nullptr;
+        }
+    }
+};
+
+#endif // INPLACEFUNCTION_H
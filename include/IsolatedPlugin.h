@@ -0,0 +1,287 @@
+// include/IsolatedPlugin.h
+#ifndef ISOLATEDPLUGIN_H
+#define ISOLATEDPLUGIN_H
+
+#include "IPluginHost.h"
+#include "ShmRing.h"
+#include "Logger.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <typeindex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <cstdint>
+
+#if defined(_WIN32)
+typedef int pid_t;
+#else
+#include <sys/types.h>
+#endif
+
+// 宿主进程与子进程之间的消息。每条消息以 IsolationFrame 开头，其后为内容。
+// 事件标识为子进程本地的 EventId：子进程首次订阅或发布某事件前先以 DefineEvent 告知其名称，
+// 父进程据此映射到共享总线上的 EventId。类型化负载同样按类型名称映射：
+// 发送方在每种类型首次出现时以 DefineType 告知名称，接收方按 IsolationTypes 中绑定的类型重建视图
+enum class IsolationMessage : uint16_t {
+    Hello = 1,       // 子 -> 父：插件名称与依赖（以 '\0' 分隔）
+    Accept,          // 父 -> 子：名称已登记，可以初始化
+    Ready,           // 子 -> 父：initialize() 成功
+    InitFailed,      // 子 -> 父：initialize() 失败
+    DefineEvent,     // 子 -> 父：事件名称
+    Subscribe,       // 子 -> 父：订阅事件，内容为 IsolationSubscribe
+    Unsubscribe,     // 子 -> 父：该事件已无本地订阅者
+    Publish,         // 子 -> 父：发布事件，mode 为 IsolationPublishMode
+    Event,           // 父 -> 子：投递订阅的事件
+    Shutdown,        // 父 -> 子：调用 shutdown() 后退出
+    DefineType,      // 双向：typeId 对应的类型名称（std::type_info::name()）
+};
+
+enum class IsolationPayloadKind : uint8_t {
+    Empty = 0,
+    String = 1,      // 字符串负载，子进程中以 std::string 重建
+    Bytes = 2,       // EventPayload::fromBytes 的原始字节
+    Typed = 3,       // 平凡可复制对象的对象表示，typeId 指向 DefineType 定义的类型；
+                     // 接收方未绑定该类型时以 EventPayload::Bytes 重建
+};
+
+enum class IsolationPublishMode : uint8_t {
+    Sync = 0,
+    Async = 1,
+    Partitioned = 2, // 按分区键有序分发，键位于负载之后
+};
+
+// 帧长为 8 的倍数，负载紧随其后，因此在环中按 8 字节对齐，可直接作为类型化视图
+struct IsolationFrame {
+    IsolationMessage type;
+    IsolationPayloadKind payloadKind;
+    uint8_t mode;
+    uint32_t eventId;
+    uint32_t typeId;     // Typed 负载或 DefineType 定义的类型编号（发送方本地）
+    uint32_t keySize;    // Partitioned 发布的分区键长度
+};
+
+static_assert(sizeof(IsolationFrame) == 16, "IsolationFrame layout is shared by both processes");
+
+struct IsolationSubscribe {
+    uint32_t policy;     // DeliveryPolicy
+    uint32_t capacity;
+};
+
+// 共享内存段开头的两个环，其后依次为父到子、子到父的数据区
+struct IsolationSegment {
+    ShmRingHeader toChild;
+    ShmRingHeader toParent;
+};
+
+// 把负载转换为消息内容；不可按字节复制的对象（make/share 的非平凡类型）无法跨进程，返回 false
+inline bool isolationPayloadOf(const EventPayload& payload, IsolationPayloadKind& kind, std::string_view& bytes) {
+    bytes = payload.bytes();
+    if (payload.empty()) {
+        kind = IsolationPayloadKind::Empty;
+    }
+    else if (payload.string()) {
+        kind = IsolationPayloadKind::String;
+    }
+    else if (payload.is<EventPayload::Bytes>()) {
+        kind = IsolationPayloadKind::Bytes;
+    }
+    else if (!bytes.empty()) {
+        kind = IsolationPayloadKind::Typed;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+// 接收方可重建为类型化视图的负载类型，按 type_info::name() 匹配（两个进程须使用同一编译器构建）。
+// 框架定义的负载（TimerEvent）预先绑定；未绑定的类型以 EventPayload::Bytes 送出
+class IsolationTypes {
+public:
+    struct Type {
+        const std::type_info* type;
+        size_t size;
+    };
+
+    IsolationTypes() { bind<TimerEvent>(); }
+
+    template <typename T>
+    void bind() {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can cross the process boundary");
+        static_assert(alignof(T) <= 8, "Isolated payloads are aligned to 8 bytes");
+        bind(typeid(T), sizeof(T));
+    }
+
+    void bind(const std::type_info& type, size_t size) {
+        types_[type.name()] = Type{ &type, size };
+    }
+
+    const Type* find(const std::string& name) const {
+        auto it = types_.find(name);
+        return it != types_.end() ? &it->second : nullptr;
+    }
+
+private:
+    std::unordered_map<std::string, Type> types_;
+};
+
+// 发送方为每种负载类型分配的编号；首次出现时须先发送 DefineType
+class IsolationTypeIds {
+public:
+    // 返回类型编号，defined 为 false 时调用方应先发送定义并调用 define()
+    uint32_t find(const std::type_info& type, bool& defined) const {
+        auto it = ids_.find(std::type_index(type));
+        defined = it != ids_.end();
+        return defined ? it->second : static_cast<uint32_t>(ids_.size());
+    }
+
+    void define(const std::type_info& type) {
+        ids_.emplace(std::type_index(type), static_cast<uint32_t>(ids_.size()));
+    }
+
+    void clear() { ids_.clear(); }
+
+private:
+    std::unordered_map<std::type_index, uint32_t> ids_;
+};
+
+// 接收方：对端类型编号 -> 本地绑定的类型，未绑定为 nullptr
+class IsolationTypeTable {
+public:
+    // 返回该名称是否已绑定
+    bool define(uint32_t typeId, std::string_view name, const IsolationTypes& types) {
+        if (typeId >= kMaxTypes) {
+            return false;
+        }
+        if (types_.size() <= typeId) {
+            types_.resize(typeId + 1);
+        }
+        types_[typeId] = types.find(std::string(name));
+        return types_[typeId] != nullptr;
+    }
+
+    // 重建负载；类型未绑定或大小不符时以原始字节送出
+    EventPayload payload(uint32_t typeId, std::string_view bytes) const {
+        const IsolationTypes::Type* type = typeId < types_.size() ? types_[typeId] : nullptr;
+        if (type && type->size == bytes.size()) {
+            return EventPayload::view(bytes.data(), *type->type, bytes.size());
+        }
+        return EventPayload::fromBytes(bytes);
+    }
+
+private:
+    static constexpr uint32_t kMaxTypes = 1u << 16;
+    std::vector<const IsolationTypes::Type*> types_;
+};
+
+struct IsolationOptions {
+    // 子进程宿主程序；为空时使用与当前程序同目录的 MotsPluginHost
+    std::string hostExecutable;
+    size_t ringBytes = size_t(1) << 20;                                 // 每个方向的环容量（2 的幂）
+    size_t memoryLimitBytes = 0;                                        // 子进程地址空间上限，0 为不限
+    uint32_t maxRestarts = 5;                                           // 崩溃后最多重启的次数
+    std::chrono::milliseconds startTimeout{ 5000 };                     // 启动到 Ready 的最长时间
+    std::chrono::milliseconds restartDelay{ 100 };
+    std::chrono::microseconds sendTimeout{ 100000 };                    // 环满时等待空位的最长时间，超时丢弃
+    std::chrono::microseconds spin{ 50 };                               // 接收方睡眠前的自旋时间
+    IsolationTypes types;                                               // 子进程发布的类型化负载按此重建
+};
+
+struct IsolationStats {
+    uint64_t sent = 0;        // 投递给子进程的事件
+    uint64_t received = 0;    // 子进程发布的事件
+    uint64_t dropped = 0;     // 环满超时或子进程不在运行而丢弃的事件
+    uint64_t rejected = 0;    // 不可按字节复制而未投递的事件
+    uint32_t restarts = 0;
+    pid_t pid = 0;            // 当前子进程，未运行时为 0
+    bool running = false;
+};
+
+// 父进程一侧的隔离插件：在子进程（MotsPluginHost）中加载插件库，经共享内存环交换事件。
+// 子进程经 IPluginHost 的订阅在父进程中登记为转发订阅（标识为该插件），发布在父进程的总线上触发，
+// 因此其他插件看到的订阅与触发语义与进程内插件相同，只是投递到子进程为异步的（保持顺序）。
+// 子进程崩溃或超出内存上限退出时，撤销其转发订阅并按 restartDelay 重启，最多 maxRestarts 次。
+// 仅支持 Linux
+class IsolatedPlugin {
+public:
+    // 收到子进程插件的名称与依赖后调用（仅首次启动），返回插件在父进程中的宿主服务；返回 nullptr 时拒绝
+    using AcceptFunc = std::function<IPluginHost*(const std::string& name, const std::vector<std::string>& dependencies)>;
+
+    IsolatedPlugin(std::string path, IsolationOptions options, LogChannel& log);
+    ~IsolatedPlugin();
+    IsolatedPlugin(const IsolatedPlugin&) = delete;
+    IsolatedPlugin& operator=(const IsolatedPlugin&) = delete;
+
+    // 启动子进程并等待插件初始化完成，之后由监视线程负责接收消息与重启
+    bool start(AcceptFunc accept);
+    // 通知子进程 shutdown() 并等待其退出（超时则强制结束），撤销转发订阅
+    void stop();
+
+    const std::string& path() const { return path_; }
+    const std::string& name() const { return name_; }
+    const std::vector<std::string>& dependencies() const { return dependencies_; }
+    IsolationStats stats() const;
+
+private:
+    struct Forward {
+        uint32_t childEvent;
+        SubscriptionToken token;
+    };
+
+    std::string path_;
+    IsolationOptions options_;
+    LogChannel& log_;
+    std::string name_;
+    std::vector<std::string> dependencies_;
+    AcceptFunc accept_;
+    IPluginHost* host_ = nullptr;
+
+    std::string shmName_;
+    void* segment_ = nullptr;
+    size_t segmentBytes_ = 0;
+    ShmRing toChild_;
+    ShmRing toParent_;
+    std::mutex sendMutex_;          // 多个发布线程共用父到子的环
+    pid_t pid_ = 0;
+    std::atomic<pid_t> runningPid_{ 0 };
+    std::atomic<bool> stopping_{ false };
+    std::thread monitor_;
+
+    std::vector<EventId> events_;   // 子进程事件标识 -> 共享总线上的标识
+    std::vector<Forward> forwards_;
+    std::string text_;              // 重建字符串负载的复用缓冲
+    IsolationTypeTable childTypes_; // 子进程类型编号 -> 本地类型，仅监视线程使用
+    IsolationTypeIds sentTypes_;    // 已向当前子进程定义的类型，由 sendMutex_ 保护
+    std::unordered_set<std::type_index> rejectedTypes_;  // 已报告过的不可复制类型，由 sendMutex_ 保护
+
+    std::atomic<uint64_t> sent_{ 0 };
+    std::atomic<uint64_t> received_{ 0 };
+    std::atomic<uint64_t> dropped_{ 0 };
+    std::atomic<uint64_t> rejected_{ 0 };
+    std::atomic<uint32_t> restarts_{ 0 };
+
+    bool createSegment();
+    void destroySegment();
+    bool spawn();
+    // 处理子进程消息直到 Ready；失败时结束子进程
+    bool handshake(bool first);
+    // 处理一条子进程消息；Ready 与 InitFailed 由 handshake 处理
+    void handle(const ShmRing::Message& message, bool& ready, bool& failed, bool first);
+    void monitor();
+    // 子进程已退出（回收其状态）
+    bool exited(int& status);
+    void terminate();
+    void revokeForwards();
+    bool send(IsolationMessage type, uint32_t eventId, const EventPayload& payload);
+    // 环满时等待子进程取走消息；子进程已退出或超时返回 false
+    bool writeLocked(const IsolationFrame& frame, std::string_view body);
+    void reject(const EventPayload& payload);
+    void sendControl(IsolationMessage type);
+};
+
+#endif // ISOLATEDPLUGIN_H
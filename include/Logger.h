@@ -0,0 +1,198 @@
+// include/Logger.h
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class LogLevel : uint8_t {
+    Trace,
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Off,
+};
+
+const char* logLevelName(LogLevel level);
+
+// 单条日志的最大长度，超出部分截断
+constexpr size_t kMaxLogMessage = 200;
+
+#if defined(__GNUC__)
+#define MOTS_PRINTF_FORMAT(formatIndex, firstArg) __attribute__((format(printf, formatIndex, firstArg)))
+#else
+#define MOTS_PRINTF_FORMAT(formatIndex, firstArg)
+#endif
+
+// 插件可见的日志接口（经 IPlugin::setLogger 传入）。
+// 写入只复制到当前线程的缓冲区，从不阻塞在 I/O 上；由后台线程统一输出
+class ILogger {
+public:
+    virtual ~ILogger() = default;
+
+    virtual bool enabled(LogLevel level) const = 0;
+    // 写入一条已格式化的消息；超过速率限制时丢弃并计数
+    virtual void write(LogLevel level, const char* text, size_t length) = 0;
+
+    void log(LogLevel level, const std::string& text) {
+        if (enabled(level)) {
+            write(level, text.data(), text.size());
+        }
+    }
+
+    // printf 风格；级别未开启时不做格式化
+    void logf(LogLevel level, const char* format, ...) MOTS_PRINTF_FORMAT(3, 4) {
+        if (!enabled(level)) {
+            return;
+        }
+        char buffer[kMaxLogMessage];
+        va_list args;
+        va_start(args, format);
+        int length = std::vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+        if (length > 0) {
+            write(level, buffer, std::min(static_cast<size_t>(length), sizeof(buffer) - 1));
+        }
+    }
+};
+
+class Logger;
+
+// 日志通道：框架各模块与每个插件各一个，级别与速率限制按通道设置。
+// 速率限制采用 GCRA（单个原子量的令牌桶），被限制的消息只计数，放行时补报条数
+class LogChannel : public ILogger {
+public:
+    LogChannel(Logger& logger, std::string name, LogLevel level, uint32_t ratePerSecond, uint32_t burst);
+
+    const std::string& name() const { return name_; }
+
+    bool enabled(LogLevel level) const override {
+        return level >= level_.load(std::memory_order_relaxed) && level != LogLevel::Off;
+    }
+    void write(LogLevel level, const char* text, size_t length) override;
+
+    void setLevel(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+    // ratePerSecond 为 0 表示不限速
+    void setRateLimit(uint32_t ratePerSecond, uint32_t burst);
+    uint64_t suppressed() const { return suppressedTotal_.load(std::memory_order_relaxed); }
+
+private:
+    Logger& logger_;
+    const std::string name_;
+    std::atomic<LogLevel> level_;
+    std::atomic<int64_t> intervalNs_{ 0 };       // 每条消息占用的时间，0 表示不限速
+    std::atomic<int64_t> toleranceNs_{ 0 };      // 允许的突发量对应的时间
+    std::atomic<int64_t> theoreticalArrival_{ 0 };
+    std::atomic<uint64_t> suppressed_{ 0 };      // 尚未补报的被限制条数
+    std::atomic<uint64_t> suppressedTotal_{ 0 };
+
+    bool admit();
+};
+
+// 异步日志：每个生产线程写自己的单生产者环形缓冲区（无锁、不分配内存），
+// 后台线程定期收集全部缓冲区，按时间排序后批量写入输出流。缓冲区满时丢弃并计数。
+// 线程退出时交还其缓冲区，后台线程排空后释放
+class Logger {
+public:
+    struct Options {
+        size_t recordsPerThread = 1024;
+        uint32_t flushIntervalMs = 2;
+        LogLevel defaultLevel = LogLevel::Info;
+        uint32_t defaultRatePerSecond = 1000;   // 新通道的默认速率限制，0 表示不限速
+        uint32_t defaultBurst = 1000;
+    };
+
+    explicit Logger(std::ostream& sink = std::clog);
+    Logger(std::ostream& sink, Options options);
+    ~Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // 进程级默认实例（有意不析构，退出时由 atexit 刷新）
+    static Logger& global();
+
+    // 按名称获取通道，首次使用时创建；返回的引用在 Logger 生命周期内有效
+    LogChannel& channel(const std::string& name);
+    void setLevel(const std::string& name, LogLevel level) { channel(name).setLevel(level); }
+    void setRateLimit(const std::string& name, uint32_t ratePerSecond, uint32_t burst) {
+        channel(name).setRateLimit(ratePerSecond, burst);
+    }
+
+    // 阻塞直到调用前写入的全部日志都已输出
+    void flush();
+
+    // 因缓冲区满而丢弃的条数
+    uint64_t dropped() const;
+
+    // 当前持有的线程缓冲区数（已退出线程的缓冲区排空后不再计入）
+    size_t bufferCount() const;
+
+private:
+    friend class LogChannel;
+
+    struct Record {
+        int64_t timeNs;
+        const LogChannel* channel;
+        LogLevel level;
+        uint16_t length;
+        char text[kMaxLogMessage];
+    };
+
+    // 单生产者（所属线程）/ 单消费者（后台线程）环形缓冲区
+    struct Buffer {
+        explicit Buffer(size_t capacity) : records(capacity), mask(capacity - 1) {}
+
+        std::vector<Record> records;
+        const size_t mask;
+        alignas(64) std::atomic<uint64_t> head{ 0 };   // 消费者位置
+        alignas(64) std::atomic<uint64_t> tail{ 0 };   // 生产者位置
+        std::atomic<uint64_t> dropped{ 0 };
+        std::atomic<bool> released{ false };           // 所属线程已退出，不再写入
+    };
+
+    // 线程缓存：线程退出（或清理残留条目）时交还其中的缓冲区
+    struct ThreadBuffers {
+        std::vector<std::pair<uint64_t, std::shared_ptr<Buffer>>> entries;
+        ~ThreadBuffers() { release(); }
+        void release();
+    };
+
+    const Options options_;
+    const uint64_t serial_;
+    std::ostream& sink_;
+
+    std::mutex channelsMutex_;
+    std::unordered_map<std::string, std::unique_ptr<LogChannel>> channels_;
+
+    mutable std::mutex buffersMutex_;
+    std::vector<std::shared_ptr<Buffer>> buffers_;
+    uint64_t releasedDropped_ = 0;  // 已释放缓冲区的丢弃数
+    uint64_t reportedDropped_ = 0;  // 仅后台线程访问
+
+    std::mutex flushMutex_;
+    std::condition_variable flushCv_;
+    uint64_t flushRequested_ = 0;
+    uint64_t flushCompleted_ = 0;
+    bool stopping_ = false;
+    std::thread worker_;
+
+    void push(const LogChannel& channel, LogLevel level, const char* text, size_t length);
+    Buffer& localBuffer();
+    Buffer& attach(ThreadBuffers& cache);
+    void run();
+    bool drain(std::vector<Record>& scratch);
+};
+
+#endif // LOGGER_H
@@ -0,0 +1,271 @@
+// include/OrderBook.h
+#ifndef ORDERBOOK_H
+#define ORDERBOOK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 订单簿插件（OrderBookPlugin）订阅与发布的事件
+constexpr const char* kOrderAddEvent = "md.order.add";        // 负载为 OrderAdd
+constexpr const char* kOrderModifyEvent = "md.order.modify";  // 负载为 OrderModify
+constexpr const char* kOrderCancelEvent = "md.order.cancel";  // 负载为 OrderCancel
+constexpr const char* kTopOfBookEvent = "md.book.top";        // 负载为 TopOfBook
+
+enum class Side : uint8_t {
+    Buy,
+    Sell
+};
+
+// 逐笔委托行情（L3）。价格以最小变动价位（tick）为单位的整数表示
+struct OrderAdd {
+    uint64_t orderId;
+    uint32_t instrument;  // 品种编号，须小于 OrderBookSet::kMaxInstruments
+    Side side;
+    int64_t price;
+    uint64_t quantity;
+};
+
+// 改价或改量：只减少数量时保持时间优先；改价或增加数量时排到新价位的队尾。数量为 0 视为撤单
+struct OrderModify {
+    uint64_t orderId;
+    int64_t price;
+    uint64_t quantity;
+};
+
+// 撤单：quantity 为 0 或不小于剩余数量时整笔撤销，否则减少该数量（部分撤单或成交）
+struct OrderCancel {
+    uint64_t orderId;
+    uint64_t quantity;
+};
+
+// 买卖一档；一侧没有委托时该侧的委托数为 0，价格与数量无意义
+struct TopOfBook {
+    uint32_t instrument = 0;
+    int64_t bidPrice = 0;
+    uint64_t bidQuantity = 0;
+    uint32_t bidOrders = 0;
+    int64_t askPrice = 0;
+    uint64_t askQuantity = 0;
+    uint32_t askOrders = 0;
+    uint64_t sequence = 0;  // 该品种已处理的更新数
+
+    bool hasBid() const { return bidOrders != 0; }
+    bool hasAsk() const { return askOrders != 0; }
+};
+
+// L2 的一档
+struct BookLevel {
+    int64_t price;
+    uint64_t quantity;
+    uint32_t orders;
+};
+
+// L3 的一笔委托
+struct BookOrder {
+    uint64_t orderId;
+    int64_t price;
+    uint64_t quantity;
+};
+
+// 订单簿中的委托；同一价位的委托按到达顺序串成双向链表
+struct OrderNode {
+    uint64_t orderId;
+    int64_t price;
+    uint64_t quantity;
+    OrderNode* prev;
+    OrderNode* next;
+    uint32_t instrument;
+    Side side;
+};
+
+// 委托节点池：按块分配、经空闲链表复用，稳态下增删委托不调用 malloc
+class OrderNodePool {
+public:
+    OrderNodePool() = default;
+    OrderNodePool(const OrderNodePool&) = delete;
+    OrderNodePool& operator=(const OrderNodePool&) = delete;
+
+    OrderNode* acquire();
+    void release(OrderNode* node);
+    size_t capacity() const { return slabs_.size() * kSlabNodes; }
+
+private:
+    static constexpr size_t kSlabNodes = 4096;
+
+    std::vector<std::unique_ptr<OrderNode[]>> slabs_;
+    OrderNode* free_ = nullptr;  // 经 next 串联
+};
+
+// 订单号 -> 委托：线性探测的开放寻址表，键与节点指针同存于槽位，查找不必访问节点；
+// 删除采用后移，不留墓碑
+class OrderIdMap {
+public:
+    OrderIdMap();
+
+    OrderNode* find(uint64_t orderId) const {
+        for (size_t i = home(orderId);; i = (i + 1) & mask_) {
+            const Slot& slot = slots_[i];
+            if (!slot.node) {
+                return nullptr;
+            }
+            if (slot.orderId == orderId) {
+                return slot.node;
+            }
+        }
+    }
+
+    // 调用方保证订单号尚不存在
+    void insert(OrderNode* node);
+    void erase(uint64_t orderId);
+    size_t size() const { return size_; }
+    void clear();
+
+private:
+    struct Slot {
+        uint64_t orderId = 0;
+        OrderNode* node = nullptr;
+    };
+
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+    int shift_ = 64;
+    size_t size_ = 0;
+
+    // 斐波那契散列：取乘积的高位，连续的订单号也能均匀分布
+    size_t home(uint64_t orderId) const {
+        return static_cast<size_t>((orderId * 0x9E3779B97F4A7C15ull) >> shift_);
+    }
+    void rehash(size_t capacity);
+};
+
+// 订单簿的一侧：按价格连续存放的价位数组，下标为相对 base_ 的 tick 偏移，
+// 定位价位是一次减法；非空价位另记位图，最优价位清空后按 64 档一步查找下一档。
+// 数组按需向价格移动的方向扩展（2 的幂，至多 kMaxLevels 档），一侧清空后以新价格为中心重新定位。
+// 价格须在 ±kMaxPrice tick 之内，下标运算因此不会溢出
+class PriceLadder {
+public:
+    struct Level {
+        uint64_t quantity = 0;
+        uint32_t orders = 0;
+        OrderNode* head = nullptr;
+        OrderNode* tail = nullptr;
+    };
+
+    static constexpr size_t kInitialLevels = 1024;
+    static constexpr size_t kMaxLevels = size_t(1) << 20;
+    static constexpr int64_t kMaxPrice = int64_t(1) << 60;
+
+    explicit PriceLadder(Side side) : side_(side) {}
+
+    bool empty() const { return best_ < 0; }
+    // 最优价位，一侧为空时返回 nullptr
+    const Level* best() const { return empty() ? nullptr : &levels_[static_cast<size_t>(best_)]; }
+    int64_t bestPrice() const { return base_ + best_; }
+
+    // 价格能否放入价位数组（必要时扩展后）；超出 ±kMaxPrice 的价格总是不能
+    bool canHold(int64_t price) const;
+    // 追加到价位队尾；调用方须先以 canHold 检查
+    void append(OrderNode* node);
+    void remove(OrderNode* node);
+    // 撤销紧接其前的 remove（其间价位数组未变），委托回到原来的队列位置
+    void restore(OrderNode* node);
+    // 减少委托数量，保持其时间优先；quantity 小于委托的剩余数量
+    void reduce(OrderNode* node, uint64_t quantity);
+
+    // 从最优价起的至多 maxLevels 档（L2）与其中按价格、时间优先排列的委托（L3）
+    void depth(size_t maxLevels, std::vector<BookLevel>& out) const;
+    void orders(size_t maxLevels, std::vector<BookOrder>& out) const;
+    void clear();
+
+private:
+    Side side_;
+    std::vector<Level> levels_;
+    std::vector<uint64_t> occupied_;  // 非空价位的位图
+    int64_t base_ = 0;                // levels_[0] 的价格
+    int64_t best_ = -1;               // 最优价位的下标，-1 表示一侧为空
+    size_t liveLevels_ = 0;
+
+    // 下标 a 的价格是否优于下标 b
+    bool better(int64_t a, int64_t b) const { return side_ == Side::Buy ? a > b : a < b; }
+    // 从下标 from（含）起向更差的价格查找第一个非空价位，没有时返回 -1
+    int64_t nextLevel(int64_t from) const;
+    void reserve(int64_t price);
+};
+
+// 单个品种的订单簿
+class OrderBook {
+public:
+    explicit OrderBook(uint32_t instrument) : instrument_(instrument) {}
+
+    uint32_t instrument() const { return instrument_; }
+    TopOfBook top() const;
+    // L2：每侧从最优价起的至多 maxLevels 档
+    void depth(Side side, size_t maxLevels, std::vector<BookLevel>& out) const { ladder(side).depth(maxLevels, out); }
+    // L3：这些价位上的全部委托，价格优先、时间优先
+    void orders(Side side, size_t maxLevels, std::vector<BookOrder>& out) const { ladder(side).orders(maxLevels, out); }
+    size_t orderCount() const { return orders_; }
+    uint64_t sequence() const { return sequence_; }
+
+private:
+    friend class OrderBookSet;
+
+    uint32_t instrument_;
+    PriceLadder bids_{ Side::Buy };
+    PriceLadder asks_{ Side::Sell };
+    size_t orders_ = 0;
+    uint64_t sequence_ = 0;
+
+    PriceLadder& ladder(Side side) { return side == Side::Buy ? bids_ : asks_; }
+    const PriceLadder& ladder(Side side) const { return side == Side::Buy ? bids_ : asks_; }
+};
+
+struct OrderBookStats {
+    uint64_t adds = 0;
+    uint64_t modifies = 0;
+    uint64_t cancels = 0;
+    uint64_t rejected = 0;   // 订单号重复或未知、数量为 0、品种编号或价格超出范围
+    size_t orders = 0;       // 当前委托数
+    size_t instruments = 0;  // 出现过的品种数
+    size_t pooledNodes = 0;  // 节点池容量
+};
+
+// 全部品种的订单簿；委托节点池与订单号表在品种间共享。
+// 单写者：全部更新须在同一线程上串行执行（插件按 Reactor 策略加载，或由单个行情线程发布）
+class OrderBookSet {
+public:
+    static constexpr uint32_t kMaxInstruments = 65536;
+
+    OrderBookSet() = default;
+    OrderBookSet(const OrderBookSet&) = delete;
+    OrderBookSet& operator=(const OrderBookSet&) = delete;
+
+    // 返回被更新的订单簿；更新无效时返回 nullptr 并计入 rejected，订单簿不变
+    OrderBook* add(const OrderAdd& order);
+    OrderBook* modify(const OrderModify& order);
+    OrderBook* cancel(const OrderCancel& order);
+
+    // 未出现过的品种返回 nullptr
+    const OrderBook* book(uint32_t instrument) const {
+        return instrument < books_.size() ? books_[instrument].get() : nullptr;
+    }
+    // 品种编号的上界（不含），遍历 book() 时使用
+    uint32_t instrumentBound() const { return static_cast<uint32_t>(books_.size()); }
+    const OrderNode* findOrder(uint64_t orderId) const { return ids_.find(orderId); }
+    OrderBookStats stats() const;
+    // 清空全部委托，保留已分配的节点与价位数组
+    void clear();
+
+private:
+    std::vector<std::unique_ptr<OrderBook>> books_;  // 按品种编号索引
+    OrderNodePool pool_;
+    OrderIdMap ids_;
+    OrderBookStats stats_;
+
+    OrderBook* bookFor(uint32_t instrument);
+    // 整笔移除委托并归还节点
+    void removeOrder(OrderBook& book, OrderNode* node);
+};
+
+#endif // ORDERBOOK_H
@@ -0,0 +1,61 @@
+// include/PayloadPool.h
+#ifndef PAYLOADPOOL_H
+#define PAYLOADPOOL_H
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+// 分配线程的池分片，定义在 PayloadPool.cpp 中
+struct PoolShard;
+
+// 负载池中的引用计数块：保留的负载（EventPayload::retain / copyOf）的存储。
+// 块按数据区大小分级，由分配线程的分片持有；最后一个引用可在任何线程上释放，
+// 在分配线程上直接放回其空闲链表，其他线程经无锁的远程归还栈还给原分片
+struct PayloadBlock {
+    std::atomic<uint32_t> refs{ 1 };
+    uint32_t sizeClass = 0;
+    PoolShard* home = nullptr;
+    PayloadBlock* next = nullptr;
+
+    void retain() { refs.fetch_add(1, std::memory_order_relaxed); }
+    void release() {
+        if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            recycle(this);
+        }
+    }
+
+    static void recycle(PayloadBlock* block);
+};
+
+// 全部分片的累计计数
+struct PayloadPoolStats {
+    uint64_t reused = 0;        // 从空闲链表取得的块
+    uint64_t created = 0;       // 新建的块（切分 slab 或新建字符串块）
+    uint64_t slabs = 0;         // 从堆分配的 slab
+    uint64_t remoteFrees = 0;   // 在其他线程上归还的块
+    uint64_t oversized = 0;     // 超过最大分级、直接从堆分配的块
+    size_t shards = 0;          // 曾经使用过池的线程数（线程退出后其分片由新线程接手）
+};
+
+// 每个线程一个分片，分配不加锁；稳态下保留负载不再调用 malloc。
+// 池的内存在进程生命周期内保留，不归还给系统
+class PayloadPool {
+public:
+    // 最大分级的数据区大小，更大的数据直接从堆分配
+    static constexpr size_t kMaxPooledBytes = 64 * 1024;
+
+    // 分配至少 size 字节、按 max_align_t 对齐的数据区，引用计数为 1
+    static PayloadBlock* allocate(size_t size);
+    static void* data(PayloadBlock* block);
+
+    // 分配内含 text 副本的字符串块；字符串容量随块复用，稳态下不再分配
+    static PayloadBlock* allocateString(std::string_view text);
+    static const std::string* string(PayloadBlock* block);
+
+    static PayloadPoolStats stats();
+};
+
+#endif // PAYLOADPOOL_H
@@ -4,10 +4,17 @@
 
 #include "IPlugin.h"
 #include "Event.h"
+#include "AsyncEventBus.h"
+#include "SubscriberMailbox.h"
+#include "TimerWheel.h"
+#include "EventJournal.h"
+#include "IsolatedPlugin.h"
+#include "Reactor.h"
 #include <string>
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include <chrono>
 
 #if defined(_WIN32)
 #include <windows.h>
@@ -17,37 +24,249 @@ typedef HMODULE LibHandle;
 typedef void* LibHandle;
 #endif
 
+// 按清单延迟激活的插件状态，定义在 PluginManager.cpp 中
+struct LazyPlugin;
+// 每个插件实例的宿主服务（IPluginHost 的实现），定义在 PluginManager.cpp 中
+class PluginHost;
+
 struct PluginInfo {
     std::string path;
-    LibHandle handle;
+    std::string name;  // 加载时缓存，避免重复调用虚函数 getName()
+    PluginId id;
+    std::vector<std::string> dependencies;
+    LibHandle handle = nullptr;
     std::unique_ptr<IPlugin> instance;
+    std::shared_ptr<PluginHost> host;  // 传给 instance 的宿主服务，与实例同生命周期
+    // 非空表示按清单登记、首次触发其事件时才加载的插件；激活后库与实例由它持有
+    std::shared_ptr<LazyPlugin> lazy;
+    // 非空表示插件运行在子进程中（见 loadIsolatedPlugin），instance 与 handle 为空
+    std::shared_ptr<IsolatedPlugin> isolated;
+};
+
+// 批量加载中单个插件的结果与耗时
+struct PluginLoadReport {
+    std::string path;
+    std::string name;
+    bool loaded = false;
+    std::string error;
+    std::chrono::nanoseconds openTime{ 0 };  // dlopen 与 CreatePlugin
+    std::chrono::nanoseconds initTime{ 0 };  // initialize()
 };
 
 class PluginManager {
 public:
-    PluginManager();
+    // 框架与插件日志写入 logger；每个插件一个以插件名称命名的通道，经 IPlugin::setLogger 传入
+    explicit PluginManager(Logger& logger = Logger::global());
     ~PluginManager();
 
     // 返回值改为 bool，表示是否成功注册事件
     bool loadPlugin(const std::string& path);
-    // 卸载特定插件
+    // 按执行策略加载：Reactor 模式下插件的全部订阅回调（含经宿主建立的）在其独占的反应器线程上执行，
+    // 该线程绑定到 policy.cpu 并忙等轮询入站队列，空闲超过 policy.idleSpin 后转为阻塞等待
+    bool loadPlugin(const std::string& path, const ExecutionPolicy& policy);
+    // 扫描目录中的插件库并在线程池上并发加载与初始化；依赖按 getDependencies() 排序。
+    // 同名插件按已加载优先、其次路径字典序决定保留哪一个；已加载的路径跳过。
+    // threads 为 0 时使用硬件线程数
+    std::vector<PluginLoadReport> loadPlugins(const std::string& directory, size_t threads = 0);
+    std::vector<PluginLoadReport> loadPlugins(const std::vector<std::string>& paths, size_t threads = 0);
+    // 按旁路清单（库路径加 ".manifest"）登记插件而不加载库；清单声明名称、处理的事件与依赖。
+    // 首次触发清单中的任一事件时才 dlopen 并 initialize()，同名检查在读取清单时完成
+    bool registerLazyPlugin(const std::string& path);
+    // 登记目录中全部带清单的插件库，按路径字典序处理，返回成功登记的数量
+    size_t registerLazyPlugins(const std::string& directory);
+    // 在独立的子进程（MotsPluginHost）中加载并初始化插件，事件经共享内存环交换；
+    // 插件崩溃或超出内存上限时只有子进程退出，框架撤销其订阅并按 options 自动重启。
+    // 其他插件看到的订阅与触发语义不变；投递到子进程为异步的；
+    // 类型化负载按类型名称在对端重建（父进程经 options.types、子进程经 IPluginHost::bindType 绑定），不可按字节复制的负载被拒绝。仅支持 Linux
+    bool loadIsolatedPlugin(const std::string& path, const IsolationOptions& options = {});
+    // 隔离插件的收发、丢弃与重启计数；非隔离插件返回空统计
+    IsolationStats getIsolationStats(const std::string& pluginName) const;
+    // 反应器插件的唤醒延迟、空闲忙等与阻塞时间；非反应器插件返回空统计
+    ReactorStats getReactorStats(const std::string& pluginName) const;
+    // 插件已加载且已初始化（延迟插件已激活）
+    bool isPluginActive(const std::string& pluginName) const;
+    // 卸载特定插件；仍被其他已加载插件依赖时失败
     bool unloadPlugin(const std::string& pluginName);
+    // 按依赖的逆序卸载全部插件
     void unloadAll();
+    // 热重载：在旧版本旁加载并初始化新版本，新版本经宿主的订阅先暂存；
+    // 随后在同一次快照切换中注销旧版本的订阅并登记新版本的订阅，等旧版本的在途回调、邮箱与反应器队列排空后
+    // 迁移状态，其间到达新版本的事件按顺序暂存，迁移完成后补发。每个事件恰好由一个版本处理，发布方不等待。
+    // 新版本拒绝状态时恢复旧版本的订阅并保留旧版本（其间暂存的事件丢弃并记入日志）。插件标识与经 registerPluginEvent 建立的订阅保持不变。
+    // 隔离插件不支持热重载，需卸载后重新加载
+    bool reloadPlugin(const std::string& pluginName, const std::string& newPath);
 
     // 返回 bool，表示是否成功注册事件
     bool registerPluginEvent(const std::string& pluginName, const std::string& eventName, EventCallback callback);
+    bool registerPluginEvent(const std::string& pluginName, EventId eventId, EventCallback callback);
     void triggerPluginEvent(const std::string& eventName, const std::string& eventData); // 移除了 pluginName 参数，因为事件是全局的
+    void triggerPluginEvent(EventId eventId, const std::string& eventData);
+
+    // 类型化负载接口：同一负载对象按引用传给全部订阅者
+    bool registerPluginEvent(const std::string& pluginName, const std::string& eventName, PayloadCallback callback);
+    bool registerPluginEvent(const std::string& pluginName, EventId eventId, PayloadCallback callback);
+    void triggerPluginEvent(const std::string& eventName, const EventPayload& payload);
+    void triggerPluginEvent(EventId eventId, const EventPayload& payload);
+
+    // 带投递策略的订阅：慢消费者按策略丢弃、合并或阻塞，不影响其他订阅者
+    bool registerPluginEvent(const std::string& pluginName, const std::string& eventName, PayloadCallback callback, const SubscriptionOptions& options);
+    bool registerPluginEvent(const std::string& pluginName, EventId eventId, PayloadCallback callback, const SubscriptionOptions& options);
+
+    // 订阅并返回凭据，之后可凭该凭据单独注销这一个回调；失败时返回无效凭据
+    SubscriptionToken subscribePluginEvent(const std::string& pluginName, const std::string& eventName, PayloadCallback callback, const SubscriptionOptions& options = {});
+    SubscriptionToken subscribePluginEvent(const std::string& pluginName, EventId eventId, PayloadCallback callback, const SubscriptionOptions& options = {});
+    // 订阅批量回调：批量触发时每段连续的同一事件只调用一次（不支持投递策略）
+    SubscriptionToken subscribePluginBatchEvent(const std::string& pluginName, const std::string& eventName, BatchCallback callback,
+        const SubscriptionQos& qos = {});
+    SubscriptionToken subscribePluginBatchEvent(const std::string& pluginName, EventId eventId, BatchCallback callback,
+        const SubscriptionQos& qos = {});
+    // 注销单个回调；返回后该回调不会再被调用
+    bool unsubscribePluginEvent(const SubscriptionToken& token);
+
+    // 插件当前的订阅数量
+    size_t getSubscriptionCount(const std::string& pluginName);
+
+    // 插件所有带策略订阅的丢弃/合并/阻塞计数
+    DeliveryStats getDeliveryStats(const std::string& pluginName) const;
+    // 插件带截止时间的订阅的执行与错过次数（见 SubscriptionOptions::deadline）
+    DeadlineStats getDeadlineStats(const std::string& pluginName);
+
+    // 批量触发（如一个行情包解码出的多条更新）：整批只进入一次读临界区；
+    // 按事件分组排列时每个事件只查找一次订阅者，批量订阅者每个事件只调用一次
+    void triggerPluginEvents(const BatchEvent* events, size_t count);
+    void triggerPluginEvents(const std::vector<BatchEvent>& events);
+
+    // 解析事件名称为标识，热路径上应缓存该标识并使用标识接口触发
+    EventId resolvePluginEvent(const std::string& eventName);
+
+    // 异步发布：启动分发线程后，publishAsync 入队即返回，由分发线程执行回调
+    bool startAsyncDispatch(size_t dispatcherThreads = 1, size_t queueCapacity = 65536);
+    void stopAsyncDispatch();
+    bool publishAsync(const std::string& eventName, const std::string& eventData);
+    bool publishAsync(EventId eventId, const EventPayload& payload);
+    // 等待已异步发布的事件全部分发完成（含带投递策略的邮箱），并等待反应器插件执行完已入队的事件
+    void flushAsync();
+
+    // 按分区键（如品种代码）有序分发：同一键的事件按发布顺序到达订阅者，不同键在多个分片上并行。
+    // 异步分发未启动时退化为同步触发；队列满时等待空位，不丢事件。
+    // 例外：在目标分片的分发线程上（如回调中）发布且队列已满时丢弃该事件并记入丢弃数，以免自锁或乱序
+    void triggerPluginEvent(const std::string& eventName, const std::string& eventData, std::string_view partitionKey);
+    void triggerPluginEvent(EventId eventId, const EventPayload& payload, std::string_view partitionKey);
+
+    // 各分片的排队深度与等待延迟
+    std::vector<ShardStats> getShardStats() const;
+
+    // 按事件、插件、订阅统计的触发次数、速率与回调延迟直方图
+    StatsSnapshot getStatsSnapshot();
+    void dumpStats(std::ostream& out);
+    // 运行期开关统计记录；编译期关闭（MOTS_ENABLE_STATS=OFF）时无效
+    void setStatsEnabled(bool enabled);
+
+    // 插件定时器：到期时触发事件（负载为 TimerEvent），period 非零时周期触发；
+    // 由框架的时间轮统一驱动，插件无需自建线程，卸载插件时自动取消其全部定时器
+    TimerId schedulePluginTimer(const std::string& pluginName, const std::string& eventName,
+        std::chrono::nanoseconds delay, std::chrono::nanoseconds period = std::chrono::nanoseconds::zero());
+    TimerId schedulePluginTimer(const std::string& pluginName, EventId eventId,
+        std::chrono::nanoseconds delay, std::chrono::nanoseconds period = std::chrono::nanoseconds::zero());
+    bool cancelPluginTimer(TimerId timer);
+    // 定时器数量与触发抖动
+    TimerStats getTimerStats() const;
+
+    // 事件日志：开启后经 triggerPluginEvent / triggerPluginEvents / publishAsync 发布的每个事件
+    // （异步发布仅记录成功入队或已同步触发的事件，被丢弃的不记录）
+    // 连同名称、负载、时间戳与序号追加到内存映射文件；已有日志时先关闭旧日志
+    bool startJournal(const std::string& path, size_t capacityBytes = JournalWriter::kDefaultCapacity);
+    // 等待在途的追加完成后关闭并截断日志文件
+    void stopJournal();
+    JournalStats getJournalStats() const;
+    // 把日志中的事件按记录顺序重放给本管理器的订阅者（重放的事件不会再次写入日志）。
+    // 需要以类型化视图重放时先对 reader 调用 bindType
+    ReplayStats replayJournal(const std::string& path, const ReplayOptions& options = {});
+    ReplayStats replayJournal(JournalReader& reader, const ReplayOptions& options = {});
+
+    // 日志级别与速率限制按插件设置（通道名称即插件名称），可在插件加载前设置
+    Logger& getLogger() { return eventManager_.logger(); }
+    void setPluginLogLevel(const std::string& pluginName, LogLevel level);
+    void setPluginLogRateLimit(const std::string& pluginName, uint32_t ratePerSecond, uint32_t burst);
 
 private:
+    friend class PluginHost;
+
     std::vector<PluginInfo> plugins_;
+    // 名称/路径 -> plugins_ 下标；卸载时与末尾元素交换后删除
+    std::unordered_map<std::string, size_t> nameIndex_;
+    std::unordered_map<std::string, size_t> pathIndex_;
+    // 插件名称 -> 依赖它的已加载插件数量
+    std::unordered_map<std::string, size_t> dependentCounts_;
     EventManager eventManager_;
+    AsyncEventBus asyncBus_{ eventManager_ };
+    MailboxDrainer mailboxDrainer_;  // 异步总线未运行时排空订阅邮箱
+    TimerWheel timers_{ eventManager_ };
+    LogChannel& log_;
+
+    // 当前日志；发布方在读临界区内追加，关闭时先摘下指针再等待读者离开
+    std::atomic<JournalWriter*> journal_{ nullptr };
+    mutable std::mutex journalMutex_;  // 开关日志
+
+    // 插件标识 -> (订阅编号 -> 带投递策略的订阅邮箱)
+    std::unordered_map<uint32_t, std::unordered_map<uint32_t, std::shared_ptr<SubscriberMailbox>>> mailboxes_;
+    // 插件标识 -> 反应器（按 Reactor 策略加载的插件），与邮箱共用锁
+    std::unordered_map<uint32_t, std::shared_ptr<Reactor>> reactors_;
+    mutable std::mutex mailboxMutex_;
 
     LibHandle loadLibrary(const std::string& path);
     void unloadLibrary(LibHandle handle);
     CreatePluginFunc getCreatePluginFunc(LibHandle handle);
 
+    std::vector<PluginLoadReport> loadPlugins(const std::vector<std::string>& paths, size_t threads, const ExecutionPolicy& policy);
+
     // 辅助函数：检查插件是否已加载
     bool isPluginLoaded(const std::string& pluginName) const;
+    // 按名称查找已加载插件，未加载时返回 nullptr
+    const PluginInfo* findPlugin(const std::string& pluginName) const;
+
+    // 注销插件全部回调并关闭其订阅邮箱，然后卸载插件库
+    void releasePlugin(PluginInfo& info);
+    // 加载并初始化延迟插件（先激活其延迟依赖），可在任意线程上并发调用
+    bool activatePlugin(LazyPlugin& lazy);
+    // 插件已登记，且若为延迟插件则已激活成功
+    bool ensureActive(const std::string& pluginName);
+    // 插件的反应器，非反应器插件返回空
+    std::shared_ptr<Reactor> findReactor(PluginId pluginId) const;
+    // 停止并移除插件的反应器；调用前须已关闭其全部订阅
+    void releaseReactor(PluginId pluginId);
+    // 关闭插件的全部订阅邮箱，唤醒阻塞在其上的发布者；在注销订阅之后、等待在途回调之前调用
+    void closeMailboxes(PluginId pluginId);
+    // 关闭单个订阅的邮箱（如有），调用时机同上
+    void closeMailbox(const SubscriptionToken& token);
+    // 关闭单个订阅在反应器上的回调（如有）；调用前须已等待在途回调返回
+    void closeReactorCallback(const SubscriptionToken& token);
+    // 已按执行策略与投递策略包装、尚未生效的订阅
+    struct PreparedSubscription {
+        StagedSubscription staged;
+        std::shared_ptr<Reactor> reactor;
+        Reactor::Target* target = nullptr;
+        std::shared_ptr<SubscriberMailbox> mailbox;
+    };
+    // 反应器插件的回调改为投递到反应器，带投递策略的回调改为投递到新建的邮箱
+    PreparedSubscription prepareSubscription(PluginId pluginId, const std::string& pluginName, EventId eventId,
+        PayloadCallback callback, const SubscriptionOptions& options);
+    PreparedSubscription prepareBatchSubscription(PluginId pluginId, EventId eventId, BatchCallback callback,
+        const SubscriptionQos& qos);
+    // 订阅生效后登记其反应器回调与邮箱；token 无效（登记失败）时释放它们
+    void bindSubscription(PreparedSubscription& prepared, const SubscriptionToken& token);
+    // 等待订阅的邮箱（如有）排空积压事件，不关闭邮箱
+    void drainMailbox(const SubscriptionToken& token);
+    // 以插件标识订阅，不检查插件是否已登记（供初始化中的插件经宿主订阅）
+    SubscriptionToken subscribe(PluginId pluginId, const std::string& pluginName, EventId eventId,
+        PayloadCallback callback, const SubscriptionOptions& options);
+    SubscriptionToken subscribeBatch(PluginId pluginId, EventId eventId, BatchCallback callback,
+        const SubscriptionQos& qos = {});
+    // 日志开启时记录一个发布的事件
+    void journalEvent(EventId eventId, const EventPayload& payload);
+    // 按名称发布时的事件标识：日志开启时尚无订阅者的事件也要记录，因此按需登记名称；
+    // 否则只查找有订阅者（含通配订阅）的主题，无效标识表示无需发布
+    EventId publishTopicOf(const std::string& eventName);
 };
 
 #endif // PLUGINMANAGER_H
\ No newline at end of file
@@ -0,0 +1,27 @@
+// include/PluginPath.h
+#ifndef PLUGINPATH_H
+#define PLUGINPATH_H
+
+#include <filesystem>
+#include <string>
+
+// 测试与基准共用：按平台命名规则拼出插件动态库的文件名与路径
+
+// 插件动态库文件名，如 Linux 上的 libSamplePlugin.so、Windows 上的 SamplePlugin.dll
+inline std::string pluginFileName(const std::string& name) {
+#if defined(_WIN32)
+    return name + ".dll";
+#elif defined(__APPLE__)
+    return "lib" + name + ".dylib";
+#else
+    return "lib" + name + ".so";
+#endif
+}
+
+// 插件动态库路径，默认在当前目录（apphome/bin）下查找
+inline std::string pluginPath(const std::string& name,
+    const std::filesystem::path& directory = std::filesystem::current_path()) {
+    return (directory / pluginFileName(name)).string();
+}
+
+#endif // PLUGINPATH_H
@@ -0,0 +1,185 @@
+// include/Rcu.h
+#ifndef RCU_H
+#define RCU_H
+
+#include <atomic>
+#include <array>
+#include <mutex>
+#include <vector>
+#include <thread>
+#include <cstdint>
+
+// 基于纪元（epoch）的读-复制-更新回收机制。
+// 读者只写自己线程的纪元槽位，不加锁也不分配内存；
+// 写者替换快照后把旧快照交给 retire()，待所有可能持有旧快照的读者退出后再释放。
+class EpochDomain {
+    struct alignas(64) Record {
+        std::atomic<uint64_t> epoch{ 0 };   // 0 表示静止
+        std::atomic<bool> inUse{ false };
+    };
+
+    struct ThreadState {
+        Record* record = nullptr;
+        uint32_t nesting = 0;
+
+        ThreadState() {
+            record = instance().acquireRecord();
+        }
+        ~ThreadState() {
+            record->epoch.store(0, std::memory_order_release);
+            record->inUse.store(false, std::memory_order_release);
+        }
+    };
+
+    struct Retired {
+        void* ptr;
+        void (*deleter)(void*);
+        uint64_t epoch;
+    };
+
+public:
+    static constexpr size_t kMaxThreads = 1024;
+
+    static EpochDomain& instance() {
+        // 有意不析构：线程退出时仍可能归还槽位
+        static EpochDomain* domain = new EpochDomain();
+        return *domain;
+    }
+
+    // 读临界区守卫，支持同一线程内嵌套（例如回调中再次触发事件）
+    class ReadGuard {
+    public:
+        ReadGuard() : state_(threadState()) {
+            if (state_.nesting++ == 0) {
+                uint64_t epoch = instance().globalEpoch_.load(std::memory_order_relaxed);
+                state_.record->epoch.store(epoch, std::memory_order_relaxed);
+                // 与写者的 “替换指针 -> 扫描读者纪元” 构成 Dekker 式同步
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+        ~ReadGuard() {
+            if (--state_.nesting == 0) {
+                state_.record->epoch.store(0, std::memory_order_release);
+            }
+        }
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+        ThreadState& state_;
+    };
+
+    // 延迟释放：ptr 必须已从所有共享位置摘除
+    void retire(void* ptr, void (*deleter)(void*)) {
+        uint64_t epoch = globalEpoch_.fetch_add(1, std::memory_order_seq_cst);
+        {
+            std::lock_guard<std::mutex> lock(retiredMutex_);
+            retired_.push_back(Retired{ ptr, deleter, epoch });
+        }
+        reclaim();
+    }
+
+    template <typename T>
+    void retire(const T* ptr) {
+        retire(const_cast<T*>(ptr), [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    // 等待调用前已进入读临界区的其他线程全部退出。
+    // 当前线程若位于读临界区内（回调中调用），不等待自身。
+    void synchronize() {
+        uint64_t target = globalEpoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const Record* self = threadState().nesting > 0 ? threadState().record : nullptr;
+        size_t count = highWater_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const Record& record = records_[i];
+            if (&record == self) {
+                continue;
+            }
+            for (;;) {
+                uint64_t epoch = record.epoch.load(std::memory_order_acquire);
+                if (epoch == 0 || epoch >= target) {
+                    break;
+                }
+                std::this_thread::yield();
+            }
+        }
+        reclaim();
+    }
+
+private:
+    std::atomic<uint64_t> globalEpoch_{ 1 };
+    std::array<Record, kMaxThreads> records_;
+    std::atomic<size_t> highWater_{ 0 };    // 曾被占用过的最大槽位数，限定扫描范围
+    std::mutex retiredMutex_;
+    std::vector<Retired> retired_;
+    std::mutex reclaimMutex_;               // 同一时刻只有一个线程执行删除器
+
+    EpochDomain() = default;
+
+    static ThreadState& threadState() {
+        thread_local ThreadState state;
+        return state;
+    }
+
+    Record* acquireRecord() {
+        for (;;) {
+            for (size_t i = 0; i < kMaxThreads; ++i) {
+                Record& record = records_[i];
+                bool expected = false;
+                if (!record.inUse.load(std::memory_order_relaxed) &&
+                    record.inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                    size_t count = highWater_.load(std::memory_order_relaxed);
+                    while (count < i + 1 &&
+                        !highWater_.compare_exchange_weak(count, i + 1, std::memory_order_acq_rel)) {
+                    }
+                    return &record;
+                }
+            }
+            // 槽位耗尽时等待其他线程退出
+            std::this_thread::yield();
+        }
+    }
+
+    // 释放纪元早于所有活跃读者的快照；删除器在 retiredMutex_ 外执行。
+    // 删除器串行且按退役顺序执行，后退役的对象不会先于先退役的对象释放
+    // （例如插件库总在引用其代码的快照之后卸载）。其他线程正在回收或在删除器内
+    // 嵌套调用时直接返回，剩余对象留待下次回收
+    void reclaim() {
+        static thread_local bool reclaiming = false;
+        if (reclaiming || !reclaimMutex_.try_lock()) {
+            return;
+        }
+        std::lock_guard<std::mutex> serial(reclaimMutex_, std::adopt_lock);
+        reclaiming = true;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint64_t minActive = UINT64_MAX;
+        size_t count = highWater_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t epoch = records_[i].epoch.load(std::memory_order_acquire);
+            if (epoch != 0 && epoch < minActive) {
+                minActive = epoch;
+            }
+        }
+        std::vector<Retired> expired;
+        {
+            std::lock_guard<std::mutex> lock(retiredMutex_);
+            auto keep = retired_.begin();
+            for (auto it = retired_.begin(); it != retired_.end(); ++it) {
+                if (it->epoch < minActive) {
+                    expired.push_back(*it);
+                }
+                else {
+                    *keep++ = *it;
+                }
+            }
+            retired_.erase(keep, retired_.end());
+        }
+        for (auto& item : expired) {
+            item.deleter(item.ptr);
+        }
+        reclaiming = false;
+    }
+};
+
+#endif // RCU_H
@@ -0,0 +1,153 @@
+// include/Reactor.h
+#ifndef REACTOR_H
+#define REACTOR_H
+
+#include "Event.h"
+#include "Logger.h"
+#include "RingBuffer.h"
+#include "Stats.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// 插件回调的执行方式
+enum class ExecutionMode {
+    Inline,     // 在发布线程上直接调用（默认）
+    Reactor     // 在插件独占的反应器线程上调用
+};
+
+struct ExecutionPolicy {
+    ExecutionMode mode = ExecutionMode::Inline;
+    int cpu = -1;                                    // 反应器线程绑定的 CPU 核，-1 为不绑定
+    std::chrono::microseconds idleSpin{ 1000 };      // 队列空闲后忙等的时间，超过后转为阻塞等待
+    size_t queueCapacity = 65536;                    // 入站队列容量（向上取 2 的幂）
+
+    static ExecutionPolicy reactor(int cpu = -1, std::chrono::microseconds idleSpin = std::chrono::microseconds(1000)) {
+        ExecutionPolicy policy;
+        policy.mode = ExecutionMode::Reactor;
+        policy.cpu = cpu;
+        policy.idleSpin = idleSpin;
+        return policy;
+    }
+};
+
+// 反应器的运行统计；时间均为反应器线程上的累计值
+struct ReactorStats {
+    std::string plugin;
+    int cpu = -1;
+    bool pinned = false;            // 是否成功绑定到 cpu
+    uint64_t events = 0;            // 已执行的回调（批量回调计一次）
+    uint64_t dropped = 0;           // 反应器线程向自身投递而队列已满时丢弃的事件
+    uint64_t blockedPublishes = 0;  // 队列满而等待空位的发布
+    uint64_t sleeps = 0;            // 忙等预算耗尽后转入阻塞等待的次数
+    uint64_t queued = 0;            // 当前排队深度
+    double busySeconds = 0;         // 执行回调
+    double spinSeconds = 0;         // 空闲忙等：没有事件时消耗的 CPU 时间
+    double sleepSeconds = 0;        // 阻塞等待，不占用 CPU
+    LatencySummary queueLatency;    // 入队到回调开始的全部事件
+    LatencySummary wakeupLatency;   // 阻塞等待中被唤醒的事件：入队到回调开始
+
+    void print(std::ostream& out) const;
+};
+
+// 插件独占的反应器线程：绑定到配置的 CPU 核，忙等轮询入站队列，
+// 空闲超过 idleSpin 后才阻塞等待，以空闲时的 CPU 换取微秒级的反应时间。
+// 订阅回调经 wrap 换成替身，发布线程只把事件（保留负载）放入队列即返回，
+// 同一插件的全部回调在反应器线程上按入队顺序串行执行
+class Reactor {
+public:
+    // 订阅在反应器上的真实回调。关闭时释放回调本身，外壳保留到反应器销毁
+    struct Target;
+
+    // 回调抛出的异常写入 log（插件的日志通道）
+    Reactor(std::string name, const ExecutionPolicy& policy, ILogger& log);
+    ~Reactor();
+    Reactor(const Reactor&) = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    // 启动反应器线程；绑核失败只记录警告，线程照常运行
+    bool start();
+    // 执行完已入队的事件后结束线程；之后的投递被丢弃
+    void stop();
+    // 等待调用前已入队的事件执行完成；在反应器线程上调用时不等待
+    void flush();
+
+    // 接管回调并返回投递到反应器线程的替身；订阅注册成功后以订阅编号 bind。
+    // deadlines 非空且 deadline 非零时，每次执行记录从入队到回调返回的时间
+    PayloadCallback wrap(PayloadCallback callback, Target*& target,
+        DeadlineCounters* deadlines = nullptr, std::chrono::microseconds deadline = std::chrono::microseconds(0));
+    BatchCallback wrap(BatchCallback callback, Target*& target,
+        DeadlineCounters* deadlines = nullptr, std::chrono::microseconds deadline = std::chrono::microseconds(0));
+    void bind(Target* target, uint32_t subscriptionId);
+    // 订阅注册失败时释放已接管的回调
+    void abandon(Target* target);
+    // 丢弃订阅的积压事件并等待其正在执行的回调返回，之后不再调用该回调。
+    // 在反应器线程上（即回调内）调用时不等待
+    void close(uint32_t subscriptionId);
+    void closeAll();
+
+    // 当前线程是否为某个反应器线程
+    static bool onReactorThread();
+
+    ReactorStats stats() const;
+
+private:
+    struct Item {
+        Target* target = nullptr;
+        EventPayload payload;
+        std::vector<BatchEvent> batch;  // 批量回调的一段；负载均已保留
+        int64_t enqueueNs = 0;
+    };
+
+    const std::string name_;
+    const ExecutionPolicy policy_;
+    ILogger& log_;
+    MpscRingBuffer<Item> queue_;
+    // 执行完的批量缓冲由反应器线程放回，发布线程复用其容量，稳态下不再分配
+    MpscRingBuffer<std::vector<BatchEvent>> spareBatches_{ 64 };
+    std::thread thread_;
+    std::atomic<bool> running_{ false };
+    std::atomic<bool> stopping_{ false };
+    std::atomic<bool> pinned_{ false };
+
+    // 订阅编号 -> 回调；只在订阅与注销时加锁
+    std::mutex targetMutex_;
+    std::vector<std::unique_ptr<Target>> targets_;
+    std::unordered_map<uint32_t, Target*> bound_;
+    // 正在执行的回调，close 据此等待
+    std::atomic<Target*> current_{ nullptr };
+
+    alignas(64) std::atomic<uint64_t> enqueued_{ 0 };
+    std::atomic<uint64_t> dropped_{ 0 };
+    std::atomic<uint64_t> blockedPublishes_{ 0 };
+    // 以下仅由反应器线程写入
+    alignas(64) std::atomic<uint64_t> dequeued_{ 0 };
+    std::atomic<uint64_t> executed_{ 0 };
+    std::atomic<uint64_t> sleeps_{ 0 };
+    std::atomic<int64_t> busyNs_{ 0 };
+    std::atomic<int64_t> spinNs_{ 0 };
+    std::atomic<int64_t> sleepNs_{ 0 };
+    LatencyHistogram queueLatency_;
+    LatencyHistogram wakeupLatency_;
+    std::atomic<bool> sleeping_{ false };
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+
+    Target* adopt(std::unique_ptr<Target> target);
+    // 关闭回调并释放其捕获的状态（可能属于即将卸载的插件库）
+    void retire(Target* target);
+    void post(Item&& item);
+    void run();
+    void pin();
+    void execute(Item& item);
+    void wake();
+};
+
+#endif // REACTOR_H
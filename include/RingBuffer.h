@@ -0,0 +1,150 @@
+// include/RingBuffer.h
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// 有界无锁环形队列（Vyukov 序号槽算法）。
+// 多生产者安全；消费者可以是一个或多个线程。容量向上取整为 2 的幂。
+template <typename T>
+class MpscRingBuffer {
+public:
+    explicit MpscRingBuffer(size_t capacity) {
+        size_t rounded = 2;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        mask_ = rounded - 1;
+        cells_.reset(new Cell[rounded]);
+        for (size_t i = 0; i < rounded; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+    // 队列满时返回 false，不阻塞
+    bool tryPush(T&& value) {
+        Cell* cell;
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 队列空时返回 false
+    bool tryPop(T& value) {
+        Cell* cell;
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        value = std::move(cell->value);
+        cell->value = T();
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 近似深度，仅用于统计
+    size_t size() const {
+        size_t enqueued = enqueuePos_.load(std::memory_order_relaxed);
+        size_t dequeued = dequeuePos_.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> enqueuePos_{ 0 };
+    alignas(64) std::atomic<size_t> dequeuePos_{ 0 };
+};
+
+// 单线程使用的环形队列（由调用方加锁），容量按需翻倍且不回缩。
+// 与 std::deque 不同，稳态的入队出队不分配内存
+template <typename T>
+class RingQueue {
+public:
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+
+    T& front() { return slots_[head_]; }
+
+    void push_back(T&& value) {
+        if (size_ == slots_.size()) {
+            grow();
+        }
+        slots_[(head_ + size_) & (slots_.size() - 1)] = std::move(value);
+        ++size_;
+    }
+
+    void pop_front() {
+        slots_[head_] = T();
+        head_ = (head_ + 1) & (slots_.size() - 1);
+        --size_;
+    }
+
+    void clear() {
+        while (size_ != 0) {
+            pop_front();
+        }
+        head_ = 0;
+    }
+
+private:
+    std::vector<T> slots_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+
+    void grow() {
+        std::vector<T> next(slots_.empty() ? 16 : slots_.size() * 2);
+        for (size_t i = 0; i < size_; ++i) {
+            next[i] = std::move(slots_[(head_ + i) & (slots_.size() - 1)]);
+        }
+        slots_.swap(next);
+        head_ = 0;
+    }
+};
+
+#endif // RINGBUFFER_H
@@ -0,0 +1,177 @@
+// include/ShmRing.h
+#ifndef SHMRING_H
+#define SHMRING_H
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+// 放在共享内存中的环形队列头部。位置单调递增，数据区紧随其后；
+// 只使用无锁原子量，两个进程各自映射后即可通信（一端生产、一端消费）
+struct ShmRingHeader {
+    alignas(64) std::atomic<uint64_t> head;      // 消费者已读位置
+    alignas(64) std::atomic<uint64_t> tail;      // 生产者已写位置
+    alignas(64) std::atomic<uint32_t> signal;    // futex 字：有新数据且消费者在等待时递增
+    std::atomic<uint32_t> waiting;               // 消费者即将或正在 futex 等待
+    uint64_t capacity;                           // 数据区字节数（2 的幂）
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+    "Shared-memory rings require address-free lock-free atomics");
+
+// 共享内存上的单生产者/单消费者消息环：每条消息为 8 字节帧头加内容，按 8 字节对齐；
+// 尾部剩余空间放不下时写一条填充帧后从头开始，消息在数据区内总是连续的。
+// 消费者先自旋，再以 futex 睡眠；生产者只在消费者声明等待时才执行唤醒的系统调用
+class ShmRing {
+public:
+    struct Message {
+        const char* data = nullptr;
+        uint32_t size = 0;
+    };
+
+    ShmRing() = default;
+    ShmRing(ShmRingHeader* header, char* data) : header_(header), data_(data) {}
+
+    // 由创建共享内存的一方在任何一端使用前调用
+    static void initialize(ShmRingHeader* header, size_t capacity) {
+        header->head.store(0, std::memory_order_relaxed);
+        header->tail.store(0, std::memory_order_relaxed);
+        header->signal.store(0, std::memory_order_relaxed);
+        header->waiting.store(0, std::memory_order_relaxed);
+        header->capacity = capacity;
+    }
+
+    bool valid() const { return header_ != nullptr; }
+
+    // 生产者：写入由至多三段拼成的一条消息；空间不足时返回 false，不阻塞
+    bool tryWrite(const void* first, size_t firstSize, const void* second = nullptr, size_t secondSize = 0,
+        const void* third = nullptr, size_t thirdSize = 0) {
+        size_t frame = align(kFrameHeader + firstSize + secondSize + thirdSize);
+        uint64_t capacity = header_->capacity;
+        if (frame > capacity / 2) {
+            return false;
+        }
+        uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+        uint64_t head = header_->head.load(std::memory_order_acquire);
+        size_t offset = static_cast<size_t>(tail & (capacity - 1));
+        size_t padding = capacity - offset < frame ? capacity - offset : 0;
+        if (tail + padding + frame - head > capacity) {
+            return false;
+        }
+        if (padding != 0) {
+            writeFrame(offset, static_cast<uint32_t>(padding), kPadding);
+            tail += padding;
+            offset = 0;
+        }
+        writeFrame(offset, static_cast<uint32_t>(frame), static_cast<uint32_t>(firstSize + secondSize + thirdSize));
+        std::memcpy(data_ + offset + kFrameHeader, first, firstSize);
+        if (secondSize != 0) {
+            std::memcpy(data_ + offset + kFrameHeader + firstSize, second, secondSize);
+        }
+        if (thirdSize != 0) {
+            std::memcpy(data_ + offset + kFrameHeader + firstSize + secondSize, third, thirdSize);
+        }
+        // 与消费者的 “声明等待 -> 复查位置” 构成 Dekker 式同步
+        header_->tail.store(tail + frame, std::memory_order_seq_cst);
+        if (header_->waiting.load(std::memory_order_seq_cst) != 0) {
+            header_->signal.fetch_add(1, std::memory_order_seq_cst);
+            futexWake(&header_->signal);
+        }
+        return true;
+    }
+
+    // 消费者：取得下一条消息（不移动读位置），没有消息时返回 false
+    bool peek(Message& message) {
+        uint64_t head = header_->head.load(std::memory_order_relaxed);
+        for (;;) {
+            if (head == header_->tail.load(std::memory_order_acquire)) {
+                return false;
+            }
+            size_t offset = static_cast<size_t>(head & (header_->capacity - 1));
+            uint32_t frame;
+            uint32_t size;
+            std::memcpy(&frame, data_ + offset, sizeof(frame));
+            std::memcpy(&size, data_ + offset + sizeof(frame), sizeof(size));
+            if (size != kPadding) {
+                message.data = data_ + offset + kFrameHeader;
+                message.size = size;
+                current_ = frame;
+                return true;
+            }
+            head += frame;
+            header_->head.store(head, std::memory_order_release);
+        }
+    }
+
+    // 消费者：释放 peek 取得的消息
+    void pop() {
+        header_->head.store(header_->head.load(std::memory_order_relaxed) + current_, std::memory_order_release);
+    }
+
+    bool empty() const {
+        return header_->head.load(std::memory_order_relaxed) == header_->tail.load(std::memory_order_acquire);
+    }
+
+    // 消费者：等待新消息，先自旋 spin，再 futex 睡眠至多 timeout；返回是否有消息
+    bool wait(std::chrono::nanoseconds spin, std::chrono::nanoseconds timeout) {
+        auto spinUntil = std::chrono::steady_clock::now() + spin;
+        while (empty()) {
+            if (std::chrono::steady_clock::now() >= spinUntil) {
+                header_->waiting.store(1, std::memory_order_seq_cst);
+                uint32_t signal = header_->signal.load(std::memory_order_seq_cst);
+                if (empty()) {
+                    futexWait(&header_->signal, signal, timeout);
+                }
+                header_->waiting.store(0, std::memory_order_relaxed);
+                return !empty();
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+private:
+    static constexpr size_t kFrameHeader = 8;
+    static constexpr uint32_t kPadding = UINT32_MAX;
+
+    ShmRingHeader* header_ = nullptr;
+    char* data_ = nullptr;
+    uint32_t current_ = 0;
+
+    static size_t align(size_t size) { return (size + 7) & ~size_t(7); }
+
+    void writeFrame(size_t offset, uint32_t frame, uint32_t size) {
+        std::memcpy(data_ + offset, &frame, sizeof(frame));
+        std::memcpy(data_ + offset + sizeof(frame), &size, sizeof(size));
+    }
+
+    // 跨进程的 futex 不能使用 FUTEX_PRIVATE_FLAG
+    static void futexWait(std::atomic<uint32_t>* word, uint32_t expected, std::chrono::nanoseconds timeout) {
+#if defined(__linux__)
+        struct timespec relative;
+        relative.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+        relative.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &relative, nullptr, 0);
+#else
+        std::this_thread::sleep_for(std::min(timeout, std::chrono::nanoseconds(100000)));
+#endif
+    }
+
+    static void futexWake(std::atomic<uint32_t>* word) {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#endif
+    }
+};
+
+#endif // SHMRING_H
@@ -0,0 +1,243 @@
+// include/Stats.h
+#ifndef STATS_H
+#define STATS_H
+
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// 编译期开关：为 0 时 EventManager 不包含任何统计代码与成员（由 CMake 选项 MOTS_ENABLE_STATS 设置）
+#ifndef MOTS_ENABLE_STATS
+#define MOTS_ENABLE_STATS 1
+#endif
+
+// 单写者计数器自增：只有所属线程写入，读者（快照）并发读取，无需原子读改写
+inline void bumpCounter(std::atomic<uint64_t>& counter, uint64_t delta = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+inline int64_t statsNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// HDR 风格的对数-线性延迟直方图（纳秒）：每个 2 的幂区间再分 8 个子桶，相对误差约 12.5%，
+// 上限约 68 秒。单写者，快照可与写入并发
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 3;
+    static constexpr int kMaxBits = 36;
+    static constexpr size_t kBuckets = static_cast<size_t>(kMaxBits - kSubBucketBits + 1) << kSubBucketBits;
+
+    void record(int64_t ns) {
+        uint64_t value = ns > 0 ? static_cast<uint64_t>(ns) : 0;
+        bumpCounter(buckets_[bucketOf(value)]);
+        bumpCounter(sumNs_, value);
+        if (value > maxNs_.load(std::memory_order_relaxed)) {
+            maxNs_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    static size_t bucketOf(uint64_t value) {
+        constexpr uint64_t kSubBuckets = uint64_t{ 1 } << kSubBucketBits;
+        if (value < kSubBuckets) {
+            return static_cast<size_t>(value);
+        }
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        int msb = static_cast<int>(index);
+#else
+        int msb = 63 - __builtin_clzll(value);
+#endif
+        if (msb >= kMaxBits) {
+            return kBuckets - 1;
+        }
+        int shift = msb - kSubBucketBits;
+        return static_cast<size_t>((shift + 1) << kSubBucketBits) + static_cast<size_t>((value >> shift) - kSubBuckets);
+    }
+
+    // 桶内最大值，用于百分位估计
+    static uint64_t upperBoundOf(size_t bucket) {
+        constexpr uint64_t kSubBuckets = uint64_t{ 1 } << kSubBucketBits;
+        if (bucket < kSubBuckets) {
+            return bucket;
+        }
+        int shift = static_cast<int>(bucket >> kSubBucketBits) - 1;
+        uint64_t sub = (bucket & (kSubBuckets - 1)) + kSubBuckets;
+        return ((sub + 1) << shift) - 1;
+    }
+
+private:
+    friend struct HistogramData;
+
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+    std::atomic<uint64_t> sumNs_{ 0 };
+    std::atomic<uint64_t> maxNs_{ 0 };
+};
+
+// 延迟摘要（微秒）
+struct LatencySummary {
+    uint64_t count = 0;
+    double meanUs = 0;
+    double p50Us = 0;
+    double p99Us = 0;
+    double p999Us = 0;
+    double maxUs = 0;
+};
+
+// 合并后的直方图，用于跨线程、跨订阅汇总
+struct HistogramData {
+    std::vector<uint64_t> counts = std::vector<uint64_t>(LatencyHistogram::kBuckets, 0);
+    uint64_t sumNs = 0;
+    uint64_t maxNs = 0;
+
+    void merge(const LatencyHistogram& histogram);
+    void merge(const HistogramData& other);
+    LatencySummary summary() const;
+};
+
+struct EventStatsEntry {
+    std::string event;
+    uint64_t triggers = 0;
+    double triggersPerSecond = 0;
+    LatencySummary dispatch;     // 一次触发内全部回调的总耗时
+};
+
+struct PluginStatsEntry {
+    std::string plugin;
+    uint64_t exceptions = 0;
+    LatencySummary callbacks;    // 插件全部订阅回调的耗时
+};
+
+struct SubscriptionStatsEntry {
+    uint32_t subscriptionId = 0;
+    std::string plugin;
+    std::string event;
+    uint64_t exceptions = 0;
+    LatencySummary callback;
+};
+
+// 统计快照：计数自 EventManager 创建起累计，速率按 elapsedSeconds 计算
+struct StatsSnapshot {
+    bool enabled = false;
+    double elapsedSeconds = 0;
+    std::vector<EventStatsEntry> events;
+    std::vector<PluginStatsEntry> plugins;
+    std::vector<SubscriptionStatsEntry> subscriptions;
+    LatencySummary writerLockWait;  // 注册/注销等写者等待 EventManager 锁的时间
+
+    void print(std::ostream& out) const;
+};
+
+#if MOTS_ENABLE_STATS
+
+// 每个 EventManager 一个统计记录器。每个线程写自己的分片，互不竞争；
+// 分片表只在首次出现新的事件/订阅时加锁扩容，快照时加锁读取后合并
+class StatsRecorder {
+public:
+    struct EventCounters {
+        std::atomic<uint64_t> triggers{ 0 };
+        LatencyHistogram dispatch;
+    };
+
+    struct SubscriptionCounters {
+        uint32_t pluginId;
+        uint32_t eventId;
+        std::atomic<uint64_t> exceptions{ 0 };
+        LatencyHistogram callback;
+    };
+
+    struct Shard {
+        std::mutex growth;  // 仅扩容与快照时使用
+        std::vector<std::unique_ptr<EventCounters>> events;
+        std::vector<std::unique_ptr<SubscriptionCounters>> subscriptions;
+        LatencyHistogram lockWait;
+        std::atomic<bool> released{ false };  // 所属线程已退出，可交给新线程继续累计
+
+        // 记录一次分发：triggers 为其中的事件数（批量发布时大于 1），ns 为全部回调耗时
+        void recordEvent(uint32_t eventId, uint64_t triggers, int64_t ns) {
+            if (eventId >= events.size() || !events[eventId]) {
+                std::lock_guard<std::mutex> lock(growth);
+                if (eventId >= events.size()) {
+                    events.resize(eventId + 1);
+                }
+                events[eventId] = std::make_unique<EventCounters>();
+            }
+            EventCounters& counters = *events[eventId];
+            bumpCounter(counters.triggers, triggers);
+            counters.dispatch.record(ns);
+        }
+
+        void recordCallback(uint32_t subscriptionId, uint32_t pluginId, uint32_t eventId, int64_t ns, bool threw) {
+            if (subscriptionId >= subscriptions.size() || !subscriptions[subscriptionId]) {
+                std::lock_guard<std::mutex> lock(growth);
+                if (subscriptionId >= subscriptions.size()) {
+                    subscriptions.resize(subscriptionId + 1);
+                }
+                subscriptions[subscriptionId] = std::make_unique<SubscriptionCounters>();
+                subscriptions[subscriptionId]->pluginId = pluginId;
+                subscriptions[subscriptionId]->eventId = eventId;
+            }
+            SubscriptionCounters& counters = *subscriptions[subscriptionId];
+            counters.callback.record(ns);
+            if (threw) {
+                bumpCounter(counters.exceptions);
+            }
+        }
+    };
+
+    StatsRecorder();
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+    // 线程缓存：线程退出（或清理残留条目）时交还其中的分片
+    struct ThreadShards {
+        std::vector<std::pair<uint64_t, std::shared_ptr<Shard>>> entries;
+        ~ThreadShards() { release(); }
+        void release() {
+            for (auto& entry : entries) {
+                entry.second->released.store(true, std::memory_order_release);
+            }
+            entries.clear();
+        }
+    };
+
+    // 当前线程的分片；首次访问时登记（优先复用已退出线程交还的分片）
+    Shard& local() {
+        thread_local ThreadShards cache;
+        for (const auto& [serial, shard] : cache.entries) {
+            if (serial == serial_) {
+                return *shard;
+            }
+        }
+        return attach(cache);
+    }
+
+    // 合并全部分片；名称按事件/插件标识下标提供，缺失时以标识代替
+    StatsSnapshot snapshot(const std::vector<std::string>& eventNames, const std::vector<std::string>& pluginNames);
+
+private:
+    const uint64_t serial_;  // 进程内唯一，区分线程缓存中已销毁记录器的残留条目
+    const int64_t startNs_;
+    std::atomic<bool> enabled_{ true };
+    std::mutex shardsMutex_;
+    std::vector<std::shared_ptr<Shard>> shards_;
+
+    Shard& attach(ThreadShards& cache);
+};
+
+#endif // MOTS_ENABLE_STATS
+
+#endif // STATS_H
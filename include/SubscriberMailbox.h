@@ -0,0 +1,140 @@
+// include/SubscriberMailbox.h
+#ifndef SUBSCRIBERMAILBOX_H
+#define SUBSCRIBERMAILBOX_H
+
+#include "AsyncEventBus.h"
+#include "EventPayload.h"
+#include "Logger.h"
+#include "RingBuffer.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// 订阅者的投递策略
+enum class DeliveryPolicy {
+    Direct,     // 在分发线程上直接调用（默认，无队列）
+    DropNewest, // 有界队列，满时丢弃新事件并计数
+    Conflate,   // 每个合并键只保留最新一条（如每个品种的最新报价）
+    Block       // 有界队列，满时阻塞发布者
+};
+
+struct SubscriptionOptions {
+    DeliveryPolicy policy = DeliveryPolicy::Direct;
+    size_t capacity = 1024;     // 队列容量；Conflate 下为最多保留的键数
+    // Conflate 使用的合并键；为空时所有事件共用一个键（只保留最新一条）
+    std::function<uint64_t(const EventPayload&)> conflationKey;
+    // 同一事件的订阅者中的执行次序；带投递策略时还决定邮箱在分发分片上排空的优先级
+    PriorityClass priority = PriorityClass::Normal;
+    // 从发布到回调返回的时限，超过计入插件的截止时间统计；为 0 时不检查。
+    // 带投递策略时从进入邮箱起算，反应器插件从进入反应器队列起算
+    std::chrono::microseconds deadline{ 0 };
+};
+
+// 单个插件的投递统计
+struct DeliveryStats {
+    uint64_t delivered = 0;
+    uint64_t dropped = 0;
+    uint64_t conflated = 0;
+    uint64_t blockedPublishes = 0;
+    uint64_t queued = 0;
+};
+
+// 异步总线未运行时邮箱的排空线程：按投递顺序串行执行任务，首次投递时才启动线程。
+// 保证总线停止期间投递策略仍然生效，发布者不会在自己的线程上执行慢消费者的回调
+class MailboxDrainer {
+public:
+    MailboxDrainer() = default;
+    // 执行完已投递的任务后停止线程
+    ~MailboxDrainer();
+    MailboxDrainer(const MailboxDrainer&) = delete;
+    MailboxDrainer& operator=(const MailboxDrainer&) = delete;
+
+    void post(std::shared_ptr<AsyncTask> task);
+
+    // 等待调用前已投递的任务全部执行完成；在排空线程上调用时直接返回
+    void flush();
+
+    // 当前线程是否为某个排空线程
+    static bool onDrainerThread();
+
+private:
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::condition_variable done_;
+    RingQueue<std::shared_ptr<AsyncTask>> tasks_;
+    uint64_t posted_ = 0;
+    uint64_t completed_ = 0;
+    bool stopping_ = false;
+    std::thread thread_;
+
+    void run();
+};
+
+// 订阅者邮箱：挂在 EventManager 订阅者列表之上的有界缓冲。
+// 发布者只向邮箱投递，邮箱在异步总线的分片上串行排空（总线未运行时在 MailboxDrainer 的线程上排空），
+// 因此慢消费者只会积压自己的邮箱，不会拖慢其他订阅者。
+// Block 策略的发布者在分发路径的读临界区内等待空位：注销订阅时须先 close() 邮箱唤醒它们，再等待在途回调
+class SubscriberMailbox : public AsyncTask, public std::enable_shared_from_this<SubscriberMailbox> {
+public:
+    // 回调抛出的异常写入 log（订阅插件的日志通道）；deadlines 非空且设置了截止时间时记录每次投递
+    SubscriberMailbox(PayloadCallback callback, SubscriptionOptions options, AsyncEventBus& bus, MailboxDrainer& drainer,
+        ILogger& log, DeadlineCounters* deadlines = nullptr);
+
+    // 由 EventManager 分发路径调用
+    void offer(const EventPayload& payload);
+
+    // 丢弃积压事件并等待正在执行的回调返回，之后不再调用回调
+    void close();
+
+    // 等待积压事件全部投递完成（不关闭邮箱）；在分发线程或排空线程上调用时直接返回
+    void drain();
+
+    DeliveryStats stats() const;
+
+    // AsyncTask：排空邮箱
+    void run() override;
+
+private:
+    // 每次排空最多处理的事件数，超过后重新投递以让出分片
+    static constexpr int kDrainBatch = 64;
+
+    // 积压的事件及其进入邮箱的时刻（仅设置了截止时间时记录）
+    struct Pending {
+        EventPayload payload;
+        int64_t offeredNs = 0;
+    };
+
+    PayloadCallback callback_;
+    SubscriptionOptions options_;
+    AsyncEventBus& bus_;
+    MailboxDrainer& fallback_;   // 总线未运行时的排空线程
+    ILogger& log_;
+    DeadlineCounters* deadlines_;
+    int64_t deadlineNs_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable notFull_;
+    std::condition_variable idle_;
+    // 队列与合并表在稳态下复用已有内存，投递不分配
+    RingQueue<Pending> queue_;
+    RingQueue<uint64_t> conflationOrder_;
+    std::unordered_map<uint64_t, Pending> latest_;
+    std::vector<std::unordered_map<uint64_t, Pending>::node_type> spareNodes_;
+    bool scheduled_ = false;
+    bool draining_ = false;
+    bool closed_ = false;
+    std::thread::id drainer_;
+    DeliveryStats stats_;
+
+    size_t pendingLocked() const;
+    bool popLocked(Pending& pending);
+    void schedule();
+};
+
+#endif // SUBSCRIBERMAILBOX_H
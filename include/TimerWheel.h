@@ -0,0 +1,131 @@
+// include/TimerWheel.h
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include "Event.h"
+#include "Stats.h"
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+// 定时器标识：低 32 位为节点下标，高 32 位为代数，节点复用后旧标识失效
+struct TimerId {
+    uint64_t value = 0;
+
+    bool valid() const { return value != 0; }
+    bool operator==(const TimerId& other) const { return value == other.value; }
+    bool operator!=(const TimerId& other) const { return value != other.value; }
+};
+
+// 定时器到期时作为事件负载（EventPayload::view）交给订阅者
+struct TimerEvent {
+    TimerId timer;
+    uint64_t fireCount = 0;   // 本定时器第几次触发（从 1 开始）
+    int64_t deadlineNs = 0;   // 计划触发时间（steady_clock）
+    int64_t firedNs = 0;      // 实际触发时间
+};
+
+struct TimerStats {
+    uint64_t scheduled = 0;
+    uint64_t fired = 0;
+    uint64_t cancelled = 0;
+    uint64_t missedPeriods = 0;  // 周期定时器因处理落后而跳过的周期数
+    size_t pending = 0;
+    LatencySummary jitter;        // 实际触发时间减计划时间
+};
+
+// 分层时间轮：4 层、每层 256 个槽，刻度默认 100 微秒，可表示约 5 天内的到期时间（更远的逐级重排）。
+// 定时器节点放在池中并以下标串成侵入式双向链表，schedule/cancel 为 O(1)，不随定时器数量变化。
+// 后台线程借助每层的占用位图直接睡到下一个非空槽或下一次降级，空闲时不按刻度空转。
+// 到期的定时器以事件形式经 EventManager 分发（在锁外），按所属插件登记以便卸载时批量取消
+class TimerWheel {
+public:
+    explicit TimerWheel(EventManager& eventManager, std::chrono::nanoseconds tick = std::chrono::microseconds(100));
+    ~TimerWheel();
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // delay 后触发 eventId；period 非零时之后每隔 period 触发一次。标识无效时返回无效定时器。
+    // instance 区分同一插件的不同实例（热重载期间新旧实例并存），0 表示不属于某个实例
+    TimerId schedule(PluginId owner, EventId eventId, std::chrono::nanoseconds delay,
+        std::chrono::nanoseconds period = std::chrono::nanoseconds::zero(), uint32_t instance = 0);
+
+    // 取消定时器；已被取出正在分发的一次触发仍会送达
+    bool cancel(TimerId timer);
+    // 仅当定时器属于 owner 的 instance 实例时取消
+    bool cancel(TimerId timer, PluginId owner, uint32_t instance);
+
+    // 取消插件的全部定时器（instance 非 0 时只取消该实例的），返回取消的数量
+    size_t cancelPluginTimers(PluginId owner, uint32_t instance = 0);
+
+    size_t pending() const;
+    // 定时器仍在等待触发（周期定时器在取消前一直为 true）
+    bool isPending(TimerId timer) const;
+    TimerStats stats() const;
+
+private:
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 8;
+    static constexpr uint32_t kSlots = 1u << kSlotBits;
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    struct Node {
+        uint64_t expiryTick = 0;
+        int64_t deadlineNs = 0;
+        int64_t periodNs = 0;
+        uint64_t fireCount = 0;
+        EventId eventId;
+        PluginId owner;
+        uint32_t instance = 0;
+        uint32_t generation = 1;
+        uint32_t prev = kNil;        // 槽内链表
+        uint32_t next = kNil;
+        uint32_t ownerPrev = kNil;   // 同一插件的定时器链表
+        uint32_t ownerNext = kNil;
+        uint16_t slot = 0;           // level * kSlots + 槽号
+        bool active = false;
+    };
+
+    EventManager& eventManager_;
+    const int64_t tickNs_;
+    const int64_t startNs_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::vector<Node> nodes_;
+    uint32_t freeList_ = kNil;
+    std::array<uint32_t, kLevels * kSlots> heads_;
+    std::array<std::array<uint64_t, kSlots / 64>, kLevels> occupied_{};
+    std::unordered_map<uint32_t, uint32_t> ownerHeads_;  // 插件标识 -> 链表头
+    uint64_t currentTick_ = 0;
+    uint64_t wakeTick_ = UINT64_MAX;  // 后台线程计划醒来的刻度
+    size_t pending_ = 0;
+    bool stopping_ = false;
+    std::thread thread_;
+
+    // 以下计数只由持锁者修改
+    uint64_t scheduled_ = 0;
+    uint64_t fired_ = 0;
+    uint64_t cancelled_ = 0;
+    uint64_t missedPeriods_ = 0;
+    LatencyHistogram jitter_;  // 只由后台线程写入
+
+    uint64_t tickOf(int64_t timeNs) const;
+    int64_t timeOf(uint64_t tick) const { return startNs_ + static_cast<int64_t>(tick) * tickNs_; }
+    uint32_t allocateLocked();
+    void releaseLocked(uint32_t index);
+    void insertLocked(uint32_t index);
+    void unlinkLocked(uint32_t index);
+    uint32_t detachSlotLocked(uint32_t slot);
+    Node* findLocked(TimerId timer);
+    uint64_t nextEventTickLocked() const;
+    void advanceLocked(uint64_t targetTick, int64_t nowNs, std::vector<TimerEvent>& expired, std::vector<EventId>& events);
+    void run();
+};
+
+#endif // TIMERWHEEL_H
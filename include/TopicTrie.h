@@ -0,0 +1,171 @@
+// include/TopicTrie.h
+#ifndef TOPICTRIE_H
+#define TOPICTRIE_H
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// 分层主题：以 '.' 分隔的层级，如 md.XNAS.AAPL.quote。
+// 订阅模式中 '*' 匹配恰好一层，'#' 匹配零或多层（如 md.XNAS.*.quote、md.#）
+namespace topic {
+
+inline bool isWildcard(std::string_view level) {
+    return level == "*" || level == "#";
+}
+
+inline std::vector<std::string_view> split(std::string_view topic) {
+    std::vector<std::string_view> levels;
+    for (;;) {
+        size_t dot = topic.find('.');
+        levels.push_back(topic.substr(0, dot));
+        if (dot == std::string_view::npos) {
+            return levels;
+        }
+        topic.remove_prefix(dot + 1);
+    }
+}
+
+// 名称中含有 '*' 或 '#' 层级即为订阅模式
+inline bool isPattern(std::string_view name) {
+    for (;;) {
+        size_t dot = name.find('.');
+        if (isWildcard(name.substr(0, dot))) {
+            return true;
+        }
+        if (dot == std::string_view::npos) {
+            return false;
+        }
+        name.remove_prefix(dot + 1);
+    }
+}
+
+} // namespace topic
+
+// 按层级组织的前缀树，每个节点保存以该路径结尾的值。
+// 同一结构有两种用法：存放订阅模式时以具体主题查询匹配的模式（matchTopic），
+// 存放具体主题时以模式查询匹配的主题（matchPattern）。只在写者一侧使用，不做并发保护
+template <typename Value>
+class TopicTrie {
+public:
+    void insert(std::string_view key, Value value) {
+        Node* node = &root_;
+        for (std::string_view level : topic::split(key)) {
+            auto& child = node->children[std::string(level)];
+            if (!child) {
+                child = std::make_unique<Node>();
+            }
+            node = child.get();
+        }
+        node->values.push_back(value);
+    }
+
+    // 删除一个值，并回收不再有值的分支
+    bool erase(std::string_view key, Value value) {
+        std::vector<std::string_view> levels = topic::split(key);
+        return erase(root_, levels, 0, value);
+    }
+
+    // 存放模式时：收集与具体主题匹配的全部值（去重、升序）
+    void matchTopic(std::string_view key, std::vector<Value>& out) const {
+        std::vector<std::string_view> levels = topic::split(key);
+        size_t begin = out.size();
+        matchTopic(root_, levels, 0, out);
+        normalize(out, begin);
+    }
+
+    // 存放具体主题时：收集与模式匹配的全部值（去重、升序）
+    void matchPattern(std::string_view pattern, std::vector<Value>& out) const {
+        std::vector<std::string_view> levels = topic::split(pattern);
+        size_t begin = out.size();
+        matchPattern(root_, levels, 0, out);
+        normalize(out, begin);
+    }
+
+    bool empty() const { return root_.children.empty() && root_.values.empty(); }
+
+private:
+    struct Node {
+        std::unordered_map<std::string, std::unique_ptr<Node>> children;
+        std::vector<Value> values;
+    };
+
+    Node root_;
+
+    static const Node* child(const Node& node, std::string_view level) {
+        auto it = node.children.find(std::string(level));
+        return it != node.children.end() ? it->second.get() : nullptr;
+    }
+
+    static bool erase(Node& node, const std::vector<std::string_view>& levels, size_t i, Value value) {
+        if (i == levels.size()) {
+            auto it = std::find(node.values.begin(), node.values.end(), value);
+            if (it == node.values.end()) {
+                return false;
+            }
+            node.values.erase(it);
+            return true;
+        }
+        auto it = node.children.find(std::string(levels[i]));
+        if (it == node.children.end() || !erase(*it->second, levels, i + 1, value)) {
+            return false;
+        }
+        if (it->second->values.empty() && it->second->children.empty()) {
+            node.children.erase(it);
+        }
+        return true;
+    }
+
+    // 节点为模式的层级，levels 为具体主题
+    static void matchTopic(const Node& node, const std::vector<std::string_view>& levels, size_t i, std::vector<Value>& out) {
+        if (const Node* hash = child(node, "#")) {
+            // '#' 可吞掉剩余的任意层（含零层）
+            for (size_t j = i; j <= levels.size(); ++j) {
+                matchTopic(*hash, levels, j, out);
+            }
+        }
+        if (i == levels.size()) {
+            out.insert(out.end(), node.values.begin(), node.values.end());
+            return;
+        }
+        if (const Node* exact = child(node, levels[i])) {
+            matchTopic(*exact, levels, i + 1, out);
+        }
+        if (const Node* star = child(node, "*")) {
+            matchTopic(*star, levels, i + 1, out);
+        }
+    }
+
+    // 节点为具体主题的层级，levels 为模式
+    static void matchPattern(const Node& node, const std::vector<std::string_view>& levels, size_t i, std::vector<Value>& out) {
+        if (i == levels.size()) {
+            out.insert(out.end(), node.values.begin(), node.values.end());
+            return;
+        }
+        if (levels[i] == "#") {
+            matchPattern(node, levels, i + 1, out);
+            for (const auto& [level, next] : node.children) {
+                matchPattern(*next, levels, i, out);
+            }
+        }
+        else if (levels[i] == "*") {
+            for (const auto& [level, next] : node.children) {
+                matchPattern(*next, levels, i + 1, out);
+            }
+        }
+        else if (const Node* exact = child(node, levels[i])) {
+            matchPattern(*exact, levels, i + 1, out);
+        }
+    }
+
+    // 含多个 '#' 的模式可能经不同路径重复匹配
+    static void normalize(std::vector<Value>& out, size_t begin) {
+        std::sort(out.begin() + begin, out.end());
+        out.erase(std::unique(out.begin() + begin, out.end()), out.end());
+    }
+};
+
+#endif // TOPICTRIE_H
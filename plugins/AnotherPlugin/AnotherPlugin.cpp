@@ -1,41 +1,37 @@
 // plugins/AnotherPlugin/AnotherPlugin.cpp
 #include "../../include/IPlugin.h"
-#include <iostream>
-#include <unordered_map>
+#include "../../include/IPluginHost.h"
+#include "../../include/Logger.h"
 
 class AnotherPlugin : public IPlugin {
 public:
     AnotherPlugin() {}
     ~AnotherPlugin() override {}
 
-    bool initialize() override {
-        std::cout << "AnotherPlugin initialized." << std::endl;
+    // 经宿主在共享总线上订阅 AnotherPlugin.Ping，并把同一负载发布为 AnotherPlugin.Pong
+    bool initialize(IPluginHost& host) override {
+        host_ = &host;
+        pongId_ = host.resolveEvent("AnotherPlugin.Pong");
+        host.subscribe(host.resolveEvent("AnotherPlugin.Ping"), [this](const EventPayload& payload) {
+            host_->publish(pongId_, payload);
+        });
+        host.logger().logf(LogLevel::Info, "AnotherPlugin initialized.");
         return true;
     }
 
     void shutdown() override {
-        std::cout << "AnotherPlugin shutdown." << std::endl;
+        if (host_) {
+            host_->logger().logf(LogLevel::Info, "AnotherPlugin shutdown.");
+        }
     }
 
     std::string getName() const override {
         return "AnotherPlugin";
     }
 
-    void registerEvent(const std::string& eventName, EventCallback callback) override {
-        callbacks_[eventName].emplace_back(callback);
-    }
-
-    void triggerEvent(const std::string& eventName, const std::string& eventData) override {
-        auto it = callbacks_.find(eventName);
-        if (it != callbacks_.end()) {
-            for (auto& cb : it->second) {
-                cb(eventData);
-            }
-        }
-    }
-
 private:
-    std::unordered_map<std::string, std::vector<EventCallback>> callbacks_;
+    IPluginHost* host_ = nullptr;  // 宿主服务，含本插件的日志通道
+    EventId pongId_;
 };
 
 // 使用导出宏确保函数被正确导出
@@ -1,41 +1,35 @@
 // plugins/DuplicateNamePlugin/DuplicateNamePlugin.cpp
 #include "../../include/IPlugin.h"
-#include <iostream>
-#include <unordered_map>
+#include "../../include/Logger.h"
 
 class DuplicateNamePlugin : public IPlugin {
 public:
     DuplicateNamePlugin() {}
     ~DuplicateNamePlugin() override {}
 
+    void setLogger(ILogger* logger) override {
+        logger_ = logger;
+    }
+
     bool initialize() override {
-        std::cout << "DuplicateNamePlugin initialized." << std::endl;
+        if (logger_) {
+            logger_->logf(LogLevel::Info, "DuplicateNamePlugin initialized.");
+        }
         return true;
     }
 
     void shutdown() override {
-        std::cout << "DuplicateNamePlugin shutdown." << std::endl;
+        if (logger_) {
+            logger_->logf(LogLevel::Info, "DuplicateNamePlugin shutdown.");
+        }
     }
 
     std::string getName() const override {
         return "SamplePlugin"; // 同名于 SamplePlugin
     }
 
-    void registerEvent(const std::string& eventName, EventCallback callback) override {
-        callbacks_[eventName].emplace_back(callback);
-    }
-
-    void triggerEvent(const std::string& eventName, const std::string& eventData) override {
-        auto it = callbacks_.find(eventName);
-        if (it != callbacks_.end()) {
-            for (auto& cb : it->second) {
-                cb(eventData);
-            }
-        }
-    }
-
 private:
-    std::unordered_map<std::string, std::vector<EventCallback>> callbacks_;
+    ILogger* logger_ = nullptr;  // 宿主提供的日志通道
 };
 
 // 使用导出宏确保函数被正确导出
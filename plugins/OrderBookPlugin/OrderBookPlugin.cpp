@@ -0,0 +1,168 @@
+// plugins/OrderBookPlugin/OrderBookPlugin.cpp
+#include "../../include/IPlugin.h"
+#include "../../include/IPluginHost.h"
+#include "../../include/Logger.h"
+#include "../../include/OrderBook.h"
+#include <sstream>
+
+// 由 md.order.add / md.order.modify / md.order.cancel 维护各品种的 L2/L3 订单簿，
+// 买卖一档变化时在总线上发布 md.book.top（负载为 TopOfBook，按引用传递，仅在回调期间有效）。
+// 订单簿为单写者：应按 ExecutionPolicy::reactor 加载，或保证行情只由一个线程同步发布
+class OrderBookPlugin : public IPlugin {
+public:
+    OrderBookPlugin() {}
+    ~OrderBookPlugin() override {}
+
+    bool initialize(IPluginHost& host) override {
+        host_ = &host;
+        topId_ = host.resolveEvent(kTopOfBookEvent);
+        // 批量订阅：一段连续的更新处理完后，每个变化的品种只发布一次一档
+        bool subscribed = host.subscribeBatch(host.resolveEvent(kOrderAddEvent), [this](const EventBatchView& batch) {
+            for (const BatchEvent& event : batch) {
+                if (const OrderAdd* order = payloadOf<OrderAdd>(event.payload)) {
+                    touch(books_.add(*order));
+                }
+            }
+            publishTops();
+        }).valid();
+        subscribed = subscribed && host.subscribeBatch(host.resolveEvent(kOrderModifyEvent), [this](const EventBatchView& batch) {
+            for (const BatchEvent& event : batch) {
+                if (const OrderModify* order = payloadOf<OrderModify>(event.payload)) {
+                    touch(books_.modify(*order));
+                }
+            }
+            publishTops();
+        }).valid();
+        subscribed = subscribed && host.subscribeBatch(host.resolveEvent(kOrderCancelEvent), [this](const EventBatchView& batch) {
+            for (const BatchEvent& event : batch) {
+                if (const OrderCancel* order = payloadOf<OrderCancel>(event.payload)) {
+                    touch(books_.cancel(*order));
+                }
+            }
+            publishTops();
+        }).valid();
+        if (!subscribed) {
+            host.logger().logf(LogLevel::Error, "OrderBookPlugin failed to subscribe to order events.");
+            return false;
+        }
+        host.logger().logf(LogLevel::Info, "OrderBookPlugin initialized.");
+        return true;
+    }
+
+    void shutdown() override {
+        if (host_) {
+            OrderBookStats stats = books_.stats();
+            host_->logger().logf(LogLevel::Info,
+                "OrderBookPlugin shutdown: %llu adds, %llu modifies, %llu cancels, %llu rejected, %zu live orders.",
+                static_cast<unsigned long long>(stats.adds), static_cast<unsigned long long>(stats.modifies),
+                static_cast<unsigned long long>(stats.cancels), static_cast<unsigned long long>(stats.rejected), stats.orders);
+        }
+    }
+
+    std::string getName() const override {
+        return "OrderBookPlugin";
+    }
+
+    // 热重载：按价格、时间优先导出全部委托，每行 "品种 方向 订单号 价格 数量"，
+    // 新实例按行重放即可恢复相同的队列顺序
+    std::string exportState() const override {
+        std::ostringstream out;
+        std::vector<BookOrder> orders;
+        for (uint32_t instrument = 0; instrument < books_.instrumentBound(); ++instrument) {
+            const OrderBook* book = books_.book(instrument);
+            if (!book) {
+                continue;
+            }
+            for (Side side : { Side::Buy, Side::Sell }) {
+                book->orders(side, PriceLadder::kMaxLevels, orders);
+                for (const BookOrder& order : orders) {
+                    out << instrument << ' ' << static_cast<int>(side) << ' ' << order.orderId << ' '
+                        << order.price << ' ' << order.quantity << '\n';
+                }
+            }
+        }
+        return out.str();
+    }
+
+    bool importState(const std::string& state) override {
+        std::istringstream in(state);
+        OrderAdd order{};
+        int side = 0;
+        while (in >> order.instrument >> side >> order.orderId >> order.price >> order.quantity) {
+            order.side = side == 0 ? Side::Buy : Side::Sell;
+            OrderBook* book = books_.add(order);
+            if (!book) {
+                return false;
+            }
+            // 订阅者已收到旧实例发布的一档，这里只记录，不重复发布
+            remember(book->top());
+        }
+        if (!in.eof()) {
+            return false;
+        }
+        if (host_) {
+            host_->logger().logf(LogLevel::Info, "OrderBookPlugin reloaded with %zu orders.", books_.stats().orders);
+        }
+        return true;
+    }
+
+private:
+    IPluginHost* host_ = nullptr;
+    EventId topId_;
+    OrderBookSet books_;
+    std::vector<TopOfBook> published_;  // 按品种编号索引，最近一次发布的一档
+    std::vector<uint32_t> dirty_;       // 本段更新涉及的品种
+    std::vector<uint8_t> marked_;       // 品种是否已在 dirty_ 中
+    uint64_t mismatched_ = 0;           // 负载类型不符而忽略的事件数
+
+    template <typename T>
+    const T* payloadOf(const EventPayload& payload) {
+        const T* value = payload.as<T>();
+        if (!value && mismatched_++ == 0) {
+            host_->logger().logf(LogLevel::Warn, "OrderBookPlugin ignored an order event with an unexpected payload type.");
+        }
+        return value;
+    }
+
+    void touch(const OrderBook* book) {
+        if (!book) {
+            return;
+        }
+        uint32_t instrument = book->instrument();
+        if (instrument >= marked_.size()) {
+            marked_.resize(instrument + 1, 0);
+        }
+        if (!marked_[instrument]) {
+            marked_[instrument] = 1;
+            dirty_.push_back(instrument);
+        }
+    }
+
+    // 记录一档，返回它与上次发布的是否不同
+    bool remember(const TopOfBook& top) {
+        if (top.instrument >= published_.size()) {
+            published_.resize(top.instrument + 1);
+        }
+        TopOfBook& last = published_[top.instrument];
+        bool changed = top.bidPrice != last.bidPrice || top.bidQuantity != last.bidQuantity || top.bidOrders != last.bidOrders ||
+            top.askPrice != last.askPrice || top.askQuantity != last.askQuantity || top.askOrders != last.askOrders;
+        last = top;
+        return changed;
+    }
+
+    void publishTops() {
+        for (uint32_t instrument : dirty_) {
+            marked_[instrument] = 0;
+            TopOfBook top = books_.book(instrument)->top();
+            if (remember(top)) {
+                host_->publish(topId_, EventPayload::view(top));
+            }
+        }
+        dirty_.clear();
+    }
+};
+
+// 使用导出宏确保函数被正确导出
+extern "C" PLUGIN_API IPlugin* CreatePlugin() {
+    return new OrderBookPlugin();
+}
@@ -1,41 +1,53 @@
 // plugins/SamplePlugin/SamplePlugin.cpp
 #include "../../include/IPlugin.h"
-#include <iostream>
-#include <unordered_map>
+#include "../../include/Logger.h"
 
 class SamplePlugin : public IPlugin {
 public:
     SamplePlugin() {}
     ~SamplePlugin() override {}
 
+    void setLogger(ILogger* logger) override {
+        logger_ = logger;
+    }
+
     bool initialize() override {
-        std::cout << "SamplePlugin initialized." << std::endl;
+        if (logger_) {
+            logger_->logf(LogLevel::Info, "SamplePlugin initialized.");
+        }
         return true;
     }
 
     void shutdown() override {
-        std::cout << "SamplePlugin shutdown." << std::endl;
+        if (logger_) {
+            logger_->logf(LogLevel::Info, "SamplePlugin shutdown.");
+        }
     }
 
     std::string getName() const override {
         return "SamplePlugin";
     }
 
-    void registerEvent(const std::string& eventName, EventCallback callback) override {
-        callbacks_[eventName].emplace_back(callback);
+    std::string exportState() const override {
+        return std::to_string(generation_);
     }
 
-    void triggerEvent(const std::string& eventName, const std::string& eventData) override {
-        auto it = callbacks_.find(eventName);
-        if (it != callbacks_.end()) {
-            for (auto& cb : it->second) {
-                cb(eventData);
-            }
+    bool importState(const std::string& state) override {
+        try {
+            generation_ = std::stoul(state) + 1;
         }
+        catch (const std::exception&) {
+            return false;
+        }
+        if (logger_) {
+            logger_->logf(LogLevel::Info, "SamplePlugin reloaded, generation %lu.", generation_);
+        }
+        return true;
     }
 
 private:
-    std::unordered_map<std::string, std::vector<EventCallback>> callbacks_;
+    unsigned long generation_ = 0;  // 热重载次数
+    ILogger* logger_ = nullptr;  // 宿主提供的日志通道
 };
 
 // 使用导出宏确保函数被正确导出
@@ -0,0 +1,292 @@
+// src/AsyncEventBus.cpp
+#include "AsyncEventBus.h"
+#include <chrono>
+
+namespace {
+
+// 分发线程在进入休眠前自旋检查队列的次数
+constexpr int kIdleSpins = 2000;
+
+thread_local const void* currentDispatcher = nullptr;
+
+} // namespace
+
+AsyncEventBus::AsyncEventBus(EventManager& eventManager)
+    : eventManager_(eventManager) {}
+
+AsyncEventBus::~AsyncEventBus() {
+    stop();
+    for (auto& segment : lanes_) {
+        delete[] segment.load(std::memory_order_relaxed);
+    }
+}
+
+bool AsyncEventBus::start(size_t dispatcherThreads, size_t queueCapacity) {
+    LogChannel& log = eventManager_.logger().channel("AsyncEventBus");
+    if (running()) {
+        log.logf(LogLevel::Error, "Async event bus is already running.");
+        return false;
+    }
+    if (dispatcherThreads == 0 || queueCapacity == 0) {
+        log.logf(LogLevel::Error, "Async event bus needs at least one dispatcher thread and a non-empty queue.");
+        return false;
+    }
+
+    stopping_.store(false, std::memory_order_relaxed);
+    dispatchers_.clear();
+    for (size_t i = 0; i < dispatcherThreads; ++i) {
+        dispatchers_.push_back(std::make_unique<Dispatcher>(queueCapacity));
+    }
+    running_.store(true, std::memory_order_release);
+    for (auto& dispatcher : dispatchers_) {
+        Dispatcher* raw = dispatcher.get();
+        raw->thread = std::thread([this, raw] { run(*raw); });
+    }
+    return true;
+}
+
+void AsyncEventBus::stop() {
+    if (!running_.exchange(false, std::memory_order_seq_cst)) {
+        return;
+    }
+    stopping_.store(true, std::memory_order_release);
+    for (auto& dispatcher : dispatchers_) {
+        wake(*dispatcher);
+    }
+    for (auto& dispatcher : dispatchers_) {
+        if (dispatcher->thread.joinable()) {
+            dispatcher->thread.join();
+        }
+    }
+    // 已通过运行检查的发布者可能仍在入队（阻塞发布还在等待空位）：边排空边等待它们离开，
+    // 确认无在途发布者后再排空一次
+    AsyncEvent event;
+    for (;;) {
+        bool quiet = inFlight_.load(std::memory_order_seq_cst) == 0;
+        for (auto& dispatcher : dispatchers_) {
+            while (dispatcher->tryPop(event)) {
+                deliver(*dispatcher, event);
+            }
+        }
+        if (quiet) {
+            break;
+        }
+        std::this_thread::yield();
+    }
+}
+
+bool AsyncEventBus::publish(EventId eventId, const EventPayload& payload) {
+    InFlight admitted(*this);
+    if (!admitted) {
+        return false;
+    }
+    LaneState* state = laneStateOf(eventId);
+    PriorityClass priority = acquireLane(state, eventManager_.eventPriority(eventId));
+    if (!enqueue(dispatcherForThisThread(), priority, AsyncEvent{ eventId, payload.retain(), nowNs(), {}, 0 }, false)) {
+        releaseLane(state);
+        return false;
+    }
+    return true;
+}
+
+bool AsyncEventBus::publish(EventId eventId, const EventPayload& payload, uint64_t partitionKey, bool block) {
+    InFlight admitted(*this);
+    if (!admitted) {
+        return false;
+    }
+    Dispatcher& dispatcher = dispatcherForKey(partitionKey);
+    uint32_t keyLane = keyLaneOf(partitionKey);
+    LaneState* state = &keyLanes_[keyLane];
+    PriorityClass priority = acquireLane(state, eventManager_.eventPriority(eventId));
+    if (!enqueue(dispatcher, priority, AsyncEvent{ eventId, payload.retain(), nowNs(), {}, keyLane + 1 }, block)) {
+        releaseLane(state);
+        return false;
+    }
+    return true;
+}
+
+bool AsyncEventBus::post(std::shared_ptr<AsyncTask> task, uint64_t partitionKey, PriorityClass priority) {
+    InFlight admitted(*this);
+    if (!admitted) {
+        return false;
+    }
+    return enqueue(dispatcherForKey(partitionKey), priority, AsyncEvent{ EventId{}, EventPayload(), nowNs(), std::move(task), 0 }, true);
+}
+
+std::vector<ShardStats> AsyncEventBus::shardStats() const {
+    std::vector<ShardStats> result;
+    for (size_t i = 0; i < dispatchers_.size(); ++i) {
+        const Dispatcher& dispatcher = *dispatchers_[i];
+        ShardStats stats;
+        stats.shard = i;
+        stats.enqueued = dispatcher.enqueued.load(std::memory_order_relaxed);
+        stats.dispatched = dispatcher.dispatched.load(std::memory_order_relaxed);
+        stats.depth = dispatcher.depth();
+        stats.maxDepth = dispatcher.maxDepth.load(std::memory_order_relaxed);
+        stats.dropped = dispatcher.dropped.load(std::memory_order_relaxed);
+        if (stats.dispatched > 0) {
+            stats.meanQueueLatencyUs = static_cast<double>(dispatcher.totalLatencyNs.load(std::memory_order_relaxed))
+                / static_cast<double>(stats.dispatched) / 1000.0;
+        }
+        stats.maxQueueLatencyUs = static_cast<double>(dispatcher.maxLatencyNs.load(std::memory_order_relaxed)) / 1000.0;
+        result.push_back(stats);
+    }
+    return result;
+}
+
+void AsyncEventBus::flush() {
+    for (auto& dispatcher : dispatchers_) {
+        if (currentDispatcher == dispatcher.get()) {
+            continue;
+        }
+        uint64_t target = dispatcher->enqueued.load(std::memory_order_acquire);
+        while (dispatcher->dispatched.load(std::memory_order_acquire) < target) {
+            wake(*dispatcher);
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool AsyncEventBus::onDispatcherThread() {
+    return currentDispatcher != nullptr;
+}
+
+AsyncEventBus::LaneState* AsyncEventBus::laneStateOf(EventId eventId) {
+    if (!eventId.valid() || (eventId.value >> kSegmentBits) >= kMaxSegments) {
+        return nullptr;
+    }
+    std::atomic<LaneState*>& slot = lanes_[eventId.value >> kSegmentBits];
+    LaneState* segment = slot.load(std::memory_order_acquire);
+    if (!segment) {
+        std::lock_guard<std::mutex> lock(lanesMutex_);
+        segment = slot.load(std::memory_order_relaxed);
+        if (!segment) {
+            segment = new LaneState[kSlotsPerSegment];
+            slot.store(segment, std::memory_order_release);
+        }
+    }
+    return &segment[eventId.value & (kSlotsPerSegment - 1)];
+}
+
+uint32_t AsyncEventBus::keyLaneOf(uint64_t partitionKey) {
+    return static_cast<uint32_t>((partitionKey * 0x9E3779B97F4A7C15ull) >> (64 - kKeyLaneBits));
+}
+
+PriorityClass AsyncEventBus::acquireLane(LaneState* state, PriorityClass priority) {
+    if (!state) {
+        return priority;
+    }
+    // 只有没有待分发的副本时才切换队列；之后的发布在计数归零前都沿用同一队列
+    uint64_t word = state->word.load(std::memory_order_acquire);
+    uint64_t next;
+    do {
+        uint64_t lane = static_cast<uint32_t>(word) == 0 ? static_cast<uint64_t>(priority) : word >> 32;
+        next = (lane << 32) | (static_cast<uint32_t>(word) + 1);
+    } while (!state->word.compare_exchange_weak(word, next, std::memory_order_acq_rel, std::memory_order_acquire));
+    return static_cast<PriorityClass>(next >> 32);
+}
+
+void AsyncEventBus::releaseLane(LaneState* state) {
+    if (state) {
+        state->word.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+bool AsyncEventBus::enqueue(Dispatcher& dispatcher, PriorityClass priority, AsyncEvent&& event, bool block) {
+    MpscRingBuffer<AsyncEvent>& lane = dispatcher.lane(priority);
+    while (!lane.tryPush(std::move(event))) {
+        // 分发线程等待自己的队列出现空位会自锁；越过排队的事件直接分发又会打乱顺序
+        if (!block || currentDispatcher == &dispatcher) {
+            if (!event.task) {
+                dispatcher.dropped.fetch_add(1, std::memory_order_relaxed);
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+            return false;
+        }
+        wake(dispatcher);
+        std::this_thread::yield();
+    }
+    dispatcher.enqueued.fetch_add(1, std::memory_order_seq_cst);
+    // 按队列自身的位置计算：已出队但尚未计入 dispatched 的在途事件不占队列容量
+    uint64_t depth = dispatcher.depth();
+    uint64_t maxDepth = dispatcher.maxDepth.load(std::memory_order_relaxed);
+    while (depth > maxDepth &&
+        !dispatcher.maxDepth.compare_exchange_weak(maxDepth, depth, std::memory_order_relaxed)) {
+    }
+    if (dispatcher.sleeping.load(std::memory_order_seq_cst)) {
+        wake(dispatcher);
+    }
+    return true;
+}
+
+void AsyncEventBus::deliver(Dispatcher& dispatcher, AsyncEvent& event) {
+    int64_t latency = nowNs() - event.enqueueTimeNs;
+    dispatcher.totalLatencyNs.store(dispatcher.totalLatencyNs.load(std::memory_order_relaxed) + latency,
+        std::memory_order_relaxed);
+    if (latency > dispatcher.maxLatencyNs.load(std::memory_order_relaxed)) {
+        dispatcher.maxLatencyNs.store(latency, std::memory_order_relaxed);
+    }
+    if (event.task) {
+        event.task->run();
+        event.task.reset();
+    }
+    else {
+        // 截止时间从入队时刻起算，排队等待计入
+        eventManager_.deliverEvent(event.eventId, event.payload, event.enqueueTimeNs);
+        event.payload = EventPayload();
+        releaseLane(event.keyLane ? &keyLanes_[event.keyLane - 1] : laneStateOf(event.eventId));
+    }
+    dispatcher.dispatched.fetch_add(1, std::memory_order_release);
+}
+
+void AsyncEventBus::run(Dispatcher& dispatcher) {
+    currentDispatcher = &dispatcher;
+    AsyncEvent event;
+    int idle = 0;
+    for (;;) {
+        if (dispatcher.tryPop(event)) {
+            deliver(dispatcher, event);
+            idle = 0;
+            continue;
+        }
+        if (stopping_.load(std::memory_order_acquire)) {
+            break;
+        }
+        if (++idle < kIdleSpins) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // 先声明即将休眠，再复查队列，避免丢失发布者的唤醒
+        std::unique_lock<std::mutex> lock(dispatcher.wakeMutex);
+        dispatcher.sleeping.store(true, std::memory_order_seq_cst);
+        bool empty = dispatcher.enqueued.load(std::memory_order_seq_cst) ==
+            dispatcher.dispatched.load(std::memory_order_relaxed);
+        if (empty && !stopping_.load(std::memory_order_acquire)) {
+            dispatcher.wakeCondition.wait_for(lock, std::chrono::milliseconds(10));
+        }
+        dispatcher.sleeping.store(false, std::memory_order_relaxed);
+        idle = 0;
+    }
+    currentDispatcher = nullptr;
+}
+
+void AsyncEventBus::wake(Dispatcher& dispatcher) {
+    std::lock_guard<std::mutex> lock(dispatcher.wakeMutex);
+    dispatcher.wakeCondition.notify_one();
+}
+
+AsyncEventBus::Dispatcher& AsyncEventBus::dispatcherForThisThread() {
+    // 每个发布线程首次发布时固定到一个队列，之后不再竞争共享计数器
+    thread_local uint32_t publisherIndex = UINT32_MAX;
+    if (publisherIndex == UINT32_MAX) {
+        publisherIndex = nextPublisher_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return *dispatchers_[publisherIndex % dispatchers_.size()];
+}
+
+AsyncEventBus::Dispatcher& AsyncEventBus::dispatcherForKey(uint64_t partitionKey) {
+    // 对键再做一次混合，避免低位分布不均
+    uint64_t mixed = partitionKey * 0x9E3779B97F4A7C15ull;
+    return *dispatchers_[(mixed >> 32) % dispatchers_.size()];
+}
@@ -1,4 +1,540 @@
 // src/Event.cpp
 #include "Event.h"
+#include <algorithm>
+#include <array>
+#include <type_traits>
 
-// 所有成员函数已在 `Event.h` 中定义，无需在此处实现。
\ No newline at end of file
+// 触发路径定义在 `Event.h` 中以便内联；此处实现写者一侧（注册、注销、名称解析）。
+
+namespace {
+
+// 按优先级类别插入：排在同类别已有订阅之后，保持注册顺序
+template <typename Info>
+void insertByPriority(std::vector<Info>& infos, std::vector<SubscriptionQos>& qos, Info info, const SubscriptionQos& entry) {
+    auto at = std::upper_bound(qos.begin(), qos.end(), entry.priority,
+        [](PriorityClass priority, const SubscriptionQos& existing) { return priority < existing.priority; });
+    infos.insert(infos.begin() + (at - qos.begin()), std::move(info));
+    qos.insert(at, entry);
+}
+
+// 通配订阅代数的全局来源：不同的事件管理器（含先后位于同一地址的）不会得到相同的代数
+std::atomic<uint64_t> nextPatternGeneration{ 1 };
+
+// 已确认不匹配任何通配订阅的主题，按名称哈希直接映射，记录确认时的通配订阅代数
+struct UnmatchedTopic {
+    uint64_t generation = 0;
+    std::string name;
+};
+constexpr size_t kUnmatchedTopics = 256;
+
+} // namespace
+
+const char* priorityClassName(PriorityClass priority) {
+    switch (priority) {
+    case PriorityClass::Critical:
+        return "critical";
+    case PriorityClass::High:
+        return "high";
+    case PriorityClass::Normal:
+        return "normal";
+    case PriorityClass::BestEffort:
+        return "best-effort";
+    }
+    return "unknown";
+}
+
+EventManager::EventManager(Logger& logger)
+    : patternGeneration_(nextPatternGeneration.fetch_add(1, std::memory_order_relaxed)),
+      logger_(logger), log_(logger.channel("EventManager")) {
+    for (auto& segment : segments_) {
+        segment.store(nullptr, std::memory_order_relaxed);
+    }
+    names_.store(new NameTable(64), std::memory_order_release);
+}
+
+EventManager::~EventManager() {
+    uint32_t count = eventCount_.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < count; ++i) {
+        EventSlot& slot = slotLocked(EventId{ i });
+        delete slot.subscribers.load(std::memory_order_relaxed);
+    }
+    for (auto& segment : segments_) {
+        delete[] segment.load(std::memory_order_relaxed);
+    }
+    delete names_.load(std::memory_order_relaxed);
+    delete pluginIndex_.load(std::memory_order_relaxed);
+}
+
+EventId EventManager::resolveEvent(const std::string& eventName) {
+    auto lock = lockWriters();
+    return internLocked(eventName);
+}
+
+EventId EventManager::internTopic(const std::string& topicName) {
+    // 新增通配订阅之前，缓存中的主题仍不匹配；移除通配订阅不会使不匹配的主题变为匹配
+    thread_local std::array<UnmatchedTopic, kUnmatchedTopics> unmatched;
+    UnmatchedTopic& cached = unmatched[std::hash<std::string>{}(topicName) & (kUnmatchedTopics - 1)];
+    if (cached.generation == patternGeneration_.load(std::memory_order_acquire) && cached.name == topicName) {
+        return EventId{};
+    }
+    auto lock = lockWriters();
+    EventId existing = findEventUnguarded(topicName);
+    if (existing.valid() || patterns_.empty() || topic::isPattern(topicName)) {
+        return existing;
+    }
+    std::vector<uint32_t> matched;
+    patternTrie_.matchTopic(topicName, matched);
+    if (!matched.empty()) {
+        return internLocked(topicName);
+    }
+    cached.generation = patternGeneration_.load(std::memory_order_relaxed);
+    cached.name = topicName;
+    return EventId{};
+}
+
+std::string EventManager::eventName(EventId eventId) {
+    auto lock = lockWriters();
+    return eventId.value < nameEntries_.size() ? nameEntries_[eventId.value]->name : std::string();
+}
+
+PluginId EventManager::resolvePlugin(const std::string& pluginName) {
+    auto lock = lockWriters();
+    auto it = pluginIds_.find(pluginName);
+    if (it != pluginIds_.end()) {
+        return it->second;
+    }
+    PluginId pluginId{ static_cast<uint32_t>(pluginIds_.size()) };
+    pluginIds_.emplace(pluginName, pluginId);
+    pluginSubscriptions_.emplace_back();
+
+    auto slot = std::make_unique<PluginSlot>();
+    slot->log = &logger_.channel(pluginName);
+    const std::vector<PluginSlot*>* previous = pluginIndex_.load(std::memory_order_relaxed);
+    auto* index = previous ? new std::vector<PluginSlot*>(*previous) : new std::vector<PluginSlot*>();
+    index->push_back(slot.get());
+    pluginSlots_.push_back(std::move(slot));
+    pluginIndex_.store(index, std::memory_order_release);
+    if (previous) {
+        EpochDomain::instance().retire(previous);
+    }
+    return pluginId;
+}
+
+template <typename Info>
+void EventManager::subscribePatternLocked(EventId pattern, Info info, const SubscriptionQos& qos) {
+    uint32_t subscriptionId = info.subscriptionId;
+    PatternSubscription& subscription = patterns_[subscriptionId];
+    subscription.pattern = pattern;
+    if constexpr (std::is_same_v<Info, CallbackInfo>) {
+        subscription.entry.callbacks.push_back(std::move(info));
+        subscription.entry.qos.push_back(qos);
+    }
+    else {
+        subscription.entry.batchCallbacks.push_back(std::move(info));
+        subscription.entry.batchQos.push_back(qos);
+    }
+    // 首个通配订阅出现时才建立具体主题的前缀树，只用精确订阅时登记主题没有额外开销
+    if (!topicsIndexed_) {
+        for (const auto& entry : nameEntries_) {
+            if (!entry->pattern) {
+                topicTrie_.insert(entry->name, entry->id.value);
+            }
+        }
+        topicsIndexed_ = true;
+    }
+    // 复制进已登记的匹配主题；之后登记的主题由 internLocked 补齐
+    const std::string& name = nameEntries_[pattern.value]->name;
+    patternTrie_.insert(name, subscriptionId);
+    std::vector<uint32_t> topics;
+    topicTrie_.matchPattern(name, topics);
+    for (uint32_t topic : topics) {
+        appendLocked(slotLocked(EventId{ topic }), subscription.entry);
+    }
+    patternSubscriptions_.fetch_add(1, std::memory_order_relaxed);
+    patternGeneration_.store(nextPatternGeneration.fetch_add(1, std::memory_order_relaxed), std::memory_order_release);
+}
+
+void EventManager::removePatternLocked(uint32_t subscriptionId, PluginId pluginId, std::vector<uint32_t>* topics) {
+    auto it = patterns_.find(subscriptionId);
+    if (it == patterns_.end()) {
+        return;
+    }
+    const std::string& name = nameEntries_[it->second.pattern.value]->name;
+    patternTrie_.erase(name, subscriptionId);
+    std::vector<uint32_t> matched;
+    topicTrie_.matchPattern(name, matched);
+    if (topics) {
+        topics->insert(topics->end(), matched.begin(), matched.end());
+    }
+    else {
+        for (uint32_t topic : matched) {
+            removeLocked(slotLocked(EventId{ topic }), pluginId, subscriptionId);
+        }
+    }
+    patterns_.erase(it);
+    patternSubscriptions_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+template <typename Info, typename Callback>
+SubscriptionToken EventManager::subscribeLocked(PluginId pluginId, EventId eventId, Callback callback, const SubscriptionQos& qos,
+    uint32_t subscriptionId) {
+    if (eventId.value >= eventCount_.load(std::memory_order_relaxed) ||
+        pluginId.value >= pluginSubscriptions_.size()) {
+        return SubscriptionToken{};
+    }
+    if (subscriptionId == 0) {
+        subscriptionId = nextSubscriptionId_++;
+    }
+    Info info{ pluginId, subscriptionId, std::move(callback) };
+    if (nameEntries_[eventId.value]->pattern) {
+        subscribePatternLocked(eventId, std::move(info), qos);
+    }
+    else {
+        appendLocked(slotLocked(eventId), std::move(info), qos);
+    }
+    pluginSubscriptions_[pluginId.value].emplace(subscriptionId, eventId);
+    return SubscriptionToken{ eventId, pluginId, subscriptionId };
+}
+
+SubscriptionToken EventManager::registerEvent(PluginId pluginId, EventId eventId, PayloadCallback callback,
+    const SubscriptionQos& qos) {
+    auto lock = lockWriters();
+    return subscribeLocked<CallbackInfo>(pluginId, eventId, std::move(callback), qos);
+}
+
+SubscriptionToken EventManager::registerBatchEvent(PluginId pluginId, EventId eventId, BatchCallback callback,
+    const SubscriptionQos& qos) {
+    auto lock = lockWriters();
+    return subscribeLocked<BatchCallbackInfo>(pluginId, eventId, std::move(callback), qos);
+}
+
+bool EventManager::unsubscribe(const SubscriptionToken& token) {
+    auto lock = lockWriters();
+    return unsubscribeLocked(token);
+}
+
+SubscriptionToken EventManager::reserveSubscription(PluginId pluginId, EventId eventId) {
+    auto lock = lockWriters();
+    if (eventId.value >= eventCount_.load(std::memory_order_relaxed) ||
+        pluginId.value >= pluginSubscriptions_.size()) {
+        return SubscriptionToken{};
+    }
+    return SubscriptionToken{ eventId, pluginId, nextSubscriptionId_++ };
+}
+
+std::vector<SubscriptionToken> EventManager::replaceSubscriptions(PluginId pluginId,
+    const std::vector<SubscriptionToken>& removed, const std::vector<StagedSubscription>& added) {
+    auto lock = lockWriters();
+    staging_ = true;
+    for (const auto& token : removed) {
+        unsubscribeLocked(token);
+    }
+    std::vector<SubscriptionToken> tokens;
+    tokens.reserve(added.size());
+    for (const auto& staged : added) {
+        if (staged.batchCallback) {
+            tokens.push_back(subscribeLocked<BatchCallbackInfo>(pluginId, staged.eventId, staged.batchCallback, staged.qos,
+                staged.subscriptionId));
+        }
+        else {
+            tokens.push_back(subscribeLocked<CallbackInfo>(pluginId, staged.eventId, staged.callback, staged.qos,
+                staged.subscriptionId));
+        }
+    }
+    staging_ = false;
+    for (auto& [slot, next] : staged_) {
+        publishLocked(*slot, std::move(next));
+    }
+    staged_.clear();
+    return tokens;
+}
+
+bool EventManager::unsubscribeLocked(const SubscriptionToken& token) {
+    if (!token.valid() || token.pluginId.value >= pluginSubscriptions_.size()) {
+        return false;
+    }
+    auto& subscriptions = pluginSubscriptions_[token.pluginId.value];
+    auto it = subscriptions.find(token.subscriptionId);
+    if (it == subscriptions.end() || it->second != token.eventId) {
+        return false;
+    }
+    subscriptions.erase(it);
+    if (nameEntries_[token.eventId.value]->pattern) {
+        removePatternLocked(token.subscriptionId, token.pluginId, nullptr);
+    }
+    else {
+        removeLocked(slotLocked(token.eventId), token.pluginId, token.subscriptionId);
+    }
+    return true;
+}
+
+void EventManager::unregisterPluginCallbacks(const std::string& pluginName) {
+    PluginId pluginId;
+    {
+        auto lock = lockWriters();
+        auto it = pluginIds_.find(pluginName);
+        if (it == pluginIds_.end()) {
+            return;
+        }
+        pluginId = it->second;
+    }
+    unregisterPluginCallbacks(pluginId);
+}
+
+void EventManager::unregisterPluginCallbacks(PluginId pluginId) {
+    auto lock = lockWriters();
+    if (pluginId.value >= pluginSubscriptions_.size()) {
+        return;
+    }
+    auto& subscriptions = pluginSubscriptions_[pluginId.value];
+    // 每个受影响的事件只重建一次快照
+    std::vector<uint32_t> events;
+    events.reserve(subscriptions.size());
+    for (const auto& [subscriptionId, eventId] : subscriptions) {
+        if (nameEntries_[eventId.value]->pattern) {
+            removePatternLocked(subscriptionId, pluginId, &events);
+        }
+        else {
+            events.push_back(eventId.value);
+        }
+    }
+    std::sort(events.begin(), events.end());
+    events.erase(std::unique(events.begin(), events.end()), events.end());
+    for (uint32_t eventIndex : events) {
+        removeLocked(slotLocked(EventId{ eventIndex }), pluginId, 0);
+    }
+    subscriptions.clear();
+}
+
+size_t EventManager::subscriptionCount(PluginId pluginId) {
+    auto lock = lockWriters();
+    return pluginId.value < pluginSubscriptions_.size() ? pluginSubscriptions_[pluginId.value].size() : 0;
+}
+
+DeadlineCounters* EventManager::deadlineCounters(PluginId pluginId) {
+    auto lock = lockWriters();
+    return pluginId.value < pluginSlots_.size() ? &pluginSlots_[pluginId.value]->deadlines : nullptr;
+}
+
+DeadlineStats EventManager::deadlineStats(PluginId pluginId) {
+    DeadlineCounters* counters = deadlineCounters(pluginId);
+    return counters ? counters->snapshot() : DeadlineStats{};
+}
+
+std::unique_lock<std::mutex> EventManager::lockWriters() {
+#if MOTS_ENABLE_STATS
+    if (stats_.enabled()) {
+        int64_t start = statsNowNs();
+        std::unique_lock<std::mutex> lock(mutex_);
+        stats_.local().lockWait.record(statsNowNs() - start);
+        return lock;
+    }
+#endif
+    return std::unique_lock<std::mutex>(mutex_);
+}
+
+StatsSnapshot EventManager::statsSnapshot() {
+#if MOTS_ENABLE_STATS
+    std::vector<std::string> eventNames;
+    std::vector<std::string> pluginNames;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        eventNames.reserve(nameEntries_.size());
+        for (const auto& entry : nameEntries_) {
+            eventNames.push_back(entry->name);
+        }
+        pluginNames.resize(pluginIds_.size());
+        for (const auto& [name, pluginId] : pluginIds_) {
+            pluginNames[pluginId.value] = name;
+        }
+    }
+    return stats_.snapshot(eventNames, pluginNames);
+#else
+    return StatsSnapshot{};
+#endif
+}
+
+void EventManager::setStatsEnabled(bool enabled) {
+#if MOTS_ENABLE_STATS
+    stats_.setEnabled(enabled);
+#else
+    (void)enabled;
+#endif
+}
+
+void EventManager::synchronize() {
+    EpochDomain::instance().synchronize();
+}
+
+EventId EventManager::internLocked(const std::string& eventName) {
+    EventId existing = findEventUnguarded(eventName);
+    if (existing.valid()) {
+        return existing;
+    }
+
+    uint32_t index = eventCount_.load(std::memory_order_relaxed);
+    uint32_t segmentIndex = index >> kSegmentBits;
+    if (segmentIndex >= kMaxSegments) {
+        log_.logf(LogLevel::Error, "Event table is full, cannot register: %s", eventName.c_str());
+        return EventId{};
+    }
+    if (!segments_[segmentIndex].load(std::memory_order_relaxed)) {
+        segments_[segmentIndex].store(new EventSlot[kSlotsPerSegment], std::memory_order_release);
+    }
+
+    bool pattern = topic::isPattern(eventName);
+    auto entry = std::make_unique<NameEntry>(NameEntry{ eventName, std::hash<std::string>{}(eventName), EventId{ index }, pattern });
+    insertNameLocked(entry.get());
+    nameEntries_.push_back(std::move(entry));
+
+    // 新的具体主题：经模式前缀树一次补齐全部匹配的通配订阅
+    if (!pattern && topicsIndexed_) {
+        topicTrie_.insert(eventName, index);
+        std::vector<uint32_t> matched;
+        if (!patterns_.empty()) {
+            patternTrie_.matchTopic(eventName, matched);
+        }
+        if (!matched.empty()) {
+            SubscriberList entries;
+            for (uint32_t subscriptionId : matched) {
+                const SubscriberList& entry = patterns_.at(subscriptionId).entry;
+                entries.callbacks.insert(entries.callbacks.end(), entry.callbacks.begin(), entry.callbacks.end());
+                entries.qos.insert(entries.qos.end(), entry.qos.begin(), entry.qos.end());
+                entries.batchCallbacks.insert(entries.batchCallbacks.end(), entry.batchCallbacks.begin(), entry.batchCallbacks.end());
+                entries.batchQos.insert(entries.batchQos.end(), entry.batchQos.begin(), entry.batchQos.end());
+            }
+            appendLocked(slotLocked(EventId{ index }), entries);
+        }
+    }
+
+    // 槽位就绪后再发布事件数量
+    eventCount_.store(index + 1, std::memory_order_release);
+    return EventId{ index };
+}
+
+EventManager::EventSlot& EventManager::slotLocked(EventId eventId) {
+    EventSlot* segment = segments_[eventId.value >> kSegmentBits].load(std::memory_order_relaxed);
+    return segment[eventId.value & (kSlotsPerSegment - 1)];
+}
+
+void EventManager::appendLocked(EventSlot& slot, CallbackInfo info, const SubscriptionQos& qos) {
+    const SubscriberList* current = currentLocked(slot);
+    auto next = std::make_unique<SubscriberList>(current ? *current : SubscriberList{});
+    insertByPriority(next->callbacks, next->qos, std::move(info), qos);
+    publishLocked(slot, std::move(next));
+}
+
+void EventManager::appendLocked(EventSlot& slot, BatchCallbackInfo info, const SubscriptionQos& qos) {
+    const SubscriberList* current = currentLocked(slot);
+    auto next = std::make_unique<SubscriberList>(current ? *current : SubscriberList{});
+    insertByPriority(next->batchCallbacks, next->batchQos, std::move(info), qos);
+    publishLocked(slot, std::move(next));
+}
+
+void EventManager::appendLocked(EventSlot& slot, const SubscriberList& entries) {
+    const SubscriberList* current = currentLocked(slot);
+    auto next = std::make_unique<SubscriberList>(current ? *current : SubscriberList{});
+    for (size_t i = 0; i < entries.callbacks.size(); ++i) {
+        insertByPriority(next->callbacks, next->qos, entries.callbacks[i], entries.qos[i]);
+    }
+    for (size_t i = 0; i < entries.batchCallbacks.size(); ++i) {
+        insertByPriority(next->batchCallbacks, next->batchQos, entries.batchCallbacks[i], entries.batchQos[i]);
+    }
+    publishLocked(slot, std::move(next));
+}
+
+// subscriptionId 为 0 时移除该插件在此事件上的全部订阅
+void EventManager::removeLocked(EventSlot& slot, PluginId pluginId, uint32_t subscriptionId) {
+    const SubscriberList* current = currentLocked(slot);
+    if (!current) {
+        return;
+    }
+    auto matches = [&](const auto& info) {
+        return info.pluginId == pluginId && (subscriptionId == 0 || info.subscriptionId == subscriptionId);
+    };
+    auto next = std::make_unique<SubscriberList>();
+    next->callbacks.reserve(current->callbacks.size());
+    next->qos.reserve(current->qos.size());
+    for (size_t i = 0; i < current->callbacks.size(); ++i) {
+        if (!matches(current->callbacks[i])) {
+            next->callbacks.push_back(current->callbacks[i]);
+            next->qos.push_back(current->qos[i]);
+        }
+    }
+    for (size_t i = 0; i < current->batchCallbacks.size(); ++i) {
+        if (!matches(current->batchCallbacks[i])) {
+            next->batchCallbacks.push_back(current->batchCallbacks[i]);
+            next->batchQos.push_back(current->batchQos[i]);
+        }
+    }
+    if (next->callbacks.size() == current->callbacks.size() &&
+        next->batchCallbacks.size() == current->batchCallbacks.size()) {
+        return;
+    }
+    if (next->empty()) {
+        next.reset();
+    }
+    publishLocked(slot, std::move(next));
+}
+
+const EventManager::SubscriberList* EventManager::currentLocked(EventSlot& slot) const {
+    if (staging_) {
+        auto it = staged_.find(&slot);
+        if (it != staged_.end()) {
+            return it->second.get();
+        }
+    }
+    return slot.subscribers.load(std::memory_order_relaxed);
+}
+
+void EventManager::publishLocked(EventSlot& slot, std::unique_ptr<SubscriberList> next) {
+    if (staging_) {
+        // 尚未发布的快照没有读者，直接替换
+        staged_[&slot] = std::move(next);
+        return;
+    }
+    PriorityClass top = PriorityClass::Normal;
+    if (next) {
+        auto hasDeadline = [](const SubscriptionQos& qos) { return qos.deadline.count() > 0; };
+        next->deadlines = std::any_of(next->qos.begin(), next->qos.end(), hasDeadline) ||
+            std::any_of(next->batchQos.begin(), next->batchQos.end(), hasDeadline);
+        top = PriorityClass::BestEffort;
+        if (!next->qos.empty()) {
+            top = next->qos.front().priority;
+        }
+        if (!next->batchQos.empty() && next->batchQos.front().priority < top) {
+            top = next->batchQos.front().priority;
+        }
+    }
+    slot.priority.store(top, std::memory_order_relaxed);
+    const SubscriberList* previous = slot.subscribers.exchange(next.release(), std::memory_order_acq_rel);
+    if (previous) {
+        EpochDomain::instance().retire(previous);
+    }
+}
+
+void EventManager::insertNameLocked(const NameEntry* entry) {
+    const NameTable* table = names_.load(std::memory_order_relaxed);
+    size_t capacity = table->mask + 1;
+
+    // 负载因子超过 1/2 时扩容，旧表交给纪元回收
+    if ((nameEntries_.size() + 1) * 2 > capacity) {
+        auto grown = std::make_unique<NameTable>(capacity * 2);
+        for (const auto& existing : nameEntries_) {
+            size_t i = existing->hash & grown->mask;
+            while (grown->buckets[i].load(std::memory_order_relaxed)) {
+                i = (i + 1) & grown->mask;
+            }
+            grown->buckets[i].store(existing.get(), std::memory_order_relaxed);
+        }
+        names_.store(grown.get(), std::memory_order_release);
+        EpochDomain::instance().retire(table);
+        table = grown.release();
+    }
+
+    size_t i = entry->hash & table->mask;
+    while (table->buckets[i].load(std::memory_order_relaxed)) {
+        i = (i + 1) & table->mask;
+    }
+    table->buckets[i].store(entry, std::memory_order_release);
+}
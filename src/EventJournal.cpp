@@ -0,0 +1,454 @@
+// src/EventJournal.cpp
+#include "EventJournal.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char kJournalMagic[8] = { 'M', 'O', 'T', 'S', 'J', 'N', 'L', '\0' };
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free,
+    "Record length is published through an atomic view of the mapped word");
+
+size_t alignRecord(size_t size) {
+    return (size + kJournalAlignment - 1) & ~(kJournalAlignment - 1);
+}
+
+int64_t wallNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// 远处睡眠，临近到期时让出 CPU 忙等，兼顾精度与占用
+void waitUntil(int64_t deadlineNs) {
+    for (;;) {
+        int64_t remaining = deadlineNs - statsNowNs();
+        if (remaining <= 0) {
+            return;
+        }
+        if (remaining > 200000) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(remaining - 100000));
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+} // namespace
+
+JournalWriter::JournalWriter(EventManager& eventManager)
+    : eventManager_(eventManager), log_(eventManager.logger().channel("EventJournal")) {}
+
+JournalWriter::~JournalWriter() {
+    close();
+}
+
+bool JournalWriter::open(const std::string& path, size_t capacityBytes, bool prefault) {
+    close();
+    size_t capacity = alignRecord(std::max(capacityBytes, sizeof(JournalFileHeader) + kJournalAlignment));
+    void* base = nullptr;
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        log_.logf(LogLevel::Error, "Cannot create journal %s: error %lu", path.c_str(), GetLastError());
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(static_cast<uint64_t>(capacity) >> 32), static_cast<DWORD>(capacity), nullptr);
+    if (mapping) {
+        base = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, capacity);
+    }
+    if (!base) {
+        log_.logf(LogLevel::Error, "Cannot map journal %s: error %lu", path.c_str(), GetLastError());
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        return false;
+    }
+    file_ = file;
+    mapping_ = mapping;
+#else
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        log_.logf(LogLevel::Error, "Cannot create journal %s: %s", path.c_str(), std::strerror(errno));
+        return false;
+    }
+    int flags = MAP_SHARED;
+#if defined(MAP_POPULATE)
+    if (prefault) {
+        flags |= MAP_POPULATE;
+    }
+#endif
+    if (::ftruncate(fd, static_cast<off_t>(capacity)) != 0 ||
+        (base = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, flags, fd, 0)) == MAP_FAILED) {
+        log_.logf(LogLevel::Error, "Cannot map journal %s: %s", path.c_str(), std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    fd_ = fd;
+#endif
+
+    base_ = static_cast<char*>(base);
+    capacity_ = capacity;
+    path_ = path;
+#if !defined(MAP_POPULATE)
+    if (prefault) {
+        // 逐页写入一次，提前建立页映射
+        for (size_t offset = 0; offset < capacity_; offset += 4096) {
+            base_[offset] = 0;
+        }
+    }
+#endif
+
+    JournalFileHeader header{};
+    std::memcpy(header.magic, kJournalMagic, sizeof(kJournalMagic));
+    header.version = kJournalVersion;
+    header.headerSize = sizeof(JournalFileHeader);
+    header.steadyBaseNs = statsNowNs();
+    header.wallBaseNs = wallNowNs();
+    std::memcpy(base_, &header, sizeof(header));
+
+    writeOffset_.store(sizeof(JournalFileHeader), std::memory_order_relaxed);
+    sequence_.store(0, std::memory_order_relaxed);
+    records_.store(0, std::memory_order_relaxed);
+    dropped_.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+void JournalWriter::close() {
+    if (!base_) {
+        return;
+    }
+    size_t used = std::min(writeOffset_.load(std::memory_order_acquire), capacity_);
+#if defined(_WIN32)
+    UnmapViewOfFile(base_);
+    CloseHandle(static_cast<HANDLE>(mapping_));
+    LARGE_INTEGER length;
+    length.QuadPart = static_cast<LONGLONG>(used);
+    if (!SetFilePointerEx(static_cast<HANDLE>(file_), length, nullptr, FILE_BEGIN) ||
+        !SetEndOfFile(static_cast<HANDLE>(file_))) {
+        log_.logf(LogLevel::Warn, "Cannot truncate journal %s: error %lu", path_.c_str(), GetLastError());
+    }
+    CloseHandle(static_cast<HANDLE>(file_));
+    file_ = nullptr;
+    mapping_ = nullptr;
+#else
+    ::munmap(base_, capacity_);
+    if (::ftruncate(fd_, static_cast<off_t>(used)) != 0) {
+        log_.logf(LogLevel::Warn, "Cannot truncate journal %s: %s", path_.c_str(), std::strerror(errno));
+    }
+    ::close(fd_);
+    fd_ = -1;
+#endif
+    base_ = nullptr;
+
+    // 下次打开的是新文件，定义记录需重新写入
+    for (auto& segment : segments_) {
+        delete[] segment.exchange(nullptr, std::memory_order_relaxed);
+    }
+    types_.clear();
+}
+
+JournalStats JournalWriter::stats() const {
+    JournalStats stats;
+    stats.records = records_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.capacity = capacity_;
+    stats.bytes = std::min(writeOffset_.load(std::memory_order_relaxed), capacity_);
+    return stats;
+}
+
+bool JournalWriter::append(EventId eventId, const EventPayload& payload) {
+    EventState* state = stateOf(eventId);
+    if (!state) {
+        return false;
+    }
+    if (!state->defined.load(std::memory_order_acquire) && !defineEvent(eventId, *state)) {
+        return false;
+    }
+
+    std::string_view bytes = payload.bytes();
+    JournalPayloadKind payloadKind = JournalPayloadKind::Typed;
+    uint16_t typeId = 0;
+    if (payload.empty()) {
+        payloadKind = JournalPayloadKind::Empty;
+    }
+    else if (payload.string()) {
+        payloadKind = JournalPayloadKind::String;
+    }
+    else if (payload.is<EventPayload::Bytes>()) {
+        payloadKind = JournalPayloadKind::Bytes;
+    }
+    else {
+        // 同一事件的负载类型通常不变，命中时无需查表
+        const TypeEntry* type = state->lastType.load(std::memory_order_acquire);
+        if (!type || *type->type != *payload.type()) {
+            type = defineType(*payload.type(), *state);
+        }
+        if (type) {
+            typeId = type->id;
+            payloadKind = bytes.empty() ? JournalPayloadKind::Opaque : JournalPayloadKind::Typed;
+        }
+        else {
+            payloadKind = JournalPayloadKind::Bytes;
+        }
+    }
+    return write(JournalRecordKind::Event, payloadKind, eventId.value, typeId, bytes.data(), bytes.size());
+}
+
+JournalWriter::EventState* JournalWriter::stateOf(EventId eventId) {
+    if (!eventId.valid() || (eventId.value >> kSegmentBits) >= kMaxSegments) {
+        return nullptr;
+    }
+    std::atomic<EventState*>& slot = segments_[eventId.value >> kSegmentBits];
+    EventState* segment = slot.load(std::memory_order_acquire);
+    if (!segment) {
+        std::lock_guard<std::mutex> lock(defineMutex_);
+        segment = slot.load(std::memory_order_relaxed);
+        if (!segment) {
+            segment = new EventState[kSlotsPerSegment];
+            slot.store(segment, std::memory_order_release);
+        }
+    }
+    return &segment[eventId.value & (kSlotsPerSegment - 1)];
+}
+
+bool JournalWriter::defineEvent(EventId eventId, EventState& state) {
+    std::lock_guard<std::mutex> lock(defineMutex_);
+    if (state.defined.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    std::string name = eventManager_.eventName(eventId);
+    if (!write(JournalRecordKind::DefineEvent, JournalPayloadKind::String, eventId.value, 0, name.data(), name.size())) {
+        return false;
+    }
+    // 定义记录的位置先于随后任何线程追加的该事件记录
+    state.defined.store(true, std::memory_order_release);
+    return true;
+}
+
+const JournalWriter::TypeEntry* JournalWriter::defineType(const std::type_info& type, EventState& state) {
+    std::lock_guard<std::mutex> lock(defineMutex_);
+    auto& entry = types_[std::type_index(type)];
+    if (!entry) {
+        if (types_.size() > UINT16_MAX) {
+            types_.erase(std::type_index(type));
+            return nullptr;
+        }
+        entry = std::make_unique<TypeEntry>(TypeEntry{ &type, static_cast<uint16_t>(types_.size() - 1) });
+        const char* name = type.name();
+        write(JournalRecordKind::DefineType, JournalPayloadKind::String, 0, entry->id, name, std::strlen(name));
+    }
+    state.lastType.store(entry.get(), std::memory_order_release);
+    return entry.get();
+}
+
+bool JournalWriter::write(JournalRecordKind kind, JournalPayloadKind payloadKind, uint32_t eventIndex, uint16_t typeId,
+    const void* payload, size_t payloadSize) {
+    size_t length = alignRecord(sizeof(JournalRecordHeader) + payloadSize);
+    size_t offset = writeOffset_.fetch_add(length, std::memory_order_relaxed);
+    if (!base_ || offset + length > capacity_ || length > UINT32_MAX) {
+        if (kind == JournalRecordKind::Event && dropped_.fetch_add(1, std::memory_order_relaxed) == 0) {
+            log_.logf(LogLevel::Warn, "Journal %s is full, further events are dropped", path_.c_str());
+        }
+        return false;
+    }
+
+    char* target = base_ + offset;
+    auto* record = reinterpret_cast<JournalRecordHeader*>(target);
+    record->payloadSize = static_cast<uint32_t>(payloadSize);
+    record->sequence = kind == JournalRecordKind::Event ? sequence_.fetch_add(1, std::memory_order_relaxed) : 0;
+    record->timestampNs = statsNowNs();
+    record->eventIndex = eventIndex;
+    record->typeId = typeId;
+    record->kind = kind;
+    record->payloadKind = payloadKind;
+    if (payloadSize != 0) {
+        std::memcpy(target + sizeof(JournalRecordHeader), payload, payloadSize);
+    }
+    // 最后发布长度，读者据此判断记录已完整
+    reinterpret_cast<std::atomic<uint32_t>*>(&record->length)->store(static_cast<uint32_t>(length), std::memory_order_release);
+    if (kind == JournalRecordKind::Event) {
+        records_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+JournalReader::JournalReader(Logger& logger) : log_(logger.channel("EventJournal")) {}
+
+JournalReader::~JournalReader() {
+    close();
+}
+
+bool JournalReader::open(const std::string& path) {
+    close();
+    void* base = nullptr;
+    size_t size = 0;
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    LARGE_INTEGER length{};
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &length)) {
+        log_.logf(LogLevel::Error, "Cannot open journal %s: error %lu", path.c_str(), GetLastError());
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+        }
+        return false;
+    }
+    size = static_cast<size_t>(length.QuadPart);
+    HANDLE mapping = size >= sizeof(JournalFileHeader) ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    if (mapping) {
+        base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+    if (!base) {
+        log_.logf(LogLevel::Error, "Cannot map journal %s", path.c_str());
+        if (mapping) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        return false;
+    }
+    file_ = file;
+    mapping_ = mapping;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat info {};
+    if (fd < 0 || ::fstat(fd, &info) != 0) {
+        log_.logf(LogLevel::Error, "Cannot open journal %s: %s", path.c_str(), std::strerror(errno));
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return false;
+    }
+    size = static_cast<size_t>(info.st_size);
+    if (size >= sizeof(JournalFileHeader)) {
+        base = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);  // 映射在关闭描述符后仍然有效
+    if (!base || base == MAP_FAILED) {
+        log_.logf(LogLevel::Error, "Cannot map journal %s", path.c_str());
+        return false;
+    }
+#if defined(MADV_SEQUENTIAL)
+    ::madvise(base, size, MADV_SEQUENTIAL);
+#endif
+#endif
+
+    base_ = static_cast<const char*>(base);
+    size_ = size;
+    const JournalFileHeader* fileHeader = header();
+    if (std::memcmp(fileHeader->magic, kJournalMagic, sizeof(kJournalMagic)) != 0 ||
+        fileHeader->version != kJournalVersion || fileHeader->headerSize != sizeof(JournalFileHeader)) {
+        log_.logf(LogLevel::Error, "%s is not a version %u event journal", path.c_str(), kJournalVersion);
+        close();
+        return false;
+    }
+    return true;
+}
+
+void JournalReader::close() {
+    if (!base_) {
+        return;
+    }
+#if defined(_WIN32)
+    UnmapViewOfFile(base_);
+    CloseHandle(static_cast<HANDLE>(mapping_));
+    CloseHandle(static_cast<HANDLE>(file_));
+    file_ = nullptr;
+    mapping_ = nullptr;
+#else
+    ::munmap(const_cast<char*>(base_), size_);
+#endif
+    base_ = nullptr;
+    size_ = 0;
+}
+
+ReplayStats JournalReader::replay(EventManager& target, const ReplayOptions& options) {
+    ReplayStats stats;
+    if (!base_) {
+        return stats;
+    }
+    std::vector<EventId> events;
+    std::vector<const BoundType*> types;
+    std::string text;  // 字符串负载的复用缓冲
+    bool paced = options.pace == ReplayPace::Recorded && options.speed > 0;
+    int64_t firstRecordNs = 0;
+    int64_t start = statsNowNs();
+
+    for (size_t offset = sizeof(JournalFileHeader); const JournalRecordHeader* record = recordAt(offset);
+        offset += record->length) {
+        const char* data = reinterpret_cast<const char*>(record + 1);
+        std::string_view bytes(data, record->payloadSize);
+        switch (record->kind) {
+        case JournalRecordKind::DefineEvent:
+            if (events.size() <= record->eventIndex) {
+                events.resize(record->eventIndex + 1);
+            }
+            events[record->eventIndex] = target.resolveEvent(std::string(bytes));
+            continue;
+        case JournalRecordKind::DefineType: {
+            if (types.size() <= record->typeId) {
+                types.resize(record->typeId + 1, nullptr);
+            }
+            auto it = boundTypes_.find(std::string(bytes));
+            types[record->typeId] = it != boundTypes_.end() ? &it->second : nullptr;
+            continue;
+        }
+        case JournalRecordKind::Event:
+            break;
+        default:
+            continue;
+        }
+
+        if (record->eventIndex >= events.size() || !events[record->eventIndex].valid()) {
+            ++stats.skipped;
+            continue;
+        }
+        if (paced) {
+            if (stats.events == 0) {
+                firstRecordNs = record->timestampNs;
+            }
+            waitUntil(start + static_cast<int64_t>(static_cast<double>(record->timestampNs - firstRecordNs) / options.speed));
+        }
+
+        EventPayload payload;
+        switch (record->payloadKind) {
+        case JournalPayloadKind::String:
+            text.assign(bytes);
+            payload = EventPayload::fromString(text);
+            break;
+        case JournalPayloadKind::Typed: {
+            const BoundType* type = record->typeId < types.size() ? types[record->typeId] : nullptr;
+            payload = type && type->size == bytes.size() ? EventPayload::view(data, *type->type, type->size)
+                                                         : EventPayload::fromBytes(bytes);
+            break;
+        }
+        case JournalPayloadKind::Bytes:
+            payload = EventPayload::fromBytes(bytes);
+            break;
+        case JournalPayloadKind::Opaque:
+            ++stats.skipped;
+            break;
+        default:
+            break;
+        }
+        target.triggerEvent(events[record->eventIndex], payload);
+        ++stats.events;
+    }
+    stats.elapsed = std::chrono::nanoseconds(statsNowNs() - start);
+    return stats;
+}
@@ -0,0 +1,481 @@
+// src/IsolatedPlugin.cpp
+#include "IsolatedPlugin.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace {
+
+// 监视线程每次睡眠的上限，也是发现子进程退出的最长延迟
+constexpr std::chrono::milliseconds kPollInterval{ 10 };
+// 通知子进程退出后等待的时间，超时则强制结束
+constexpr std::chrono::milliseconds kShutdownTimeout{ 1000 };
+
+std::vector<std::string> splitNames(std::string_view body) {
+    std::vector<std::string> names;
+    while (!body.empty()) {
+        size_t end = body.find('\0');
+        names.emplace_back(body.substr(0, end));
+        body.remove_prefix(end == std::string_view::npos ? body.size() : end + 1);
+    }
+    return names;
+}
+
+} // namespace
+
+IsolatedPlugin::IsolatedPlugin(std::string path, IsolationOptions options, LogChannel& log)
+    : path_(std::move(path)), options_(std::move(options)), log_(log) {}
+
+IsolatedPlugin::~IsolatedPlugin() {
+    stop();
+}
+
+#if defined(__linux__)
+
+bool IsolatedPlugin::start(AcceptFunc accept) {
+    size_t ringBytes = options_.ringBytes;
+    if (ringBytes < 4096 || (ringBytes & (ringBytes - 1)) != 0) {
+        log_.logf(LogLevel::Error, "Isolated plugin ring size must be a power of two of at least 4096: %zu", ringBytes);
+        return false;
+    }
+    if (options_.hostExecutable.empty()) {
+        std::error_code error;
+        std::filesystem::path self = std::filesystem::read_symlink("/proc/self/exe", error);
+        options_.hostExecutable = (self.parent_path() / "MotsPluginHost").string();
+    }
+    accept_ = std::move(accept);
+    if (!createSegment()) {
+        return false;
+    }
+    if (!spawn() || !handshake(true)) {
+        terminate();
+        revokeForwards();
+        destroySegment();
+        return false;
+    }
+    monitor_ = std::thread(&IsolatedPlugin::monitor, this);
+    return true;
+}
+
+void IsolatedPlugin::stop() {
+    if (stopping_.exchange(true)) {
+        return;
+    }
+    if (monitor_.joinable()) {
+        monitor_.join();
+    }
+    // 先撤销转发订阅，子进程 shutdown() 期间不再收到事件
+    revokeForwards();
+    if (pid_ != 0) {
+        sendControl(IsolationMessage::Shutdown);
+        auto deadline = std::chrono::steady_clock::now() + kShutdownTimeout;
+        int status = 0;
+        while (!exited(status) && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        terminate();
+    }
+    destroySegment();
+}
+
+bool IsolatedPlugin::createSegment() {
+    static std::atomic<uint32_t> counter{ 0 };
+    shmName_ = "/mots-" + std::to_string(getpid()) + "-" + std::to_string(counter.fetch_add(1));
+    int fd = shm_open(shmName_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        log_.logf(LogLevel::Error, "shm_open failed for %s: %s", shmName_.c_str(), std::strerror(errno));
+        shmName_.clear();
+        return false;
+    }
+    segmentBytes_ = sizeof(IsolationSegment) + 2 * options_.ringBytes;
+    if (ftruncate(fd, static_cast<off_t>(segmentBytes_)) != 0) {
+        log_.logf(LogLevel::Error, "ftruncate failed for %s: %s", shmName_.c_str(), std::strerror(errno));
+        close(fd);
+        destroySegment();
+        return false;
+    }
+    void* segment = mmap(nullptr, segmentBytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED) {
+        log_.logf(LogLevel::Error, "mmap failed for %s: %s", shmName_.c_str(), std::strerror(errno));
+        destroySegment();
+        return false;
+    }
+    segment_ = segment;
+    return true;
+}
+
+void IsolatedPlugin::destroySegment() {
+    if (segment_) {
+        munmap(segment_, segmentBytes_);
+        segment_ = nullptr;
+    }
+    if (!shmName_.empty()) {
+        shm_unlink(shmName_.c_str());
+        shmName_.clear();
+    }
+}
+
+bool IsolatedPlugin::spawn() {
+    {
+        // 转发订阅已撤销，此时只有发送超时的发布方可能仍持锁
+        std::lock_guard<std::mutex> lock(sendMutex_);
+        auto* segment = static_cast<IsolationSegment*>(segment_);
+        char* data = static_cast<char*>(segment_) + sizeof(IsolationSegment);
+        ShmRing::initialize(&segment->toChild, options_.ringBytes);
+        ShmRing::initialize(&segment->toParent, options_.ringBytes);
+        toChild_ = ShmRing(&segment->toChild, data);
+        toParent_ = ShmRing(&segment->toParent, data + options_.ringBytes);
+        // 新的子进程不认识此前定义的类型
+        sentTypes_.clear();
+    }
+
+    std::string ringBytes = std::to_string(options_.ringBytes);
+    std::string memoryLimit = std::to_string(options_.memoryLimitBytes);
+    std::string sendTimeout = std::to_string(options_.sendTimeout.count());
+    std::string spin = std::to_string(options_.spin.count());
+    char* argv[] = {
+        const_cast<char*>(options_.hostExecutable.c_str()),
+        const_cast<char*>(shmName_.c_str()),
+        const_cast<char*>(ringBytes.c_str()),
+        const_cast<char*>(path_.c_str()),
+        const_cast<char*>(memoryLimit.c_str()),
+        const_cast<char*>(sendTimeout.c_str()),
+        const_cast<char*>(spin.c_str()),
+        nullptr,
+    };
+    pid_t pid = 0;
+    int error = posix_spawn(&pid, options_.hostExecutable.c_str(), nullptr, nullptr, argv, environ);
+    if (error != 0) {
+        log_.logf(LogLevel::Error, "Failed to start plugin host %s: %s", options_.hostExecutable.c_str(), std::strerror(error));
+        return false;
+    }
+    pid_ = pid;
+    runningPid_.store(pid);
+    return true;
+}
+
+bool IsolatedPlugin::handshake(bool first) {
+    auto deadline = std::chrono::steady_clock::now() + options_.startTimeout;
+    bool ready = false;
+    bool failed = false;
+    while (!ready && !failed) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            log_.logf(LogLevel::Error, "Isolated plugin %s did not start within %lld ms", path_.c_str(),
+                static_cast<long long>(options_.startTimeout.count()));
+            terminate();
+            return false;
+        }
+        if (!toParent_.wait(options_.spin, kPollInterval)) {
+            int status = 0;
+            if (exited(status)) {
+                log_.logf(LogLevel::Error, "Isolated plugin %s exited during startup (status %d)", path_.c_str(), status);
+                return false;
+            }
+            continue;
+        }
+        ShmRing::Message message;
+        while (!ready && !failed && toParent_.peek(message)) {
+            handle(message, ready, failed, first);
+            toParent_.pop();
+        }
+    }
+    if (failed) {
+        terminate();
+        return false;
+    }
+    return true;
+}
+
+void IsolatedPlugin::handle(const ShmRing::Message& message, bool& ready, bool& failed, bool first) {
+    IsolationFrame frame;
+    std::memcpy(&frame, message.data, sizeof(frame));
+    std::string_view body(message.data + sizeof(frame), message.size - sizeof(frame));
+    auto busEvent = [&]() {
+        return frame.eventId < events_.size() ? events_[frame.eventId] : EventId{};
+    };
+
+    switch (frame.type) {
+    case IsolationMessage::Hello: {
+        std::vector<std::string> names = splitNames(body);
+        std::string name = names.empty() ? std::string() : names.front();
+        if (first) {
+            name_ = name;
+            dependencies_.assign(names.size() > 1 ? names.begin() + 1 : names.end(), names.end());
+            host_ = accept_(name_, dependencies_);
+        }
+        else if (name != name_) {
+            log_.logf(LogLevel::Error, "Restarted plugin %s reports a different name: %s", name_.c_str(), name.c_str());
+            failed = true;
+            return;
+        }
+        if (!host_) {
+            failed = true;
+            return;
+        }
+        sendControl(IsolationMessage::Accept);
+        break;
+    }
+    case IsolationMessage::Ready:
+        ready = true;
+        break;
+    case IsolationMessage::InitFailed:
+        log_.logf(LogLevel::Error, "Failed to initialize isolated plugin: %s", path_.c_str());
+        failed = true;
+        break;
+    case IsolationMessage::DefineEvent:
+        if (events_.size() <= frame.eventId) {
+            events_.resize(frame.eventId + 1);
+        }
+        events_[frame.eventId] = host_->resolveEvent(std::string(body));
+        break;
+    case IsolationMessage::DefineType:
+        if (!childTypes_.define(frame.typeId, body, options_.types)) {
+            log_.logf(LogLevel::Warn, "Payload type %.*s from isolated plugin %s is not bound in IsolationOptions::types, "
+                "delivering it as bytes", static_cast<int>(body.size()), body.data(), name_.c_str());
+        }
+        break;
+    case IsolationMessage::Subscribe: {
+        IsolationSubscribe request{};
+        std::memcpy(&request, body.data(), std::min(body.size(), sizeof(request)));
+        SubscriptionOptions options;
+        options.policy = static_cast<DeliveryPolicy>(request.policy);
+        options.capacity = request.capacity;
+        uint32_t childEvent = frame.eventId;
+        SubscriptionToken token = host_->subscribe(busEvent(), [this, childEvent](const EventPayload& payload) {
+            send(IsolationMessage::Event, childEvent, payload);
+        }, options);
+        if (token) {
+            forwards_.push_back(Forward{ childEvent, token });
+        }
+        break;
+    }
+    case IsolationMessage::Unsubscribe: {
+        auto it = std::find_if(forwards_.begin(), forwards_.end(),
+            [&](const Forward& forward) { return forward.childEvent == frame.eventId; });
+        if (it != forwards_.end()) {
+            SubscriptionToken token = it->token;
+            forwards_.erase(it);
+            host_->unsubscribe(token);
+        }
+        break;
+    }
+    case IsolationMessage::Publish: {
+        bool partitioned = frame.mode == static_cast<uint8_t>(IsolationPublishMode::Partitioned);
+        std::string_view key;
+        if (partitioned) {
+            key = body.substr(body.size() - std::min<size_t>(frame.keySize, body.size()));
+            body.remove_suffix(key.size());
+        }
+        EventPayload payload;
+        if (frame.payloadKind == IsolationPayloadKind::String) {
+            text_.assign(body);
+            payload = EventPayload::fromString(text_);
+        }
+        else if (frame.payloadKind == IsolationPayloadKind::Bytes) {
+            payload = EventPayload::fromBytes(body);
+        }
+        else if (frame.payloadKind == IsolationPayloadKind::Typed) {
+            payload = childTypes_.payload(frame.typeId, body);
+        }
+        received_.fetch_add(1, std::memory_order_relaxed);
+        if (partitioned) {
+            host_->publish(busEvent(), payload, key);
+        }
+        else if (frame.mode != static_cast<uint8_t>(IsolationPublishMode::Async) || !host_->publishAsync(busEvent(), payload)) {
+            host_->publish(busEvent(), payload);
+        }
+        break;
+    }
+    default:
+        log_.logf(LogLevel::Warn, "Unexpected message %u from isolated plugin %s",
+            static_cast<unsigned>(frame.type), name_.c_str());
+        break;
+    }
+}
+
+void IsolatedPlugin::monitor() {
+    while (!stopping_.load()) {
+        if (toParent_.wait(options_.spin, kPollInterval)) {
+            bool ready = false;
+            bool failed = false;
+            ShmRing::Message message;
+            while (toParent_.peek(message)) {
+                handle(message, ready, failed, false);
+                toParent_.pop();
+            }
+            continue;
+        }
+        int status = 0;
+        if (stopping_.load() || !exited(status)) {
+            continue;
+        }
+
+        // 子进程已退出：它留下的消息已处理完，撤销转发订阅后重启
+        if (WIFSIGNALED(status)) {
+            log_.logf(LogLevel::Error, "Isolated plugin %s crashed (signal %d)", name_.c_str(), WTERMSIG(status));
+        }
+        else {
+            log_.logf(LogLevel::Error, "Isolated plugin %s exited unexpectedly (status %d)", name_.c_str(),
+                WIFEXITED(status) ? WEXITSTATUS(status) : status);
+        }
+        revokeForwards();
+        if (restarts_.load() >= options_.maxRestarts) {
+            log_.logf(LogLevel::Error, "Isolated plugin %s reached the restart limit (%u), not restarting",
+                name_.c_str(), options_.maxRestarts);
+            return;
+        }
+        for (auto waited = std::chrono::milliseconds::zero(); waited < options_.restartDelay && !stopping_.load();
+            waited += std::chrono::milliseconds(1)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (stopping_.load()) {
+            return;
+        }
+        restarts_.fetch_add(1);
+        // 启动失败时下一轮仍视为已退出，继续重启直到达到上限
+        if (spawn() && handshake(false)) {
+            log_.logf(LogLevel::Info, "Restarted isolated plugin %s (pid %d, restart %u)", name_.c_str(),
+                static_cast<int>(pid_), restarts_.load());
+        }
+    }
+}
+
+bool IsolatedPlugin::exited(int& status) {
+    if (pid_ == 0) {
+        return true;
+    }
+    pid_t result = waitpid(pid_, &status, WNOHANG);
+    if (result == 0) {
+        return false;
+    }
+    pid_ = 0;
+    runningPid_.store(0);
+    return true;
+}
+
+void IsolatedPlugin::terminate() {
+    if (pid_ == 0) {
+        return;
+    }
+    kill(pid_, SIGKILL);
+    int status = 0;
+    waitpid(pid_, &status, 0);
+    pid_ = 0;
+    runningPid_.store(0);
+}
+
+#else
+
+bool IsolatedPlugin::start(AcceptFunc) {
+    log_.logf(LogLevel::Error, "Isolated plugins are not supported on this platform: %s", path_.c_str());
+    return false;
+}
+
+void IsolatedPlugin::stop() {}
+
+#endif
+
+void IsolatedPlugin::revokeForwards() {
+    std::vector<Forward> forwards;
+    forwards.swap(forwards_);
+    if (!host_) {
+        return;
+    }
+    for (const auto& forward : forwards) {
+        host_->unsubscribe(forward.token);
+    }
+}
+
+bool IsolatedPlugin::send(IsolationMessage type, uint32_t eventId, const EventPayload& payload) {
+    IsolationFrame frame{ type, IsolationPayloadKind::Empty, 0, eventId, 0, 0 };
+    std::string_view bytes;
+    if (!isolationPayloadOf(payload, frame.payloadKind, bytes)) {
+        reject(payload);
+        return false;
+    }
+    if (sizeof(frame) + bytes.size() > options_.ringBytes / 2) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    if (frame.payloadKind == IsolationPayloadKind::Typed) {
+        bool defined = false;
+        frame.typeId = sentTypes_.find(*payload.type(), defined);
+        if (!defined) {
+            IsolationFrame definition{ IsolationMessage::DefineType, IsolationPayloadKind::String, 0, 0, frame.typeId, 0 };
+            if (!writeLocked(definition, payload.type()->name())) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            sentTypes_.define(*payload.type());
+        }
+    }
+    if (!writeLocked(frame, bytes)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (type == IsolationMessage::Event) {
+        sent_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool IsolatedPlugin::writeLocked(const IsolationFrame& frame, std::string_view body) {
+    // 子进程已退出或超时则放弃，发布方不会无限阻塞
+    auto deadline = std::chrono::steady_clock::time_point::min();
+    while (!toChild_.tryWrite(&frame, sizeof(frame), body.data(), body.size())) {
+        auto now = std::chrono::steady_clock::now();
+        if (deadline == std::chrono::steady_clock::time_point::min()) {
+            deadline = now + options_.sendTimeout;
+        }
+        if (runningPid_.load(std::memory_order_relaxed) == 0 || now >= deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+// 不可按字节复制的对象无法送入子进程：计数并按类型报告一次
+void IsolatedPlugin::reject(const EventPayload& payload) {
+    rejected_.fetch_add(1, std::memory_order_relaxed);
+    bool first = false;
+    {
+        std::lock_guard<std::mutex> lock(sendMutex_);
+        first = rejectedTypes_.insert(std::type_index(*payload.type())).second;
+    }
+    if (first) {
+        log_.logf(LogLevel::Error, "Isolated plugin %s cannot receive a payload of type %s: it is not trivially copyable",
+            name_.c_str(), payload.type()->name());
+    }
+}
+
+void IsolatedPlugin::sendControl(IsolationMessage type) {
+    send(type, 0, EventPayload{});
+}
+
+IsolationStats IsolatedPlugin::stats() const {
+    IsolationStats stats;
+    stats.sent = sent_.load(std::memory_order_relaxed);
+    stats.received = received_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.rejected = rejected_.load(std::memory_order_relaxed);
+    stats.restarts = restarts_.load(std::memory_order_relaxed);
+    stats.pid = runningPid_.load(std::memory_order_relaxed);
+    stats.running = stats.pid != 0;
+    return stats;
+}
@@ -0,0 +1,280 @@
+// src/Logger.cpp
+#include "Logger.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+std::atomic<uint64_t> nextLoggerSerial{ 1 };
+
+int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t wallNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// 本地时间 HH:MM:SS.uuuuuu
+void appendTime(std::string& out, int64_t timeNs) {
+    std::time_t seconds = static_cast<std::time_t>(timeNs / 1000000000);
+    std::tm local{};
+#if defined(_WIN32)
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+    char buffer[32];
+    size_t length = std::strftime(buffer, sizeof(buffer), "%H:%M:%S", &local);
+    std::snprintf(buffer + length, sizeof(buffer) - length, ".%06lld",
+        static_cast<long long>((timeNs % 1000000000) / 1000));
+    out += buffer;
+}
+
+} // namespace
+
+const char* logLevelName(LogLevel level) {
+    switch (level) {
+    case LogLevel::Trace: return "TRACE";
+    case LogLevel::Debug: return "DEBUG";
+    case LogLevel::Info: return "INFO";
+    case LogLevel::Warn: return "WARN";
+    case LogLevel::Error: return "ERROR";
+    case LogLevel::Off: return "OFF";
+    }
+    return "?";
+}
+
+LogChannel::LogChannel(Logger& logger, std::string name, LogLevel level, uint32_t ratePerSecond, uint32_t burst)
+    : logger_(logger), name_(std::move(name)), level_(level) {
+    setRateLimit(ratePerSecond, burst);
+}
+
+void LogChannel::setRateLimit(uint32_t ratePerSecond, uint32_t burst) {
+    int64_t interval = ratePerSecond == 0 ? 0 : 1000000000 / static_cast<int64_t>(ratePerSecond);
+    toleranceNs_.store(interval * (std::max<uint32_t>(burst, 1) - 1), std::memory_order_relaxed);
+    intervalNs_.store(interval, std::memory_order_relaxed);
+}
+
+bool LogChannel::admit() {
+    int64_t interval = intervalNs_.load(std::memory_order_relaxed);
+    if (interval == 0) {
+        return true;
+    }
+    int64_t tolerance = toleranceNs_.load(std::memory_order_relaxed);
+    int64_t now = steadyNowNs();
+    int64_t arrival = theoreticalArrival_.load(std::memory_order_relaxed);
+    for (;;) {
+        int64_t start = std::max(arrival, now);
+        if (start - now > tolerance) {
+            return false;
+        }
+        if (theoreticalArrival_.compare_exchange_weak(arrival, start + interval, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+void LogChannel::write(LogLevel level, const char* text, size_t length) {
+    if (!admit()) {
+        suppressed_.fetch_add(1, std::memory_order_relaxed);
+        suppressedTotal_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (suppressed_.load(std::memory_order_relaxed) != 0) {
+        uint64_t missed = suppressed_.exchange(0, std::memory_order_relaxed);
+        if (missed != 0) {
+            char note[64];
+            int noteLength = std::snprintf(note, sizeof(note), "%llu messages suppressed by rate limit",
+                static_cast<unsigned long long>(missed));
+            logger_.push(*this, LogLevel::Warn, note, static_cast<size_t>(noteLength));
+        }
+    }
+    logger_.push(*this, level, text, length);
+}
+
+Logger::Logger(std::ostream& sink) : Logger(sink, Options()) {}
+
+Logger::Logger(std::ostream& sink, Options options)
+    : options_(options), serial_(nextLoggerSerial.fetch_add(1, std::memory_order_relaxed)), sink_(sink) {
+    worker_ = std::thread([this] { run(); });
+}
+
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(flushMutex_);
+        stopping_ = true;
+    }
+    flushCv_.notify_all();
+    worker_.join();
+}
+
+Logger& Logger::global() {
+    static Logger* logger = [] {
+        Logger* instance = new Logger();
+        std::atexit([] { global().flush(); });
+        return instance;
+    }();
+    return *logger;
+}
+
+LogChannel& Logger::channel(const std::string& name) {
+    std::lock_guard<std::mutex> lock(channelsMutex_);
+    auto& slot = channels_[name];
+    if (!slot) {
+        slot = std::make_unique<LogChannel>(*this, name, options_.defaultLevel,
+            options_.defaultRatePerSecond, options_.defaultBurst);
+    }
+    return *slot;
+}
+
+void Logger::flush() {
+    std::unique_lock<std::mutex> lock(flushMutex_);
+    if (stopping_) {
+        return;
+    }
+    uint64_t target = ++flushRequested_;
+    flushCv_.notify_all();
+    flushCv_.wait(lock, [&] { return flushCompleted_ >= target; });
+}
+
+uint64_t Logger::dropped() const {
+    std::lock_guard<std::mutex> lock(buffersMutex_);
+    uint64_t total = releasedDropped_;
+    for (const auto& buffer : buffers_) {
+        total += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void Logger::push(const LogChannel& channel, LogLevel level, const char* text, size_t length) {
+    Buffer& buffer = localBuffer();
+    uint64_t tail = buffer.tail.load(std::memory_order_relaxed);
+    if (tail - buffer.head.load(std::memory_order_acquire) > buffer.mask) {
+        buffer.dropped.store(buffer.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    Record& record = buffer.records[tail & buffer.mask];
+    length = std::min(length, kMaxLogMessage);
+    record.timeNs = wallNowNs();
+    record.channel = &channel;
+    record.level = level;
+    record.length = static_cast<uint16_t>(length);
+    std::memcpy(record.text, text, length);
+    buffer.tail.store(tail + 1, std::memory_order_release);
+}
+
+size_t Logger::bufferCount() const {
+    std::lock_guard<std::mutex> lock(buffersMutex_);
+    return buffers_.size();
+}
+
+Logger::Buffer& Logger::localBuffer() {
+    thread_local ThreadBuffers cache;
+    for (const auto& [serial, buffer] : cache.entries) {
+        if (serial == serial_) {
+            return *buffer;
+        }
+    }
+    return attach(cache);
+}
+
+void Logger::ThreadBuffers::release() {
+    for (auto& entry : entries) {
+        entry.second->released.store(true, std::memory_order_release);
+    }
+    entries.clear();
+}
+
+Logger::Buffer& Logger::attach(ThreadBuffers& cache) {
+    // 与 StatsRecorder 相同：清理已销毁 Logger 的残留条目（仍存活的 Logger 之后重新登记）
+    if (cache.entries.size() >= 8) {
+        cache.release();
+    }
+    size_t capacity = 2;
+    while (capacity < options_.recordsPerThread) {
+        capacity <<= 1;
+    }
+    auto buffer = std::make_shared<Buffer>(capacity);
+    std::lock_guard<std::mutex> lock(buffersMutex_);
+    buffers_.push_back(buffer);
+    cache.entries.emplace_back(serial_, buffer);
+    return *buffer;
+}
+
+void Logger::run() {
+    std::vector<Record> scratch;
+    std::unique_lock<std::mutex> lock(flushMutex_);
+    for (;;) {
+        uint64_t requested = flushRequested_;
+        bool stop = stopping_;
+        lock.unlock();
+        drain(scratch);
+        lock.lock();
+        flushCompleted_ = requested;
+        flushCv_.notify_all();
+        if (stop) {
+            return;
+        }
+        flushCv_.wait_for(lock, std::chrono::milliseconds(options_.flushIntervalMs),
+            [&] { return stopping_ || flushRequested_ != requested; });
+    }
+}
+
+bool Logger::drain(std::vector<Record>& scratch) {
+    scratch.clear();
+    uint64_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex_);
+        for (auto it = buffers_.begin(); it != buffers_.end();) {
+            Buffer& buffer = **it;
+            // 先读交还标志：已交还时，之后读到的 tail 就是最终位置，排空即可释放
+            bool released = buffer.released.load(std::memory_order_acquire);
+            uint64_t head = buffer.head.load(std::memory_order_relaxed);
+            uint64_t tail = buffer.tail.load(std::memory_order_acquire);
+            for (uint64_t i = head; i < tail; ++i) {
+                scratch.push_back(buffer.records[i & buffer.mask]);
+            }
+            buffer.head.store(tail, std::memory_order_release);
+            if (released) {
+                releasedDropped_ += buffer.dropped.load(std::memory_order_relaxed);
+                it = buffers_.erase(it);
+                continue;
+            }
+            dropped += buffer.dropped.load(std::memory_order_relaxed);
+            ++it;
+        }
+        dropped += releasedDropped_;
+    }
+
+    if (scratch.empty() && dropped == reportedDropped_) {
+        return false;
+    }
+    // 各线程缓冲区内已有序，合并后按时间排序即可得到全局顺序
+    std::stable_sort(scratch.begin(), scratch.end(),
+        [](const Record& a, const Record& b) { return a.timeNs < b.timeNs; });
+
+    std::string out;
+    out.reserve(scratch.size() * 96);
+    for (const Record& record : scratch) {
+        appendTime(out, record.timeNs);
+        out += ' ';
+        out += logLevelName(record.level);
+        out += " [";
+        out += record.channel->name();
+        out += "] ";
+        out.append(record.text, record.length);
+        out += '\n';
+    }
+    if (dropped != reportedDropped_) {
+        out += "Logger dropped " + std::to_string(dropped - reportedDropped_) + " messages (thread buffer full)\n";
+        reportedDropped_ = dropped;
+    }
+    sink_ << out;
+    sink_.flush();
+    return true;
+}
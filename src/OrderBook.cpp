@@ -0,0 +1,441 @@
+// src/OrderBook.cpp
+#include "OrderBook.h"
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+// 最低/最高置位的下标；word 非零
+inline int lowestBit(uint64_t word) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+inline int highestBit(uint64_t word) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, word);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(word);
+#endif
+}
+
+} // namespace
+
+OrderNode* OrderNodePool::acquire() {
+    if (!free_) {
+        slabs_.emplace_back(new OrderNode[kSlabNodes]);
+        OrderNode* slab = slabs_.back().get();
+        for (size_t i = kSlabNodes; i-- > 0;) {
+            slab[i].next = free_;
+            free_ = &slab[i];
+        }
+    }
+    OrderNode* node = free_;
+    free_ = node->next;
+    return node;
+}
+
+void OrderNodePool::release(OrderNode* node) {
+    node->next = free_;
+    free_ = node;
+}
+
+OrderIdMap::OrderIdMap() {
+    rehash(1024);
+}
+
+void OrderIdMap::insert(OrderNode* node) {
+    // 负载因子超过 1/2 时扩容
+    if ((size_ + 1) * 2 > slots_.size()) {
+        rehash(slots_.size() * 2);
+    }
+    size_t i = home(node->orderId);
+    while (slots_[i].node) {
+        i = (i + 1) & mask_;
+    }
+    slots_[i] = Slot{ node->orderId, node };
+    ++size_;
+}
+
+void OrderIdMap::erase(uint64_t orderId) {
+    size_t i = home(orderId);
+    for (;; i = (i + 1) & mask_) {
+        if (!slots_[i].node) {
+            return;
+        }
+        if (slots_[i].orderId == orderId) {
+            break;
+        }
+    }
+    // 后移删除：其后同一探测链上的元素，若理想位置不在 (i, j] 之间就移到空出的 i
+    size_t j = i;
+    for (;;) {
+        j = (j + 1) & mask_;
+        if (!slots_[j].node) {
+            break;
+        }
+        size_t ideal = home(slots_[j].orderId);
+        bool between = i <= j ? (ideal > i && ideal <= j) : (ideal > i || ideal <= j);
+        if (!between) {
+            slots_[i] = slots_[j];
+            i = j;
+        }
+    }
+    slots_[i] = Slot{};
+    --size_;
+}
+
+void OrderIdMap::clear() {
+    std::fill(slots_.begin(), slots_.end(), Slot{});
+    size_ = 0;
+}
+
+void OrderIdMap::rehash(size_t capacity) {
+    std::vector<Slot> previous;
+    previous.swap(slots_);
+    slots_.assign(capacity, Slot{});
+    mask_ = capacity - 1;
+    shift_ = 64;
+    for (size_t bits = capacity; bits > 1; bits >>= 1) {
+        --shift_;
+    }
+    size_ = 0;
+    for (const Slot& slot : previous) {
+        if (slot.node) {
+            insert(slot.node);
+        }
+    }
+}
+
+bool PriceLadder::canHold(int64_t price) const {
+    if (price < -kMaxPrice || price > kMaxPrice) {
+        return false;
+    }
+    if (levels_.empty() || liveLevels_ == 0) {
+        return true;
+    }
+    int64_t low = std::min(base_, price);
+    int64_t high = std::max(base_ + static_cast<int64_t>(levels_.size()) - 1, price);
+    return high - low < static_cast<int64_t>(kMaxLevels);
+}
+
+void PriceLadder::reserve(int64_t price) {
+    if (levels_.empty()) {
+        levels_.resize(kInitialLevels);
+        occupied_.assign(kInitialLevels / 64, 0);
+    }
+    int64_t size = static_cast<int64_t>(levels_.size());
+    if (liveLevels_ == 0) {
+        // 一侧为空：以新价格为中心重新定位，不必扩展
+        base_ = price - size / 2;
+        return;
+    }
+    if (price >= base_ && price < base_ + size) {
+        return;
+    }
+    // 按 2 的幂扩展，余量放在价格移动的方向上
+    int64_t low = std::min(base_, price);
+    int64_t high = std::max(base_ + size - 1, price);
+    int64_t grown = size;
+    while (grown < (high - low + 1) * 2 && grown < static_cast<int64_t>(kMaxLevels)) {
+        grown *= 2;
+    }
+    int64_t base = price < base_ ? high - grown + 1 : low;
+    int64_t offset = base_ - base;
+
+    std::vector<Level> levels(static_cast<size_t>(grown));
+    std::vector<uint64_t> occupied(static_cast<size_t>(grown) / 64, 0);
+    for (int64_t i = 0; i < size; ++i) {
+        if (levels_[static_cast<size_t>(i)].head) {
+            size_t index = static_cast<size_t>(i + offset);
+            levels[index] = levels_[static_cast<size_t>(i)];
+            occupied[index >> 6] |= uint64_t(1) << (index & 63);
+        }
+    }
+    levels_.swap(levels);
+    occupied_.swap(occupied);
+    base_ = base;
+    best_ += offset;
+}
+
+void PriceLadder::append(OrderNode* node) {
+    reserve(node->price);
+    int64_t index = node->price - base_;
+    Level& level = levels_[static_cast<size_t>(index)];
+    node->prev = level.tail;
+    node->next = nullptr;
+    if (level.tail) {
+        level.tail->next = node;
+    }
+    else {
+        level.head = node;
+        occupied_[static_cast<size_t>(index) >> 6] |= uint64_t(1) << (index & 63);
+        ++liveLevels_;
+    }
+    level.tail = node;
+    level.quantity += node->quantity;
+    ++level.orders;
+    if (best_ < 0 || better(index, best_)) {
+        best_ = index;
+    }
+}
+
+void PriceLadder::remove(OrderNode* node) {
+    int64_t index = node->price - base_;
+    Level& level = levels_[static_cast<size_t>(index)];
+    if (node->prev) {
+        node->prev->next = node->next;
+    }
+    else {
+        level.head = node->next;
+    }
+    if (node->next) {
+        node->next->prev = node->prev;
+    }
+    else {
+        level.tail = node->prev;
+    }
+    level.quantity -= node->quantity;
+    --level.orders;
+    if (!level.head) {
+        occupied_[static_cast<size_t>(index) >> 6] &= ~(uint64_t(1) << (index & 63));
+        --liveLevels_;
+        if (index == best_) {
+            best_ = liveLevels_ ? nextLevel(index) : -1;
+        }
+    }
+}
+
+void PriceLadder::restore(OrderNode* node) {
+    int64_t index = node->price - base_;
+    Level& level = levels_[static_cast<size_t>(index)];
+    if (node->prev) {
+        node->prev->next = node;
+    }
+    else {
+        level.head = node;
+    }
+    if (node->next) {
+        node->next->prev = node;
+    }
+    else {
+        level.tail = node;
+    }
+    level.quantity += node->quantity;
+    if (level.orders++ == 0) {
+        occupied_[static_cast<size_t>(index) >> 6] |= uint64_t(1) << (index & 63);
+        ++liveLevels_;
+    }
+    if (best_ < 0 || better(index, best_)) {
+        best_ = index;
+    }
+}
+
+void PriceLadder::reduce(OrderNode* node, uint64_t quantity) {
+    node->quantity -= quantity;
+    levels_[static_cast<size_t>(node->price - base_)].quantity -= quantity;
+}
+
+int64_t PriceLadder::nextLevel(int64_t from) const {
+    if (from < 0 || from >= static_cast<int64_t>(levels_.size())) {
+        return -1;
+    }
+    int64_t word = from >> 6;
+    int bit = static_cast<int>(from & 63);
+    if (side_ == Side::Buy) {
+        // 买方向低价查找
+        uint64_t bits = occupied_[static_cast<size_t>(word)] & (bit == 63 ? ~uint64_t(0) : (uint64_t(1) << (bit + 1)) - 1);
+        for (;;) {
+            if (bits) {
+                return word * 64 + highestBit(bits);
+            }
+            if (--word < 0) {
+                return -1;
+            }
+            bits = occupied_[static_cast<size_t>(word)];
+        }
+    }
+    uint64_t bits = occupied_[static_cast<size_t>(word)] & (~uint64_t(0) << bit);
+    const int64_t words = static_cast<int64_t>(occupied_.size());
+    for (;;) {
+        if (bits) {
+            return word * 64 + lowestBit(bits);
+        }
+        if (++word >= words) {
+            return -1;
+        }
+        bits = occupied_[static_cast<size_t>(word)];
+    }
+}
+
+void PriceLadder::depth(size_t maxLevels, std::vector<BookLevel>& out) const {
+    out.clear();
+    int64_t step = side_ == Side::Buy ? -1 : 1;
+    for (int64_t index = best_; index >= 0 && out.size() < maxLevels; index = nextLevel(index + step)) {
+        const Level& level = levels_[static_cast<size_t>(index)];
+        out.push_back(BookLevel{ base_ + index, level.quantity, level.orders });
+    }
+}
+
+void PriceLadder::orders(size_t maxLevels, std::vector<BookOrder>& out) const {
+    out.clear();
+    int64_t step = side_ == Side::Buy ? -1 : 1;
+    size_t visited = 0;
+    for (int64_t index = best_; index >= 0 && visited < maxLevels; index = nextLevel(index + step), ++visited) {
+        for (const OrderNode* node = levels_[static_cast<size_t>(index)].head; node; node = node->next) {
+            out.push_back(BookOrder{ node->orderId, node->price, node->quantity });
+        }
+    }
+}
+
+void PriceLadder::clear() {
+    std::fill(levels_.begin(), levels_.end(), Level{});
+    std::fill(occupied_.begin(), occupied_.end(), 0);
+    best_ = -1;
+    liveLevels_ = 0;
+}
+
+TopOfBook OrderBook::top() const {
+    TopOfBook top;
+    top.instrument = instrument_;
+    top.sequence = sequence_;
+    if (const PriceLadder::Level* bid = bids_.best()) {
+        top.bidPrice = bids_.bestPrice();
+        top.bidQuantity = bid->quantity;
+        top.bidOrders = bid->orders;
+    }
+    if (const PriceLadder::Level* ask = asks_.best()) {
+        top.askPrice = asks_.bestPrice();
+        top.askQuantity = ask->quantity;
+        top.askOrders = ask->orders;
+    }
+    return top;
+}
+
+OrderBook* OrderBookSet::bookFor(uint32_t instrument) {
+    if (instrument >= books_.size()) {
+        books_.resize(instrument + 1);
+    }
+    if (!books_[instrument]) {
+        books_[instrument] = std::make_unique<OrderBook>(instrument);
+        ++stats_.instruments;
+    }
+    return books_[instrument].get();
+}
+
+OrderBook* OrderBookSet::add(const OrderAdd& order) {
+    if (order.quantity == 0 || order.instrument >= kMaxInstruments || ids_.find(order.orderId)) {
+        ++stats_.rejected;
+        return nullptr;
+    }
+    OrderBook* book = bookFor(order.instrument);
+    PriceLadder& ladder = book->ladder(order.side);
+    if (!ladder.canHold(order.price)) {
+        ++stats_.rejected;
+        return nullptr;
+    }
+    OrderNode* node = pool_.acquire();
+    node->orderId = order.orderId;
+    node->price = order.price;
+    node->quantity = order.quantity;
+    node->instrument = order.instrument;
+    node->side = order.side;
+    ladder.append(node);
+    ids_.insert(node);
+    ++book->orders_;
+    ++book->sequence_;
+    ++stats_.adds;
+    return book;
+}
+
+OrderBook* OrderBookSet::modify(const OrderModify& order) {
+    OrderNode* node = ids_.find(order.orderId);
+    if (!node) {
+        ++stats_.rejected;
+        return nullptr;
+    }
+    OrderBook* book = books_[node->instrument].get();
+    PriceLadder& ladder = book->ladder(node->side);
+    if (order.quantity == 0) {
+        removeOrder(*book, node);
+    }
+    else if (order.price == node->price && order.quantity <= node->quantity) {
+        ladder.reduce(node, node->quantity - order.quantity);
+    }
+    else {
+        // 改价或增加数量：失去时间优先。先移出再检查新价格，同侧唯一的委托因此可改到任意价格；
+        // 放不下时放回原位，订单簿不变
+        ladder.remove(node);
+        if (!ladder.canHold(order.price)) {
+            ladder.restore(node);
+            ++stats_.rejected;
+            return nullptr;
+        }
+        node->price = order.price;
+        node->quantity = order.quantity;
+        ladder.append(node);
+    }
+    ++book->sequence_;
+    ++stats_.modifies;
+    return book;
+}
+
+OrderBook* OrderBookSet::cancel(const OrderCancel& order) {
+    OrderNode* node = ids_.find(order.orderId);
+    if (!node) {
+        ++stats_.rejected;
+        return nullptr;
+    }
+    OrderBook* book = books_[node->instrument].get();
+    if (order.quantity == 0 || order.quantity >= node->quantity) {
+        removeOrder(*book, node);
+    }
+    else {
+        book->ladder(node->side).reduce(node, order.quantity);
+    }
+    ++book->sequence_;
+    ++stats_.cancels;
+    return book;
+}
+
+void OrderBookSet::removeOrder(OrderBook& book, OrderNode* node) {
+    book.ladder(node->side).remove(node);
+    ids_.erase(node->orderId);
+    pool_.release(node);
+    --book.orders_;
+}
+
+OrderBookStats OrderBookSet::stats() const {
+    OrderBookStats result = stats_;
+    result.orders = ids_.size();
+    result.pooledNodes = pool_.capacity();
+    return result;
+}
+
+void OrderBookSet::clear() {
+    for (auto& book : books_) {
+        if (!book) {
+            continue;
+        }
+        for (PriceLadder* ladder : { &book->bids_, &book->asks_ }) {
+            std::vector<BookOrder> orders;
+            ladder->orders(PriceLadder::kMaxLevels, orders);
+            for (const BookOrder& order : orders) {
+                pool_.release(ids_.find(order.orderId));
+            }
+            ladder->clear();
+        }
+        book->orders_ = 0;
+    }
+    ids_.clear();
+}
@@ -0,0 +1,245 @@
+// src/PayloadPool.cpp
+#include "PayloadPool.h"
+#include <algorithm>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace {
+
+// 数据区分级
+constexpr size_t kClassBytes[] = { 64, 256, 1024, 4096, 16384, PayloadPool::kMaxPooledBytes };
+constexpr uint32_t kClasses = sizeof(kClassBytes) / sizeof(kClassBytes[0]);
+constexpr uint32_t kStringClass = kClasses;       // 字符串块
+constexpr uint32_t kOversizedClass = kClasses + 1;  // 直接从堆分配，释放时归还堆
+constexpr uint32_t kUnpooledStringClass = kClasses + 2;  // 线程退出过程中分配的字符串块
+constexpr size_t kSlabBytes = 64 * 1024;
+constexpr size_t kMinBlocksPerSlab = 4;
+// 归还时容量超过此值的字符串缓冲释放，避免偶发的大负载长期占用
+constexpr size_t kMaxRetainedString = 64 * 1024;
+
+constexpr size_t kAlign = alignof(std::max_align_t);
+constexpr size_t kHeaderBytes = (sizeof(PayloadBlock) + kAlign - 1) / kAlign * kAlign;
+
+struct StringBlock : PayloadBlock {
+    std::string text;
+};
+
+} // namespace
+
+struct PoolShard {
+    PayloadBlock* free[kClasses + 1] = {};         // 仅所属线程访问
+    std::atomic<PayloadBlock*> remote{ nullptr };  // 其他线程归还的块
+    std::vector<void*> slabs;
+    PoolShard* nextIdle = nullptr;
+
+    std::atomic<uint64_t> reused{ 0 };
+    std::atomic<uint64_t> created{ 0 };
+    std::atomic<uint64_t> slabCount{ 0 };
+    std::atomic<uint64_t> remoteFrees{ 0 };
+    std::atomic<uint64_t> oversized{ 0 };
+};
+
+namespace {
+
+inline void bump(std::atomic<uint64_t>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+// 全部分片；线程退出时分片进入空闲链表，由之后的新线程接手（其空闲块与远程归还照常有效）
+struct Registry {
+    std::mutex mutex;
+    std::vector<PoolShard*> shards;
+    PoolShard* idle = nullptr;
+};
+
+// 有意不销毁：其他静态对象析构时仍可能释放负载
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+thread_local PoolShard* tlsShard = nullptr;
+thread_local bool tlsExited = false;
+
+struct ShardHolder {
+    ~ShardHolder() {
+        if (tlsShard) {
+            Registry& shared = registry();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            tlsShard->nextIdle = shared.idle;
+            shared.idle = tlsShard;
+        }
+        tlsShard = nullptr;
+        tlsExited = true;
+    }
+};
+
+thread_local ShardHolder tlsHolder;
+
+// 当前线程的分片；线程退出过程中返回 nullptr
+PoolShard* currentShard() {
+    if (tlsShard) {
+        return tlsShard;
+    }
+    if (tlsExited) {
+        return nullptr;
+    }
+    (void)&tlsHolder;  // 确保本线程注册 ShardHolder 的析构
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    if (shared.idle) {
+        tlsShard = shared.idle;
+        shared.idle = tlsShard->nextIdle;
+        tlsShard->nextIdle = nullptr;
+    }
+    else {
+        tlsShard = new PoolShard();
+        shared.shards.push_back(tlsShard);
+    }
+    return tlsShard;
+}
+
+// 取回其他线程归还的块，按分级放回本地空闲链表
+void drainRemote(PoolShard& shard) {
+    PayloadBlock* block = shard.remote.exchange(nullptr, std::memory_order_acquire);
+    while (block) {
+        PayloadBlock* next = block->next;
+        block->next = shard.free[block->sizeClass];
+        shard.free[block->sizeClass] = block;
+        block = next;
+    }
+}
+
+PayloadBlock* popFree(PoolShard& shard, uint32_t sizeClass) {
+    PayloadBlock* block = shard.free[sizeClass];
+    if (!block && shard.remote.load(std::memory_order_relaxed)) {
+        drainRemote(shard);
+        block = shard.free[sizeClass];
+    }
+    if (block) {
+        shard.free[sizeClass] = block->next;
+        block->next = nullptr;
+        block->refs.store(1, std::memory_order_relaxed);
+        bump(shard.reused);
+    }
+    return block;
+}
+
+// 新分配一个 slab 切分为同一分级的块，放入本地空闲链表
+void growClass(PoolShard& shard, uint32_t sizeClass) {
+    size_t blockBytes = kHeaderBytes + kClassBytes[sizeClass];
+    size_t count = std::max(kMinBlocksPerSlab, kSlabBytes / blockBytes);
+    char* slab = static_cast<char*>(::operator new(blockBytes * count));
+    shard.slabs.push_back(slab);
+    bump(shard.slabCount);
+    for (size_t i = count; i-- > 0;) {
+        auto* block = new (slab + i * blockBytes) PayloadBlock();
+        block->sizeClass = sizeClass;
+        block->home = &shard;
+        block->next = shard.free[sizeClass];
+        shard.free[sizeClass] = block;
+    }
+    shard.created.fetch_add(count, std::memory_order_relaxed);
+}
+
+PayloadBlock* allocateOversized(size_t size, PoolShard* shard) {
+    auto* block = new (::operator new(kHeaderBytes + size)) PayloadBlock();
+    block->sizeClass = kOversizedClass;
+    if (shard) {
+        bump(shard->oversized);
+    }
+    return block;
+}
+
+} // namespace
+
+PayloadBlock* PayloadPool::allocate(size_t size) {
+    PoolShard* shard = currentShard();
+    uint32_t sizeClass = 0;
+    while (sizeClass < kClasses && kClassBytes[sizeClass] < size) {
+        ++sizeClass;
+    }
+    if (!shard || sizeClass == kClasses) {
+        return allocateOversized(size, shard);
+    }
+    PayloadBlock* block = popFree(*shard, sizeClass);
+    if (!block) {
+        growClass(*shard, sizeClass);
+        block = popFree(*shard, sizeClass);
+    }
+    return block;
+}
+
+void* PayloadPool::data(PayloadBlock* block) {
+    return reinterpret_cast<char*>(block) + kHeaderBytes;
+}
+
+PayloadBlock* PayloadPool::allocateString(std::string_view text) {
+    PoolShard* shard = currentShard();
+    StringBlock* block = nullptr;
+    if (shard) {
+        block = static_cast<StringBlock*>(popFree(*shard, kStringClass));
+        if (!block) {
+            block = new StringBlock();
+            block->sizeClass = kStringClass;
+            block->home = shard;
+            bump(shard->created);
+        }
+    }
+    else {
+        block = new StringBlock();
+        block->sizeClass = kUnpooledStringClass;
+    }
+    block->text.assign(text.data(), text.size());
+    return block;
+}
+
+const std::string* PayloadPool::string(PayloadBlock* block) {
+    return &static_cast<StringBlock*>(block)->text;
+}
+
+void PayloadBlock::recycle(PayloadBlock* block) {
+    if (block->sizeClass == kUnpooledStringClass) {
+        delete static_cast<StringBlock*>(block);
+        return;
+    }
+    if (block->sizeClass == kOversizedClass) {
+        block->~PayloadBlock();
+        ::operator delete(block);
+        return;
+    }
+    if (block->sizeClass == kStringClass) {
+        std::string& text = static_cast<StringBlock*>(block)->text;
+        if (text.capacity() > kMaxRetainedString) {
+            std::string().swap(text);
+        }
+    }
+    PoolShard* home = block->home;
+    if (home == tlsShard) {
+        block->next = home->free[block->sizeClass];
+        home->free[block->sizeClass] = block;
+        return;
+    }
+    // 多个线程可同时归还；所属线程一次取走整个栈，因此不存在 ABA 问题
+    home->remoteFrees.fetch_add(1, std::memory_order_relaxed);
+    PayloadBlock* head = home->remote.load(std::memory_order_relaxed);
+    do {
+        block->next = head;
+    } while (!home->remote.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+}
+
+PayloadPoolStats PayloadPool::stats() {
+    PayloadPoolStats result;
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    result.shards = shared.shards.size();
+    for (const PoolShard* shard : shared.shards) {
+        result.reused += shard->reused.load(std::memory_order_relaxed);
+        result.created += shard->created.load(std::memory_order_relaxed);
+        result.slabs += shard->slabCount.load(std::memory_order_relaxed);
+        result.remoteFrees += shard->remoteFrees.load(std::memory_order_relaxed);
+        result.oversized += shard->oversized.load(std::memory_order_relaxed);
+    }
+    return result;
+}
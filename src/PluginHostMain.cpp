@@ -0,0 +1,352 @@
+// src/PluginHostMain.cpp
+// 隔离插件的子进程宿主：由 IsolatedPlugin 启动，加载一个插件库并经共享内存环与父进程交换事件。
+// 用法：MotsPluginHost <共享内存名称> <环容量> <插件路径> <内存上限> <发送超时(us)> <自旋时间(us)>
+#include "IsolatedPlugin.h"
+#include "IPlugin.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__linux__)
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+
+namespace {
+
+// 子进程内的宿主服务：订阅登记在本地的事件表，并在事件首个订阅者出现与最后一个离开时告知父进程；
+// 发布经环交给父进程，在共享总线上触发（插件自己的订阅也经父进程转发回来）。定时器在子进程内触发。
+// 类型化负载按插件 bindType 绑定的类型重建，未绑定的以原始字节投递
+class ChildHost : public IPluginHost {
+public:
+    ChildHost(ShmRing toParent, std::string name, std::chrono::microseconds sendTimeout)
+        : toParent_(toParent), name_(std::move(name)), sendTimeout_(sendTimeout),
+          id_(events_.resolvePlugin(name_)), logger_(Logger::global().channel(name_)) {}
+
+    const std::string& pluginName() const override { return name_; }
+    PluginId pluginId() const override { return id_; }
+
+    EventId resolveEvent(const std::string& eventName) override {
+        return events_.resolveEvent(eventName);
+    }
+
+    SubscriptionToken subscribe(EventId eventId, PayloadCallback callback, const SubscriptionOptions& options) override {
+        SubscriptionToken token = events_.registerEvent(id_, eventId, std::move(callback));
+        if (token) {
+            IsolationSubscribe request{ static_cast<uint32_t>(options.policy), static_cast<uint32_t>(options.capacity) };
+            added(eventId, request);
+        }
+        return token;
+    }
+
+    SubscriptionToken subscribeBatch(EventId eventId, BatchCallback callback) override {
+        SubscriptionToken token = events_.registerBatchEvent(id_, eventId, std::move(callback));
+        if (token) {
+            added(eventId, IsolationSubscribe{ static_cast<uint32_t>(DeliveryPolicy::Direct), 0 });
+        }
+        return token;
+    }
+
+    bool unsubscribe(const SubscriptionToken& token) override {
+        if (!events_.unsubscribe(token)) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--subscribers_[token.eventId.value] == 0) {
+            sendLocked(IsolationFrame{ IsolationMessage::Unsubscribe, IsolationPayloadKind::Empty, 0, token.eventId.value, 0, 0 },
+                std::string_view());
+        }
+        return true;
+    }
+
+    void publish(EventId eventId, const EventPayload& payload) override {
+        send(eventId, payload, IsolationPublishMode::Sync);
+    }
+
+    void publish(const BatchEvent* events, size_t count) override {
+        for (size_t i = 0; i < count; ++i) {
+            send(events[i].eventId, events[i].payload, IsolationPublishMode::Sync);
+        }
+    }
+
+    bool publishAsync(EventId eventId, const EventPayload& payload) override {
+        return send(eventId, payload, IsolationPublishMode::Async);
+    }
+
+    // 分区键随消息交给父进程，由父进程按键有序分发
+    void publish(EventId eventId, const EventPayload& payload, std::string_view partitionKey) override {
+        send(eventId, payload, IsolationPublishMode::Partitioned, partitionKey);
+    }
+
+    ILogger& logger() override { return logger_; }
+
+    TimerId scheduleTimer(EventId eventId, std::chrono::nanoseconds delay, std::chrono::nanoseconds period) override {
+        return timers_.schedule(id_, eventId, delay, period);
+    }
+
+    bool cancelTimer(TimerId timer) override {
+        return timers_.cancel(timer);
+    }
+
+    // 仅在 initialize() 与事件回调中调用，均在主循环线程上
+    void bindType(const std::type_info& type, size_t size) override {
+        types_.bind(type, size);
+    }
+
+    // 把父进程转发的事件交给本地订阅者
+    void deliver(const IsolationFrame& frame, std::string_view body) {
+        EventId eventId{ frame.eventId };
+        if (frame.payloadKind == IsolationPayloadKind::String) {
+            text_.assign(body);
+            events_.triggerEvent(eventId, EventPayload::fromString(text_));
+        }
+        else if (frame.payloadKind == IsolationPayloadKind::Bytes) {
+            events_.triggerEvent(eventId, EventPayload::fromBytes(body));
+        }
+        else if (frame.payloadKind == IsolationPayloadKind::Typed) {
+            events_.triggerEvent(eventId, parentTypes_.payload(frame.typeId, body));
+        }
+        else {
+            events_.triggerEvent(eventId, EventPayload{});
+        }
+    }
+
+    void defineType(const IsolationFrame& frame, std::string_view name) {
+        if (!parentTypes_.define(frame.typeId, name, types_)) {
+            logger_.logf(LogLevel::Warn, "Payload type %.*s is not bound with IPluginHost::bindType, delivering it as bytes",
+                static_cast<int>(name.size()), name.data());
+        }
+    }
+
+    bool sendControl(IsolationMessage type, std::string_view body = {}) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return sendLocked(IsolationFrame{ type, IsolationPayloadKind::Empty, 0, EventId::kInvalid, 0, 0 }, body);
+    }
+
+private:
+    ShmRing toParent_;
+    const std::string name_;
+    const std::chrono::microseconds sendTimeout_;
+    EventManager events_;
+    TimerWheel timers_{ events_ };
+    const PluginId id_;
+    LogChannel& logger_;
+    std::string text_;  // 重建字符串负载的复用缓冲，仅在主循环中使用
+    IsolationTypes types_;             // 插件绑定的类型，仅在主循环线程上修改
+    IsolationTypeTable parentTypes_;   // 父进程类型编号 -> 本地类型，仅在主循环中使用
+
+    std::mutex mutex_;  // 子到父的环与下列表格；插件可在多个线程上发布
+    std::vector<bool> defined_;
+    std::unordered_map<uint32_t, size_t> subscribers_;
+    IsolationTypeIds sentTypes_;
+    std::unordered_set<std::type_index> rejectedTypes_;
+
+    void added(EventId eventId, const IsolationSubscribe& request) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (subscribers_[eventId.value]++ == 0) {
+            sendLocked(IsolationFrame{ IsolationMessage::Subscribe, IsolationPayloadKind::Bytes, 0, eventId.value, 0, 0 },
+                std::string_view(reinterpret_cast<const char*>(&request), sizeof(request)));
+        }
+    }
+
+    // 不可按字节复制的负载无法交给父进程：按类型报告一次并拒绝发布
+    bool send(EventId eventId, const EventPayload& payload, IsolationPublishMode mode, std::string_view key = {}) {
+        IsolationFrame frame{ IsolationMessage::Publish, IsolationPayloadKind::Empty, static_cast<uint8_t>(mode), eventId.value,
+            0, static_cast<uint32_t>(key.size()) };
+        std::string_view bytes;
+        bool copyable = isolationPayloadOf(payload, frame.payloadKind, bytes);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!copyable) {
+            if (rejectedTypes_.insert(std::type_index(*payload.type())).second) {
+                logger_.logf(LogLevel::Error, "Cannot publish a payload of type %s from an isolated plugin: it is not trivially copyable",
+                    payload.type()->name());
+            }
+            return false;
+        }
+        if (frame.payloadKind == IsolationPayloadKind::Typed) {
+            bool defined = false;
+            frame.typeId = sentTypes_.find(*payload.type(), defined);
+            if (!defined) {
+                if (!write(IsolationFrame{ IsolationMessage::DefineType, IsolationPayloadKind::String, 0, 0, frame.typeId, 0 },
+                    payload.type()->name())) {
+                    return false;
+                }
+                sentTypes_.define(*payload.type());
+            }
+        }
+        return sendLocked(frame, bytes, key);
+    }
+
+    // 事件首次出现时先发送其名称；环满时等待至多 sendTimeout，超时丢弃
+    bool sendLocked(const IsolationFrame& frame, std::string_view body, std::string_view key = {}) {
+        uint32_t eventId = frame.eventId;
+        if (EventId{ eventId }.valid() && (defined_.size() <= eventId || !defined_[eventId])) {
+            std::string name = events_.eventName(EventId{ eventId });
+            if (!write(IsolationFrame{ IsolationMessage::DefineEvent, IsolationPayloadKind::String, 0, eventId, 0, 0 }, name)) {
+                return false;
+            }
+            if (defined_.size() <= eventId) {
+                defined_.resize(eventId + 1);
+            }
+            defined_[eventId] = true;
+        }
+        return write(frame, body, key);
+    }
+
+    bool write(const IsolationFrame& frame, std::string_view body, std::string_view key = {}) {
+        auto deadline = std::chrono::steady_clock::now() + sendTimeout_;
+        while (!toParent_.tryWrite(&frame, sizeof(frame), body.data(), body.size(), key.data(), key.size())) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                logger_.logf(LogLevel::Warn, "Dropped a message to the host process: ring full");
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+};
+
+// 等待父进程的下一条消息（父进程退出时由 PR_SET_PDEATHSIG 结束本进程）
+bool nextMessage(ShmRing& ring, std::chrono::microseconds spin, ShmRing::Message& message) {
+    while (!ring.peek(message)) {
+        ring.wait(spin, std::chrono::milliseconds(100));
+    }
+    return true;
+}
+
+IsolationFrame frameOf(const ShmRing::Message& message) {
+    IsolationFrame frame;
+    std::memcpy(&frame, message.data, sizeof(frame));
+    return frame;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 7) {
+        std::fprintf(stderr, "Usage: %s <shm> <ringBytes> <plugin> <memoryLimit> <sendTimeoutUs> <spinUs>\n", argv[0]);
+        return 2;
+    }
+    const char* shmName = argv[1];
+    size_t ringBytes = std::strtoull(argv[2], nullptr, 10);
+    std::string path = argv[3];
+    size_t memoryLimit = std::strtoull(argv[4], nullptr, 10);
+    std::chrono::microseconds sendTimeout(std::strtoll(argv[5], nullptr, 10));
+    std::chrono::microseconds spin(std::strtoll(argv[6], nullptr, 10));
+
+    // 父进程退出时随之结束，不留下孤儿进程
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (getppid() == 1) {
+        return 1;
+    }
+
+    int fd = shm_open(shmName, O_RDWR, 0);
+    if (fd < 0) {
+        std::fprintf(stderr, "MotsPluginHost: shm_open %s failed\n", shmName);
+        return 1;
+    }
+    size_t segmentBytes = sizeof(IsolationSegment) + 2 * ringBytes;
+    void* segment = mmap(nullptr, segmentBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED) {
+        std::fprintf(stderr, "MotsPluginHost: mmap %s failed\n", shmName);
+        return 1;
+    }
+    auto* header = static_cast<IsolationSegment*>(segment);
+    char* data = static_cast<char*>(segment) + sizeof(IsolationSegment);
+    ShmRing fromParent(&header->toChild, data);
+    ShmRing toParent(&header->toParent, data + ringBytes);
+
+    // 映射共享内存后再限制地址空间，超出上限的分配失败使插件崩溃并由父进程重启
+    if (memoryLimit != 0) {
+        struct rlimit limit{ memoryLimit, memoryLimit };
+        setrlimit(RLIMIT_AS, &limit);
+    }
+
+    void* handle = dlopen(path.c_str(), RTLD_NOW);
+    CreatePluginFunc create = handle ? reinterpret_cast<CreatePluginFunc>(dlsym(handle, "CreatePlugin")) : nullptr;
+    std::unique_ptr<IPlugin> plugin(create ? create() : nullptr);
+    if (!plugin) {
+        std::fprintf(stderr, "MotsPluginHost: failed to load plugin %s: %s\n", path.c_str(), handle ? "no CreatePlugin" : dlerror());
+        return 1;
+    }
+
+    int exitCode = 0;
+    {
+        std::string name = plugin->getName();
+        ChildHost host(toParent, name, sendTimeout);
+        plugin->setLogger(&host.logger());
+
+        std::string hello = name;
+        for (const auto& dependency : plugin->getDependencies()) {
+            hello.push_back('\0');
+            hello += dependency;
+        }
+        host.sendControl(IsolationMessage::Hello, hello);
+
+        ShmRing::Message message;
+        nextMessage(fromParent, spin, message);
+        IsolationMessage reply = frameOf(message).type;
+        fromParent.pop();
+        if (reply != IsolationMessage::Accept) {
+            return 1;
+        }
+
+        bool initialized = false;
+        try {
+            initialized = plugin->initialize(host);
+        }
+        catch (const std::exception& e) {
+            host.logger().logf(LogLevel::Error, "Exception in plugin initialize: %s", e.what());
+        }
+        host.sendControl(initialized ? IsolationMessage::Ready : IsolationMessage::InitFailed);
+
+        for (bool running = initialized; running;) {
+            nextMessage(fromParent, spin, message);
+            IsolationFrame frame = frameOf(message);
+            std::string_view body(message.data + sizeof(frame), message.size - sizeof(frame));
+            if (frame.type == IsolationMessage::Event) {
+                host.deliver(frame, body);
+            }
+            else if (frame.type == IsolationMessage::DefineType) {
+                host.defineType(frame, body);
+            }
+            else if (frame.type == IsolationMessage::Shutdown) {
+                running = false;
+            }
+            fromParent.pop();
+        }
+        if (initialized) {
+            plugin->shutdown();
+        }
+        else {
+            exitCode = 1;
+        }
+        plugin.reset();
+    }
+    Logger::global().flush();
+    dlclose(handle);
+    munmap(segment, segmentBytes);
+    return exitCode;
+}
+
+#else
+
+int main() {
+    std::fprintf(stderr, "MotsPluginHost: isolated plugins are not supported on this platform\n");
+    return 1;
+}
+
+#endif
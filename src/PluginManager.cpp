@@ -1,124 +1,1789 @@
 // src/PluginManager.cpp
 #include "PluginManager.h"
-#include <iostream>
+#include "IPluginHost.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
 
-PluginManager::PluginManager() {}
+// 热重载切换后、状态迁移完成前，新实例的回调经闸门暂存事件（负载转为拥有型）；
+// open() 按到达顺序补发后放行，补发期间其他线程上到达的事件等待补发完成后再执行
+class ReloadGate {
+public:
+    explicit ReloadGate(ILogger& log) : log_(log) {}
+
+    bool isOpen() const { return open_.load(std::memory_order_acquire); }
+
+    // 闸门关闭时暂存 task，已打开时直接执行
+    void hold(std::function<void()> task) {
+        {
+            std::lock_guard<std::recursive_mutex> lock(mutex_);
+            if (!open_.load(std::memory_order_relaxed)) {
+                pending_.push_back(std::move(task));
+                return;
+            }
+        }
+        task();
+    }
+
+    // 补发中的回调再次触发本实例的订阅时，新事件排在队尾
+    void open() {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        for (size_t i = 0; i < pending_.size(); ++i) {
+            std::function<void()> task = std::move(pending_[i]);
+            try {
+                task();
+            }
+            catch (const std::exception& e) {
+                log_.logf(LogLevel::Error, "Exception in event callback: %s", e.what());
+            }
+            catch (...) {
+                log_.logf(LogLevel::Error, "Unknown exception in event callback.");
+            }
+        }
+        pending_.clear();
+        open_.store(true, std::memory_order_release);
+    }
+
+    // 放弃新实例时丢弃暂存的事件，返回丢弃的数量
+    size_t discard() {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        size_t dropped = pending_.size();
+        pending_.clear();
+        return dropped;
+    }
+
+    static PayloadCallback wrap(std::shared_ptr<ReloadGate> gate, PayloadCallback callback) {
+        auto inner = std::make_shared<PayloadCallback>(std::move(callback));
+        return [gate = std::move(gate), inner](const EventPayload& payload) {
+            if (gate->isOpen()) {
+                (*inner)(payload);
+                return;
+            }
+            gate->hold([inner, retained = payload.retain()] { (*inner)(retained); });
+        };
+    }
+
+    static BatchCallback wrap(std::shared_ptr<ReloadGate> gate, BatchCallback callback) {
+        auto inner = std::make_shared<BatchCallback>(std::move(callback));
+        return [gate = std::move(gate), inner](const EventBatchView& batch) {
+            if (gate->isOpen()) {
+                (*inner)(batch);
+                return;
+            }
+            std::vector<BatchEvent> retained;
+            retained.reserve(batch.size());
+            for (const BatchEvent& event : batch) {
+                retained.push_back(BatchEvent{ event.eventId, event.payload.retain() });
+            }
+            gate->hold([inner, retained = std::move(retained)] { (*inner)(EventBatchView(retained.data(), retained.size())); });
+        };
+    }
+
+private:
+    ILogger& log_;
+    std::atomic<bool> open_{ false };
+    std::recursive_mutex mutex_;
+    std::vector<std::function<void()>> pending_;
+};
+
+// 经宿主建立的订阅与定时器按实例登记；revoke() 之后宿主拒绝新的订阅与定时器。
+// 订阅在持锁期间完成，revoke() 取得锁后不会再有新的订阅生效。
+// 延迟激活与热重载的实例以暂存模式构造：initialize() 中的订阅只预留编号，由 commit() 与被替换的订阅
+// （激活桩或旧实例的订阅）一并生效。每个订阅保留登记时的回调副本，重载失败时据此恢复旧实例的订阅
+class PluginHost : public IPluginHost {
+public:
+    enum class Mode {
+        Live,    // 订阅立即生效
+        Staged,  // 订阅暂存到 commit()
+        Gated    // 暂存，且回调在 openGate() 之前经闸门暂存事件（热重载）
+    };
+
+    PluginHost(PluginManager& manager, PluginId pluginId, std::string pluginName, Mode mode = Mode::Live)
+        : manager_(manager), pluginId_(pluginId), pluginName_(std::move(pluginName)),
+          logger_(manager.eventManager_.logger().channel(pluginName_)),
+          gate_(mode == Mode::Gated ? std::make_shared<ReloadGate>(logger_) : nullptr),
+          instance_(nextInstance_.fetch_add(1, std::memory_order_relaxed)), staged_(mode != Mode::Live) {}
+
+    const std::string& pluginName() const override { return pluginName_; }
+    PluginId pluginId() const override { return pluginId_; }
+
+    EventId resolveEvent(const std::string& eventName) override {
+        return manager_.eventManager_.resolveEvent(eventName);
+    }
+
+    SubscriptionToken subscribe(EventId eventId, PayloadCallback callback, const SubscriptionOptions& options) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (revoked_) {
+            return SubscriptionToken{};
+        }
+        PluginManager::PreparedSubscription prepared = manager_.prepareSubscription(pluginId_, pluginName_, eventId,
+            std::move(callback), options);
+        if (gate_) {
+            prepared.staged.callback = ReloadGate::wrap(gate_, std::move(prepared.staged.callback));
+        }
+        return addLocked(std::move(prepared));
+    }
+
+    SubscriptionToken subscribeBatch(EventId eventId, BatchCallback callback) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (revoked_) {
+            return SubscriptionToken{};
+        }
+        PluginManager::PreparedSubscription prepared = manager_.prepareBatchSubscription(pluginId_, eventId,
+            std::move(callback), SubscriptionQos{});
+        if (gate_) {
+            prepared.staged.batchCallback = ReloadGate::wrap(gate_, std::move(prepared.staged.batchCallback));
+        }
+        return addLocked(std::move(prepared));
+    }
+
+    bool unsubscribe(const SubscriptionToken& token) override {
+        PluginManager::PreparedSubscription removed;
+        bool live = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = std::find_if(subscriptions_.begin(), subscriptions_.end(), [&](const Subscription& owned) {
+                return owned.token.eventId == token.eventId && owned.token.subscriptionId == token.subscriptionId;
+            });
+            if (it == subscriptions_.end()) {
+                return false;
+            }
+            removed = std::move(it->prepared);
+            subscriptions_.erase(it);
+            live = !staged_;
+        }
+        if (!live) {
+            // 尚未生效的订阅只需释放其反应器回调与邮箱
+            manager_.bindSubscription(removed, SubscriptionToken{});
+            return true;
+        }
+        return manager_.unsubscribePluginEvent(token);
+    }
+
+    void publish(EventId eventId, const EventPayload& payload) override {
+        manager_.triggerPluginEvent(eventId, payload);
+    }
+
+    void publish(const BatchEvent* events, size_t count) override {
+        manager_.triggerPluginEvents(events, count);
+    }
+
+    bool publishAsync(EventId eventId, const EventPayload& payload) override {
+        return manager_.publishAsync(eventId, payload);
+    }
+
+    void publish(EventId eventId, const EventPayload& payload, std::string_view partitionKey) override {
+        manager_.triggerPluginEvent(eventId, payload, partitionKey);
+    }
+
+    ILogger& logger() override { return logger_; }
+
+    // 定时器由时间轮按插件与实例登记，撤销时按实例批量取消
+    TimerId scheduleTimer(EventId eventId, std::chrono::nanoseconds delay, std::chrono::nanoseconds period) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (revoked_) {
+            return TimerId{};
+        }
+        return manager_.timers_.schedule(pluginId_, eventId, delay, period, instance_);
+    }
+
+    bool cancelTimer(TimerId timer) override {
+        return manager_.timers_.cancel(timer, pluginId_, instance_);
+    }
+
+    // 撤销本实例经宿主建立的全部订阅与定时器，返回后不会再调用这些订阅的回调
+    void revoke() {
+        std::vector<Subscription> subscriptions;
+        bool live = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            revoked_ = true;
+            subscriptions.swap(subscriptions_);
+            live = !staged_;
+        }
+        manager_.timers_.cancelPluginTimers(pluginId_, instance_);
+        if (!live) {
+            for (auto& subscription : subscriptions) {
+                manager_.bindSubscription(subscription.prepared, SubscriptionToken{});
+            }
+            return;
+        }
+        bool removed = false;
+        for (const auto& subscription : subscriptions) {
+            removed = manager_.eventManager_.unsubscribe(subscription.token) || removed;
+        }
+        if (removed) {
+            // 先关闭邮箱唤醒阻塞的发布者，全部注销后只等待一次在途回调
+            for (const auto& subscription : subscriptions) {
+                manager_.closeMailbox(subscription.token);
+            }
+            manager_.eventManager_.synchronize();
+            for (const auto& subscription : subscriptions) {
+                manager_.closeReactorCallback(subscription.token);
+            }
+        }
+    }
+
+    // 热重载切换前：拒绝新的订阅与定时器（已有定时器照常触发），返回当前订阅的凭据
+    std::vector<SubscriptionToken> suspend() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        revoked_ = true;
+        std::vector<SubscriptionToken> tokens;
+        for (const auto& subscription : subscriptions_) {
+            tokens.push_back(subscription.token);
+        }
+        return tokens;
+    }
+
+    // 重载失败时恢复：registered() 为按原编号重新登记的回调副本
+    void resume() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        revoked_ = false;
+    }
+
+    std::vector<StagedSubscription> registered() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<StagedSubscription> staged;
+        for (const auto& subscription : subscriptions_) {
+            staged.push_back(subscription.prepared.staged);
+        }
+        return staged;
+    }
+
+    // 注销 removed（旧实例的订阅）并使暂存的订阅生效，二者在同一次快照切换中完成
+    void commit(const std::vector<SubscriptionToken>& removed) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<StagedSubscription> added;
+        for (const auto& subscription : subscriptions_) {
+            added.push_back(subscription.prepared.staged);
+        }
+        std::vector<SubscriptionToken> tokens = manager_.eventManager_.replaceSubscriptions(pluginId_, removed, added);
+        size_t kept = 0;
+        for (size_t i = 0; i < subscriptions_.size(); ++i) {
+            manager_.bindSubscription(subscriptions_[i].prepared, tokens[i]);
+            if (tokens[i]) {
+                subscriptions_[kept++] = std::move(subscriptions_[i]);
+            }
+            else {
+                logger_.logf(LogLevel::Error, "Cannot register event. Invalid event id: %u", subscriptions_[i].token.eventId.value);
+            }
+        }
+        subscriptions_.resize(kept);
+        staged_ = false;
+    }
+
+    // 把事件直接交给本实例订阅 eventId 的回调，按优先级类别排列（延迟激活时补发触发激活的事件）
+    void deliver(EventId eventId, const EventPayload& payload) {
+        std::vector<StagedSubscription> targets;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& subscription : subscriptions_) {
+                if (subscription.token.eventId == eventId) {
+                    targets.push_back(subscription.prepared.staged);
+                }
+            }
+        }
+        std::stable_sort(targets.begin(), targets.end(), [](const StagedSubscription& a, const StagedSubscription& b) {
+            return a.qos.priority < b.qos.priority;
+        });
+        BatchEvent event{ eventId, payload };
+        for (const auto& target : targets) {
+            try {
+                if (target.batchCallback) {
+                    target.batchCallback(EventBatchView(&event, 1));
+                }
+                else {
+                    target.callback(payload);
+                }
+            }
+            catch (const std::exception& e) {
+                logger_.logf(LogLevel::Error, "Exception in event callback: %s", e.what());
+            }
+            catch (...) {
+                logger_.logf(LogLevel::Error, "Unknown exception in event callback.");
+            }
+        }
+    }
+
+    // 状态迁移完成后补发暂存的事件
+    void openGate() {
+        std::shared_ptr<ReloadGate> gate;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            gate = std::move(gate_);
+        }
+        if (gate) {
+            gate->open();
+        }
+    }
+
+    // 放弃新实例（其订阅已注销且在途回调已返回）时丢弃暂存的事件，返回丢弃的数量
+    size_t discardGate() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return gate_ ? gate_->discard() : 0;
+    }
+
+    // 订阅已由 replaceSubscriptions 注销且在途回调已返回：关闭其邮箱与反应器回调，取消定时器
+    void retire() {
+        std::vector<Subscription> subscriptions;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            revoked_ = true;
+            subscriptions.swap(subscriptions_);
+        }
+        manager_.timers_.cancelPluginTimers(pluginId_, instance_);
+        for (const auto& subscription : subscriptions) {
+            manager_.closeMailbox(subscription.token);
+            manager_.closeReactorCallback(subscription.token);
+        }
+    }
+
+private:
+    struct Subscription {
+        SubscriptionToken token;
+        PluginManager::PreparedSubscription prepared;  // 登记时的回调副本（含反应器、邮箱与闸门外壳）
+    };
+
+    PluginManager& manager_;
+    const PluginId pluginId_;
+    const std::string pluginName_;
+    LogChannel& logger_;
+    std::mutex mutex_;
+    std::shared_ptr<ReloadGate> gate_;  // 仅热重载的新实例，打开后释放
+    std::vector<Subscription> subscriptions_;
+    const uint32_t instance_;  // 时间轮中区分同一插件新旧实例的定时器
+    bool staged_ = false;
+    bool revoked_ = false;
+
+    static inline std::atomic<uint32_t> nextInstance_{ 1 };
+
+    // 暂存模式只预留编号，否则立即登记
+    SubscriptionToken addLocked(PluginManager::PreparedSubscription prepared) {
+        SubscriptionToken token;
+        if (staged_) {
+            token = manager_.eventManager_.reserveSubscription(pluginId_, prepared.staged.eventId);
+            if (!token) {
+                manager_.bindSubscription(prepared, token);
+            }
+        }
+        else if (prepared.staged.batchCallback) {
+            token = manager_.eventManager_.registerBatchEvent(pluginId_, prepared.staged.eventId,
+                prepared.staged.batchCallback, prepared.staged.qos);
+            manager_.bindSubscription(prepared, token);
+        }
+        else {
+            token = manager_.eventManager_.registerEvent(pluginId_, prepared.staged.eventId,
+                prepared.staged.callback, prepared.staged.qos);
+            manager_.bindSubscription(prepared, token);
+        }
+        if (!token) {
+            logger_.logf(LogLevel::Error, "Cannot register event. Invalid event id: %u", prepared.staged.eventId.value);
+            return token;
+        }
+        prepared.staged.subscriptionId = token.subscriptionId;
+        subscriptions_.push_back(Subscription{ token, std::move(prepared) });
+        return token;
+    }
+};
+
+struct LazyPlugin {
+    std::string path;
+    std::string name;
+    PluginId id;
+    std::vector<std::shared_ptr<LazyPlugin>> prerequisites;  // 同为延迟激活的依赖
+    std::vector<SubscriptionToken> stubs;                    // 激活桩的订阅凭据
+    // 递归锁：插件在 initialize() 中触发自身事件时不会死锁，而是视为激活失败
+    std::recursive_mutex mutex;
+    std::atomic<bool> active{ false };
+    bool failed = false;  // 激活失败后不再重试
+    bool closed = false;  // 已卸载，不再激活
+    LibHandle handle = nullptr;
+    std::unique_ptr<IPlugin> instance;
+    std::shared_ptr<PluginHost> host;
+};
+
+namespace {
+
+#if defined(_WIN32)
+const char* const kPluginSuffix = ".dll";
+#elif defined(__APPLE__)
+const char* const kPluginSuffix = ".dylib";
+#else
+const char* const kPluginSuffix = ".so";
+#endif
+
+const char* const kManifestSuffix = ".manifest";
+
+// 插件旁路清单：每行一个 key=value，# 开头为注释；event 与 depends 可重复
+struct PluginManifest {
+    std::string name;
+    std::vector<std::string> events;
+    std::vector<std::string> dependencies;
+};
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return {};
+    }
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+bool readManifest(const std::string& manifestPath, PluginManifest& manifest, ILogger& log) {
+    std::ifstream input(manifestPath);
+    if (!input) {
+        log.logf(LogLevel::Error, "Failed to open plugin manifest: %s", manifestPath.c_str());
+        return false;
+    }
+    std::string line;
+    while (std::getline(input, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        size_t separator = line.find('=');
+        if (separator == std::string::npos) {
+            log.logf(LogLevel::Error, "Invalid line in plugin manifest %s: %s", manifestPath.c_str(), line.c_str());
+            return false;
+        }
+        std::string key = trim(line.substr(0, separator));
+        std::string value = trim(line.substr(separator + 1));
+        if (key == "name") {
+            manifest.name = value;
+        }
+        else if (key == "event") {
+            manifest.events.push_back(value);
+        }
+        else if (key == "depends") {
+            manifest.dependencies.push_back(value);
+        }
+        // 未知键忽略，便于清单格式后续扩展
+    }
+    if (manifest.name.empty()) {
+        log.logf(LogLevel::Error, "Plugin manifest does not declare a name: %s", manifestPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+// 批量加载中的候选插件
+struct PendingPlugin {
+    PluginInfo info;
+    bool failed = false;
+    bool initialized = false;       // 已调用过 initialize()
+    size_t waiting = 0;             // 同批次中尚未初始化完成的依赖数
+    std::vector<size_t> dependents; // 同批次中依赖本插件的候选
+};
+
+// 在 threads 个线程（含调用线程）上执行 task(0..count-1)
+template <typename Task>
+void parallelFor(size_t count, size_t threads, Task task) {
+    std::atomic<size_t> next{ 0 };
+    auto worker = [&] {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            task(i);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+}
+
+double toMillis(std::chrono::nanoseconds duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+} // namespace
+
+PluginManager::PluginManager(Logger& logger) : eventManager_(logger), log_(logger.channel("PluginManager")) {}
 
 PluginManager::~PluginManager() {
+    stopJournal();
+    stopAsyncDispatch();
     unloadAll();
 }
 
 bool PluginManager::isPluginLoaded(const std::string& pluginName) const {
-    for (const auto& pluginInfo : plugins_) {
-        if (pluginInfo.instance && pluginInfo.instance->getName() == pluginName) {
-            return true;
+    return nameIndex_.count(pluginName) != 0;
+}
+
+const PluginInfo* PluginManager::findPlugin(const std::string& pluginName) const {
+    auto it = nameIndex_.find(pluginName);
+    return it != nameIndex_.end() ? &plugins_[it->second] : nullptr;
+}
+
+bool PluginManager::loadPlugin(const std::string& path) {
+    return loadPlugin(path, ExecutionPolicy{});
+}
+
+bool PluginManager::loadPlugin(const std::string& path, const ExecutionPolicy& policy) {
+    std::vector<PluginLoadReport> reports = loadPlugins(std::vector<std::string>{ path }, 1, policy);
+    return reports.size() == 1 && reports[0].loaded;
+}
+
+std::vector<PluginLoadReport> PluginManager::loadPlugins(const std::string& directory, size_t threads) {
+    std::vector<std::string> paths;
+    std::error_code ec;
+    for (auto it = std::filesystem::directory_iterator(directory, ec);
+        !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        if (it->is_regular_file(ec) && it->path().extension() == kPluginSuffix) {
+            std::string path = it->path().string();
+            if (!pathIndex_.count(path)) {
+                paths.push_back(std::move(path));
+            }
         }
     }
-    return false;
+    if (ec) {
+        log_.logf(LogLevel::Error, "Failed to scan plugin directory: %s (%s)", directory.c_str(), ec.message().c_str());
+        return {};
+    }
+    return loadPlugins(paths, threads);
 }
 
-bool PluginManager::loadPlugin(const std::string& path) {
+std::vector<PluginLoadReport> PluginManager::loadPlugins(const std::vector<std::string>& paths, size_t threads) {
+    return loadPlugins(paths, threads, ExecutionPolicy{});
+}
+
+std::vector<PluginLoadReport> PluginManager::loadPlugins(const std::vector<std::string>& paths, size_t threads, const ExecutionPolicy& policy) {
+    using Clock = std::chrono::steady_clock;
+
+    size_t count = paths.size();
+    std::vector<PluginLoadReport> reports(count);
+    std::vector<PendingPlugin> pending(count);
+    auto fail = [&](size_t i, std::string message) {
+        reports[i].error = std::move(message);
+        pending[i].failed = true;
+    };
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, std::max<size_t>(count, 1));
+
+    // 同名冲突与依赖均按路径字典序处理，结果与线程调度无关
+    std::vector<size_t> byPath(count);
+    for (size_t i = 0; i < count; ++i) {
+        byPath[i] = i;
+        reports[i].path = paths[i];
+        pending[i].info.path = paths[i];
+    }
+    std::sort(byPath.begin(), byPath.end(), [&](size_t a, size_t b) { return paths[a] < paths[b]; });
+
     // 检查插件路径是否已经加载
-    for (const auto& pluginInfo : plugins_) {
-        if (pluginInfo.path == path) {
-            std::cerr << "Plugin already loaded: " << path << std::endl;
-            return false;
+    std::unordered_map<std::string, size_t> claimedPaths;
+    for (size_t i : byPath) {
+        if (pathIndex_.count(paths[i]) || !claimedPaths.emplace(paths[i], i).second) {
+            fail(i, "Plugin already loaded: " + paths[i]);
         }
     }
 
-    LibHandle handle = loadLibrary(path);
-    if (!handle) {
-        std::cerr << "Failed to load library: " << path << std::endl;
+    // 第一阶段：并发执行 dlopen 与 CreatePlugin
+    parallelFor(count, threads, [&](size_t i) {
+        if (pending[i].failed) {
+            return;
+        }
+        auto start = Clock::now();
+        PluginInfo& info = pending[i].info;
+        info.handle = loadLibrary(info.path);
+        if (!info.handle) {
+            fail(i, "Failed to load library: " + info.path);
+            return;
+        }
+        CreatePluginFunc createFunc = getCreatePluginFunc(info.handle);
+        if (!createFunc) {
+            fail(i, "Failed to find CreatePlugin function in: " + info.path);
+            return;
+        }
+        info.instance.reset(createFunc());
+        if (!info.instance) {
+            fail(i, "Failed to create plugin instance from: " + info.path);
+            return;
+        }
+        info.name = info.instance->getName();
+        info.dependencies = info.instance->getDependencies();
+        info.instance->setLogger(&eventManager_.logger().channel(info.name));
+        reports[i].name = info.name;
+        reports[i].openTime = Clock::now() - start;
+    });
+
+    // 检查插件名称是否已经存在：已加载的插件优先，其次路径靠前者
+    std::unordered_map<std::string, size_t> claimedNames;
+    for (size_t i : byPath) {
+        if (pending[i].failed) {
+            continue;
+        }
+        PluginInfo& info = pending[i].info;
+        if (isPluginLoaded(info.name) || !claimedNames.emplace(info.name, i).second) {
+            fail(i, "Plugin with name '" + info.name + "' is already loaded.");
+            continue;
+        }
+        // 名称已独占，插件可在 initialize() 中经宿主以该标识订阅
+        info.id = eventManager_.resolvePlugin(info.name);
+        info.host = std::make_shared<PluginHost>(*this, info.id, info.name);
+        // 反应器在 initialize() 之前启动，初始化中建立的订阅即已在反应器上执行
+        if (policy.mode == ExecutionMode::Reactor) {
+            auto reactor = std::make_shared<Reactor>(info.name, policy, eventManager_.logger().channel(info.name));
+            if (!reactor->start()) {
+                fail(i, "Failed to start the reactor of plugin '" + info.name + "'.");
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(mailboxMutex_);
+            reactors_[info.id.value] = std::move(reactor);
+        }
+    }
+
+    // 建立依赖关系：依赖可以是已加载的插件，或同一批次中的插件
+    for (size_t i : byPath) {
+        if (pending[i].failed) {
+            continue;
+        }
+        for (const auto& dependency : pending[i].info.dependencies) {
+            auto it = claimedNames.find(dependency);
+            if (it != claimedNames.end()) {
+                pending[it->second].dependents.push_back(i);
+                ++pending[i].waiting;
+            }
+            else if (!ensureActive(dependency)) {
+                fail(i, "Plugin '" + pending[i].info.name + "' depends on '" + dependency + "', which is not loaded.");
+            }
+        }
+    }
+
+    // 拓扑排序；失败沿依赖传递，未能排入的插件处于依赖环中
+    std::vector<size_t> order;
+    {
+        std::vector<size_t> waiting(count);
+        std::deque<size_t> ready;
+        for (size_t i : byPath) {
+            waiting[i] = pending[i].waiting;
+            auto claimed = claimedNames.find(pending[i].info.name);
+            if (claimed != claimedNames.end() && claimed->second == i && waiting[i] == 0) {
+                ready.push_back(i);
+            }
+        }
+        while (!ready.empty()) {
+            size_t i = ready.front();
+            ready.pop_front();
+            order.push_back(i);
+            for (size_t dependent : pending[i].dependents) {
+                if (pending[i].failed && !pending[dependent].failed) {
+                    fail(dependent, "Plugin '" + pending[dependent].info.name + "' depends on '" + pending[i].info.name + "', which failed to load.");
+                }
+                if (--waiting[dependent] == 0) {
+                    ready.push_back(dependent);
+                }
+            }
+        }
+        for (const auto& [name, i] : claimedNames) {
+            if (waiting[i] != 0 && !pending[i].failed) {
+                fail(i, "Plugin '" + name + "' is part of or depends on a dependency cycle.");
+            }
+        }
+    }
+
+    // 第二阶段：并发初始化，依赖全部初始化成功后才调度依赖方
+    {
+        std::mutex mutex;
+        std::condition_variable wakeup;
+        std::deque<size_t> ready;
+        size_t outstanding = 0;
+        for (size_t i : order) {
+            if (!pending[i].failed) {
+                ++outstanding;
+                if (pending[i].waiting == 0) {
+                    ready.push_back(i);
+                }
+            }
+        }
+
+        // 在锁内调用：标记完成，并释放或连带失败其依赖方
+        std::function<void(size_t)> complete = [&](size_t i) {
+            --outstanding;
+            for (size_t dependent : pending[i].dependents) {
+                if (pending[dependent].failed) {
+                    continue;
+                }
+                if (pending[i].failed) {
+                    fail(dependent, "Plugin '" + pending[dependent].info.name + "' depends on '" + pending[i].info.name + "', which failed to load.");
+                    complete(dependent);
+                }
+                else if (--pending[dependent].waiting == 0) {
+                    ready.push_back(dependent);
+                }
+            }
+        };
+
+        parallelFor(threads, threads, [&](size_t) {
+            std::unique_lock<std::mutex> lock(mutex);
+            for (;;) {
+                wakeup.wait(lock, [&] { return !ready.empty() || outstanding == 0; });
+                if (ready.empty()) {
+                    return;
+                }
+                size_t i = ready.front();
+                ready.pop_front();
+                lock.unlock();
+
+                auto start = Clock::now();
+                bool initialized = false;
+                try {
+                    initialized = pending[i].info.instance->initialize(*pending[i].info.host);
+                }
+                catch (const std::exception& e) {
+                    log_.logf(LogLevel::Error, "Exception in plugin initialize: %s", e.what());
+                }
+                reports[i].initTime = Clock::now() - start;
+
+                lock.lock();
+                pending[i].initialized = true;
+                if (!initialized) {
+                    fail(i, "Failed to initialize plugin: " + pending[i].info.path);
+                }
+                complete(i);
+                wakeup.notify_all();
+            }
+        });
+    }
+
+    // 释放失败的插件，按依赖顺序登记成功的插件
+    for (size_t i = 0; i < count; ++i) {
+        PluginInfo& info = pending[i].info;
+        if (!pending[i].failed) {
+            continue;
+        }
+        if (info.instance && pending[i].initialized) {
+            info.host->revoke();
+            info.instance->shutdown();
+        }
+        info.instance.reset();
+        info.host.reset();
+        releaseReactor(info.id);
+        unloadLibrary(info.handle);
+    }
+    for (size_t i : order) {
+        if (pending[i].failed) {
+            continue;
+        }
+        PluginInfo& info = pending[i].info;
+        for (const auto& dependency : info.dependencies) {
+            ++dependentCounts_[dependency];
+        }
+        nameIndex_.emplace(info.name, plugins_.size());
+        pathIndex_.emplace(info.path, plugins_.size());
+        plugins_.emplace_back(std::move(info));
+        reports[i].loaded = true;
+    }
+
+    for (const auto& report : reports) {
+        if (report.loaded) {
+            log_.logf(LogLevel::Info, "Successfully loaded plugin: %s (open %.3f ms, init %.3f ms)",
+                report.name.c_str(), toMillis(report.openTime), toMillis(report.initTime));
+        }
+        else {
+            log_.log(LogLevel::Error, report.error);
+        }
+    }
+    return reports;
+}
+
+bool PluginManager::loadIsolatedPlugin(const std::string& path, const IsolationOptions& options) {
+    if (pathIndex_.count(path)) {
+        log_.logf(LogLevel::Error, "Plugin already loaded: %s", path.c_str());
         return false;
     }
+    PluginInfo info;
+    info.path = path;
+    info.isolated = std::make_shared<IsolatedPlugin>(path, options, log_);
+    // 子进程报告名称与依赖后才能检查冲突并建立宿主服务，随后它在 initialize() 中经宿主订阅
+    bool started = info.isolated->start([&](const std::string& name, const std::vector<std::string>& dependencies) -> IPluginHost* {
+        if (isPluginLoaded(name)) {
+            log_.logf(LogLevel::Error, "Plugin with name '%s' is already loaded.", name.c_str());
+            return nullptr;
+        }
+        for (const auto& dependency : dependencies) {
+            if (!ensureActive(dependency)) {
+                log_.logf(LogLevel::Error, "Plugin '%s' depends on '%s', which is not loaded.", name.c_str(), dependency.c_str());
+                return nullptr;
+            }
+        }
+        info.name = name;
+        info.dependencies = dependencies;
+        info.id = eventManager_.resolvePlugin(name);
+        info.host = std::make_shared<PluginHost>(*this, info.id, name);
+        return info.host.get();
+    });
+    if (!started) {
+        if (info.host) {
+            info.host->revoke();
+        }
+        log_.logf(LogLevel::Error, "Failed to load isolated plugin: %s", path.c_str());
+        return false;
+    }
+    for (const auto& dependency : info.dependencies) {
+        ++dependentCounts_[dependency];
+    }
+    nameIndex_.emplace(info.name, plugins_.size());
+    pathIndex_.emplace(info.path, plugins_.size());
+    log_.logf(LogLevel::Info, "Successfully loaded isolated plugin: %s (pid %d)", info.name.c_str(),
+        static_cast<int>(info.isolated->stats().pid));
+    plugins_.emplace_back(std::move(info));
+    return true;
+}
 
-    CreatePluginFunc createFunc = getCreatePluginFunc(handle);
-    if (!createFunc) {
-        std::cerr << "Failed to find CreatePlugin function in: " << path << std::endl;
-        unloadLibrary(handle);
+IsolationStats PluginManager::getIsolationStats(const std::string& pluginName) const {
+    const PluginInfo* plugin = findPlugin(pluginName);
+    return plugin && plugin->isolated ? plugin->isolated->stats() : IsolationStats{};
+}
+
+bool PluginManager::registerLazyPlugin(const std::string& path) {
+    if (pathIndex_.count(path)) {
+        log_.logf(LogLevel::Error, "Plugin already loaded: %s", path.c_str());
+        return false;
+    }
+    PluginManifest manifest;
+    if (!readManifest(path + kManifestSuffix, manifest, log_)) {
         return false;
     }
 
-    IPlugin* plugin = createFunc();
+    // 检查插件名称是否已经存在，无需加载库
+    if (isPluginLoaded(manifest.name)) {
+        log_.logf(LogLevel::Error, "Plugin with name '%s' is already loaded.", manifest.name.c_str());
+        return false;
+    }
+    auto lazy = std::make_shared<LazyPlugin>();
+    lazy->path = path;
+    lazy->name = manifest.name;
+    for (const auto& dependency : manifest.dependencies) {
+        const PluginInfo* prerequisite = findPlugin(dependency);
+        if (!prerequisite || dependency == manifest.name) {
+            log_.logf(LogLevel::Error, "Plugin '%s' depends on '%s', which is not loaded.", manifest.name.c_str(), dependency.c_str());
+            return false;
+        }
+        if (prerequisite->lazy) {
+            lazy->prerequisites.push_back(prerequisite->lazy);
+        }
+    }
+
+    PluginInfo info;
+    info.path = path;
+    info.name = manifest.name;
+    info.id = eventManager_.resolvePlugin(manifest.name);
+    info.dependencies = manifest.dependencies;
+    info.lazy = lazy;
+    lazy->id = info.id;
+
+    // 激活桩先于其他订阅登记，首次触发时插件在其他回调之前完成初始化。
+    // 激活时插件的订阅与激活桩在同一次快照切换中交换：经过激活桩的分发不含插件的订阅，由激活桩补发该事件
+    {
+        std::lock_guard<std::recursive_mutex> lock(lazy->mutex);
+        for (const auto& eventName : manifest.events) {
+            EventId eventId = eventManager_.resolveEvent(eventName);
+            lazy->stubs.push_back(eventManager_.registerEvent(info.id, eventId,
+                [this, lazy, eventId](const EventPayload& payload) {
+                    if (!activatePlugin(*lazy)) {
+                        return;
+                    }
+                    std::shared_ptr<PluginHost> host;
+                    {
+                        std::lock_guard<std::recursive_mutex> lock(lazy->mutex);
+                        host = lazy->host;
+                    }
+                    if (host) {
+                        host->deliver(eventId, payload);
+                    }
+                }));
+        }
+    }
+
+    for (const auto& dependency : info.dependencies) {
+        ++dependentCounts_[dependency];
+    }
+    nameIndex_.emplace(info.name, plugins_.size());
+    pathIndex_.emplace(info.path, plugins_.size());
+    plugins_.emplace_back(std::move(info));
+
+    log_.logf(LogLevel::Info, "Registered lazy plugin: %s (%zu events)", manifest.name.c_str(), manifest.events.size());
+    return true;
+}
+
+size_t PluginManager::registerLazyPlugins(const std::string& directory) {
+    std::vector<std::string> paths;
+    std::error_code ec;
+    for (auto it = std::filesystem::directory_iterator(directory, ec);
+        !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        if (it->is_regular_file(ec) && it->path().extension() == kManifestSuffix) {
+            std::filesystem::path library = it->path();
+            library.replace_extension();
+            if (!pathIndex_.count(library.string())) {
+                paths.push_back(library.string());
+            }
+        }
+    }
+    if (ec) {
+        log_.logf(LogLevel::Error, "Failed to scan plugin directory: %s (%s)", directory.c_str(), ec.message().c_str());
+        return 0;
+    }
+
+    // 按路径字典序登记，同名冲突的结果确定
+    std::sort(paths.begin(), paths.end());
+    size_t registered = 0;
+    for (const auto& path : paths) {
+        if (registerLazyPlugin(path)) {
+            ++registered;
+        }
+    }
+    return registered;
+}
+
+bool PluginManager::isPluginActive(const std::string& pluginName) const {
+    const PluginInfo* plugin = findPlugin(pluginName);
+    return plugin && (!plugin->lazy || plugin->lazy->active.load(std::memory_order_acquire));
+}
+
+bool PluginManager::ensureActive(const std::string& pluginName) {
+    const PluginInfo* plugin = findPlugin(pluginName);
+    return plugin && (!plugin->lazy || activatePlugin(*plugin->lazy));
+}
+
+bool PluginManager::activatePlugin(LazyPlugin& lazy) {
+    using Clock = std::chrono::steady_clock;
+
+    // 已激活时只有一次原子读
+    if (lazy.active.load(std::memory_order_acquire)) {
+        return true;
+    }
+    for (const auto& prerequisite : lazy.prerequisites) {
+        if (!activatePlugin(*prerequisite)) {
+            return false;
+        }
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(lazy.mutex);
+    if (lazy.active.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    if (lazy.failed || lazy.closed) {
+        return false;
+    }
+    lazy.failed = true;
+
+    auto start = Clock::now();
+    LibHandle handle = loadLibrary(lazy.path);
+    if (!handle) {
+        log_.logf(LogLevel::Error, "Failed to load library: %s", lazy.path.c_str());
+        return false;
+    }
+    CreatePluginFunc createFunc = getCreatePluginFunc(handle);
+    std::unique_ptr<IPlugin> plugin(createFunc ? createFunc() : nullptr);
     if (!plugin) {
-        std::cerr << "Failed to create plugin instance from: " << path << std::endl;
+        log_.logf(LogLevel::Error, "Failed to create plugin instance from: %s", lazy.path.c_str());
         unloadLibrary(handle);
         return false;
     }
-
-    if (!plugin->initialize()) {
-        std::cerr << "Failed to initialize plugin: " << path << std::endl;
-        plugin->shutdown();
+    if (plugin->getName() != lazy.name) {
+        log_.logf(LogLevel::Error, "Plugin at %s reports name '%s' but its manifest declares '%s'.",
+            lazy.path.c_str(), plugin->getName().c_str(), lazy.name.c_str());
+        plugin.reset();
         unloadLibrary(handle);
         return false;
     }
-
-    std::string pluginName = plugin->getName();
-
-    // 检查插件名称是否已经存在
-    if (isPluginLoaded(pluginName)) {
-        std::cerr << "Plugin with name '" << pluginName << "' is already loaded." << std::endl;
+    plugin->setLogger(&eventManager_.logger().channel(lazy.name));
+    auto host = std::make_shared<PluginHost>(*this, lazy.id, lazy.name, PluginHost::Mode::Staged);
+    if (!plugin->initialize(*host)) {
+        log_.logf(LogLevel::Error, "Failed to initialize plugin: %s", lazy.path.c_str());
+        host->revoke();
         plugin->shutdown();
+        plugin.reset();
         unloadLibrary(handle);
         return false;
     }
 
-    PluginInfo info;
-    info.path = path;
-    info.handle = handle;
-    info.instance.reset(plugin);
-    plugins_.emplace_back(std::move(info));
+    // 以插件的订阅替换激活桩，之后的触发不再经过它
+    host->commit(lazy.stubs);
+    lazy.stubs.clear();
 
-    std::cout << "Successfully loaded plugin: " << plugin->getName() << std::endl;
+    lazy.failed = false;
+    lazy.handle = handle;
+    lazy.instance = std::move(plugin);
+    lazy.host = std::move(host);
+    lazy.active.store(true, std::memory_order_release);
+
+    log_.logf(LogLevel::Info, "Activated plugin: %s (%.3f ms)", lazy.name.c_str(), toMillis(Clock::now() - start));
     return true;
 }
 
-bool PluginManager::unloadPlugin(const std::string& pluginName) {
-    for (auto it = plugins_.begin(); it != plugins_.end(); ++it) {
-        if (it->instance && it->instance->getName() == pluginName) {
-            // 注销所有与该插件关联的事件回调
-            eventManager_.unregisterPluginCallbacks(pluginName);
-    
-            it->instance->shutdown();
-            it->instance.reset();
-    
-            unloadLibrary(it->handle);
-            std::cout << "Unloaded plugin: " << it->path << std::endl;
-    
-            plugins_.erase(it);
-            return true;
+void PluginManager::releasePlugin(PluginInfo& info) {
+    if (info.lazy) {
+        // 取回延迟插件持有的库与实例，之后不会再被激活
+        std::lock_guard<std::recursive_mutex> lock(info.lazy->mutex);
+        info.lazy->closed = true;
+        info.instance = std::move(info.lazy->instance);
+        info.host = std::move(info.lazy->host);
+        info.handle = info.lazy->handle;
+        info.lazy->handle = nullptr;
+    }
+    // 隔离插件：停止监视线程与子进程，之后不再有经转发的订阅与发布
+    if (info.isolated) {
+        info.isolated->stop();
+    }
+    // 先让宿主拒绝新的订阅与定时器，插件在 shutdown() 中也无法再登记回调
+    if (info.host) {
+        info.host->revoke();
+    }
+    timers_.cancelPluginTimers(info.id);
+    // 注销所有与该插件关联的事件回调（含激活桩），并等待其他线程上的在途回调返回
+    eventManager_.unregisterPluginCallbacks(info.id);
+    closeMailboxes(info.id);
+    eventManager_.synchronize();
+    if (std::shared_ptr<Reactor> reactor = findReactor(info.id)) {
+        reactor->closeAll();
+    }
+
+    if (info.instance) {
+        info.instance->shutdown();
+        info.instance.reset();
+    }
+    info.host.reset();
+    // 反应器持有的回调外壳可能引用插件库，须在卸载库之前销毁
+    releaseReactor(info.id);
+    unloadLibrary(info.handle);
+    for (const auto& dependency : info.dependencies) {
+        auto it = dependentCounts_.find(dependency);
+        if (it != dependentCounts_.end() && --it->second == 0) {
+            dependentCounts_.erase(it);
         }
     }
-    std::cerr << "Plugin not found: " << pluginName << std::endl;
-    return false;
+    log_.logf(LogLevel::Info, "Unloaded plugin: %s", info.path.c_str());
+}
+
+bool PluginManager::unloadPlugin(const std::string& pluginName) {
+    auto it = nameIndex_.find(pluginName);
+    if (it == nameIndex_.end()) {
+        log_.logf(LogLevel::Error, "Plugin not found: %s", pluginName.c_str());
+        return false;
+    }
+    if (dependentCounts_.count(pluginName)) {
+        log_.logf(LogLevel::Error, "Cannot unload plugin '%s': other loaded plugins depend on it.", pluginName.c_str());
+        return false;
+    }
+    size_t index = it->second;
+
+    // 先排空异步队列与反应器队列，保证已发布的事件在卸载前送达
+    flushAsync();
+    releasePlugin(plugins_[index]);
+
+    // 与末尾元素交换后删除，并修正被移动元素的下标
+    nameIndex_.erase(plugins_[index].name);
+    pathIndex_.erase(plugins_[index].path);
+    if (index + 1 != plugins_.size()) {
+        plugins_[index] = std::move(plugins_.back());
+        nameIndex_[plugins_[index].name] = index;
+        pathIndex_[plugins_[index].path] = index;
+    }
+    plugins_.pop_back();
+    return true;
 }
 
 void PluginManager::unloadAll() {
-    for (auto& pluginInfo : plugins_) {
-        if (pluginInfo.instance) {
-            // 注销所有与该插件关联的事件回调
-            eventManager_.unregisterPluginCallbacks(pluginInfo.instance->getName());
+    // 先排空异步队列与反应器队列，保证已发布的事件在卸载前送达
+    flushAsync();
 
-            pluginInfo.instance->shutdown();
-            pluginInfo.instance.reset();
+    // 每轮卸载不再被依赖的插件，依赖方总是先于其依赖卸载
+    std::vector<bool> released(plugins_.size(), false);
+    size_t remaining = plugins_.size();
+    while (remaining > 0) {
+        bool progressed = false;
+        for (size_t i = plugins_.size(); i-- > 0;) {
+            if (released[i] || dependentCounts_.count(plugins_[i].name)) {
+                continue;
+            }
+            releasePlugin(plugins_[i]);
+            released[i] = true;
+            --remaining;
+            progressed = true;
+        }
+        if (!progressed) {
+            // 加载时已排除依赖环，此处仅作兜底
+            dependentCounts_.clear();
         }
-        unloadLibrary(pluginInfo.handle);
-        std::cout << "Unloaded plugin: " << pluginInfo.path << std::endl;
     }
     plugins_.clear();
+    nameIndex_.clear();
+    pathIndex_.clear();
+    dependentCounts_.clear();
+}
+
+bool PluginManager::reloadPlugin(const std::string& pluginName, const std::string& newPath) {
+    using Clock = std::chrono::steady_clock;
+
+    auto it = nameIndex_.find(pluginName);
+    if (it == nameIndex_.end()) {
+        log_.logf(LogLevel::Error, "Plugin not found: %s", pluginName.c_str());
+        return false;
+    }
+    size_t index = it->second;
+    if (plugins_[index].isolated) {
+        log_.logf(LogLevel::Error, "Cannot reload isolated plugin '%s'; unload it and load the new version instead.", pluginName.c_str());
+        return false;
+    }
+    if (plugins_[index].lazy) {
+        // 延迟插件先激活，再由注册表直接持有其库与实例
+        std::shared_ptr<LazyPlugin> lazy = plugins_[index].lazy;
+        if (!activatePlugin(*lazy)) {
+            log_.logf(LogLevel::Error, "Cannot reload plugin '%s': it failed to activate.", pluginName.c_str());
+            return false;
+        }
+        std::lock_guard<std::recursive_mutex> lock(lazy->mutex);
+        lazy->closed = true;
+        plugins_[index].instance = std::move(lazy->instance);
+        plugins_[index].host = std::move(lazy->host);
+        plugins_[index].handle = lazy->handle;
+        lazy->handle = nullptr;
+        plugins_[index].lazy.reset();
+    }
+    auto loadedAt = pathIndex_.find(newPath);
+    if (loadedAt != pathIndex_.end() && loadedAt->second != index) {
+        log_.logf(LogLevel::Error, "Plugin already loaded: %s", newPath.c_str());
+        return false;
+    }
+
+    // 在旧版本继续服务的同时加载并初始化新版本
+    auto start = Clock::now();
+    PluginInfo next;
+    next.path = newPath;
+    next.handle = loadLibrary(newPath);
+    if (!next.handle) {
+        log_.logf(LogLevel::Error, "Failed to load library: %s", newPath.c_str());
+        return false;
+    }
+    CreatePluginFunc createFunc = getCreatePluginFunc(next.handle);
+    if (!createFunc) {
+        log_.logf(LogLevel::Error, "Failed to find CreatePlugin function in: %s", newPath.c_str());
+        unloadLibrary(next.handle);
+        return false;
+    }
+    next.instance.reset(createFunc());
+    if (!next.instance) {
+        log_.logf(LogLevel::Error, "Failed to create plugin instance from: %s", newPath.c_str());
+        unloadLibrary(next.handle);
+        return false;
+    }
+    auto discard = [&](bool initialized) {
+        if (initialized) {
+            next.host->revoke();
+            next.instance->shutdown();
+        }
+        next.instance.reset();
+        next.host.reset();
+        unloadLibrary(next.handle);
+    };
+
+    // 名称决定插件标识与订阅归属，新版本必须保持同名
+    next.name = next.instance->getName();
+    if (next.name != pluginName) {
+        log_.logf(LogLevel::Error, "Cannot reload plugin '%s': new library reports name '%s'.", pluginName.c_str(), next.name.c_str());
+        discard(false);
+        return false;
+    }
+    next.dependencies = next.instance->getDependencies();
+    for (const auto& dependency : next.dependencies) {
+        if (dependency == pluginName || !ensureActive(dependency)) {
+            log_.logf(LogLevel::Error, "Plugin '%s' depends on '%s', which is not loaded.", pluginName.c_str(), dependency.c_str());
+            discard(false);
+            return false;
+        }
+    }
+    next.instance->setLogger(&eventManager_.logger().channel(pluginName));
+    // 新实例使用自己的宿主：initialize() 中的订阅先暂存，切换时才生效
+    next.host = std::make_shared<PluginHost>(*this, plugins_[index].id, pluginName, PluginHost::Mode::Gated);
+    if (!next.instance->initialize(*next.host)) {
+        log_.logf(LogLevel::Error, "Failed to initialize plugin: %s", newPath.c_str());
+        discard(true);
+        return false;
+    }
+
+    // 切换点：同一次快照切换注销旧实例经宿主的订阅并登记新实例的订阅，之后到达的事件在新实例的闸门中排队。
+    // 经 registerPluginEvent 建立的订阅按插件标识记录，标识不变，因此原样保留
+    PluginInfo& current = plugins_[index];
+    std::vector<SubscriptionToken> retired = current.host->suspend();
+    next.host->commit(retired);
+
+    // 等待旧实例静默：在途回调返回，邮箱与反应器队列中已接收的事件执行完，之后才导出状态
+    eventManager_.synchronize();
+    for (const auto& token : retired) {
+        drainMailbox(token);
+    }
+    if (std::shared_ptr<Reactor> reactor = findReactor(current.id)) {
+        reactor->flush();
+    }
+    if (!next.instance->importState(current.instance->exportState())) {
+        // 恢复旧实例的订阅（沿用原订阅编号，其邮箱与反应器回调仍在）；闸门中的事件无法转交旧实例
+        eventManager_.replaceSubscriptions(current.id, next.host->suspend(), current.host->registered());
+        eventManager_.synchronize();
+        size_t dropped = next.host->discardGate();
+        current.host->resume();
+        next.host->retire();
+        next.instance->shutdown();
+        next.instance.reset();
+        next.host.reset();
+        unloadLibrary(next.handle);
+        log_.logf(LogLevel::Error, "Plugin '%s' rejected the exported state, keeping the loaded version (%zu events dropped).",
+            pluginName.c_str(), dropped);
+        return false;
+    }
+    next.host->openGate();
+
+    next.id = current.id;
+    for (const auto& dependency : next.dependencies) {
+        ++dependentCounts_[dependency];
+    }
+    for (const auto& dependency : current.dependencies) {
+        auto count = dependentCounts_.find(dependency);
+        if (count != dependentCounts_.end() && --count->second == 0) {
+            dependentCounts_.erase(count);
+        }
+    }
+    pathIndex_.erase(current.path);
+    pathIndex_[newPath] = index;
+    std::swap(current, next);
+
+    // 旧实例的订阅已注销且已排空：关闭其邮箱与反应器回调、取消其定时器，再关闭旧实例并卸载旧库
+    next.host->retire();
+    next.instance->shutdown();
+    next.instance.reset();
+    next.host.reset();
+    unloadLibrary(next.handle);
+
+    log_.logf(LogLevel::Info, "Reloaded plugin: %s from %s (%.3f ms)", pluginName.c_str(), newPath.c_str(), toMillis(Clock::now() - start));
+    return true;
 }
 
 bool PluginManager::registerPluginEvent(const std::string& pluginName, const std::string& eventName, EventCallback callback) {
+    return registerPluginEvent(pluginName, eventName, adaptEventCallback(std::move(callback)));
+}
+
+bool PluginManager::registerPluginEvent(const std::string& pluginName, EventId eventId, EventCallback callback) {
+    return registerPluginEvent(pluginName, eventId, adaptEventCallback(std::move(callback)));
+}
+
+bool PluginManager::registerPluginEvent(const std::string& pluginName, const std::string& eventName, PayloadCallback callback) {
+    return subscribePluginEvent(pluginName, eventName, std::move(callback)).valid();
+}
+
+bool PluginManager::registerPluginEvent(const std::string& pluginName, EventId eventId, PayloadCallback callback) {
+    return subscribePluginEvent(pluginName, eventId, std::move(callback)).valid();
+}
+
+bool PluginManager::registerPluginEvent(const std::string& pluginName, const std::string& eventName, PayloadCallback callback, const SubscriptionOptions& options) {
+    return subscribePluginEvent(pluginName, eventName, std::move(callback), options).valid();
+}
+
+bool PluginManager::registerPluginEvent(const std::string& pluginName, EventId eventId, PayloadCallback callback, const SubscriptionOptions& options) {
+    return subscribePluginEvent(pluginName, eventId, std::move(callback), options).valid();
+}
+
+SubscriptionToken PluginManager::subscribePluginEvent(const std::string& pluginName, const std::string& eventName, PayloadCallback callback, const SubscriptionOptions& options) {
     if (!isPluginLoaded(pluginName)) {
-        std::cerr << "Cannot register event. Plugin '" << pluginName << "' is not loaded." << std::endl;
+        log_.logf(LogLevel::Error, "Cannot register event. Plugin '%s' is not loaded.", pluginName.c_str());
+        return SubscriptionToken{};
+    }
+    return subscribePluginEvent(pluginName, eventManager_.resolveEvent(eventName), std::move(callback), options);
+}
+
+SubscriptionToken PluginManager::subscribePluginEvent(const std::string& pluginName, EventId eventId, PayloadCallback callback, const SubscriptionOptions& options) {
+    const PluginInfo* plugin = findPlugin(pluginName);
+    if (!plugin) {
+        log_.logf(LogLevel::Error, "Cannot register event. Plugin '%s' is not loaded.", pluginName.c_str());
+        return SubscriptionToken{};
+    }
+    return subscribe(plugin->id, pluginName, eventId, std::move(callback), options);
+}
+
+SubscriptionToken PluginManager::subscribe(PluginId pluginId, const std::string& pluginName, EventId eventId,
+    PayloadCallback callback, const SubscriptionOptions& options) {
+    PreparedSubscription prepared = prepareSubscription(pluginId, pluginName, eventId, std::move(callback), options);
+    SubscriptionToken token = eventManager_.registerEvent(pluginId, eventId, std::move(prepared.staged.callback),
+        prepared.staged.qos);
+    if (!token) {
+        log_.logf(LogLevel::Error, "Cannot register event. Invalid event id: %u", eventId.value);
+    }
+    bindSubscription(prepared, token);
+    return token;
+}
+
+PluginManager::PreparedSubscription PluginManager::prepareSubscription(PluginId pluginId, const std::string& pluginName,
+    EventId eventId, PayloadCallback callback, const SubscriptionOptions& options) {
+    PreparedSubscription prepared;
+    prepared.staged.eventId = eventId;
+    // 截止时间在真实回调返回处检查：反应器线程上、邮箱排空时，否则在分发路径上
+    SubscriptionQos qos{ options.priority, options.deadline };
+    DeadlineCounters* deadlines = options.deadline.count() > 0 ? eventManager_.deadlineCounters(pluginId) : nullptr;
+    // 反应器插件：真实回调在反应器线程上执行，带策略的邮箱排空时再投递到反应器
+    prepared.reactor = findReactor(pluginId);
+    if (prepared.reactor) {
+        callback = prepared.reactor->wrap(std::move(callback), prepared.target, deadlines, options.deadline);
+        deadlines = nullptr;
+        qos.deadline = std::chrono::microseconds(0);
+    }
+    if (options.policy != DeliveryPolicy::Direct) {
+        auto mailbox = std::make_shared<SubscriberMailbox>(std::move(callback), options, asyncBus_, mailboxDrainer_,
+            eventManager_.logger().channel(pluginName), deadlines);
+        callback = [mailbox](const EventPayload& payload) {
+            mailbox->offer(payload);
+        };
+        prepared.mailbox = std::move(mailbox);
+        qos.deadline = std::chrono::microseconds(0);
+    }
+    prepared.staged.callback = std::move(callback);
+    prepared.staged.qos = qos;
+    return prepared;
+}
+
+PluginManager::PreparedSubscription PluginManager::prepareBatchSubscription(PluginId pluginId, EventId eventId,
+    BatchCallback callback, const SubscriptionQos& qos) {
+    PreparedSubscription prepared;
+    prepared.staged.eventId = eventId;
+    prepared.staged.qos = qos;
+    prepared.reactor = findReactor(pluginId);
+    if (prepared.reactor) {
+        DeadlineCounters* deadlines = qos.deadline.count() > 0 ? eventManager_.deadlineCounters(pluginId) : nullptr;
+        callback = prepared.reactor->wrap(std::move(callback), prepared.target, deadlines, qos.deadline);
+        prepared.staged.qos.deadline = std::chrono::microseconds(0);
+    }
+    prepared.staged.batchCallback = std::move(callback);
+    return prepared;
+}
+
+void PluginManager::bindSubscription(PreparedSubscription& prepared, const SubscriptionToken& token) {
+    if (!token) {
+        if (prepared.target) {
+            prepared.reactor->abandon(prepared.target);
+        }
+        if (prepared.mailbox) {
+            prepared.mailbox->close();
+        }
+    }
+    else {
+        if (prepared.target) {
+            prepared.reactor->bind(prepared.target, token.subscriptionId);
+        }
+        if (prepared.mailbox) {
+            std::lock_guard<std::mutex> lock(mailboxMutex_);
+            mailboxes_[token.pluginId.value].emplace(token.subscriptionId, prepared.mailbox);
+        }
+    }
+    prepared.target = nullptr;
+    prepared.mailbox.reset();
+}
+
+void PluginManager::drainMailbox(const SubscriptionToken& token) {
+    std::shared_ptr<SubscriberMailbox> mailbox;
+    {
+        std::lock_guard<std::mutex> lock(mailboxMutex_);
+        auto it = mailboxes_.find(token.pluginId.value);
+        if (it != mailboxes_.end()) {
+            auto found = it->second.find(token.subscriptionId);
+            if (found != it->second.end()) {
+                mailbox = found->second;
+            }
+        }
+    }
+    if (mailbox) {
+        mailbox->drain();
+    }
+}
+
+SubscriptionToken PluginManager::subscribePluginBatchEvent(const std::string& pluginName, const std::string& eventName, BatchCallback callback,
+    const SubscriptionQos& qos) {
+    if (!isPluginLoaded(pluginName)) {
+        log_.logf(LogLevel::Error, "Cannot register event. Plugin '%s' is not loaded.", pluginName.c_str());
+        return SubscriptionToken{};
+    }
+    return subscribePluginBatchEvent(pluginName, eventManager_.resolveEvent(eventName), std::move(callback), qos);
+}
+
+SubscriptionToken PluginManager::subscribePluginBatchEvent(const std::string& pluginName, EventId eventId, BatchCallback callback,
+    const SubscriptionQos& qos) {
+    const PluginInfo* plugin = findPlugin(pluginName);
+    if (!plugin) {
+        log_.logf(LogLevel::Error, "Cannot register event. Plugin '%s' is not loaded.", pluginName.c_str());
+        return SubscriptionToken{};
+    }
+    SubscriptionToken token = subscribeBatch(plugin->id, eventId, std::move(callback), qos);
+    if (!token) {
+        log_.logf(LogLevel::Error, "Cannot register event. Invalid event id: %u", eventId.value);
+    }
+    return token;
+}
+
+SubscriptionToken PluginManager::subscribeBatch(PluginId pluginId, EventId eventId, BatchCallback callback,
+    const SubscriptionQos& qos) {
+    PreparedSubscription prepared = prepareBatchSubscription(pluginId, eventId, std::move(callback), qos);
+    SubscriptionToken token = eventManager_.registerBatchEvent(pluginId, eventId, std::move(prepared.staged.batchCallback),
+        prepared.staged.qos);
+    bindSubscription(prepared, token);
+    return token;
+}
+
+bool PluginManager::unsubscribePluginEvent(const SubscriptionToken& token) {
+    if (!eventManager_.unsubscribe(token)) {
         return false;
     }
-    eventManager_.registerEvent(pluginName, eventName, callback);
+    // 邮箱先关闭，阻塞在其上的发布者返回后才能等到在途回调全部返回
+    closeMailbox(token);
+    eventManager_.synchronize();
+    closeReactorCallback(token);
     return true;
 }
 
+void PluginManager::closeMailbox(const SubscriptionToken& token) {
+    std::shared_ptr<SubscriberMailbox> mailbox;
+    {
+        std::lock_guard<std::mutex> lock(mailboxMutex_);
+        auto it = mailboxes_.find(token.pluginId.value);
+        if (it != mailboxes_.end()) {
+            auto found = it->second.find(token.subscriptionId);
+            if (found != it->second.end()) {
+                mailbox = std::move(found->second);
+                it->second.erase(found);
+            }
+        }
+    }
+    // 关闭后排空中的邮箱不会再向反应器投递
+    if (mailbox) {
+        mailbox->close();
+    }
+}
+
+void PluginManager::closeReactorCallback(const SubscriptionToken& token) {
+    if (std::shared_ptr<Reactor> reactor = findReactor(token.pluginId)) {
+        reactor->close(token.subscriptionId);
+    }
+}
+
+std::shared_ptr<Reactor> PluginManager::findReactor(PluginId pluginId) const {
+    std::lock_guard<std::mutex> lock(mailboxMutex_);
+    auto it = reactors_.find(pluginId.value);
+    return it != reactors_.end() ? it->second : nullptr;
+}
+
+void PluginManager::releaseReactor(PluginId pluginId) {
+    std::shared_ptr<Reactor> reactor;
+    {
+        std::lock_guard<std::mutex> lock(mailboxMutex_);
+        auto it = reactors_.find(pluginId.value);
+        if (it == reactors_.end()) {
+            return;
+        }
+        reactor = std::move(it->second);
+        reactors_.erase(it);
+    }
+    reactor->closeAll();
+    reactor->stop();
+}
+
+ReactorStats PluginManager::getReactorStats(const std::string& pluginName) const {
+    const PluginInfo* plugin = findPlugin(pluginName);
+    std::shared_ptr<Reactor> reactor = plugin ? findReactor(plugin->id) : nullptr;
+    return reactor ? reactor->stats() : ReactorStats{};
+}
+
+size_t PluginManager::getSubscriptionCount(const std::string& pluginName) {
+    const PluginInfo* plugin = findPlugin(pluginName);
+    return plugin ? eventManager_.subscriptionCount(plugin->id) : 0;
+}
+
+DeliveryStats PluginManager::getDeliveryStats(const std::string& pluginName) const {
+    DeliveryStats total;
+    const PluginInfo* plugin = findPlugin(pluginName);
+    if (!plugin) {
+        return total;
+    }
+    std::lock_guard<std::mutex> lock(mailboxMutex_);
+    auto it = mailboxes_.find(plugin->id.value);
+    if (it == mailboxes_.end()) {
+        return total;
+    }
+    for (const auto& [subscriptionId, mailbox] : it->second) {
+        DeliveryStats stats = mailbox->stats();
+        total.delivered += stats.delivered;
+        total.dropped += stats.dropped;
+        total.conflated += stats.conflated;
+        total.blockedPublishes += stats.blockedPublishes;
+        total.queued += stats.queued;
+    }
+    return total;
+}
+
+DeadlineStats PluginManager::getDeadlineStats(const std::string& pluginName) {
+    const PluginInfo* plugin = findPlugin(pluginName);
+    return plugin ? eventManager_.deadlineStats(plugin->id) : DeadlineStats{};
+}
+
+void PluginManager::closeMailboxes(PluginId pluginId) {
+    std::unordered_map<uint32_t, std::shared_ptr<SubscriberMailbox>> closing;
+    {
+        std::lock_guard<std::mutex> lock(mailboxMutex_);
+        auto it = mailboxes_.find(pluginId.value);
+        if (it != mailboxes_.end()) {
+            closing.swap(it->second);
+            mailboxes_.erase(it);
+        }
+    }
+    for (auto& [subscriptionId, mailbox] : closing) {
+        mailbox->close();
+    }
+}
+
 void PluginManager::triggerPluginEvent(const std::string& eventName, const std::string& eventData) {
-    eventManager_.triggerEvent(eventName, eventData);
+    triggerPluginEvent(eventName, EventPayload::fromString(eventData));
+}
+
+void PluginManager::triggerPluginEvent(EventId eventId, const std::string& eventData) {
+    triggerPluginEvent(eventId, EventPayload::fromString(eventData));
+}
+
+void PluginManager::triggerPluginEvent(const std::string& eventName, const EventPayload& payload) {
+    if (journal_.load(std::memory_order_relaxed)) {
+        // 记录日志时需要事件标识
+        triggerPluginEvent(publishTopicOf(eventName), payload);
+        return;
+    }
+    eventManager_.triggerEvent(eventName, payload);
+}
+
+void PluginManager::triggerPluginEvent(EventId eventId, const EventPayload& payload) {
+    journalEvent(eventId, payload);
+    eventManager_.triggerEvent(eventId, payload);
+}
+
+void PluginManager::triggerPluginEvents(const BatchEvent* events, size_t count) {
+    if (journal_.load(std::memory_order_relaxed)) {
+        for (size_t i = 0; i < count; ++i) {
+            journalEvent(events[i].eventId, events[i].payload);
+        }
+    }
+    eventManager_.triggerEvents(events, count);
+}
+
+void PluginManager::triggerPluginEvents(const std::vector<BatchEvent>& events) {
+    triggerPluginEvents(events.data(), events.size());
+}
+
+EventId PluginManager::resolvePluginEvent(const std::string& eventName) {
+    return eventManager_.resolveEvent(eventName);
+}
+
+bool PluginManager::startAsyncDispatch(size_t dispatcherThreads, size_t queueCapacity) {
+    return asyncBus_.start(dispatcherThreads, queueCapacity);
+}
+
+void PluginManager::stopAsyncDispatch() {
+    asyncBus_.stop();
+}
+
+bool PluginManager::publishAsync(const std::string& eventName, const std::string& eventData) {
+    EventId eventId = publishTopicOf(eventName);
+    if (!eventId.valid()) {
+        // 没有任何订阅者（含通配订阅）的事件无需入队
+        return asyncBus_.running();
+    }
+    return publishAsync(eventId, EventPayload::fromString(eventData));
+}
+
+bool PluginManager::publishAsync(EventId eventId, const EventPayload& payload) {
+    // 入队成功后再记录，被丢弃的事件不写入日志
+    if (!asyncBus_.publish(eventId, payload)) {
+        return false;
+    }
+    journalEvent(eventId, payload);
+    return true;
+}
+
+void PluginManager::flushAsync() {
+    asyncBus_.flush();
+    mailboxDrainer_.flush();
+    std::vector<std::shared_ptr<Reactor>> reactors;
+    {
+        std::lock_guard<std::mutex> lock(mailboxMutex_);
+        for (const auto& [pluginId, reactor] : reactors_) {
+            reactors.push_back(reactor);
+        }
+    }
+    for (const auto& reactor : reactors) {
+        reactor->flush();
+    }
+}
+
+void PluginManager::triggerPluginEvent(const std::string& eventName, const std::string& eventData, std::string_view partitionKey) {
+    EventId eventId = publishTopicOf(eventName);
+    if (eventId.valid()) {
+        triggerPluginEvent(eventId, EventPayload::fromString(eventData), partitionKey);
+    }
+}
+
+void PluginManager::triggerPluginEvent(EventId eventId, const EventPayload& payload, std::string_view partitionKey) {
+    if (asyncBus_.publish(eventId, payload, AsyncEventBus::partitionOf(partitionKey), true)) {
+        journalEvent(eventId, payload);
+    }
+    else if (!asyncBus_.running()) {
+        journalEvent(eventId, payload);
+        eventManager_.triggerEvent(eventId, payload);
+    }
+}
+
+EventId PluginManager::publishTopicOf(const std::string& eventName) {
+    if (!journal_.load(std::memory_order_relaxed)) {
+        return eventManager_.findTopic(eventName);
+    }
+    EventId eventId = eventManager_.findEvent(eventName);
+    return eventId.valid() ? eventId : eventManager_.resolveEvent(eventName);
+}
+
+void PluginManager::journalEvent(EventId eventId, const EventPayload& payload) {
+    if (!journal_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    EpochDomain::ReadGuard guard;
+    if (JournalWriter* journal = journal_.load(std::memory_order_acquire)) {
+        journal->append(eventId, payload);
+    }
+}
+
+bool PluginManager::startJournal(const std::string& path, size_t capacityBytes) {
+    stopJournal();
+    auto journal = std::make_unique<JournalWriter>(eventManager_);
+    if (!journal->open(path, capacityBytes)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(journalMutex_);
+    journal_.store(journal.release(), std::memory_order_release);
+    log_.logf(LogLevel::Info, "Journaling events to %s", path.c_str());
+    return true;
+}
+
+void PluginManager::stopJournal() {
+    std::lock_guard<std::mutex> lock(journalMutex_);
+    std::unique_ptr<JournalWriter> journal(journal_.exchange(nullptr, std::memory_order_acq_rel));
+    if (!journal) {
+        return;
+    }
+    // 追加只发生在读临界区内，等待全部读者离开后即可安全关闭
+    EpochDomain::instance().synchronize();
+    JournalStats stats = journal->stats();
+    journal->close();
+    log_.logf(LogLevel::Info, "Journal closed: %llu events, %zu bytes, %llu dropped",
+        static_cast<unsigned long long>(stats.records), stats.bytes, static_cast<unsigned long long>(stats.dropped));
+}
+
+JournalStats PluginManager::getJournalStats() const {
+    std::lock_guard<std::mutex> lock(journalMutex_);
+    JournalWriter* journal = journal_.load(std::memory_order_acquire);
+    return journal ? journal->stats() : JournalStats{};
+}
+
+ReplayStats PluginManager::replayJournal(const std::string& path, const ReplayOptions& options) {
+    JournalReader reader(eventManager_.logger());
+    if (!reader.open(path)) {
+        return ReplayStats{};
+    }
+    return replayJournal(reader, options);
+}
+
+ReplayStats PluginManager::replayJournal(JournalReader& reader, const ReplayOptions& options) {
+    return reader.replay(eventManager_, options);
+}
+
+std::vector<ShardStats> PluginManager::getShardStats() const {
+    return asyncBus_.shardStats();
+}
+
+StatsSnapshot PluginManager::getStatsSnapshot() {
+    return eventManager_.statsSnapshot();
+}
+
+void PluginManager::dumpStats(std::ostream& out) {
+    eventManager_.statsSnapshot().print(out);
+    std::vector<std::shared_ptr<Reactor>> reactors;
+    {
+        std::lock_guard<std::mutex> lock(mailboxMutex_);
+        for (const auto& [pluginId, reactor] : reactors_) {
+            reactors.push_back(reactor);
+        }
+    }
+    if (!reactors.empty()) {
+        out << "[reactors]" << std::endl;
+        for (const auto& reactor : reactors) {
+            reactor->stats().print(out);
+        }
+    }
+    bool deadlineHeader = false;
+    for (const auto& plugin : plugins_) {
+        DeadlineStats stats = eventManager_.deadlineStats(plugin.id);
+        if (stats.checked == 0) {
+            continue;
+        }
+        if (!deadlineHeader) {
+            out << "[deadlines]" << std::endl;
+            deadlineHeader = true;
+        }
+        out << "  " << plugin.name << ": checked=" << stats.checked << " missed=" << stats.missed
+            << " worstOverrun=" << stats.worstOverrunUs << "us" << std::endl;
+    }
+}
+
+void PluginManager::setStatsEnabled(bool enabled) {
+    eventManager_.setStatsEnabled(enabled);
+}
+
+TimerId PluginManager::schedulePluginTimer(const std::string& pluginName, const std::string& eventName,
+    std::chrono::nanoseconds delay, std::chrono::nanoseconds period) {
+    if (!isPluginLoaded(pluginName)) {
+        log_.logf(LogLevel::Error, "Cannot schedule timer. Plugin '%s' is not loaded.", pluginName.c_str());
+        return TimerId{};
+    }
+    return schedulePluginTimer(pluginName, eventManager_.resolveEvent(eventName), delay, period);
+}
+
+TimerId PluginManager::schedulePluginTimer(const std::string& pluginName, EventId eventId,
+    std::chrono::nanoseconds delay, std::chrono::nanoseconds period) {
+    const PluginInfo* plugin = findPlugin(pluginName);
+    if (!plugin) {
+        log_.logf(LogLevel::Error, "Cannot schedule timer. Plugin '%s' is not loaded.", pluginName.c_str());
+        return TimerId{};
+    }
+    TimerId timer = timers_.schedule(plugin->id, eventId, delay, period);
+    if (!timer.valid()) {
+        log_.logf(LogLevel::Error, "Cannot schedule timer. Invalid event id: %u", eventId.value);
+    }
+    return timer;
+}
+
+bool PluginManager::cancelPluginTimer(TimerId timer) {
+    return timers_.cancel(timer);
+}
+
+TimerStats PluginManager::getTimerStats() const {
+    return timers_.stats();
+}
+
+void PluginManager::setPluginLogLevel(const std::string& pluginName, LogLevel level) {
+    eventManager_.logger().setLevel(pluginName, level);
+}
+
+void PluginManager::setPluginLogRateLimit(const std::string& pluginName, uint32_t ratePerSecond, uint32_t burst) {
+    eventManager_.logger().setRateLimit(pluginName, ratePerSecond, burst);
 }
 
 LibHandle PluginManager::loadLibrary(const std::string& path) {
@@ -131,18 +1796,22 @@ LibHandle PluginManager::loadLibrary(const std::string& path) {
 
 void PluginManager::unloadLibrary(LibHandle handle) {
     if (!handle) return;
+    // 在回调内卸载时 synchronize() 不等待调用线程自身，已退役的快照仍持有库中代码的回调；
+    // 库交给纪元回收，按退役顺序在这些快照释放之后才关闭
+    EpochDomain::instance().retire(handle, [](void* library) {
 #if defined(_WIN32)
-    FreeLibrary(handle);
+        FreeLibrary(static_cast<HMODULE>(library));
 #else
-    dlclose(handle);
+        dlclose(library);
 #endif
+    });
 }
 
 CreatePluginFunc PluginManager::getCreatePluginFunc(LibHandle handle) {
 #if defined(_WIN32)
     FARPROC func = GetProcAddress(handle, "CreatePlugin");
     if (!func) {
-        std::cerr << "GetProcAddress failed with error: " << GetLastError() << std::endl;
+        log_.logf(LogLevel::Error, "GetProcAddress failed with error: %lu", static_cast<unsigned long>(GetLastError()));
     }
     return reinterpret_cast<CreatePluginFunc>(func);
 #else
@@ -150,7 +1819,7 @@ CreatePluginFunc PluginManager::getCreatePluginFunc(LibHandle handle) {
     CreatePluginFunc func = reinterpret_cast<CreatePluginFunc>(dlsym(handle, "CreatePlugin"));
     const char* dlsym_error = dlerror();
     if (dlsym_error) {
-        std::cerr << "dlsym failed: " << dlsym_error << std::endl;
+        log_.logf(LogLevel::Error, "dlsym failed: %s", dlsym_error);
         return nullptr;
     }
     return func;
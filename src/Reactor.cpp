@@ -0,0 +1,393 @@
+// src/Reactor.cpp
+#include "Reactor.h"
+#include <exception>
+#include <iomanip>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// 阻塞等待的超时，防止极端情况下丢失唤醒
+constexpr std::chrono::milliseconds kSleepTimeout(10);
+
+thread_local const Reactor* currentReactor = nullptr;
+
+// 忙等时提示 CPU 降低功耗并让出超线程的执行资源
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+inline void addRelaxed(std::atomic<int64_t>& counter, int64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+inline void addRelaxed(std::atomic<uint64_t>& counter, uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+LatencySummary summarize(const LatencyHistogram& histogram) {
+    HistogramData data;
+    data.merge(histogram);
+    return data.summary();
+}
+
+void printLatency(std::ostream& out, const char* label, const LatencySummary& summary) {
+    out << label << " n=" << summary.count
+        << " mean=" << summary.meanUs << "us"
+        << " p50=" << summary.p50Us << "us"
+        << " p99=" << summary.p99Us << "us"
+        << " max=" << summary.maxUs << "us";
+}
+
+} // namespace
+
+struct Reactor::Target {
+    PayloadCallback callback;
+    BatchCallback batchCallback;
+    bool batch = false;
+    std::atomic<bool> open{ true };
+    DeadlineCounters* deadlines = nullptr;
+    int64_t deadlineNs = 0;
+};
+
+namespace {
+
+void setDeadline(Reactor::Target& target, DeadlineCounters* deadlines, std::chrono::microseconds deadline) {
+    if (deadlines && deadline.count() > 0) {
+        target.deadlines = deadlines;
+        target.deadlineNs = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline).count();
+    }
+}
+
+} // namespace
+
+void ReactorStats::print(std::ostream& out) const {
+    std::ios::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(2);
+    out << "  " << plugin << ": cpu=" << cpu << (pinned ? " (pinned)" : " (unpinned)")
+        << " events=" << events << " queued=" << queued << " dropped=" << dropped
+        << " blockedPublishes=" << blockedPublishes << " sleeps=" << sleeps << std::endl;
+    out << std::setprecision(6)
+        << "    busy=" << busySeconds << "s spin=" << spinSeconds << "s sleep=" << sleepSeconds << "s" << std::endl;
+    out << std::setprecision(2) << "    ";
+    printLatency(out, "queue", queueLatency);
+    out << std::endl << "    ";
+    printLatency(out, "wakeup", wakeupLatency);
+    out << std::endl;
+    out.flags(flags);
+}
+
+Reactor::Reactor(std::string name, const ExecutionPolicy& policy, ILogger& log)
+    : name_(std::move(name)), policy_(policy), log_(log), queue_(policy.queueCapacity) {}
+
+Reactor::~Reactor() {
+    stop();
+}
+
+bool Reactor::start() {
+    if (running_.load(std::memory_order_acquire) || thread_.joinable()) {
+        log_.logf(LogLevel::Error, "Reactor for %s is already running.", name_.c_str());
+        return false;
+    }
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread([this] { run(); });
+    return true;
+}
+
+void Reactor::stop() {
+    if (!running_.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    stopping_.store(true, std::memory_order_release);
+    wake();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    // 线程退出后仍可能有并发发布者刚刚入队的事件，在此同步执行
+    Item item;
+    while (queue_.tryPop(item)) {
+        execute(item);
+        item = Item();
+    }
+}
+
+void Reactor::flush() {
+    if (currentReactor == this) {
+        return;
+    }
+    uint64_t target = enqueued_.load(std::memory_order_acquire);
+    while (running_.load(std::memory_order_acquire) && dequeued_.load(std::memory_order_acquire) < target) {
+        wake();
+        std::this_thread::yield();
+    }
+}
+
+PayloadCallback Reactor::wrap(PayloadCallback callback, Target*& target,
+    DeadlineCounters* deadlines, std::chrono::microseconds deadline) {
+    auto owned = std::make_unique<Target>();
+    owned->callback = std::move(callback);
+    setDeadline(*owned, deadlines, deadline);
+    target = adopt(std::move(owned));
+    Target* raw = target;
+    return [this, raw](const EventPayload& payload) {
+        Item item;
+        item.target = raw;
+        item.payload = payload.retain();
+        item.enqueueNs = statsNowNs();
+        post(std::move(item));
+    };
+}
+
+BatchCallback Reactor::wrap(BatchCallback callback, Target*& target,
+    DeadlineCounters* deadlines, std::chrono::microseconds deadline) {
+    auto owned = std::make_unique<Target>();
+    owned->batchCallback = std::move(callback);
+    setDeadline(*owned, deadlines, deadline);
+    owned->batch = true;
+    target = adopt(std::move(owned));
+    Target* raw = target;
+    return [this, raw](const EventBatchView& view) {
+        Item item;
+        item.target = raw;
+        spareBatches_.tryPop(item.batch);
+        item.batch.reserve(view.size());
+        for (const BatchEvent& event : view) {
+            item.batch.push_back(BatchEvent{ event.eventId, event.payload.retain() });
+        }
+        item.enqueueNs = statsNowNs();
+        post(std::move(item));
+    };
+}
+
+Reactor::Target* Reactor::adopt(std::unique_ptr<Target> target) {
+    std::lock_guard<std::mutex> lock(targetMutex_);
+    targets_.push_back(std::move(target));
+    return targets_.back().get();
+}
+
+void Reactor::bind(Target* target, uint32_t subscriptionId) {
+    std::lock_guard<std::mutex> lock(targetMutex_);
+    bound_[subscriptionId] = target;
+}
+
+void Reactor::abandon(Target* target) {
+    retire(target);
+}
+
+void Reactor::close(uint32_t subscriptionId) {
+    Target* target = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(targetMutex_);
+        auto it = bound_.find(subscriptionId);
+        if (it == bound_.end()) {
+            return;
+        }
+        target = it->second;
+        bound_.erase(it);
+    }
+    retire(target);
+}
+
+void Reactor::retire(Target* target) {
+    // 队列中仍可能有指向该回调的事件，因此外壳保留，只标记为关闭
+    target->open.store(false, std::memory_order_seq_cst);
+    if (currentReactor == this && current_.load(std::memory_order_relaxed) == target) {
+        return;  // 在该回调内关闭自身：回调返回后由 execute 释放
+    }
+    while (current_.load(std::memory_order_seq_cst) == target) {
+        std::this_thread::yield();
+    }
+    target->callback = PayloadCallback();
+    target->batchCallback = BatchCallback();
+}
+
+void Reactor::closeAll() {
+    std::vector<uint32_t> subscriptions;
+    {
+        std::lock_guard<std::mutex> lock(targetMutex_);
+        for (const auto& [subscriptionId, target] : bound_) {
+            subscriptions.push_back(subscriptionId);
+        }
+    }
+    for (uint32_t subscriptionId : subscriptions) {
+        close(subscriptionId);
+    }
+}
+
+bool Reactor::onReactorThread() {
+    return currentReactor != nullptr;
+}
+
+ReactorStats Reactor::stats() const {
+    ReactorStats result;
+    result.plugin = name_;
+    result.cpu = policy_.cpu;
+    result.pinned = pinned_.load(std::memory_order_relaxed);
+    result.events = executed_.load(std::memory_order_relaxed);
+    result.dropped = dropped_.load(std::memory_order_relaxed);
+    result.blockedPublishes = blockedPublishes_.load(std::memory_order_relaxed);
+    result.sleeps = sleeps_.load(std::memory_order_relaxed);
+    result.queued = queue_.size();
+    result.busySeconds = busyNs_.load(std::memory_order_relaxed) / 1e9;
+    result.spinSeconds = spinNs_.load(std::memory_order_relaxed) / 1e9;
+    result.sleepSeconds = sleepNs_.load(std::memory_order_relaxed) / 1e9;
+    result.queueLatency = summarize(queueLatency_);
+    result.wakeupLatency = summarize(wakeupLatency_);
+    return result;
+}
+
+void Reactor::post(Item&& item) {
+    if (!running_.load(std::memory_order_acquire)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    bool blocked = false;
+    while (!queue_.tryPush(std::move(item))) {
+        // 反应器线程向自身投递时等待空位会自锁，只能丢弃
+        if (currentReactor == this || !running_.load(std::memory_order_acquire)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (!blocked) {
+            blocked = true;
+            blockedPublishes_.fetch_add(1, std::memory_order_relaxed);
+        }
+        wake();
+        std::this_thread::yield();
+    }
+    enqueued_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_seq_cst)) {
+        wake();
+    }
+}
+
+void Reactor::wake() {
+    std::lock_guard<std::mutex> lock(wakeMutex_);
+    wakeCondition_.notify_one();
+}
+
+void Reactor::pin() {
+#if defined(__linux__)
+    pthread_setname_np(pthread_self(), ("mots:" + name_).substr(0, 15).c_str());
+    if (policy_.cpu < 0) {
+        return;
+    }
+    if (policy_.cpu < CPU_SETSIZE) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(policy_.cpu, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+            pinned_.store(true, std::memory_order_relaxed);
+            return;
+        }
+    }
+    log_.logf(LogLevel::Warn, "Failed to pin the reactor of %s to CPU %d; running unpinned.", name_.c_str(), policy_.cpu);
+#else
+    if (policy_.cpu >= 0) {
+        log_.logf(LogLevel::Warn, "CPU pinning is not supported on this platform; the reactor of %s runs unpinned.", name_.c_str());
+    }
+#endif
+}
+
+void Reactor::execute(Item& item) {
+    Target* target = item.target;
+    // 先公布正在执行的回调再检查是否已关闭，与 close 的先关闭再等待配对
+    current_.store(target, std::memory_order_seq_cst);
+    if (target->open.load(std::memory_order_seq_cst)) {
+        try {
+            if (target->batch) {
+                target->batchCallback(EventBatchView(item.batch.data(), item.batch.size()));
+            }
+            else {
+                target->callback(item.payload);
+            }
+        }
+        catch (const std::exception& e) {
+            log_.logf(LogLevel::Error, "Exception in event callback: %s", e.what());
+        }
+        catch (...) {
+            log_.logf(LogLevel::Error, "Unknown exception in event callback.");
+        }
+        addRelaxed(executed_, 1);
+        if (target->deadlines) {
+            target->deadlines->record(statsNowNs() - item.enqueueNs, target->deadlineNs);
+        }
+        if (!target->open.load(std::memory_order_seq_cst)) {
+            // 执行期间被关闭：其他线程上的关闭方在 current_ 清除前只等待不释放，二者不会并发
+            target->callback = PayloadCallback();
+            target->batchCallback = BatchCallback();
+        }
+    }
+    current_.store(nullptr, std::memory_order_release);
+}
+
+void Reactor::run() {
+    currentReactor = this;
+    pin();
+    const int64_t idleSpinNs = std::chrono::duration_cast<std::chrono::nanoseconds>(policy_.idleSpin).count();
+    Item item;
+    int64_t idleSince = statsNowNs();
+    bool sleepy = false;  // 已耗尽忙等预算：醒来后仍无事件时直接再次阻塞
+    bool woken = false;   // 阻塞等待后尚未执行事件
+    for (;;) {
+        if (queue_.tryPop(item)) {
+            int64_t start = statsNowNs();
+            addRelaxed(spinNs_, start - idleSince);
+            int64_t latency = start - item.enqueueNs;
+            queueLatency_.record(latency);
+            if (woken) {
+                wakeupLatency_.record(latency);
+                woken = false;
+            }
+            execute(item);
+            if (item.batch.capacity() != 0) {
+                item.batch.clear();
+                spareBatches_.tryPush(std::move(item.batch));
+            }
+            item = Item();
+            dequeued_.fetch_add(1, std::memory_order_release);
+            idleSince = statsNowNs();
+            addRelaxed(busyNs_, idleSince - start);
+            sleepy = false;
+            continue;
+        }
+        if (stopping_.load(std::memory_order_acquire)) {
+            break;
+        }
+        int64_t now = statsNowNs();
+        if (!sleepy && now - idleSince < idleSpinNs) {
+            cpuRelax();
+            continue;
+        }
+        addRelaxed(spinNs_, now - idleSince);
+
+        // 先声明即将休眠，再复查队列，避免丢失发布者的唤醒
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        sleeping_.store(true, std::memory_order_seq_cst);
+        bool empty = enqueued_.load(std::memory_order_seq_cst) <= dequeued_.load(std::memory_order_relaxed);
+        if (empty && !stopping_.load(std::memory_order_acquire)) {
+            if (!sleepy) {
+                addRelaxed(sleeps_, 1);
+            }
+            wakeCondition_.wait_for(lock, kSleepTimeout);
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+        lock.unlock();
+        idleSince = statsNowNs();
+        addRelaxed(sleepNs_, idleSince - now);
+        sleepy = true;
+        woken = true;
+    }
+    addRelaxed(spinNs_, statsNowNs() - idleSince);
+}
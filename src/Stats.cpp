@@ -0,0 +1,212 @@
+// src/Stats.cpp
+#include "Stats.h"
+#include <algorithm>
+#include <iomanip>
+#include <map>
+
+void HistogramData::merge(const LatencyHistogram& histogram) {
+    for (size_t i = 0; i < LatencyHistogram::kBuckets; ++i) {
+        counts[i] += histogram.buckets_[i].load(std::memory_order_relaxed);
+    }
+    sumNs += histogram.sumNs_.load(std::memory_order_relaxed);
+    maxNs = std::max(maxNs, histogram.maxNs_.load(std::memory_order_relaxed));
+}
+
+void HistogramData::merge(const HistogramData& other) {
+    for (size_t i = 0; i < LatencyHistogram::kBuckets; ++i) {
+        counts[i] += other.counts[i];
+    }
+    sumNs += other.sumNs;
+    maxNs = std::max(maxNs, other.maxNs);
+}
+
+LatencySummary HistogramData::summary() const {
+    LatencySummary result;
+    for (uint64_t count : counts) {
+        result.count += count;
+    }
+    if (result.count == 0) {
+        return result;
+    }
+
+    // 百分位取所在桶的上界，不超过观测到的最大值
+    auto percentile = [&](double fraction) {
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * static_cast<double>(result.count) + 0.5));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return std::min(LatencyHistogram::upperBoundOf(i), maxNs) / 1000.0;
+            }
+        }
+        return maxNs / 1000.0;
+    };
+    result.meanUs = static_cast<double>(sumNs) / static_cast<double>(result.count) / 1000.0;
+    result.p50Us = percentile(0.50);
+    result.p99Us = percentile(0.99);
+    result.p999Us = percentile(0.999);
+    result.maxUs = maxNs / 1000.0;
+    return result;
+}
+
+namespace {
+
+void printSummary(std::ostream& out, const LatencySummary& summary) {
+    out << "n=" << summary.count
+        << " mean=" << summary.meanUs << "us"
+        << " p50=" << summary.p50Us << "us"
+        << " p99=" << summary.p99Us << "us"
+        << " p99.9=" << summary.p999Us << "us"
+        << " max=" << summary.maxUs << "us";
+}
+
+} // namespace
+
+void StatsSnapshot::print(std::ostream& out) const {
+    if (!enabled) {
+        out << "Event statistics are disabled." << std::endl;
+        return;
+    }
+    std::ios::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(2);
+    out << "Event statistics over " << elapsedSeconds << "s" << std::endl;
+    out << "[events]" << std::endl;
+    for (const auto& entry : events) {
+        out << "  " << entry.event << ": triggers=" << entry.triggers << " rate=" << entry.triggersPerSecond << "/s dispatch ";
+        printSummary(out, entry.dispatch);
+        out << std::endl;
+    }
+    out << "[plugins]" << std::endl;
+    for (const auto& entry : plugins) {
+        out << "  " << entry.plugin << ": exceptions=" << entry.exceptions << " callbacks ";
+        printSummary(out, entry.callbacks);
+        out << std::endl;
+    }
+    out << "[subscriptions]" << std::endl;
+    for (const auto& entry : subscriptions) {
+        out << "  #" << entry.subscriptionId << " " << entry.plugin << " <- " << entry.event
+            << ": exceptions=" << entry.exceptions << " callback ";
+        printSummary(out, entry.callback);
+        out << std::endl;
+    }
+    out << "[writer lock wait] ";
+    printSummary(out, writerLockWait);
+    out << std::endl;
+    out.flags(flags);
+}
+
+#if MOTS_ENABLE_STATS
+
+namespace {
+
+std::atomic<uint64_t> nextRecorderSerial{ 1 };
+
+std::string nameOf(const std::vector<std::string>& names, uint32_t id) {
+    return id < names.size() ? names[id] : "#" + std::to_string(id);
+}
+
+} // namespace
+
+StatsRecorder::StatsRecorder()
+    : serial_(nextRecorderSerial.fetch_add(1, std::memory_order_relaxed)), startNs_(statsNowNs()) {}
+
+StatsRecorder::Shard& StatsRecorder::attach(ThreadShards& cache) {
+    // 线程缓存中可能残留已销毁记录器的条目，超过少量时整体交还，之后按需重新登记
+    if (cache.entries.size() >= 8) {
+        cache.release();
+    }
+    std::lock_guard<std::mutex> lock(shardsMutex_);
+    // 计数按分片累加，换一个写入线程不影响合计：分片数不超过同时写入的线程数
+    for (const auto& shard : shards_) {
+        if (shard->released.load(std::memory_order_acquire)) {
+            shard->released.store(false, std::memory_order_relaxed);
+            cache.entries.emplace_back(serial_, shard);
+            return *shard;
+        }
+    }
+    shards_.push_back(std::make_shared<Shard>());
+    cache.entries.emplace_back(serial_, shards_.back());
+    return *shards_.back();
+}
+
+StatsSnapshot StatsRecorder::snapshot(const std::vector<std::string>& eventNames, const std::vector<std::string>& pluginNames) {
+    struct SubscriptionTotals {
+        uint32_t pluginId = 0;
+        uint32_t eventId = 0;
+        uint64_t exceptions = 0;
+        HistogramData callback;
+    };
+
+    std::vector<uint64_t> triggers;
+    std::vector<HistogramData> dispatch;
+    std::map<uint32_t, SubscriptionTotals> subscriptions;
+    HistogramData lockWait;
+    {
+        std::lock_guard<std::mutex> lock(shardsMutex_);
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> growth(shard->growth);
+            if (shard->events.size() > triggers.size()) {
+                triggers.resize(shard->events.size());
+                dispatch.resize(shard->events.size());
+            }
+            for (size_t id = 0; id < shard->events.size(); ++id) {
+                if (const EventCounters* counters = shard->events[id].get()) {
+                    triggers[id] += counters->triggers.load(std::memory_order_relaxed);
+                    dispatch[id].merge(counters->dispatch);
+                }
+            }
+            for (size_t id = 0; id < shard->subscriptions.size(); ++id) {
+                if (const SubscriptionCounters* counters = shard->subscriptions[id].get()) {
+                    SubscriptionTotals& totals = subscriptions[static_cast<uint32_t>(id)];
+                    totals.pluginId = counters->pluginId;
+                    totals.eventId = counters->eventId;
+                    totals.exceptions += counters->exceptions.load(std::memory_order_relaxed);
+                    totals.callback.merge(counters->callback);
+                }
+            }
+            lockWait.merge(shard->lockWait);
+        }
+    }
+
+    StatsSnapshot snapshot;
+    snapshot.enabled = true;
+    snapshot.elapsedSeconds = static_cast<double>(statsNowNs() - startNs_) / 1e9;
+    for (size_t id = 0; id < triggers.size(); ++id) {
+        if (triggers[id] == 0) {
+            continue;
+        }
+        EventStatsEntry entry;
+        entry.event = nameOf(eventNames, static_cast<uint32_t>(id));
+        entry.triggers = triggers[id];
+        entry.triggersPerSecond = snapshot.elapsedSeconds > 0 ? triggers[id] / snapshot.elapsedSeconds : 0;
+        entry.dispatch = dispatch[id].summary();
+        snapshot.events.push_back(std::move(entry));
+    }
+
+    // 插件级统计由其全部订阅汇总而来，避免热路径上重复记录
+    std::map<uint32_t, std::pair<uint64_t, HistogramData>> plugins;
+    for (const auto& [id, totals] : subscriptions) {
+        SubscriptionStatsEntry entry;
+        entry.subscriptionId = id;
+        entry.plugin = nameOf(pluginNames, totals.pluginId);
+        entry.event = nameOf(eventNames, totals.eventId);
+        entry.exceptions = totals.exceptions;
+        entry.callback = totals.callback.summary();
+        snapshot.subscriptions.push_back(std::move(entry));
+
+        auto& plugin = plugins[totals.pluginId];
+        plugin.first += totals.exceptions;
+        plugin.second.merge(totals.callback);
+    }
+    for (const auto& [id, totals] : plugins) {
+        PluginStatsEntry entry;
+        entry.plugin = nameOf(pluginNames, id);
+        entry.exceptions = totals.first;
+        entry.callbacks = totals.second.summary();
+        snapshot.plugins.push_back(std::move(entry));
+    }
+    snapshot.writerLockWait = lockWait.summary();
+    return snapshot;
+}
+
+#endif // MOTS_ENABLE_STATS
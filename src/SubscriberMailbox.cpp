@@ -0,0 +1,246 @@
+// src/SubscriberMailbox.cpp
+#include "SubscriberMailbox.h"
+
+namespace {
+
+thread_local const MailboxDrainer* currentDrainer = nullptr;
+
+} // namespace
+
+MailboxDrainer::~MailboxDrainer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeup_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void MailboxDrainer::post(std::shared_ptr<AsyncTask> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+        ++posted_;
+        if (!thread_.joinable()) {
+            thread_ = std::thread([this] { run(); });
+        }
+    }
+    wakeup_.notify_one();
+}
+
+void MailboxDrainer::flush() {
+    if (currentDrainer == this) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t target = posted_;
+    done_.wait(lock, [&] { return completed_ >= target; });
+}
+
+bool MailboxDrainer::onDrainerThread() {
+    return currentDrainer != nullptr;
+}
+
+void MailboxDrainer::run() {
+    currentDrainer = this;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wakeup_.wait(lock, [&] { return stopping_ || !tasks_.empty(); });
+        if (tasks_.empty()) {
+            break;
+        }
+        std::shared_ptr<AsyncTask> task = std::move(tasks_.front());
+        tasks_.pop_front();
+        lock.unlock();
+        task->run();
+        task.reset();
+        lock.lock();
+        ++completed_;
+        done_.notify_all();
+    }
+    currentDrainer = nullptr;
+}
+
+SubscriberMailbox::SubscriberMailbox(PayloadCallback callback, SubscriptionOptions options, AsyncEventBus& bus,
+    MailboxDrainer& drainer, ILogger& log, DeadlineCounters* deadlines)
+    : callback_(std::move(callback)), options_(std::move(options)), bus_(bus), fallback_(drainer), log_(log),
+      deadlines_(options_.deadline.count() > 0 ? deadlines : nullptr),
+      deadlineNs_(std::chrono::duration_cast<std::chrono::nanoseconds>(options_.deadline).count()) {
+    if (options_.capacity == 0) {
+        options_.capacity = 1;
+    }
+}
+
+void SubscriberMailbox::offer(const EventPayload& payload) {
+    uint64_t key = 0;
+    if (options_.policy == DeliveryPolicy::Conflate && options_.conflationKey) {
+        key = options_.conflationKey(payload);
+    }
+    // 在锁外完成复制，避免在锁内分配
+    Pending retained{ payload.retain(), deadlines_ ? statsNowNs() : 0 };
+
+    bool needSchedule = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (closed_) {
+            return;
+        }
+        switch (options_.policy) {
+        case DeliveryPolicy::DropNewest:
+            if (queue_.size() >= options_.capacity) {
+                ++stats_.dropped;
+                return;
+            }
+            queue_.push_back(std::move(retained));
+            break;
+        case DeliveryPolicy::Conflate: {
+            auto it = latest_.find(key);
+            if (it != latest_.end()) {
+                it->second = std::move(retained);
+                ++stats_.conflated;
+                return;
+            }
+            if (latest_.size() >= options_.capacity) {
+                ++stats_.dropped;
+                return;
+            }
+            conflationOrder_.push_back(uint64_t(key));
+            if (!spareNodes_.empty()) {
+                auto node = std::move(spareNodes_.back());
+                spareNodes_.pop_back();
+                node.key() = key;
+                node.mapped() = std::move(retained);
+                latest_.insert(std::move(node));
+            }
+            else {
+                latest_.emplace(key, std::move(retained));
+            }
+            break;
+        }
+        case DeliveryPolicy::Block:
+            // 分发线程或排空线程上阻塞可能等待自身，此时允许暂时超出容量
+            if (queue_.size() >= options_.capacity && !AsyncEventBus::onDispatcherThread() &&
+                !MailboxDrainer::onDrainerThread()) {
+                ++stats_.blockedPublishes;
+                notFull_.wait(lock, [&] { return closed_ || queue_.size() < options_.capacity; });
+                if (closed_) {
+                    return;
+                }
+            }
+            queue_.push_back(std::move(retained));
+            break;
+        case DeliveryPolicy::Direct:
+            queue_.push_back(std::move(retained));
+            break;
+        }
+        if (!scheduled_) {
+            scheduled_ = true;
+            needSchedule = true;
+        }
+    }
+    if (needSchedule) {
+        schedule();
+    }
+}
+
+void SubscriberMailbox::close() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    closed_ = true;
+    queue_.clear();
+    conflationOrder_.clear();
+    latest_.clear();
+    notFull_.notify_all();
+    if (drainer_ != std::this_thread::get_id()) {
+        idle_.wait(lock, [&] { return !draining_; });
+    }
+}
+
+void SubscriberMailbox::drain() {
+    if (AsyncEventBus::onDispatcherThread() || MailboxDrainer::onDrainerThread()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [&] { return closed_ || !scheduled_; });
+}
+
+DeliveryStats SubscriberMailbox::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    DeliveryStats result = stats_;
+    result.queued = pendingLocked();
+    return result;
+}
+
+void SubscriberMailbox::run() {
+    for (int processed = 0;; ++processed) {
+        Pending pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (draining_) {
+                draining_ = false;
+                ++stats_.delivered;
+            }
+            if (closed_ || pendingLocked() == 0) {
+                scheduled_ = false;
+                drainer_ = std::thread::id();
+                idle_.notify_all();
+                return;
+            }
+            if (processed >= kDrainBatch) {
+                // 重新投递，让同一分片或排空线程上的其他邮箱得以执行
+                drainer_ = std::thread::id();
+                break;
+            }
+            popLocked(pending);
+            draining_ = true;
+            drainer_ = std::this_thread::get_id();
+            notFull_.notify_one();
+        }
+        try {
+            callback_(pending.payload);
+        }
+        catch (const std::exception& e) {
+            log_.logf(LogLevel::Error, "Exception in event callback: %s", e.what());
+        }
+        catch (...) {
+            log_.logf(LogLevel::Error, "Unknown exception in event callback.");
+        }
+        if (deadlines_) {
+            deadlines_->record(statsNowNs() - pending.offeredNs, deadlineNs_);
+        }
+    }
+    schedule();
+}
+
+size_t SubscriberMailbox::pendingLocked() const {
+    return options_.policy == DeliveryPolicy::Conflate ? latest_.size() : queue_.size();
+}
+
+bool SubscriberMailbox::popLocked(Pending& pending) {
+    if (options_.policy == DeliveryPolicy::Conflate) {
+        if (conflationOrder_.empty()) {
+            return false;
+        }
+        auto node = latest_.extract(conflationOrder_.front());
+        conflationOrder_.pop_front();
+        pending = std::move(node.mapped());
+        // 保留节点供下一个新键复用
+        spareNodes_.push_back(std::move(node));
+        return true;
+    }
+    if (queue_.empty()) {
+        return false;
+    }
+    pending = std::move(queue_.front());
+    queue_.pop_front();
+    return true;
+}
+
+void SubscriberMailbox::schedule() {
+    // 以邮箱地址作为分区键，同一邮箱总在同一分片上排空
+    // 总线未运行时交给排空线程，而不是在发布线程上执行回调
+    if (!bus_.post(shared_from_this(), reinterpret_cast<uintptr_t>(this), options_.priority)) {
+        fallback_.post(shared_from_this());
+    }
+}
@@ -0,0 +1,375 @@
+// src/TimerWheel.cpp
+#include "TimerWheel.h"
+#include <algorithm>
+
+namespace {
+
+// 位图中严格大于 position 的第一个置位，不存在时返回 -1
+template <size_t Words>
+int nextSetBit(const std::array<uint64_t, Words>& bits, uint32_t position) {
+    uint32_t start = position + 1;
+    for (uint32_t word = start / 64; word < Words; ++word) {
+        uint64_t value = bits[word];
+        if (word == start / 64) {
+            value &= start % 64 == 0 ? ~uint64_t{ 0 } : ~((uint64_t{ 1 } << (start % 64)) - 1);
+        }
+        if (value != 0) {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward64(&index, value);
+            return static_cast<int>(word * 64 + index);
+#else
+            return static_cast<int>(word * 64 + __builtin_ctzll(value));
+#endif
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+TimerWheel::TimerWheel(EventManager& eventManager, std::chrono::nanoseconds tick)
+    : eventManager_(eventManager), tickNs_(std::max<int64_t>(tick.count(), 1)), startNs_(statsNowNs()) {
+    heads_.fill(kNil);
+}
+
+TimerWheel::~TimerWheel() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeup_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+TimerId TimerWheel::schedule(PluginId owner, EventId eventId, std::chrono::nanoseconds delay, std::chrono::nanoseconds period,
+    uint32_t instance) {
+    if (!owner.valid() || !eventId.valid() || period.count() < 0) {
+        return TimerId{};
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+        return TimerId{};
+    }
+    // 首个定时器时才启动后台线程
+    if (!thread_.joinable()) {
+        thread_ = std::thread([this] { run(); });
+    }
+
+    uint32_t index = allocateLocked();
+    Node& node = nodes_[index];
+    node.deadlineNs = statsNowNs() + std::max<int64_t>(delay.count(), 0);
+    node.periodNs = period.count();
+    node.fireCount = 0;
+    node.eventId = eventId;
+    node.owner = owner;
+    node.instance = instance;
+    node.expiryTick = std::max(tickOf(node.deadlineNs), currentTick_ + 1);
+    insertLocked(index);
+
+    // 挂到插件链表头
+    auto [head, inserted] = ownerHeads_.emplace(owner.value, index);
+    if (!inserted) {
+        node.ownerNext = head->second;
+        nodes_[head->second].ownerPrev = index;
+        head->second = index;
+    }
+
+    ++pending_;
+    ++scheduled_;
+    if (node.expiryTick < wakeTick_) {
+        wakeTick_ = node.expiryTick;
+        wakeup_.notify_one();
+    }
+    return TimerId{ (static_cast<uint64_t>(node.generation) << 32) | index };
+}
+
+bool TimerWheel::cancel(TimerId timer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Node* node = findLocked(timer);
+    if (!node) {
+        return false;
+    }
+    uint32_t index = static_cast<uint32_t>(timer.value);
+    unlinkLocked(index);
+    releaseLocked(index);
+    ++cancelled_;
+    return true;
+}
+
+bool TimerWheel::cancel(TimerId timer, PluginId owner, uint32_t instance) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Node* node = findLocked(timer);
+    if (!node || node->owner != owner || node->instance != instance) {
+        return false;
+    }
+    uint32_t index = static_cast<uint32_t>(timer.value);
+    unlinkLocked(index);
+    releaseLocked(index);
+    ++cancelled_;
+    return true;
+}
+
+size_t TimerWheel::cancelPluginTimers(PluginId owner, uint32_t instance) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ownerHeads_.find(owner.value);
+    if (it == ownerHeads_.end()) {
+        return 0;
+    }
+    size_t count = 0;
+    for (uint32_t index = it->second; index != kNil;) {
+        uint32_t next = nodes_[index].ownerNext;
+        if (instance == 0 || nodes_[index].instance == instance) {
+            unlinkLocked(index);
+            releaseLocked(index);
+            ++count;
+        }
+        index = next;
+    }
+    cancelled_ += count;
+    return count;
+}
+
+size_t TimerWheel::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_;
+}
+
+bool TimerWheel::isPending(TimerId timer) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return const_cast<TimerWheel*>(this)->findLocked(timer) != nullptr;
+}
+
+TimerStats TimerWheel::stats() const {
+    TimerStats result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result.scheduled = scheduled_;
+        result.fired = fired_;
+        result.cancelled = cancelled_;
+        result.missedPeriods = missedPeriods_;
+        result.pending = pending_;
+    }
+    HistogramData jitter;
+    jitter.merge(jitter_);
+    result.jitter = jitter.summary();
+    return result;
+}
+
+uint64_t TimerWheel::tickOf(int64_t timeNs) const {
+    int64_t offset = timeNs - startNs_;
+    return offset <= 0 ? 0 : static_cast<uint64_t>((offset + tickNs_ - 1) / tickNs_);
+}
+
+uint32_t TimerWheel::allocateLocked() {
+    uint32_t index;
+    if (freeList_ != kNil) {
+        index = freeList_;
+        freeList_ = nodes_[index].next;
+    }
+    else {
+        index = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+    Node& node = nodes_[index];
+    node.prev = node.next = kNil;
+    node.ownerPrev = node.ownerNext = kNil;
+    node.active = true;
+    return index;
+}
+
+// 从插件链表摘下并归还节点池；调用前节点已不在任何槽中
+void TimerWheel::releaseLocked(uint32_t index) {
+    Node& node = nodes_[index];
+    if (node.ownerPrev != kNil) {
+        nodes_[node.ownerPrev].ownerNext = node.ownerNext;
+    }
+    else {
+        auto it = ownerHeads_.find(node.owner.value);
+        if (node.ownerNext != kNil) {
+            it->second = node.ownerNext;
+        }
+        else {
+            ownerHeads_.erase(it);
+        }
+    }
+    if (node.ownerNext != kNil) {
+        nodes_[node.ownerNext].ownerPrev = node.ownerPrev;
+    }
+    node.ownerPrev = node.ownerNext = kNil;
+    node.active = false;
+    ++node.generation;
+    node.next = freeList_;
+    freeList_ = index;
+    --pending_;
+}
+
+// 选择与当前刻度高位相同的最低一层：到期刻度在该层的槽必然位于当前槽之后，
+// 当前刻度走到该槽起点时降级，最终在第 0 层恰好于到期刻度取出
+void TimerWheel::insertLocked(uint32_t index) {
+    Node& node = nodes_[index];
+    // 超出四层范围的到期时间先放在当前最高层周期的末尾，届时重新计算
+    constexpr uint64_t kTopMask = (uint64_t{ 1 } << (kLevels * kSlotBits)) - 1;
+    uint64_t placed = std::min(node.expiryTick, currentTick_ | kTopMask);
+    int level = 0;
+    while (level + 1 < kLevels &&
+        (placed >> ((level + 1) * kSlotBits)) != (currentTick_ >> ((level + 1) * kSlotBits))) {
+        ++level;
+    }
+    uint32_t slotIndex = static_cast<uint32_t>((placed >> (level * kSlotBits)) & (kSlots - 1));
+    uint32_t slot = static_cast<uint32_t>(level) * kSlots + slotIndex;
+
+    node.slot = static_cast<uint16_t>(slot);
+    node.prev = kNil;
+    node.next = heads_[slot];
+    if (node.next != kNil) {
+        nodes_[node.next].prev = index;
+    }
+    heads_[slot] = index;
+    occupied_[level][slotIndex / 64] |= uint64_t{ 1 } << (slotIndex % 64);
+}
+
+void TimerWheel::unlinkLocked(uint32_t index) {
+    Node& node = nodes_[index];
+    if (node.prev != kNil) {
+        nodes_[node.prev].next = node.next;
+    }
+    else {
+        heads_[node.slot] = node.next;
+        if (node.next == kNil) {
+            uint32_t slotIndex = node.slot % kSlots;
+            occupied_[node.slot / kSlots][slotIndex / 64] &= ~(uint64_t{ 1 } << (slotIndex % 64));
+        }
+    }
+    if (node.next != kNil) {
+        nodes_[node.next].prev = node.prev;
+    }
+    node.prev = node.next = kNil;
+}
+
+uint32_t TimerWheel::detachSlotLocked(uint32_t slot) {
+    uint32_t head = heads_[slot];
+    heads_[slot] = kNil;
+    uint32_t slotIndex = slot % kSlots;
+    occupied_[slot / kSlots][slotIndex / 64] &= ~(uint64_t{ 1 } << (slotIndex % 64));
+    return head;
+}
+
+TimerWheel::Node* TimerWheel::findLocked(TimerId timer) {
+    uint32_t index = static_cast<uint32_t>(timer.value);
+    uint32_t generation = static_cast<uint32_t>(timer.value >> 32);
+    if (!timer.valid() || index >= nodes_.size()) {
+        return nullptr;
+    }
+    Node& node = nodes_[index];
+    return node.active && node.generation == generation ? &node : nullptr;
+}
+
+// 下一个需要处理的刻度：低层的下一个非空槽总是早于高层的下一次降级
+uint64_t TimerWheel::nextEventTickLocked() const {
+    for (int level = 0; level < kLevels; ++level) {
+        int shift = level * kSlotBits;
+        uint32_t current = static_cast<uint32_t>((currentTick_ >> shift) & (kSlots - 1));
+        int slot = nextSetBit(occupied_[level], current);
+        if (slot >= 0) {
+            uint64_t block = (currentTick_ >> (shift + kSlotBits)) << (shift + kSlotBits);
+            return block | (static_cast<uint64_t>(slot) << shift);
+        }
+    }
+    // 只剩超出范围的定时器：下一个最高层周期开始时重新放置
+    return ((currentTick_ >> (kLevels * kSlotBits)) + 1) << (kLevels * kSlotBits);
+}
+
+void TimerWheel::advanceLocked(uint64_t targetTick, int64_t nowNs, std::vector<TimerEvent>& expired, std::vector<EventId>& events) {
+    while (currentTick_ < targetTick && pending_ != 0) {
+        uint64_t next = nextEventTickLocked();
+        if (next > targetTick) {
+            currentTick_ = targetTick;
+            break;
+        }
+        currentTick_ = next;
+
+        // 自高层向低层降级，落到第 0 层当前槽的节点随后在本刻度到期
+        for (int level = kLevels - 1; level >= 1; --level) {
+            int shift = level * kSlotBits;
+            if ((currentTick_ & ((uint64_t{ 1 } << shift) - 1)) != 0) {
+                continue;
+            }
+            uint32_t slot = static_cast<uint32_t>(level) * kSlots + static_cast<uint32_t>((currentTick_ >> shift) & (kSlots - 1));
+            for (uint32_t index = detachSlotLocked(slot); index != kNil;) {
+                uint32_t next = nodes_[index].next;
+                insertLocked(index);
+                index = next;
+            }
+        }
+
+        uint32_t slot = static_cast<uint32_t>(currentTick_ & (kSlots - 1));
+        for (uint32_t index = detachSlotLocked(slot); index != kNil;) {
+            uint32_t next = nodes_[index].next;
+            Node& node = nodes_[index];
+            if (node.expiryTick > currentTick_) {
+                insertLocked(index);
+                index = next;
+                continue;
+            }
+            ++fired_;
+            expired.push_back(TimerEvent{ TimerId{ (static_cast<uint64_t>(node.generation) << 32) | index },
+                ++node.fireCount, node.deadlineNs, 0 });
+            events.push_back(node.eventId);
+            if (node.periodNs > 0) {
+                // 周期定时器按计划时间累加，不随触发延迟漂移；落后时跳过已错过的周期
+                node.deadlineNs += node.periodNs;
+                if (node.deadlineNs <= nowNs) {
+                    int64_t missed = (nowNs - node.deadlineNs) / node.periodNs + 1;
+                    node.deadlineNs += missed * node.periodNs;
+                    missedPeriods_ += static_cast<uint64_t>(missed);
+                }
+                node.expiryTick = std::max(tickOf(node.deadlineNs), currentTick_ + 1);
+                insertLocked(index);
+            }
+            else {
+                node.prev = node.next = kNil;
+                releaseLocked(index);
+            }
+            index = next;
+        }
+    }
+    if (currentTick_ < targetTick && pending_ == 0) {
+        currentTick_ = targetTick;
+    }
+}
+
+void TimerWheel::run() {
+    std::vector<TimerEvent> expired;
+    std::vector<EventId> events;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        int64_t now = statsNowNs();
+        expired.clear();
+        events.clear();
+        advanceLocked(static_cast<uint64_t>(std::max<int64_t>(now - startNs_, 0) / tickNs_), now, expired, events);
+
+        if (!expired.empty()) {
+            // 在锁外分发，回调中可以再次调度或取消定时器
+            lock.unlock();
+            for (size_t i = 0; i < expired.size(); ++i) {
+                TimerEvent& event = expired[i];
+                event.firedNs = statsNowNs();
+                jitter_.record(event.firedNs - event.deadlineNs);
+                eventManager_.triggerEvent(events[i], EventPayload::view(event));
+            }
+            lock.lock();
+            continue;
+        }
+
+        wakeTick_ = pending_ != 0 ? nextEventTickLocked() : UINT64_MAX;
+        if (wakeTick_ == UINT64_MAX) {
+            wakeup_.wait(lock);
+        }
+        else {
+            wakeup_.wait_until(lock, std::chrono::steady_clock::time_point(std::chrono::nanoseconds(timeOf(wakeTick_))));
+        }
+    }
+}
@@ -6,20 +6,16 @@
 int main() {
     PluginManager manager;
 
-    // 使用 apphome/bin 目录下的插件路径
+    // 并发加载 apphome/bin 目录下的全部插件，依赖方在其依赖初始化后才初始化
     std::filesystem::path exePath = std::filesystem::current_path();
-    std::string pluginPath;
+    std::vector<PluginLoadReport> reports = manager.loadPlugins(exePath.string());
 
-#if defined(_WIN32)
-    pluginPath = (exePath / "SamplePlugin.dll").string();
-#elif defined(__APPLE__)
-    pluginPath = (exePath / "libSamplePlugin.dylib").string();
-#else
-    pluginPath = (exePath / "libSamplePlugin.so").string();
-#endif
-
-    if (!manager.loadPlugin(pluginPath)) {
-        std::cerr << "Failed to load plugin from: " << pluginPath << std::endl;
+    bool anyLoaded = false;
+    for (const auto& report : reports) {
+        anyLoaded = anyLoaded || report.loaded;
+    }
+    if (!anyLoaded) {
+        std::cerr << "Failed to load any plugin from: " << exePath.string() << std::endl;
         return 1;
     }
 
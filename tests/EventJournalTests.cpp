@@ -0,0 +1,196 @@
+// tests/EventJournalTests.cpp
+#include "../include/Test.h"
+#include "../include/PluginManager.h"
+#include "../include/PluginPath.h"
+#include <filesystem>
+#include <set>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+struct JournalQuote {
+    uint32_t symbolId;
+    double bid;
+    double ask;
+};
+
+std::string journalPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / ("mots_" + name + ".journal")).string();
+}
+
+} // namespace
+
+// 测试经 PluginManager 发布的各类负载被记录，并能在新的管理器中按原顺序、原类型重放
+TEST(TestJournalRecordsAndReplays) {
+    std::string path = journalPath("replay");
+    {
+        PluginManager recorder;
+        ASSERT_TRUE(recorder.startJournal(path, size_t(1) << 20), "Journal should open");
+        EventId quoteId = recorder.resolvePluginEvent("OnQuote");
+        JournalQuote quote{ 7, 100.25, 100.5 };
+        recorder.triggerPluginEvent("OnText", std::string("hello"));
+        recorder.triggerPluginEvent(quoteId, EventPayload::view(quote));
+        recorder.triggerPluginEvent("OnRaw", EventPayload::fromBytes(std::string_view("\x01\x02\x03", 3)));
+        std::vector<BatchEvent> batch{ { quoteId, EventPayload::view(quote) }, { quoteId, EventPayload::view(quote) } };
+        recorder.triggerPluginEvents(batch);
+        ASSERT_EQ(recorder.getJournalStats().records, static_cast<uint64_t>(5), "Every published event should be recorded");
+        recorder.stopJournal();
+        ASSERT_EQ(recorder.getJournalStats().records, static_cast<uint64_t>(0), "A stopped journal reports nothing");
+        recorder.triggerPluginEvent("OnText", std::string("not recorded"));
+    }
+
+    JournalReader reader;
+    ASSERT_TRUE(reader.open(path), "Journal should be readable after stop");
+    std::vector<std::string> names;
+    uint64_t lastSequence = 0;
+    bool ordered = true;
+    reader.forEach([&](const JournalEntry& entry) {
+        ordered = ordered && (names.empty() || entry.sequence == lastSequence + 1);
+        lastSequence = entry.sequence;
+        names.emplace_back(entry.eventName);
+    });
+    ASSERT_EQ(names.size(), static_cast<size_t>(5), "The reader should see every recorded event");
+    ASSERT_TRUE(ordered, "Sequence numbers should increase by one");
+    ASSERT_TRUE(names[0] == "OnText" && names[1] == "OnQuote" && names[2] == "OnRaw" && names[4] == "OnQuote",
+        "Event names should be restored from definition records");
+
+    EventManager replayer;
+    std::vector<std::string> texts;
+    std::vector<double> bids;
+    std::string raw;
+    replayer.registerEvent("Strategy", "OnText", [&](const std::string& data) { texts.push_back(data); });
+    replayer.registerEvent("Strategy", "OnQuote", [&](const EventPayload& payload) {
+        const JournalQuote* replayed = payload.as<JournalQuote>();
+        bids.push_back(replayed ? replayed->bid : 0.0);
+    });
+    replayer.registerEvent("Strategy", "OnRaw", [&](const EventPayload& payload) {
+        raw = payload.is<EventPayload::Bytes>() ? std::string(payload.bytes()) : std::string();
+    });
+    reader.bindType<JournalQuote>();
+    ReplayStats stats = reader.replay(replayer);
+
+    ASSERT_EQ(stats.events, static_cast<uint64_t>(5), "Every event should be replayed");
+    ASSERT_TRUE(texts.size() == 1 && texts[0] == "hello", "String payloads should replay unchanged");
+    ASSERT_TRUE(bids.size() == 3 && bids[0] == 100.25 && bids[2] == 100.25, "Bound types should replay as typed views");
+    ASSERT_EQ(raw, std::string("\x01\x02\x03", 3), "Raw bytes should replay as bytes");
+    reader.close();
+    std::filesystem::remove(path);
+}
+
+// 测试多个线程并发追加：记录不丢失、不重叠，序号各不相同；容量耗尽时计数并截断文件
+TEST(TestJournalConcurrentAppendAndCapacity) {
+    std::string path = journalPath("concurrent");
+    EventManager manager;
+    EventId eventId = manager.resolveEvent("OnTick");
+    {
+        JournalWriter writer(manager);
+        ASSERT_TRUE(writer.open(path, size_t(4) << 20), "Journal should open");
+        constexpr int kThreads = 4;
+        constexpr int kPerThread = 5000;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < kPerThread; ++i) {
+                    uint64_t value = static_cast<uint64_t>(t) << 32 | static_cast<uint64_t>(i);
+                    writer.append(eventId, EventPayload::view(value));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        ASSERT_EQ(writer.stats().records, static_cast<uint64_t>(kThreads * kPerThread), "Every append should be recorded");
+        writer.close();
+
+        JournalReader reader;
+        ASSERT_TRUE(reader.open(path), "Journal should be readable");
+        std::set<uint64_t> sequences;
+        std::vector<int> nextPerThread(kThreads, 0);
+        bool perThreadOrdered = true;
+        reader.forEach([&](const JournalEntry& entry) {
+            sequences.insert(entry.sequence);
+            uint64_t value = 0;
+            std::memcpy(&value, entry.bytes.data(), sizeof(value));
+            int thread = static_cast<int>(value >> 32);
+            perThreadOrdered = perThreadOrdered && static_cast<int>(value & 0xffffffffu) == nextPerThread[thread]++;
+        });
+        ASSERT_EQ(sequences.size(), static_cast<size_t>(kThreads * kPerThread), "Sequence numbers should be unique");
+        ASSERT_TRUE(perThreadOrdered, "Each thread's records should stay in order");
+    }
+
+    {
+        JournalWriter writer(manager);
+        ASSERT_TRUE(writer.open(path, 4096, false), "A small journal should open");
+        const std::string payload(100, 'x');
+        int appended = 0;
+        for (int i = 0; i < 100; ++i) {
+            appended += writer.append(eventId, EventPayload::fromString(payload)) ? 1 : 0;
+        }
+        JournalStats stats = writer.stats();
+        ASSERT_TRUE(appended > 0 && appended < 100, "Only part of the events should fit");
+        ASSERT_EQ(stats.dropped, static_cast<uint64_t>(100 - appended), "Events beyond the capacity should be counted");
+        writer.close();
+        ASSERT_EQ(static_cast<size_t>(std::filesystem::file_size(path)), stats.bytes, "The file should be truncated to its used length");
+
+        JournalReader reader;
+        ASSERT_TRUE(reader.open(path), "A full journal should be readable");
+        ASSERT_EQ(reader.forEach([](const JournalEntry&) {}), static_cast<uint64_t>(appended),
+            "The reader should see every event that fit");
+    }
+    std::filesystem::remove(path);
+}
+
+// 测试按记录节奏重放时保持事件间隔，speed 加快重放
+TEST(TestJournalReplayAtRecordedPace) {
+    std::string path = journalPath("paced");
+    {
+        PluginManager recorder;
+        ASSERT_TRUE(recorder.startJournal(path, size_t(1) << 20), "Journal should open");
+        for (int i = 0; i < 5; ++i) {
+            recorder.triggerPluginEvent("OnPaced", std::to_string(i));
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    PluginManager replayer;
+    ASSERT_TRUE(replayer.loadPlugin(pluginPath("SamplePlugin")), "SamplePlugin should load");
+    std::vector<int64_t> arrivals;
+    replayer.registerPluginEvent("SamplePlugin", "OnPaced", [&](const EventPayload&) { arrivals.push_back(statsNowNs()); });
+    ReplayOptions options;
+    options.pace = ReplayPace::Recorded;
+    ReplayStats stats = replayer.replayJournal(path, options);
+    ASSERT_EQ(stats.events, static_cast<uint64_t>(5), "Every event should be replayed");
+    ASSERT_TRUE(arrivals.back() - arrivals.front() >= 38000000, "Recorded pace should keep the original spacing");
+
+    options.speed = 4.0;
+    arrivals.clear();
+    stats = replayer.replayJournal(path, options);
+    int64_t span = arrivals.back() - arrivals.front();
+    ASSERT_TRUE(span >= 9000000 && span < 38000000, "Speed should shorten the spacing");
+    std::filesystem::remove(path);
+}
+
+// 测试异步发布只记录被接受的事件；按名称的分区发布与同步按名称发布一样记录尚无订阅者的事件
+TEST(TestJournalRecordsOnlyAcceptedAsyncEvents) {
+    std::string path = journalPath("async");
+    PluginManager recorder;
+    ASSERT_TRUE(recorder.startJournal(path, size_t(1) << 20), "Journal should open");
+    EventId quoteId = recorder.resolvePluginEvent("OnQuote");
+    JournalQuote quote{ 7, 100.25, 100.5 };
+    ASSERT_TRUE(!recorder.publishAsync(quoteId, EventPayload::view(quote)), "Publishing without dispatchers should fail");
+    ASSERT_TRUE(!recorder.publishAsync("OnText", std::string("dropped")), "Publishing by name without dispatchers should fail");
+    ASSERT_EQ(recorder.getJournalStats().records, static_cast<uint64_t>(0), "Rejected async events should not be recorded");
+
+    recorder.triggerPluginEvent("OnKeyed", std::string("sync"), std::string_view("AAPL"));
+    ASSERT_EQ(recorder.getJournalStats().records, static_cast<uint64_t>(1), "A keyed event without subscribers should be recorded");
+
+    ASSERT_TRUE(recorder.startAsyncDispatch(1, 64), "Async dispatch should start");
+    ASSERT_TRUE(recorder.publishAsync("OnText", std::string("queued")), "Publishing by name should be accepted");
+    recorder.triggerPluginEvent("OnKeyed", std::string("async"), std::string_view("AAPL"));
+    recorder.flushAsync();
+    ASSERT_EQ(recorder.getJournalStats().records, static_cast<uint64_t>(3), "Accepted async events should be recorded");
+    recorder.stopAsyncDispatch();
+    recorder.stopJournal();
+    std::filesystem::remove(path);
+}
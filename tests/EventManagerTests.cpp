@@ -0,0 +1,492 @@
+// tests/EventManagerTests.cpp
+#include "../include/Test.h"
+#include "../include/Event.h"
+#include "../include/Channel.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 测试同一事件名称总是解析为同一标识
+TEST(TestResolveEventIsStable) {
+    EventManager manager;
+    EventId first = manager.resolveEvent("OnQuote");
+    EventId second = manager.resolveEvent("OnQuote");
+    EventId other = manager.resolveEvent("OnTrade");
+    ASSERT_TRUE(first.valid(), "Resolved id should be valid");
+    ASSERT_TRUE(first == second, "Same name should resolve to the same id");
+    ASSERT_TRUE(first != other, "Different names should resolve to different ids");
+    ASSERT_TRUE(!manager.findEvent("OnUnknown").valid(), "findEvent should not intern unknown names");
+}
+
+// 测试按标识触发与按名称触发到达同一组回调
+TEST(TestTriggerByEventId) {
+    EventManager manager;
+    int count = 0;
+    manager.registerEvent("TestPlugin", "OnQuote", [&](const std::string& data) {
+        ASSERT_EQ(data, std::string("payload"), "Payload should be forwarded");
+        ++count;
+    });
+    EventId quoteId = manager.resolveEvent("OnQuote");
+    manager.triggerEvent(quoteId, "payload");
+    manager.triggerEvent("OnQuote", "payload");
+    ASSERT_EQ(count, 2, "Callback should fire for both id and name triggers");
+
+    manager.triggerEvent(EventId{}, "payload");
+    ASSERT_EQ(count, 2, "Invalid id should not dispatch");
+    ASSERT_TRUE(!manager.registerEvent("TestPlugin", EventId{}, [](const std::string&) {}),
+        "Registering with an invalid id should fail");
+}
+
+// 测试回调中再次触发事件和注册新回调不会死锁
+TEST(TestReentrantTriggerFromCallback) {
+    EventManager manager;
+    int innerCount = 0;
+    manager.registerEvent("TestPlugin", "OnInner", [&](const std::string&) {
+        ++innerCount;
+    });
+    manager.registerEvent("TestPlugin", "OnOuter", [&](const std::string& data) {
+        manager.triggerEvent("OnInner", data);
+        manager.registerEvent("TestPlugin", "OnLate", [](const std::string&) {});
+    });
+    manager.triggerEvent("OnOuter", "data");
+    ASSERT_EQ(innerCount, 1, "Nested trigger should reach the inner callback");
+    ASSERT_TRUE(manager.findEvent("OnLate").valid(), "Registration inside a callback should succeed");
+}
+
+// 测试多线程发布与注册/注销并发进行时回调不丢失也不崩溃
+TEST(TestConcurrentPublishAndChurn) {
+    EventManager manager;
+    std::atomic<uint64_t> delivered{ 0 };
+    manager.registerEvent("StablePlugin", "OnTick", [&](const std::string&) {
+        delivered.fetch_add(1, std::memory_order_relaxed);
+    });
+    EventId tickId = manager.resolveEvent("OnTick");
+
+    constexpr int kPublishers = 4;
+    constexpr int kPerPublisher = 20000;
+    std::vector<std::thread> publishers;
+    for (int t = 0; t < kPublishers; ++t) {
+        publishers.emplace_back([&] {
+            for (int i = 0; i < kPerPublisher; ++i) {
+                manager.triggerEvent(tickId, "tick");
+            }
+        });
+    }
+    for (int i = 0; i < 200; ++i) {
+        manager.registerEvent("ChurnPlugin", "OnTick", [](const std::string&) {});
+        manager.registerEvent("ChurnPlugin", "OnOther" + std::to_string(i), [](const std::string&) {});
+        manager.unregisterPluginCallbacks("ChurnPlugin");
+    }
+    for (auto& publisher : publishers) {
+        publisher.join();
+    }
+    manager.synchronize();
+    ASSERT_EQ(delivered.load(), static_cast<uint64_t>(kPublishers * kPerPublisher),
+        "Stable subscriber should see every publish");
+}
+
+namespace {
+struct TestQuote {
+    uint32_t symbolId;
+    double bid;
+    double ask;
+};
+}
+
+// 测试类型化负载按引用到达所有订阅者，旧字符串回调仍可接收字符串负载
+TEST(TestTypedPayloadSharedAcrossSubscribers) {
+    EventManager manager;
+    const TestQuote* seen[2] = { nullptr, nullptr };
+    manager.registerEvent("TestPlugin", "OnQuote", [&](const EventPayload& payload) {
+        seen[0] = payload.as<TestQuote>();
+    });
+    manager.registerEvent("TestPlugin", "OnQuote", [&](const EventPayload& payload) {
+        seen[1] = payload.as<TestQuote>();
+        ASSERT_TRUE(payload.as<std::string>() == nullptr, "Type mismatch should yield nullptr");
+    });
+
+    TestQuote quote{ 7, 100.25, 100.26 };
+    manager.triggerEvent("OnQuote", EventPayload::view(quote));
+    ASSERT_TRUE(seen[0] == &quote && seen[1] == &quote, "Subscribers should see the publisher's object without a copy");
+
+    std::string legacyData;
+    manager.registerEvent("TestPlugin", "OnLegacy", [&](const std::string& data) {
+        legacyData = data;
+    });
+    manager.triggerEvent("OnLegacy", EventPayload::copyOf("legacy"));
+    ASSERT_EQ(legacyData, std::string("legacy"), "String callbacks should receive string payloads");
+}
+
+// 测试 retain() 生成可跨调用保留的拥有型负载
+TEST(TestPayloadRetainOwnsData) {
+    EventPayload retained;
+    {
+        TestQuote quote{ 1, 1.5, 2.5 };
+        retained = EventPayload::view(quote).retain();
+    }
+    ASSERT_TRUE(retained.owning(), "Retained payload should own its data");
+    ASSERT_TRUE(retained.as<TestQuote>() != nullptr, "Retained payload should keep its type");
+    ASSERT_EQ(retained.as<TestQuote>()->ask, 2.5, "Retained payload should keep its contents");
+
+    auto shared = EventPayload::make<TestQuote>(TestQuote{ 2, 3.0, 4.0 });
+    ASSERT_TRUE(shared.retain().as<TestQuote>() == shared.as<TestQuote>(), "Owning payloads retain by reference");
+}
+
+// 测试就地回调的复制、移动与调用语义
+TEST(TestInplaceCallbackCopyAndMove) {
+    auto counter = std::make_shared<int>(0);
+    PayloadCallback original = [counter](const EventPayload&) { ++*counter; };
+    ASSERT_EQ(counter.use_count(), 2L, "Capture should be stored in place");
+
+    PayloadCallback copy = original;
+    ASSERT_EQ(counter.use_count(), 3L, "Copy should copy the capture");
+    PayloadCallback moved = std::move(copy);
+    ASSERT_TRUE(!copy && moved, "Move should transfer the callable");
+    ASSERT_EQ(counter.use_count(), 3L, "Move should not duplicate the capture");
+
+    original(EventPayload());
+    moved(EventPayload());
+    ASSERT_EQ(*counter, 2, "Both callables should invoke the shared capture");
+
+    original = nullptr;
+    moved = PayloadCallback();
+    ASSERT_EQ(counter.use_count(), 1L, "Reset should destroy the capture");
+    ASSERT_TRUE(sizeof(CallbackInfo) <= 64, "A subscription record should fit in one cache line");
+}
+
+// 测试插件标识：同名插件共享标识，按标识注销只影响该插件
+TEST(TestUnregisterByPluginId) {
+    EventManager manager;
+    PluginId first = manager.resolvePlugin("FirstPlugin");
+    PluginId second = manager.resolvePlugin("SecondPlugin");
+    ASSERT_TRUE(first == manager.resolvePlugin("FirstPlugin"), "Same plugin name should resolve to the same id");
+    ASSERT_TRUE(first != second, "Different plugins should get different ids");
+
+    EventId eventId = manager.resolveEvent("OnShared");
+    int firstCount = 0;
+    int secondCount = 0;
+    manager.registerEvent(first, eventId, [&](const EventPayload&) { ++firstCount; });
+    manager.registerEvent(second, eventId, [&](const EventPayload&) { ++secondCount; });
+    manager.unregisterPluginCallbacks(first);
+    manager.triggerEvent(eventId, "data");
+    ASSERT_EQ(firstCount, 0, "Unregistered plugin should not be called");
+    ASSERT_EQ(secondCount, 1, "Other plugins should keep their callbacks");
+}
+
+// 测试按凭据注销单个回调，同一插件的其他订阅保持不变
+TEST(TestUnsubscribeByToken) {
+    EventManager manager;
+    PluginId pluginId = manager.resolvePlugin("TokenPlugin");
+    EventId eventId = manager.resolveEvent("OnToken");
+    int firstCount = 0;
+    int secondCount = 0;
+    SubscriptionToken first = manager.registerEvent(pluginId, eventId, [&](const EventPayload&) { ++firstCount; });
+    SubscriptionToken second = manager.registerEvent(pluginId, eventId, [&](const EventPayload&) { ++secondCount; });
+    ASSERT_TRUE(first.valid() && second.valid(), "Registration should return valid tokens");
+    ASSERT_TRUE(first.subscriptionId != second.subscriptionId, "Each subscription should get its own token");
+    ASSERT_TRUE(!manager.registerEvent(pluginId, EventId{ 999 }, [](const EventPayload&) {}).valid(), "Unknown event id should yield an invalid token");
+
+    ASSERT_TRUE(manager.unsubscribe(first), "Token should unsubscribe its callback");
+    ASSERT_TRUE(!manager.unsubscribe(first), "Token should only unsubscribe once");
+    manager.triggerEvent(eventId, "data");
+    ASSERT_EQ(firstCount, 0, "Unsubscribed callback should not be called");
+    ASSERT_EQ(secondCount, 1, "Other callbacks of the plugin should remain");
+    ASSERT_EQ(manager.subscriptionCount(pluginId), static_cast<size_t>(1), "Reverse index should track remaining subscriptions");
+
+    manager.unregisterPluginCallbacks(pluginId);
+    ASSERT_EQ(manager.subscriptionCount(pluginId), static_cast<size_t>(0), "Unregistering a plugin should clear its reverse index");
+    ASSERT_TRUE(!manager.hasSubscribers(eventId), "Event should have no subscribers left");
+}
+
+// 测试编译期通道调用全部静态处理器，并与动态总线双向互通
+TEST(TestChannelStaticDispatchAndBridge) {
+    EventManager bus;
+    int staticCalls = 0;
+    double lastBid = 0;
+    auto channel = makeChannel<TestQuote>(
+        [&](const TestQuote&) { ++staticCalls; },
+        [&](const TestQuote& quote) { lastBid = quote.bid; });
+
+    channel.publish(TestQuote{ 1, 10.5, 10.6 });
+    ASSERT_EQ(staticCalls, 1, "Static handler should be called");
+    ASSERT_EQ(lastBid, 10.5, "All static handlers should receive the message");
+
+    // 运行时订阅者经桥接收到同一对象
+    EventId quoteId = bus.resolveEvent("OnChannelQuote");
+    PluginId pluginId = bus.resolvePlugin("RuntimePlugin");
+    channel.bridgeTo(bus, quoteId);
+    const TestQuote* dynamicSeen = nullptr;
+    subscribeTyped<TestQuote>(bus, pluginId, quoteId, [&](const TestQuote& quote) { dynamicSeen = &quote; });
+    TestQuote quote{ 2, 11.0, 11.1 };
+    channel.publish(quote);
+    ASSERT_TRUE(dynamicSeen == &quote, "Bridged publish should reach runtime subscribers without a copy");
+    ASSERT_EQ(staticCalls, 2, "Static handlers should still run when bridged");
+
+    // 动态总线上的事件进入静态处理器，但不会再次转发形成回环
+    EventId inboundId = bus.resolveEvent("OnInboundQuote");
+    channel.subscribeTo(bus, pluginId, inboundId);
+    bus.triggerEvent(inboundId, EventPayload::view(TestQuote{ 3, 12.0, 12.1 }));
+    ASSERT_EQ(staticCalls, 3, "Inbound bus events should reach static handlers");
+    ASSERT_EQ(lastBid, 12.0, "Inbound payload should be delivered as T");
+}
+
+// 测试统计快照按事件、插件与订阅计数，异常单独计数；直方图百分位单调
+TEST(TestStatsSnapshotCountsCallbacks) {
+    EventManager manager;
+    PluginId pluginId = manager.resolvePlugin("StatsPlugin");
+    EventId eventId = manager.resolveEvent("OnStats");
+    SubscriptionToken ok = manager.registerEvent(pluginId, eventId, [](const EventPayload&) {});
+    manager.registerEvent(pluginId, eventId, [](const EventPayload&) { throw std::runtime_error("stats"); });
+    for (int i = 0; i < 10; ++i) {
+        manager.triggerEvent(eventId, "data");
+    }
+
+    StatsSnapshot snapshot = manager.statsSnapshot();
+#if MOTS_ENABLE_STATS
+    ASSERT_TRUE(snapshot.enabled, "Statistics should be enabled by default");
+    ASSERT_EQ(snapshot.events.size(), static_cast<size_t>(1), "Only triggered events should be reported");
+    ASSERT_EQ(snapshot.events[0].event, std::string("OnStats"), "Event should be reported by name");
+    ASSERT_EQ(snapshot.events[0].triggers, static_cast<uint64_t>(10), "Every trigger should be counted");
+    ASSERT_EQ(snapshot.subscriptions.size(), static_cast<size_t>(2), "Each subscription should be reported");
+    ASSERT_EQ(snapshot.subscriptions[0].subscriptionId, ok.subscriptionId, "Subscriptions should be ordered by id");
+    ASSERT_EQ(snapshot.subscriptions[0].callback.count, static_cast<uint64_t>(10), "Every callback should be timed");
+    ASSERT_EQ(snapshot.subscriptions[1].exceptions, static_cast<uint64_t>(10), "Exceptions should be counted per subscription");
+    ASSERT_EQ(snapshot.plugins.size(), static_cast<size_t>(1), "Plugin totals should be aggregated");
+    ASSERT_EQ(snapshot.plugins[0].plugin, std::string("StatsPlugin"), "Plugin should be reported by name");
+    ASSERT_EQ(snapshot.plugins[0].callbacks.count, static_cast<uint64_t>(20), "Plugin totals should include all its callbacks");
+    ASSERT_TRUE(snapshot.writerLockWait.count > 0, "Writer lock waits should be recorded");
+
+    manager.setStatsEnabled(false);
+    manager.triggerEvent(eventId, "data");
+    ASSERT_EQ(manager.statsSnapshot().events[0].triggers, static_cast<uint64_t>(10), "Disabled statistics should not record");
+
+    HistogramData histogram;
+    for (uint64_t ns : { 5ull, 100ull, 1000ull, 50000ull, 1000000ull }) {
+        histogram.counts[LatencyHistogram::bucketOf(ns)] += 1;
+        histogram.sumNs += ns;
+        histogram.maxNs = std::max<uint64_t>(histogram.maxNs, ns);
+        ASSERT_TRUE(LatencyHistogram::upperBoundOf(LatencyHistogram::bucketOf(ns)) >= ns, "Bucket upper bound should cover the value");
+    }
+    LatencySummary summary = histogram.summary();
+    ASSERT_TRUE(summary.p50Us <= summary.p99Us && summary.p99Us <= summary.maxUs, "Percentiles should be monotonic");
+    ASSERT_EQ(summary.maxUs, 1000.0, "Maximum should be exact");
+#else
+    ASSERT_TRUE(!snapshot.enabled, "Statistics should be compiled out");
+#endif
+}
+
+// 测试批量触发：普通订阅者按批内顺序逐条收到，批量订阅者每段连续事件只调用一次
+TEST(TestTriggerEventsDeliversSlices) {
+    EventManager manager;
+    PluginId pluginId = manager.resolvePlugin("BatchPlugin");
+    EventId quotes = manager.resolveEvent("OnBatchQuote");
+    EventId trades = manager.resolveEvent("OnBatchTrade");
+
+    std::vector<int> perItem;
+    manager.registerEvent(pluginId, quotes, [&](const EventPayload& payload) { perItem.push_back(*payload.as<int>()); });
+    std::vector<size_t> sliceSizes;
+    int sliceSum = 0;
+    SubscriptionToken batchToken = manager.registerBatchEvent(pluginId, quotes, [&](const EventBatchView& slice) {
+        sliceSizes.push_back(slice.size());
+        for (const auto& event : slice) {
+            sliceSum += *event.payload.as<int>();
+        }
+    });
+    ASSERT_TRUE(batchToken.valid(), "Batch subscription should return a valid token");
+
+    int values[] = { 1, 2, 3, 4, 5 };
+    std::vector<BatchEvent> batch = {
+        { quotes, EventPayload::view(values[0]) },
+        { quotes, EventPayload::view(values[1]) },
+        { quotes, EventPayload::view(values[2]) },
+        { trades, EventPayload::view(values[3]) },
+        { quotes, EventPayload::view(values[4]) },
+    };
+    manager.triggerEvents(batch);
+    ASSERT_EQ(perItem.size(), static_cast<size_t>(4), "Per-item subscribers should receive every matching event");
+    ASSERT_EQ(perItem[3], 5, "Per-item subscribers should receive events in batch order");
+    ASSERT_EQ(sliceSizes.size(), static_cast<size_t>(2), "Batch subscriber should be called once per contiguous run");
+    ASSERT_EQ(sliceSizes[0], static_cast<size_t>(3), "First run should hold the three leading quotes");
+    ASSERT_EQ(sliceSum, 1 + 2 + 3 + 5, "Batch subscriber should see every quote");
+
+    manager.triggerEvent(quotes, EventPayload::view(values[0]));
+    ASSERT_EQ(sliceSizes.back(), static_cast<size_t>(1), "Single triggers should reach batch subscribers as a slice of one");
+
+    ASSERT_TRUE(manager.unsubscribe(batchToken), "Batch subscription should unsubscribe by token");
+    manager.triggerEvents(batch);
+    ASSERT_EQ(sliceSizes.size(), static_cast<size_t>(3), "Unsubscribed batch callback should not be called");
+}
+
+// 测试主题前缀树两个方向的匹配：'*' 恰好一层，'#' 零或多层
+TEST(TestTopicTrieMatching) {
+    TopicTrie<uint32_t> patterns;
+    patterns.insert("md.XNAS.*.quote", 1);
+    patterns.insert("md.#", 2);
+    patterns.insert("md.XNAS.AAPL.quote", 3);
+    patterns.insert("#.trade", 4);
+    patterns.insert("md.#.#", 5);
+    std::vector<uint32_t> matched;
+    patterns.matchTopic("md.XNAS.AAPL.quote", matched);
+    ASSERT_TRUE((matched == std::vector<uint32_t>{ 1, 2, 3, 5 }), "Exact, '*' and '#' patterns should match once each");
+    matched.clear();
+    patterns.matchTopic("md", matched);
+    ASSERT_TRUE((matched == std::vector<uint32_t>{ 2, 5 }), "'#' should match zero levels");
+    matched.clear();
+    patterns.matchTopic("md.XNAS.AAPL.trade", matched);
+    ASSERT_TRUE((matched == std::vector<uint32_t>{ 2, 4, 5 }), "A leading '#' should match any prefix");
+    matched.clear();
+    patterns.matchTopic("md.XNAS.quote", matched);
+    ASSERT_TRUE((matched == std::vector<uint32_t>{ 2, 5 }), "'*' should match exactly one level");
+    ASSERT_TRUE(patterns.erase("md.#", 2) && !patterns.erase("md.#", 2), "Erase should remove a value once");
+
+    TopicTrie<uint32_t> topics;
+    topics.insert("md.XNAS.AAPL.quote", 10);
+    topics.insert("md.XNAS.MSFT.quote", 11);
+    topics.insert("md.XNYS.IBM.quote", 12);
+    topics.insert("md.XNAS.AAPL.trade", 13);
+    matched.clear();
+    topics.matchPattern("md.XNAS.*.quote", matched);
+    ASSERT_TRUE((matched == std::vector<uint32_t>{ 10, 11 }), "'*' should select one level of concrete topics");
+    matched.clear();
+    topics.matchPattern("#.quote", matched);
+    ASSERT_TRUE((matched == std::vector<uint32_t>{ 10, 11, 12 }), "'#' should select any depth");
+    ASSERT_TRUE(topic::isPattern("md.*") && !topic::isPattern("md.a*b"), "Only whole wildcard levels form a pattern");
+}
+
+// 测试通配订阅覆盖已有与之后登记的主题，首次按名称发布的主题也能送达
+TEST(TestWildcardSubscriptions) {
+    EventManager manager;
+    PluginId plugin = manager.resolvePlugin("QuotePlugin");
+    EventId before = manager.resolveEvent("md.XNAS.AAPL.quote");
+    std::vector<std::string> received;
+    SubscriptionToken exchange = manager.registerEvent(plugin, manager.resolveEvent("md.XNAS.*.quote"),
+        [&](const EventPayload& payload) { received.push_back("xnas:" + payload.toString()); });
+    SubscriptionToken all = manager.registerEvent(plugin, manager.resolveEvent("md.#"),
+        [&](const EventPayload& payload) { received.push_back("all:" + payload.toString()); });
+    ASSERT_TRUE(exchange && all, "Pattern subscriptions should return valid tokens");
+    ASSERT_EQ(manager.subscriptionCount(plugin), static_cast<size_t>(2), "Each pattern counts as one subscription");
+
+    manager.triggerEvent(before, "1");
+    manager.triggerEvent("md.XNAS.MSFT.quote", "2");
+    manager.triggerEvent("md.XNYS.IBM.quote", "3");
+    manager.triggerEvent("ref.XNAS.AAPL", "4");
+    ASSERT_TRUE((received == std::vector<std::string>{ "xnas:1", "all:1", "xnas:2", "all:2", "all:3" }),
+        "Patterns should match existing and first-seen topics");
+    ASSERT_TRUE(manager.findEvent("md.XNYS.IBM.quote").valid(), "A first-seen topic should be registered once");
+    ASSERT_TRUE(!manager.findEvent("ref.XNAS.AAPL").valid(), "A topic that matches no pattern should not be registered");
+    ASSERT_TRUE(!manager.findTopic("ref.XNAS.MSFT").valid() && !manager.findEvent("ref.XNAS.MSFT").valid(),
+        "Looking up a topic that matches no pattern should not register it");
+    ASSERT_TRUE(manager.findTopic("md.XNAS.TSLA.quote").valid(), "Looking up a matching topic should register it");
+
+    received.clear();
+    ASSERT_TRUE(manager.unsubscribe(exchange), "A pattern subscription should unsubscribe by token");
+    manager.triggerEvent("md.XNAS.MSFT.quote", "5");
+    ASSERT_TRUE((received == std::vector<std::string>{ "all:5" }), "Only the remaining pattern should match");
+
+    received.clear();
+    manager.unregisterPluginCallbacks(plugin);
+    manager.triggerEvent("md.XNAS.MSFT.quote", "6");
+    manager.triggerEvent("md.XNAS.GOOG.quote", "7");
+    ASSERT_TRUE(received.empty(), "Unregistering the plugin should remove every materialized copy");
+    ASSERT_TRUE(!manager.findEvent("md.XNAS.GOOG.quote").valid(), "Without patterns unknown topics stay unregistered");
+    ASSERT_EQ(manager.subscriptionCount(plugin), static_cast<size_t>(0), "No subscriptions should remain");
+}
+
+// 测试优先级类别：同一事件的订阅者按类别从高到低执行、同类别内按注册顺序，
+// 批量订阅者与通配订阅同样参与排序；截止时间按插件计数
+TEST(TestPriorityClassesAndDeadlines) {
+    EventManager manager;
+    PluginId logging = manager.resolvePlugin("LoggingPlugin");
+    PluginId risk = manager.resolvePlugin("RiskPlugin");
+    EventId orders = manager.resolveEvent("orders.new");
+    ASSERT_TRUE(manager.eventPriority(orders) == PriorityClass::Normal, "Events without subscribers should use the normal class");
+
+    std::vector<std::string> order;
+    SubscriptionQos bestEffort{ PriorityClass::BestEffort, std::chrono::microseconds(1) };
+    manager.registerEvent(logging, orders, [&](const EventPayload&) {
+        order.push_back("log");
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }, bestEffort);
+    manager.registerEvent(logging, orders, [&](const EventPayload&) { order.push_back("normal"); });
+    SubscriptionToken riskToken = manager.registerEvent(risk, orders, [&](const EventPayload&) {
+        order.push_back("risk");
+    }, SubscriptionQos{ PriorityClass::Critical, std::chrono::seconds(10) });
+    manager.registerBatchEvent(risk, orders, [&](const EventBatchView& batch) {
+        order.push_back("batch" + std::to_string(batch.size()));
+    }, SubscriptionQos{ PriorityClass::High });
+    manager.registerEvent(risk, manager.resolveEvent("orders.*"), [&](const EventPayload&) {
+        order.push_back("pattern");
+    }, SubscriptionQos{ PriorityClass::Critical });
+    ASSERT_TRUE(manager.eventPriority(orders) == PriorityClass::Critical, "The event should take its highest subscriber class");
+
+    manager.triggerEvent(orders, EventPayload{});
+    std::vector<std::string> expected = { "risk", "pattern", "batch1", "normal", "log" };
+    ASSERT_TRUE(order == expected, "Higher classes should run first, registration order within a class");
+
+    // 批量触发：每个类别内先逐条调用，再整段调用批量订阅者
+    order.clear();
+    BatchEvent batch[2] = { { orders, EventPayload{} }, { orders, EventPayload{} } };
+    manager.triggerEvents(batch, 2);
+    expected = { "risk", "pattern", "risk", "pattern", "batch2", "normal", "normal", "log", "log" };
+    ASSERT_TRUE(order == expected, "Batches should be delivered class by class");
+
+    DeadlineStats riskDeadlines = manager.deadlineStats(risk);
+    DeadlineStats logDeadlines = manager.deadlineStats(logging);
+    ASSERT_EQ(riskDeadlines.checked, static_cast<uint64_t>(3), "Every run of a deadline subscription should be checked");
+    ASSERT_EQ(riskDeadlines.missed, static_cast<uint64_t>(0), "The critical path should meet its deadline");
+    ASSERT_EQ(logDeadlines.missed, static_cast<uint64_t>(3), "A slow best-effort consumer should miss its deadline");
+    ASSERT_TRUE(logDeadlines.worstOverrunUs >= 1000, "The worst overrun should be reported");
+
+    // 注销后调度属性随订阅一起移除
+    ASSERT_TRUE(manager.unsubscribe(riskToken), "The critical subscription should unsubscribe");
+    order.clear();
+    manager.triggerEvent(orders, EventPayload{});
+    expected = { "pattern", "batch1", "normal", "log" };
+    ASSERT_TRUE(order == expected, "Remaining subscribers should keep their order");
+    ASSERT_EQ(manager.deadlineStats(risk).checked, static_cast<uint64_t>(3), "A removed subscription should no longer be checked");
+}
+
+// 测试未匹配主题的缓存：重复发布不登记该主题，新增匹配的通配订阅后缓存失效，下一次发布即可送达
+TEST(TestUnmatchedTopicCacheInvalidatedByNewPattern) {
+    EventManager manager;
+    PluginId plugin = manager.resolvePlugin("QuotePlugin");
+    std::vector<std::string> received;
+    manager.registerEvent(plugin, manager.resolveEvent("md.#"),
+        [&](const EventPayload& payload) { received.push_back("md:" + payload.toString()); });
+
+    for (int i = 0; i < 3; ++i) {
+        manager.triggerEvent("ref.XNAS.AAPL", "miss");
+        ASSERT_TRUE(!manager.findTopic("ref.XNAS.AAPL").valid(), "An unmatched topic should stay unregistered");
+    }
+    ASSERT_TRUE(!manager.findEvent("ref.XNAS.AAPL").valid(), "Repeated misses should not register the topic");
+
+    manager.registerEvent(plugin, manager.resolveEvent("ref.*.AAPL"),
+        [&](const EventPayload& payload) { received.push_back("ref:" + payload.toString()); });
+    manager.triggerEvent("ref.XNAS.AAPL", "hit");
+    ASSERT_TRUE((received == std::vector<std::string>{ "ref:hit" }), "A new pattern should reach a previously unmatched topic");
+    ASSERT_TRUE(manager.findEvent("ref.XNAS.AAPL").valid(), "The newly matched topic should be registered");
+}
+
+// 测试线程退出后交还的统计分片由之后的线程继续累计，计数不丢失
+TEST(TestStatsKeepCountsOfExitedThreads) {
+    EventManager manager;
+    PluginId pluginId = manager.resolvePlugin("StatsPlugin");
+    EventId eventId = manager.resolveEvent("OnThreadStats");
+    manager.registerEvent(pluginId, eventId, [](const EventPayload&) {});
+    for (int t = 0; t < 16; ++t) {
+        std::thread([&] { manager.triggerEvent(eventId, "data"); }).join();
+    }
+
+    StatsSnapshot snapshot = manager.statsSnapshot();
+#if MOTS_ENABLE_STATS
+    ASSERT_EQ(snapshot.events.size(), static_cast<size_t>(1), "Only triggered events should be reported");
+    ASSERT_EQ(snapshot.events[0].triggers, static_cast<uint64_t>(16), "Triggers from exited threads should be kept");
+#else
+    ASSERT_TRUE(!snapshot.enabled, "Statistics should be compiled out");
+#endif
+}
@@ -0,0 +1,114 @@
+// tests/IsolatedPluginTests.cpp
+#include "../include/Test.h"
+#include "../include/PluginManager.h"
+#include "../include/PluginPath.h"
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <signal.h>
+
+namespace {
+
+// 隔离插件的投递是异步的，等待条件成立或超时
+template <typename Predicate>
+bool waitFor(Predicate predicate, std::chrono::milliseconds timeout = std::chrono::milliseconds(5000)) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+// 测试子进程中的插件经宿主订阅与发布，强制结束子进程后自动重启并恢复订阅
+TEST(TestIsolatedPluginRoundTripAndRestart) {
+    PluginManager manager;
+    ASSERT_TRUE(manager.loadPlugin(pluginPath("SamplePlugin")), "SamplePlugin should load in-process");
+    IsolationOptions options;
+    options.restartDelay = std::chrono::milliseconds(10);
+    ASSERT_TRUE(manager.loadIsolatedPlugin(pluginPath("AnotherPlugin"), options), "AnotherPlugin should load isolated");
+    ASSERT_TRUE(manager.isPluginActive("AnotherPlugin"), "The isolated plugin should be registered under its own name");
+    ASSERT_EQ(manager.getSubscriptionCount("AnotherPlugin"), static_cast<size_t>(1), "The child's subscription should be forwarded");
+
+    std::mutex mutex;
+    std::vector<std::string> pongs;
+    std::vector<TimerEvent> typedPongs;
+    manager.registerPluginEvent("SamplePlugin", "AnotherPlugin.Pong", [&](const EventPayload& payload) {
+        std::lock_guard<std::mutex> lock(mutex);
+        pongs.emplace_back(payload.bytes());
+        if (const TimerEvent* event = payload.as<TimerEvent>()) {
+            typedPongs.push_back(*event);
+        }
+    });
+    auto pongCount = [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return pongs.size();
+    };
+    EventId pingId = manager.resolvePluginEvent("AnotherPlugin.Ping");
+    manager.triggerPluginEvent(pingId, std::string("hello"));
+    ASSERT_TRUE(waitFor([&] { return pongCount() == 1; }), "The child should answer on the shared bus");
+    ASSERT_EQ(pongs[0], std::string("hello"), "String payloads should cross unchanged");
+    int value = 7;
+    manager.triggerPluginEvent(pingId, EventPayload::view(value));
+    ASSERT_TRUE(waitFor([&] { return pongCount() == 2; }), "Typed payloads should cross as bytes");
+    ASSERT_EQ(pongs[1].size(), sizeof(int), "The object representation should be preserved");
+    // 两侧都绑定的结构体往返后仍是同一类型
+    TimerEvent event{ TimerId{ 42 }, 3, 1000, 2000 };
+    manager.triggerPluginEvent(pingId, EventPayload::view(event));
+    ASSERT_TRUE(waitFor([&] { return pongCount() == 3; }), "Struct payloads should cross to the child and back");
+    ASSERT_EQ(typedPongs.size(), static_cast<size_t>(1), "A bound struct should be rebuilt as a typed view on both sides");
+    ASSERT_EQ(typedPongs[0].timer.value, static_cast<uint64_t>(42), "The struct fields should be preserved");
+    ASSERT_EQ(typedPongs[0].fireCount, static_cast<uint64_t>(3), "The struct fields should be preserved");
+    ASSERT_EQ(typedPongs[0].firedNs, static_cast<int64_t>(2000), "The struct fields should be preserved");
+    // 不可按字节复制的对象不能送入子进程
+    manager.triggerPluginEvent(pingId, EventPayload::make<std::vector<int>>(3, 7));
+    ASSERT_TRUE(waitFor([&] { return manager.getIsolationStats("AnotherPlugin").rejected == 1; }),
+        "A non-copyable payload should be rejected, not sent empty");
+
+    IsolationStats before = manager.getIsolationStats("AnotherPlugin");
+    ASSERT_TRUE(before.running && before.pid > 0, "The child process should be running");
+    ASSERT_EQ(before.sent, static_cast<uint64_t>(3), "Every copyable event should be delivered to the child");
+    ASSERT_EQ(before.received, static_cast<uint64_t>(3), "Every answer should be received from the child");
+
+    kill(before.pid, SIGKILL);
+    ASSERT_TRUE(waitFor([&] {
+        IsolationStats stats = manager.getIsolationStats("AnotherPlugin");
+        return stats.restarts == 1 && stats.running && stats.pid != before.pid &&
+            manager.getSubscriptionCount("AnotherPlugin") == 1;
+    }), "A crashed child should be restarted with its subscriptions");
+    manager.triggerPluginEvent(pingId, std::string("again"));
+    ASSERT_TRUE(waitFor([&] { return pongCount() == 4; }), "The restarted child should answer");
+    ASSERT_EQ(pongs[3], std::string("again"), "The restarted child should receive new events");
+    manager.triggerPluginEvent(pingId, EventPayload::view(event));
+    ASSERT_TRUE(waitFor([&] { return pongCount() == 5; }), "The restarted child should answer struct payloads");
+    ASSERT_EQ(typedPongs.size(), static_cast<size_t>(2), "Type definitions should be resent to a restarted child");
+
+    pid_t pid = manager.getIsolationStats("AnotherPlugin").pid;
+    ASSERT_TRUE(!manager.reloadPlugin("AnotherPlugin", pluginPath("AnotherPlugin")), "Isolated plugins cannot be reloaded");
+    ASSERT_TRUE(manager.unloadPlugin("AnotherPlugin"), "The isolated plugin should unload");
+    ASSERT_TRUE(kill(pid, 0) != 0, "Unloading should stop the child process");
+    manager.triggerPluginEvent(pingId, std::string("gone"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(pongCount(), static_cast<size_t>(5), "An unloaded plugin should no longer answer");
+}
+
+// 测试依赖未加载时拒绝启动，且不留下登记与子进程
+TEST(TestIsolatedPluginRejectsMissingDependency) {
+    PluginManager manager;
+    ASSERT_TRUE(!manager.loadIsolatedPlugin(pluginPath("DependentPlugin")), "A missing dependency should fail the load");
+    ASSERT_TRUE(!manager.isPluginActive("DependentPlugin"), "A rejected plugin should not be registered");
+    ASSERT_TRUE(!manager.loadIsolatedPlugin(pluginPath("NoSuchPlugin")), "A missing library should fail the load");
+    ASSERT_TRUE(manager.loadPlugin(pluginPath("SamplePlugin")), "SamplePlugin should load in-process");
+    ASSERT_TRUE(manager.loadIsolatedPlugin(pluginPath("DependentPlugin")), "The load should succeed once the dependency exists");
+    ASSERT_TRUE(!manager.unloadPlugin("SamplePlugin"), "An isolated dependent should keep its dependency loaded");
+    manager.unloadAll();
+}
+
+#endif
@@ -0,0 +1,136 @@
+// tests/LoggerTests.cpp
+#include "../include/Test.h"
+#include "../include/Logger.h"
+#include "../include/Event.h"
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+size_t countOccurrences(const std::string& text, const std::string& needle) {
+    size_t count = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + needle.size())) {
+        ++count;
+    }
+    return count;
+}
+
+} // namespace
+
+// 测试日志经通道异步输出，低于通道级别的消息被过滤
+TEST(TestLoggerWritesThroughChannel) {
+    std::ostringstream out;
+    Logger logger(out);
+    LogChannel& channel = logger.channel("Strategy");
+    ASSERT_TRUE(&channel == &logger.channel("Strategy"), "Channel lookup should return the same channel");
+
+    channel.logf(LogLevel::Info, "quote %d", 42);
+    channel.logf(LogLevel::Debug, "hidden");
+    logger.setLevel("Strategy", LogLevel::Debug);
+    channel.log(LogLevel::Debug, "visible");
+    logger.flush();
+
+    std::string text = out.str();
+    ASSERT_TRUE(text.find("INFO [Strategy] quote 42\n") != std::string::npos, "Info message should be written");
+    ASSERT_TRUE(text.find("hidden") == std::string::npos, "Messages below the channel level should be filtered");
+    ASSERT_TRUE(text.find("DEBUG [Strategy] visible\n") != std::string::npos, "Lowering the level should enable debug");
+}
+
+// 测试速率限制按通道生效，被限制的条数在下一次放行时补报
+TEST(TestLoggerRateLimitsPerChannel) {
+    std::ostringstream out;
+    Logger::Options options;
+    options.defaultRatePerSecond = 1;
+    options.defaultBurst = 3;
+    Logger logger(out, options);
+    LogChannel& noisy = logger.channel("Noisy");
+    LogChannel& quiet = logger.channel("Quiet");
+
+    for (int i = 0; i < 50; ++i) {
+        noisy.logf(LogLevel::Error, "tick failed %d", i);
+    }
+    quiet.logf(LogLevel::Error, "single failure");
+    logger.flush();
+
+    std::string text = out.str();
+    ASSERT_EQ(countOccurrences(text, "[Noisy] tick failed"), static_cast<size_t>(3), "Only the burst should pass the limit");
+    ASSERT_EQ(noisy.suppressed(), static_cast<uint64_t>(47), "Suppressed messages should be counted");
+    ASSERT_TRUE(text.find("[Quiet] single failure") != std::string::npos, "Other channels should not be limited");
+
+    noisy.setRateLimit(0, 0);
+    noisy.logf(LogLevel::Error, "after limit");
+    logger.flush();
+    text = out.str();
+    ASSERT_TRUE(text.find("[Noisy] 47 messages suppressed by rate limit") != std::string::npos,
+        "The next admitted message should report the suppressed count");
+}
+
+// 测试多个线程并发写入时不丢失、不交错
+TEST(TestLoggerConcurrentProducers) {
+    std::ostringstream out;
+    Logger::Options options;
+    options.defaultRatePerSecond = 0;
+    Logger logger(out, options);
+    LogChannel& channel = logger.channel("Workers");
+
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 200;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                channel.logf(LogLevel::Info, "thread %d message %d", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    logger.flush();
+
+    ASSERT_EQ(countOccurrences(out.str(), "[Workers] thread "), static_cast<size_t>(kThreads * kPerThread),
+        "Every message should be written exactly once");
+    ASSERT_EQ(logger.dropped(), static_cast<uint64_t>(0), "No message should be dropped below buffer capacity");
+}
+
+// 测试回调异常写入所属插件的日志通道
+TEST(TestCallbackExceptionLoggedToPluginChannel) {
+    std::ostringstream out;
+    Logger logger(out);
+    EventManager manager(logger);
+    manager.registerEvent("ThrowingPlugin", "OnTick", [](const EventPayload&) -> void {
+        throw std::runtime_error("boom");
+    });
+    manager.triggerEvent("OnTick", "data");
+    logger.flush();
+
+    ASSERT_TRUE(out.str().find("ERROR [ThrowingPlugin] Exception in event callback: boom") != std::string::npos,
+        "Callback exceptions should be logged on the plugin's channel");
+}
+
+// 测试线程退出后其缓冲区排空再释放：消息与丢弃计数都不丢失
+TEST(TestLoggerReleasesBuffersOfExitedThreads) {
+    std::ostringstream out;
+    Logger::Options options;
+    options.recordsPerThread = 4;
+    options.defaultRatePerSecond = 0;
+    Logger logger(out, options);
+    LogChannel& channel = logger.channel("ShortLived");
+
+    constexpr int kThreads = 16;
+    for (int t = 0; t < kThreads; ++t) {
+        std::thread([&, t] {
+            for (int i = 0; i < 6; ++i) {
+                channel.logf(LogLevel::Info, "thread %d message %d", t, i);
+            }
+        }).join();
+    }
+    logger.flush();
+
+    // 缓冲区满时丢弃：每条消息要么写出、要么计入丢弃数
+    size_t written = countOccurrences(out.str(), "[ShortLived] thread ");
+    ASSERT_TRUE(written >= static_cast<size_t>(kThreads * 4), "Messages of exited threads should be written before release");
+    ASSERT_EQ(written + logger.dropped(), static_cast<uint64_t>(kThreads * 6), "Drops of released buffers should still be counted");
+    ASSERT_EQ(logger.bufferCount(), static_cast<size_t>(0), "Buffers of exited threads should be released once drained");
+}
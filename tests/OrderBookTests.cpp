@@ -0,0 +1,333 @@
+// tests/OrderBookTests.cpp
+#include "../include/Test.h"
+#include "../include/OrderBook.h"
+#include "../include/PluginManager.h"
+#include "../include/PluginPath.h"
+#include <filesystem>
+#include <list>
+#include <map>
+#include <unordered_map>
+
+namespace {
+
+// 参考模型：每侧为 价格 -> 按时间排列的 (订单号, 数量)
+struct ReferenceBook {
+    struct Order {
+        uint64_t orderId;
+        uint64_t quantity;
+    };
+    std::map<int64_t, std::list<Order>> sides[2];
+    struct Location {
+        Side side;
+        int64_t price;
+    };
+    std::unordered_map<uint64_t, Location> index;
+
+    std::list<Order>::iterator find(uint64_t orderId) {
+        const Location& location = index.at(orderId);
+        std::list<Order>& queue = sides[static_cast<int>(location.side)][location.price];
+        for (auto it = queue.begin();; ++it) {
+            if (it->orderId == orderId) {
+                return it;
+            }
+        }
+    }
+
+    void erase(uint64_t orderId) {
+        const Location location = index.at(orderId);
+        auto& side = sides[static_cast<int>(location.side)];
+        side[location.price].erase(find(orderId));
+        if (side[location.price].empty()) {
+            side.erase(location.price);
+        }
+        index.erase(orderId);
+    }
+
+    void add(uint64_t orderId, Side side, int64_t price, uint64_t quantity) {
+        sides[static_cast<int>(side)][price].push_back(Order{ orderId, quantity });
+        index[orderId] = Location{ side, price };
+    }
+
+    void levels(Side side, std::vector<BookLevel>& out) const {
+        out.clear();
+        const auto& levels = sides[static_cast<int>(side)];
+        auto emit = [&](const std::pair<const int64_t, std::list<Order>>& level) {
+            uint64_t quantity = 0;
+            for (const Order& order : level.second) {
+                quantity += order.quantity;
+            }
+            out.push_back(BookLevel{ level.first, quantity, static_cast<uint32_t>(level.second.size()) });
+        };
+        if (side == Side::Buy) {
+            for (auto it = levels.rbegin(); it != levels.rend(); ++it) {
+                emit(*it);
+            }
+        }
+        else {
+            for (const auto& level : levels) {
+                emit(level);
+            }
+        }
+    }
+};
+
+bool sameLevels(const std::vector<BookLevel>& a, const std::vector<BookLevel>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].price != b[i].price || a[i].quantity != b[i].quantity || a[i].orders != b[i].orders) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// 测试价格、时间优先与改单规则：只减量保持队列位置，改价或增量排到队尾
+TEST(TestOrderBookPriceTimePriority) {
+    OrderBookSet books;
+    ASSERT_TRUE(books.add(OrderAdd{ 1, 7, Side::Buy, 100, 10 }) != nullptr, "Add should succeed");
+    books.add(OrderAdd{ 2, 7, Side::Buy, 100, 20 });
+    books.add(OrderAdd{ 3, 7, Side::Buy, 99, 5 });
+    books.add(OrderAdd{ 4, 7, Side::Sell, 101, 7 });
+
+    TopOfBook top = books.book(7)->top();
+    ASSERT_TRUE(top.hasBid() && top.hasAsk(), "Both sides should be present");
+    ASSERT_EQ(top.bidPrice, int64_t(100), "Best bid price");
+    ASSERT_EQ(top.bidQuantity, uint64_t(30), "Best bid quantity");
+    ASSERT_EQ(top.bidOrders, 2u, "Orders at the best bid");
+    ASSERT_EQ(top.askPrice, int64_t(101), "Best ask price");
+    ASSERT_EQ(top.sequence, uint64_t(4), "Each update should bump the sequence");
+
+    std::vector<BookOrder> orders;
+    books.modify(OrderModify{ 1, 100, 4 });
+    books.book(7)->orders(Side::Buy, 1, orders);
+    ASSERT_TRUE(orders.size() == 2 && orders[0].orderId == 1 && orders[0].quantity == 4, "A size decrease should keep priority");
+
+    books.modify(OrderModify{ 1, 100, 8 });
+    books.book(7)->orders(Side::Buy, 1, orders);
+    ASSERT_TRUE(orders.size() == 2 && orders[0].orderId == 2 && orders[1].orderId == 1, "A size increase should lose priority");
+
+    books.modify(OrderModify{ 2, 98, 20 });
+    std::vector<BookLevel> levels;
+    books.book(7)->depth(Side::Buy, 10, levels);
+    ASSERT_EQ(levels.size(), size_t(3), "A price change should move the order to its new level");
+    ASSERT_TRUE(levels[0].price == 100 && levels[1].price == 99 && levels[2].price == 98, "Bids should be ordered best first");
+
+    books.cancel(OrderCancel{ 1, 3 });
+    ASSERT_EQ(books.findOrder(1)->quantity, uint64_t(5), "A partial cancel should reduce the order");
+    books.cancel(OrderCancel{ 1, 0 });
+    ASSERT_TRUE(books.findOrder(1) == nullptr, "A full cancel should remove the order");
+    ASSERT_EQ(books.book(7)->top().bidPrice, int64_t(99), "The next level should become the best bid");
+    books.modify(OrderModify{ 4, 101, 0 });
+    ASSERT_TRUE(!books.book(7)->top().hasAsk(), "A modify to zero should cancel");
+
+    ASSERT_TRUE(books.add(OrderAdd{ 3, 7, Side::Sell, 105, 1 }) == nullptr, "A duplicate order ID should be rejected");
+    ASSERT_TRUE(books.cancel(OrderCancel{ 42, 0 }) == nullptr, "An unknown order ID should be rejected");
+    ASSERT_TRUE(books.add(OrderAdd{ 50, 7, Side::Buy, 100, 0 }) == nullptr, "A zero quantity should be rejected");
+    ASSERT_TRUE(books.add(OrderAdd{ 51, OrderBookSet::kMaxInstruments, Side::Buy, 100, 1 }) == nullptr, "An out-of-range instrument should be rejected");
+    ASSERT_TRUE(books.add(OrderAdd{ 52, 7, Side::Buy, 99 + int64_t(PriceLadder::kMaxLevels), 1 }) == nullptr,
+        "A price too far from the live levels should be rejected");
+    OrderBookStats stats = books.stats();
+    ASSERT_EQ(stats.rejected, uint64_t(5), "Rejected updates should be counted");
+    ASSERT_EQ(stats.orders, size_t(2), "Live orders");
+    ASSERT_EQ(books.book(7)->orderCount(), size_t(2), "Live orders in the book");
+}
+
+// 测试改价：同侧唯一的委托可改到远处的价格；放不下的改价被拒绝且委托保持原有的队列位置；
+// 超出价格范围的委托在任何运算之前被拒绝
+TEST(TestOrderBookModifyRepricesAndRollsBack) {
+    OrderBookSet books;
+    books.add(OrderAdd{ 1, 3, Side::Sell, 1000, 10 });
+    int64_t far = 1000 + 4 * int64_t(PriceLadder::kMaxLevels);
+    ASSERT_TRUE(books.modify(OrderModify{ 1, far, 10 }) != nullptr, "The only order on a side should re-price anywhere");
+    ASSERT_EQ(books.book(3)->top().askPrice, far, "The re-priced order should be the best ask");
+
+    books.add(OrderAdd{ 2, 3, Side::Sell, far, 20 });
+    books.add(OrderAdd{ 3, 3, Side::Sell, far, 30 });
+    books.add(OrderAdd{ 4, 3, Side::Sell, far + 1, 5 });
+    ASSERT_TRUE(books.modify(OrderModify{ 2, 1000, 20 }) == nullptr, "A re-price too far from the other orders should be rejected");
+    std::vector<BookOrder> orders;
+    books.book(3)->orders(Side::Sell, 2, orders);
+    ASSERT_TRUE(orders.size() == 4 && orders[0].orderId == 1 && orders[1].orderId == 2 && orders[2].orderId == 3 &&
+        orders[3].orderId == 4, "A rejected re-price should keep the order's queue position");
+    TopOfBook top = books.book(3)->top();
+    ASSERT_TRUE(top.askPrice == far && top.askQuantity == 60 && top.askOrders == 3, "A rejected re-price should leave the level unchanged");
+    ASSERT_EQ(books.findOrder(2)->price, far, "A rejected re-price should keep the old price");
+
+    ASSERT_TRUE(books.add(OrderAdd{ 5, 4, Side::Buy, INT64_MAX, 1 }) == nullptr, "A price beyond the tick range should be rejected");
+    ASSERT_TRUE(books.add(OrderAdd{ 6, 4, Side::Sell, INT64_MIN, 1 }) == nullptr, "A price beyond the tick range should be rejected");
+    books.add(OrderAdd{ 7, 4, Side::Buy, -PriceLadder::kMaxPrice, 1 });
+    ASSERT_TRUE(books.modify(OrderModify{ 7, INT64_MAX, 1 }) == nullptr, "A re-price beyond the tick range should be rejected");
+    ASSERT_EQ(books.book(4)->top().bidPrice, -PriceLadder::kMaxPrice, "Prices at the edge of the range should be accepted");
+    ASSERT_EQ(books.stats().rejected, uint64_t(4), "Rejected updates should be counted");
+    ASSERT_EQ(books.stats().orders, size_t(5), "Live orders");
+}
+
+// 随机行情与参考模型逐步比对 L2；价格随机游走并偶有远价，覆盖价位数组的扩展与重新定位
+TEST(TestOrderBookMatchesReferenceModel) {
+    OrderBookSet books;
+    ReferenceBook reference[3];
+    std::vector<uint64_t> live;
+    uint64_t state = 12345;
+    auto next = [&state] {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return state >> 33;
+    };
+    int64_t mid = 10000;
+    uint64_t nextId = 1;
+    std::vector<BookLevel> actual;
+    std::vector<BookLevel> expected;
+    bool consistent = true;
+    for (int step = 0; step < 20000 && consistent; ++step) {
+        mid += static_cast<int64_t>(next() % 5) - 2;
+        uint64_t action = next() % 10;
+        if (action < 5 || live.empty()) {
+            uint32_t instrument = static_cast<uint32_t>(next() % 3);
+            Side side = next() % 2 ? Side::Buy : Side::Sell;
+            int64_t offset = static_cast<int64_t>(next() % 20);
+            if (next() % 500 == 0) {
+                offset += 5000;  // 远价，迫使价位数组扩展
+            }
+            int64_t price = side == Side::Buy ? mid - offset : mid + offset;
+            uint64_t quantity = 1 + next() % 100;
+            books.add(OrderAdd{ nextId, instrument, side, price, quantity });
+            reference[instrument].add(nextId, side, price, quantity);
+            live.push_back(nextId++);
+        }
+        else {
+            size_t slot = static_cast<size_t>(next() % live.size());
+            uint64_t orderId = live[slot];
+            const OrderNode* node = books.findOrder(orderId);
+            ReferenceBook& model = reference[node->instrument];
+            Side side = node->side;
+            if (action < 8) {
+                uint64_t quantity = next() % 4 == 0 ? 0 : 1 + next() % 30;
+                books.cancel(OrderCancel{ orderId, quantity });
+                auto order = model.find(orderId);
+                if (quantity == 0 || quantity >= order->quantity) {
+                    model.erase(orderId);
+                    live[slot] = live.back();
+                    live.pop_back();
+                }
+                else {
+                    order->quantity -= quantity;
+                }
+            }
+            else {
+                const int64_t previous = node->price;
+                int64_t price = previous;
+                if (next() % 2) {
+                    price += static_cast<int64_t>(next() % 7) - 3;
+                }
+                uint64_t quantity = 1 + next() % 100;
+                uint64_t remaining = model.find(orderId)->quantity;
+                books.modify(OrderModify{ orderId, price, quantity });
+                if (price == previous && quantity <= remaining) {
+                    model.find(orderId)->quantity = quantity;
+                }
+                else {
+                    model.erase(orderId);
+                    model.add(orderId, side, price, quantity);
+                }
+            }
+        }
+        for (uint32_t instrument = 0; instrument < 3 && consistent; ++instrument) {
+            const OrderBook* book = books.book(instrument);
+            for (Side side : { Side::Buy, Side::Sell }) {
+                if (book) {
+                    book->depth(side, PriceLadder::kMaxLevels, actual);
+                }
+                else {
+                    actual.clear();
+                }
+                reference[instrument].levels(side, expected);
+                consistent = consistent && sameLevels(actual, expected);
+            }
+        }
+    }
+    ASSERT_TRUE(consistent, "Depth should match the reference model after every update");
+    ASSERT_EQ(books.stats().orders, live.size(), "Live order count should match the reference model");
+    ASSERT_EQ(books.stats().rejected, uint64_t(0), "No generated update should be rejected");
+
+    // 全部撤单后节点回到池中，再次加入不再分配
+    for (uint64_t orderId : live) {
+        books.cancel(OrderCancel{ orderId, 0 });
+    }
+    size_t pooled = books.stats().pooledNodes;
+    for (uint64_t orderId = 1; orderId <= pooled; ++orderId) {
+        books.add(OrderAdd{ 1000000 + orderId, 0, Side::Sell, 50000, 1 });
+    }
+    ASSERT_EQ(books.stats().pooledNodes, pooled, "Cancelled nodes should be reused");
+    ASSERT_EQ(books.book(0)->top().askOrders, static_cast<uint32_t>(pooled), "An emptied side should recentre on the new price");
+    books.clear();
+    ASSERT_EQ(books.stats().orders, size_t(0), "Clear should remove all orders");
+    ASSERT_TRUE(!books.book(0)->top().hasAsk(), "Clear should empty the books");
+}
+
+// 测试插件经总线维护订单簿，只在一档变化时发布，批量中每个品种每段只发布一次；热重载保留订单簿
+TEST(TestOrderBookPluginPublishesTopOfBook) {
+    PluginManager manager;
+    ASSERT_TRUE(manager.loadPlugin(pluginPath("OrderBookPlugin")), "OrderBookPlugin should load successfully");
+
+    std::vector<TopOfBook> tops;
+    manager.subscribePluginEvent("OrderBookPlugin", kTopOfBookEvent, [&](const EventPayload& payload) {
+        if (const TopOfBook* top = payload.as<TopOfBook>()) {
+            tops.push_back(*top);
+        }
+    });
+    EventId addId = manager.resolvePluginEvent(kOrderAddEvent);
+    EventId modifyId = manager.resolvePluginEvent(kOrderModifyEvent);
+    EventId cancelId = manager.resolvePluginEvent(kOrderCancelEvent);
+
+    OrderAdd bid{ 1, 3, Side::Buy, 500, 10 };
+    manager.triggerPluginEvent(addId, EventPayload::view(bid));
+    ASSERT_EQ(tops.size(), size_t(1), "A new best bid should publish the top of book");
+    ASSERT_TRUE(tops[0].instrument == 3 && tops[0].bidPrice == 500 && !tops[0].hasAsk(), "The published top should describe the book");
+
+    OrderAdd behind{ 2, 3, Side::Buy, 499, 10 };
+    manager.triggerPluginEvent(addId, EventPayload::view(behind));
+    ASSERT_EQ(tops.size(), size_t(1), "An update behind the top should not publish");
+
+    OrderAdd batch[] = {
+        { 3, 3, Side::Sell, 502, 5 },
+        { 4, 3, Side::Sell, 501, 5 },
+        { 5, 3, Side::Sell, 501, 6 },
+        { 6, 4, Side::Buy, 10, 1 },
+    };
+    std::vector<BatchEvent> events;
+    for (const OrderAdd& order : batch) {
+        events.push_back(BatchEvent{ addId, EventPayload::view(order) });
+    }
+    manager.triggerPluginEvents(events);
+    ASSERT_EQ(tops.size(), size_t(3), "A batch should publish once per changed instrument");
+    ASSERT_TRUE(tops[1].instrument == 3 && tops[1].askPrice == 501 && tops[1].askQuantity == 11 && tops[1].askOrders == 2,
+        "The batch should publish the final top");
+    ASSERT_EQ(tops[2].instrument, 4u, "The other instrument should publish its own top");
+
+    OrderModify improve{ 2, 500, 10 };
+    manager.triggerPluginEvent(modifyId, EventPayload::view(improve));
+    ASSERT_TRUE(tops.size() == 4 && tops[3].bidQuantity == 20 && tops[3].bidOrders == 2, "Joining the best bid should publish");
+
+    int wrongType = 1;
+    manager.triggerPluginEvent(cancelId, EventPayload::view(wrongType));
+    ASSERT_EQ(tops.size(), size_t(4), "A payload of the wrong type should be ignored");
+
+    std::filesystem::path reloadPath = std::filesystem::temp_directory_path() / ("reload_" + pluginFileName("OrderBookPlugin"));
+    std::filesystem::copy_file(pluginPath("OrderBookPlugin"), reloadPath, std::filesystem::copy_options::overwrite_existing);
+    ASSERT_TRUE(manager.reloadPlugin("OrderBookPlugin", reloadPath.string()), "OrderBookPlugin should reload");
+    ASSERT_EQ(tops.size(), size_t(4), "Importing the state should not republish");
+
+    OrderCancel cancel{ 1, 0 };
+    manager.triggerPluginEvent(cancelId, EventPayload::view(cancel));
+    ASSERT_TRUE(tops.size() == 5 && tops[4].bidPrice == 500 && tops[4].bidQuantity == 10 && tops[4].bidOrders == 1,
+        "The reloaded book should keep its orders in time priority");
+    OrderCancel last{ 2, 0 };
+    manager.triggerPluginEvent(cancelId, EventPayload::view(last));
+    ASSERT_TRUE(tops.size() == 6 && !tops[5].hasBid() && tops[5].askPrice == 501, "Cancelling the last bid should publish an empty bid side");
+
+    ASSERT_TRUE(manager.unloadPlugin("OrderBookPlugin"), "OrderBookPlugin should unload");
+    std::filesystem::remove(reloadPath);
+}
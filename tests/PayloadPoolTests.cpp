@@ -0,0 +1,48 @@
+// tests/PayloadPoolTests.cpp
+#include "../include/Test.h"
+#include "../include/Event.h"
+#include "../include/PayloadPool.h"
+#include <thread>
+
+namespace {
+
+struct PoolQuote {
+    uint64_t instrument;
+    double bid;
+    double ask;
+};
+
+} // namespace
+
+// 测试保留的负载来自负载池：跨线程释放后归还原分片并被复用，超大负载直接从堆分配
+TEST(TestPayloadPoolRecyclesAcrossThreads) {
+    PoolQuote quote{ 7, 100.25, 100.26 };
+    EventPayload typed = EventPayload::view(quote).retain();
+    ASSERT_TRUE(typed.owning() && typed.as<PoolQuote>() != nullptr, "A retained view should own a typed copy");
+    ASSERT_TRUE(typed.as<PoolQuote>() != &quote && typed.as<PoolQuote>()->ask == 100.26, "The copy should be independent");
+    const void* first = typed.as<PoolQuote>();
+    typed = EventPayload();
+    EventPayload reused = EventPayload::view(quote).retain();
+    ASSERT_TRUE(reused.as<PoolQuote>() == first, "A released block should be reused by the same thread");
+
+    std::string text(200, 'x');
+    EventPayload copied = EventPayload::copyOf(text);
+    ASSERT_TRUE(copied.string() && *copied.string() == text, "copyOf should produce a string payload");
+    EventPayload shared = copied;
+    ASSERT_TRUE(shared.string() == copied.string(), "Copies should share the pooled block");
+
+    // 在另一线程上释放最后一个引用：经远程归还栈回到本线程的分片
+    PayloadPoolStats before = PayloadPool::stats();
+    std::thread([moved = std::move(reused), other = std::move(shared)]() mutable {
+        moved = EventPayload();
+        other = EventPayload();
+    }).join();
+    copied = EventPayload();
+    ASSERT_EQ(PayloadPool::stats().remoteFrees, before.remoteFrees + 1, "Only the last reference released on another thread should go back remotely");
+    ASSERT_EQ(PayloadPool::stats().shards, before.shards, "Releasing on a thread should not give it blocks of its own");
+
+    std::string large(PayloadPool::kMaxPooledBytes + 1, 'y');
+    EventPayload oversized = EventPayload::view(large.data(), typeid(EventPayload::Bytes), large.size()).retain();
+    ASSERT_EQ(oversized.bytes().size(), large.size(), "Oversized payloads should still be retained");
+    ASSERT_TRUE(PayloadPool::stats().oversized >= 1, "Oversized payloads should be counted");
+}
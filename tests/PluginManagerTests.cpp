@@ -1,19 +1,19 @@
 // tests/PluginManagerTests.cpp
 #include "../include/Test.h"
 #include "../include/PluginManager.h"
+#include "../include/PluginPath.h"
 #include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <thread>
 
 // 定义插件路径的辅助函数
 std::string getPluginPath() {
-    std::filesystem::path exePath = std::filesystem::current_path();
-#if defined(_WIN32)
-    return (exePath / "SamplePlugin.dll").string();
-#elif defined(__APPLE__)
-    return (exePath / "libSamplePlugin.dylib").string();
-#else
-    return (exePath / "libSamplePlugin.so").string();
-#endif
+    return pluginPath("SamplePlugin");
 }
 
 // 测试插件管理器是否能成功加载插件
@@ -215,3 +215,784 @@ TEST(TestEventCallbackExceptionHandling) {
     ASSERT_TRUE(exceptionCallbackTriggered, "Exception callback should be triggered");
 }
 
+
+TEST(TestPublishAsyncDeliversOnDispatcherThread) {
+    PluginManager manager;
+    bool loaded = manager.loadPlugin(getPluginPath());
+    ASSERT_TRUE(loaded, "Plugin should load successfully");
+
+    ASSERT_TRUE(!manager.publishAsync("OnAsyncEvent", "data"), "publishAsync should fail before the bus is started");
+    ASSERT_TRUE(manager.startAsyncDispatch(2, 1024), "Async dispatch should start");
+
+    std::atomic<int> delivered{ 0 };
+    std::atomic<bool> onOtherThread{ true };
+    std::thread::id publisherThread = std::this_thread::get_id();
+    manager.registerPluginEvent("SamplePlugin", "OnAsyncEvent", [&](const std::string& data) {
+        if (std::this_thread::get_id() == publisherThread || data != "async") {
+            onOtherThread = false;
+        }
+        ++delivered;
+    });
+
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(manager.publishAsync("OnAsyncEvent", std::string("async")), "publishAsync should enqueue");
+    }
+    manager.flushAsync();
+    ASSERT_EQ(delivered.load(), 100, "All async events should be delivered after flush");
+    ASSERT_TRUE(onOtherThread.load(), "Callbacks should run on dispatcher threads with the original payload");
+}
+
+TEST(TestUnloadDrainsAsyncQueue) {
+    PluginManager manager;
+    bool loaded = manager.loadPlugin(getPluginPath());
+    ASSERT_TRUE(loaded, "Plugin should load successfully");
+    ASSERT_TRUE(manager.startAsyncDispatch(1, 4096), "Async dispatch should start");
+
+    std::atomic<int> delivered{ 0 };
+    manager.registerPluginEvent("SamplePlugin", "OnDrainEvent", [&](const std::string&) {
+        ++delivered;
+    });
+    EventId drainId = manager.resolvePluginEvent("OnDrainEvent");
+    for (int i = 0; i < 1000; ++i) {
+        manager.publishAsync(drainId, EventPayload::copyOf("x"));
+    }
+    ASSERT_TRUE(manager.unloadPlugin("SamplePlugin"), "Plugin should unload successfully");
+    ASSERT_EQ(delivered.load(), 1000, "Events published before unload should be delivered before it returns");
+
+    manager.publishAsync(drainId, EventPayload::copyOf("x"));
+    manager.flushAsync();
+    ASSERT_EQ(delivered.load(), 1000, "No callbacks should run after unload");
+}
+
+// 测试停止异步分发时与之并发的发布：每个被接受的事件都在 stop 返回前送达
+TEST(TestStopAsyncDeliversAcceptedEvents) {
+    PluginManager manager;
+    ASSERT_TRUE(manager.loadPlugin(getPluginPath()), "Plugin should load successfully");
+    ASSERT_TRUE(manager.startAsyncDispatch(2, 1 << 16), "Async dispatch should start");
+
+    std::atomic<int> delivered{ 0 };
+    EventId stopId = manager.resolvePluginEvent("OnStopEvent");
+    manager.registerPluginEvent("SamplePlugin", stopId, [&](const EventPayload&) {
+        ++delivered;
+    });
+    std::atomic<int> accepted{ 0 };
+    std::atomic<bool> stopped{ false };
+    std::vector<std::thread> publishers;
+    for (int t = 0; t < 4; ++t) {
+        publishers.emplace_back([&] {
+            while (!stopped.load()) {
+                if (manager.publishAsync(stopId, EventPayload::copyOf("x"))) {
+                    ++accepted;
+                }
+            }
+        });
+    }
+    while (accepted.load() < 1000) {
+        std::this_thread::yield();
+    }
+    manager.stopAsyncDispatch();
+    int atStop = delivered.load();
+    stopped = true;
+    for (auto& publisher : publishers) {
+        publisher.join();
+    }
+    ASSERT_EQ(atStop, accepted.load(), "Every accepted event should be delivered before stop returns");
+}
+
+TEST(TestPartitionedDispatchKeepsPerKeyOrder) {
+    struct KeyedTick {
+        uint32_t key;
+        uint32_t sequence;
+    };
+
+    PluginManager manager;
+    bool loaded = manager.loadPlugin(getPluginPath());
+    ASSERT_TRUE(loaded, "Plugin should load successfully");
+    ASSERT_TRUE(manager.startAsyncDispatch(4, 256), "Async dispatch should start");
+
+    constexpr uint32_t kKeys = 16;
+    constexpr uint32_t kPerKey = 500;
+    std::vector<uint32_t> lastSequence(kKeys, 0);
+    std::atomic<uint32_t> outOfOrder{ 0 };
+    std::atomic<uint32_t> delivered{ 0 };
+    manager.registerPluginEvent("SamplePlugin", "OnKeyedTick", [&](const EventPayload& payload) {
+        const KeyedTick* tick = payload.as<KeyedTick>();
+        // 同一键只会在同一分片线程上执行，因此按键访问 lastSequence 无需加锁
+        if (tick->sequence != lastSequence[tick->key] + 1) {
+            ++outOfOrder;
+        }
+        lastSequence[tick->key] = tick->sequence;
+        ++delivered;
+    });
+    EventId tickId = manager.resolvePluginEvent("OnKeyedTick");
+
+    for (uint32_t sequence = 1; sequence <= kPerKey; ++sequence) {
+        for (uint32_t key = 0; key < kKeys; ++key) {
+            KeyedTick tick{ key, sequence };
+            std::string symbol = "SYM" + std::to_string(key);
+            manager.triggerPluginEvent(tickId, EventPayload::view(tick), symbol);
+        }
+    }
+    manager.flushAsync();
+
+    ASSERT_EQ(delivered.load(), kKeys * kPerKey, "Keyed events should not be dropped");
+    ASSERT_EQ(outOfOrder.load(), 0u, "Events for one key should arrive in publish order");
+
+    uint64_t dispatched = 0;
+    for (const auto& shard : manager.getShardStats()) {
+        dispatched += shard.dispatched;
+        ASSERT_TRUE(shard.maxDepth <= 256, "Depth should be bounded by the queue capacity");
+    }
+    ASSERT_EQ(dispatched, static_cast<uint64_t>(kKeys * kPerKey), "Shard stats should account for every event");
+}
+
+TEST(TestConflatingSubscriptionKeepsLatestPerKey) {
+    PluginManager manager;
+    bool loaded = manager.loadPlugin(getPluginPath());
+    ASSERT_TRUE(loaded, "Plugin should load successfully");
+    ASSERT_TRUE(manager.startAsyncDispatch(1, 1024), "Async dispatch should start");
+
+    // 第一个回调阻塞，使后续报价在邮箱中积压并被合并
+    std::mutex gate;
+    std::unique_lock<std::mutex> hold(gate);
+    std::atomic<int> delivered{ 0 };
+    std::vector<std::string> received;
+    SubscriptionOptions options;
+    options.policy = DeliveryPolicy::Conflate;
+    options.conflationKey = [](const EventPayload& payload) {
+        return static_cast<uint64_t>(payload.bytes().front());
+    };
+    bool registered = manager.registerPluginEvent("SamplePlugin", "OnQuote", [&](const EventPayload& payload) {
+        std::lock_guard<std::mutex> wait(gate);
+        received.push_back(payload.toString());
+        ++delivered;
+    }, options);
+    ASSERT_TRUE(registered, "Conflating subscription should register");
+
+    EventId quoteId = manager.resolvePluginEvent("OnQuote");
+    manager.triggerPluginEvent(quoteId, EventPayload::copyOf("A1"));
+    while (manager.getDeliveryStats("SamplePlugin").queued != 0) {
+        std::this_thread::yield();
+    }
+    for (int i = 2; i <= 5; ++i) {
+        manager.triggerPluginEvent(quoteId, EventPayload::copyOf("A" + std::to_string(i)));
+        manager.triggerPluginEvent(quoteId, EventPayload::copyOf("B" + std::to_string(i)));
+    }
+    hold.unlock();
+    while (delivered.load() < 3) {
+        std::this_thread::yield();
+    }
+
+    DeliveryStats stats = manager.getDeliveryStats("SamplePlugin");
+    ASSERT_EQ(received.size(), static_cast<size_t>(3), "Only the first quote and the latest per key should be delivered");
+    ASSERT_EQ(received[1], std::string("A5"), "Conflation should keep the latest quote for key A");
+    ASSERT_EQ(received[2], std::string("B5"), "Conflation should keep the latest quote for key B");
+    ASSERT_EQ(stats.conflated, static_cast<uint64_t>(6), "Replaced quotes should be counted as conflated");
+}
+
+TEST(TestDropNewestSubscriptionCountsDrops) {
+    PluginManager manager;
+    bool loaded = manager.loadPlugin(getPluginPath());
+    ASSERT_TRUE(loaded, "Plugin should load successfully");
+    ASSERT_TRUE(manager.startAsyncDispatch(1, 1024), "Async dispatch should start");
+
+    std::mutex gate;
+    std::unique_lock<std::mutex> hold(gate);
+    std::atomic<int> delivered{ 0 };
+    std::atomic<int> fastDelivered{ 0 };
+    SubscriptionOptions options;
+    options.policy = DeliveryPolicy::DropNewest;
+    options.capacity = 4;
+    manager.registerPluginEvent("SamplePlugin", "OnBurst", [&](const EventPayload&) {
+        std::lock_guard<std::mutex> wait(gate);
+        ++delivered;
+    }, options);
+    manager.registerPluginEvent("SamplePlugin", "OnBurst", [&](const std::string&) {
+        ++fastDelivered;
+    });
+
+    for (int i = 0; i < 20; ++i) {
+        manager.triggerPluginEvent("OnBurst", "tick");
+    }
+    ASSERT_EQ(fastDelivered.load(), 20, "A slow subscriber should not hold back a direct subscriber");
+    hold.unlock();
+    manager.flushAsync();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    DeliveryStats stats = manager.getDeliveryStats("SamplePlugin");
+    while (stats.delivered + stats.dropped < 20 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+        stats = manager.getDeliveryStats("SamplePlugin");
+    }
+    ASSERT_EQ(stats.delivered + stats.dropped, static_cast<uint64_t>(20), "Every event should be delivered or counted as dropped");
+    ASSERT_TRUE(stats.dropped > 0, "Events beyond the capacity should be dropped");
+    ASSERT_TRUE(manager.unloadPlugin("SamplePlugin"), "Plugin should unload successfully");
+}
+
+// 测试订阅凭据可单独注销带策略的订阅，且卸载后可按同一路径重新加载
+TEST(TestSubscriptionTokenUnsubscribe) {
+    PluginManager manager;
+    bool loaded = manager.loadPlugin(getPluginPath());
+    ASSERT_TRUE(loaded, "Plugin should load successfully");
+
+    int directCount = 0;
+    int mailboxCount = 0;
+    SubscriptionOptions options;
+    options.policy = DeliveryPolicy::DropNewest;
+    SubscriptionToken direct = manager.subscribePluginEvent("SamplePlugin", "OnTokenEvent", [&](const EventPayload&) { ++directCount; });
+    SubscriptionToken queued = manager.subscribePluginEvent("SamplePlugin", "OnTokenEvent", [&](const EventPayload&) { ++mailboxCount; }, options);
+    ASSERT_TRUE(direct.valid() && queued.valid(), "Subscriptions should return valid tokens");
+    ASSERT_TRUE(!manager.subscribePluginEvent("MissingPlugin", "OnTokenEvent", [](const EventPayload&) {}).valid(), "Unknown plugin should yield an invalid token");
+
+    size_t before = manager.getSubscriptionCount("SamplePlugin");
+    ASSERT_TRUE(manager.unsubscribePluginEvent(queued), "Token should unsubscribe the mailbox subscription");
+    ASSERT_EQ(manager.getSubscriptionCount("SamplePlugin"), before - 1, "Only the unsubscribed callback should be removed");
+    manager.triggerPluginEvent("OnTokenEvent", "data");
+    ASSERT_EQ(directCount, 1, "Remaining subscription should still be called");
+    ASSERT_EQ(mailboxCount, 0, "Unsubscribed mailbox should not be called");
+
+    ASSERT_TRUE(manager.unloadPlugin("SamplePlugin"), "Plugin should unload successfully");
+    ASSERT_TRUE(!manager.unsubscribePluginEvent(direct), "Tokens should be invalidated by unload");
+    ASSERT_TRUE(manager.loadPlugin(getPluginPath()), "Plugin should reload from the same path after unload");
+}
+
+// 测试未启动异步分发时投递策略仍然生效：邮箱在排空线程上执行，发布者不执行慢消费者的回调
+TEST(TestDeliveryPoliciesWithoutAsyncDispatch) {
+    PluginManager manager;
+    ASSERT_TRUE(manager.loadPlugin(getPluginPath()), "Plugin should load successfully");
+
+    std::mutex gate;
+    std::unique_lock<std::mutex> hold(gate);
+    std::thread::id publisherThread = std::this_thread::get_id();
+    std::atomic<bool> onPublisherThread{ false };
+    SubscriptionOptions dropNewest;
+    dropNewest.policy = DeliveryPolicy::DropNewest;
+    dropNewest.capacity = 4;
+    manager.registerPluginEvent("SamplePlugin", "OnStoppedBurst", [&](const EventPayload&) {
+        if (std::this_thread::get_id() == publisherThread) {
+            onPublisherThread = true;
+        }
+        std::lock_guard<std::mutex> wait(gate);
+    }, dropNewest);
+    for (int i = 0; i < 20; ++i) {
+        manager.triggerPluginEvent("OnStoppedBurst", "tick");
+    }
+    ASSERT_TRUE(manager.getDeliveryStats("SamplePlugin").dropped > 0, "DropNewest should drop while the consumer is stalled");
+
+    // Block：发布者在邮箱满时等待；注销订阅会唤醒它
+    SubscriptionOptions block;
+    block.policy = DeliveryPolicy::Block;
+    block.capacity = 2;
+    std::atomic<int> blockedDelivered{ 0 };
+    SubscriptionToken blocking = manager.subscribePluginEvent("SamplePlugin", "OnStoppedBlock", [&](const EventPayload&) {
+        std::lock_guard<std::mutex> wait(gate);
+        ++blockedDelivered;
+    }, block);
+    std::thread publisher([&] {
+        for (int i = 0; i < 10; ++i) {
+            manager.triggerPluginEvent("OnStoppedBlock", "tick");
+        }
+    });
+    while (manager.getDeliveryStats("SamplePlugin").blockedPublishes == 0) {
+        std::this_thread::yield();
+    }
+    std::thread unsubscriber([&] {
+        manager.unsubscribePluginEvent(blocking);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    hold.unlock();
+    unsubscriber.join();
+    publisher.join();
+    ASSERT_TRUE(blockedDelivered.load() < 10, "Publishes blocked on a closed mailbox should be released");
+
+    manager.flushAsync();
+    DeliveryStats stats = manager.getDeliveryStats("SamplePlugin");
+    ASSERT_EQ(stats.delivered + stats.dropped, static_cast<uint64_t>(20), "Every event should be delivered or counted as dropped");
+    ASSERT_TRUE(!onPublisherThread.load(), "Mailbox callbacks should not run on the publisher thread");
+    ASSERT_TRUE(manager.unloadPlugin("SamplePlugin"), "Plugin should unload successfully");
+}
+
+namespace {
+
+const PluginLoadReport* findReport(const std::vector<PluginLoadReport>& reports, const std::string& fileName) {
+    for (const auto& report : reports) {
+        if (std::filesystem::path(report.path).filename() == fileName) {
+            return &report;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+// 测试目录扫描加载：已加载的插件优先保留名称，依赖已加载插件的插件可以加载
+TEST(TestLoadPluginsFromDirectory) {
+    PluginManager manager;
+    ASSERT_TRUE(manager.loadPlugin(getPluginPath()), "SamplePlugin should load successfully");
+
+    std::vector<PluginLoadReport> reports = manager.loadPlugins(std::filesystem::current_path().string(), 4);
+    ASSERT_TRUE(findReport(reports, pluginFileName("SamplePlugin")) == nullptr, "Already loaded paths should be skipped");
+    const PluginLoadReport* dependent = findReport(reports, pluginFileName("DependentPlugin"));
+    ASSERT_TRUE(dependent && dependent->loaded, "DependentPlugin should load once its dependency is loaded");
+    ASSERT_TRUE(dependent->openTime.count() > 0, "Load timing should be reported");
+    const PluginLoadReport* duplicate = findReport(reports, pluginFileName("DuplicateNamePlugin"));
+    ASSERT_TRUE(duplicate && !duplicate->loaded, "Plugin with an already loaded name should be rejected");
+
+    ASSERT_TRUE(!manager.unloadPlugin("SamplePlugin"), "A plugin should not unload while others depend on it");
+    ASSERT_TRUE(manager.unloadPlugin("DependentPlugin"), "Dependent plugin should unload");
+    ASSERT_TRUE(manager.unloadPlugin("SamplePlugin"), "Plugin should unload once nothing depends on it");
+}
+
+// 测试批量加载的结果与线程数无关，缺少依赖的插件加载失败
+TEST(TestLoadPluginsIsDeterministic) {
+    std::vector<std::string> paths;
+    for (const char* name : { "SamplePlugin", "DuplicateNamePlugin", "DependentPlugin" }) {
+        paths.push_back(pluginPath(name));
+    }
+    for (size_t threads : { 1, 3 }) {
+        PluginManager manager;
+        std::vector<PluginLoadReport> reports = manager.loadPlugins(paths, threads);
+        ASSERT_EQ(reports.size(), static_cast<size_t>(3), "Every path should get a report");
+        // 同名插件按路径字典序保留第一个
+        ASSERT_TRUE(reports[1].loaded, "Lexicographically first claimant should keep the name");
+        ASSERT_TRUE(!reports[0].loaded, "Later claimant of the same name should be rejected");
+        ASSERT_TRUE(reports[2].loaded, "Dependency should be satisfied by the plugin that kept the name");
+    }
+
+    PluginManager manager;
+    ASSERT_TRUE(!manager.loadPlugin(paths[2]), "Plugin with a missing dependency should fail to load");
+}
+
+// 测试热重载保留订阅，重载期间持续发布的事件不丢失
+TEST(TestReloadPluginKeepsSubscriptions) {
+    PluginManager manager;
+    ASSERT_TRUE(manager.loadPlugin(getPluginPath()), "Plugin should load successfully");
+
+    std::atomic<int> received{ 0 };
+    ASSERT_TRUE(manager.registerPluginEvent("SamplePlugin", "OnReloadTick", [&](const std::string&) {
+        ++received;
+    }), "Event should register successfully");
+    size_t subscriptions = manager.getSubscriptionCount("SamplePlugin");
+
+    // 新版本使用不同的文件名，避免 dlopen 返回已加载的同一映像
+    std::filesystem::path reloadPath = std::filesystem::temp_directory_path() / ("reload_" + pluginFileName("SamplePlugin"));
+    std::filesystem::copy_file(getPluginPath(), reloadPath, std::filesystem::copy_options::overwrite_existing);
+
+    std::atomic<bool> publishing{ true };
+    std::atomic<int> published{ 0 };
+    std::thread publisher([&] {
+        while (publishing.load()) {
+            manager.triggerPluginEvent("OnReloadTick", "tick");
+            ++published;
+        }
+    });
+    while (published.load() < 100) {
+        std::this_thread::yield();
+    }
+    bool reloaded = manager.reloadPlugin("SamplePlugin", reloadPath.string());
+    int atReload = published.load();
+    while (published.load() < atReload + 100) {
+        std::this_thread::yield();
+    }
+    publishing = false;
+    publisher.join();
+
+    ASSERT_TRUE(reloaded, "Plugin should reload from the new library");
+    ASSERT_EQ(received.load(), published.load(), "No event should be dropped across the reload");
+    ASSERT_EQ(manager.getSubscriptionCount("SamplePlugin"), subscriptions, "Subscriptions should survive the reload");
+
+    std::string anotherPath = pluginPath("AnotherPlugin");
+    ASSERT_TRUE(!manager.reloadPlugin("SamplePlugin", anotherPath), "Reload to a library with another name should fail");
+    ASSERT_TRUE(manager.unloadPlugin("SamplePlugin"), "Reloaded plugin should unload successfully");
+    std::filesystem::remove(reloadPath);
+}
+
+// 测试热重载期间另一线程持续发布：每个事件恰好由新旧实例之一处理，按发布顺序，不重复也不遗漏
+TEST(TestReloadPluginHandsOverEveryEventOnce) {
+    PluginManager manager;
+    std::string anotherPath = pluginPath("AnotherPlugin");
+    ASSERT_TRUE(manager.loadPlugin(anotherPath), "AnotherPlugin should load successfully");
+
+    std::mutex mutex;
+    std::vector<uint64_t> pongs;
+    ASSERT_TRUE(manager.subscribePluginEvent("AnotherPlugin", "AnotherPlugin.Pong", [&](const EventPayload& payload) {
+        if (const uint64_t* sequence = payload.as<uint64_t>()) {
+            std::lock_guard<std::mutex> lock(mutex);
+            pongs.push_back(*sequence);
+        }
+    }).valid(), "Pong subscription should register");
+    EventId pingId = manager.resolvePluginEvent("AnotherPlugin.Ping");
+
+    std::filesystem::path reloadPath = std::filesystem::temp_directory_path() / ("reload_" + pluginFileName("AnotherPlugin"));
+    std::filesystem::copy_file(anotherPath, reloadPath, std::filesystem::copy_options::overwrite_existing);
+
+    std::atomic<bool> publishing{ true };
+    std::atomic<uint64_t> published{ 0 };
+    std::thread publisher([&] {
+        for (uint64_t sequence = 0; publishing.load(); ++sequence) {
+            manager.triggerPluginEvent(pingId, EventPayload::view(sequence));
+            published.store(sequence + 1);
+        }
+    });
+    while (published.load() < 1000) {
+        std::this_thread::yield();
+    }
+    bool reloaded = manager.reloadPlugin("AnotherPlugin", reloadPath.string());
+    uint64_t atReload = published.load();
+    while (published.load() < atReload + 1000) {
+        std::this_thread::yield();
+    }
+    publishing = false;
+    publisher.join();
+
+    ASSERT_TRUE(reloaded, "AnotherPlugin should reload from the new library");
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(pongs.size(), static_cast<size_t>(published.load()), "Every ping should be answered exactly once across the reload");
+    bool inOrder = true;
+    for (size_t i = 0; i < pongs.size(); ++i) {
+        inOrder = inOrder && pongs[i] == i;
+    }
+    ASSERT_TRUE(inOrder, "Pings should be answered in publish order across the reload");
+    ASSERT_TRUE(manager.unloadPlugin("AnotherPlugin"), "Reloaded plugin should unload successfully");
+    std::filesystem::remove(reloadPath);
+}
+
+// 测试按清单登记的插件在首次触发其事件时才加载，同名检查在读取清单时完成
+TEST(TestLazyPluginActivatesOnFirstEvent) {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "mots_lazy_plugins";
+    std::filesystem::create_directories(directory);
+    std::filesystem::path libraryPath = directory / pluginFileName("SamplePlugin");
+    std::filesystem::copy_file(getPluginPath(), libraryPath, std::filesystem::copy_options::overwrite_existing);
+    {
+        std::ofstream manifest(libraryPath.string() + ".manifest");
+        manifest << "# SamplePlugin only handles end-of-day events\n";
+        manifest << "name = SamplePlugin\n";
+        manifest << "event = OnEndOfDay\n";
+    }
+
+    PluginManager manager;
+    ASSERT_EQ(manager.registerLazyPlugins(directory.string()), static_cast<size_t>(1), "Manifest should register the plugin");
+    ASSERT_TRUE(!manager.isPluginActive("SamplePlugin"), "Lazy plugin should not be loaded at registration");
+    ASSERT_TRUE(!manager.loadPlugin(getPluginPath()), "Duplicate name should be rejected from the manifest alone");
+
+    int received = 0;
+    ASSERT_TRUE(manager.registerPluginEvent("SamplePlugin", "OnEndOfDay", [&](const std::string&) {
+        ++received;
+    }), "Lazy plugin should accept subscriptions before activation");
+    manager.triggerPluginEvent("OnEndOfDay", "close");
+    ASSERT_TRUE(manager.isPluginActive("SamplePlugin"), "First event should activate the plugin");
+    ASSERT_EQ(received, 1, "Triggering event should still reach subscribers");
+    ASSERT_EQ(manager.getSubscriptionCount("SamplePlugin"), static_cast<size_t>(1), "Activation stub should be removed");
+
+    manager.triggerPluginEvent("OnEndOfDay", "close");
+    ASSERT_EQ(received, 2, "Later events should be delivered directly");
+    ASSERT_TRUE(manager.unloadPlugin("SamplePlugin"), "Activated lazy plugin should unload");
+    std::filesystem::remove_all(directory);
+}
+
+// 测试经宿主订阅的延迟插件也能收到触发激活的那个事件
+TEST(TestLazyPluginReceivesActivatingEvent) {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "mots_lazy_host_plugins";
+    std::filesystem::create_directories(directory);
+    std::filesystem::path libraryPath = directory / pluginFileName("AnotherPlugin");
+    std::filesystem::copy_file(std::filesystem::current_path() / pluginFileName("AnotherPlugin"), libraryPath,
+        std::filesystem::copy_options::overwrite_existing);
+    {
+        std::ofstream manifest(libraryPath.string() + ".manifest");
+        manifest << "name = AnotherPlugin\n";
+        manifest << "event = AnotherPlugin.Ping\n";
+    }
+
+    PluginManager manager;
+    ASSERT_TRUE(manager.registerLazyPlugin(libraryPath.string()), "Manifest should register the plugin");
+    std::vector<uint64_t> pongs;
+    ASSERT_TRUE(manager.subscribePluginEvent("AnotherPlugin", "AnotherPlugin.Pong", [&](const EventPayload& payload) {
+        if (const uint64_t* sequence = payload.as<uint64_t>()) {
+            pongs.push_back(*sequence);
+        }
+    }).valid(), "Lazy plugin should accept subscriptions before activation");
+
+    EventId pingId = manager.resolvePluginEvent("AnotherPlugin.Ping");
+    uint64_t first = 1;
+    manager.triggerPluginEvent(pingId, EventPayload::view(first));
+    ASSERT_TRUE(manager.isPluginActive("AnotherPlugin"), "First ping should activate the plugin");
+    ASSERT_TRUE(pongs.size() == 1 && pongs[0] == 1, "The activating ping should reach the plugin's own subscription once");
+
+    uint64_t second = 2;
+    manager.triggerPluginEvent(pingId, EventPayload::view(second));
+    ASSERT_TRUE(pongs.size() == 2 && pongs[1] == 2, "Later pings should be delivered directly");
+    ASSERT_TRUE(manager.unloadPlugin("AnotherPlugin"), "Activated lazy plugin should unload");
+    std::filesystem::remove_all(directory);
+}
+
+// 测试插件定时器以事件形式送达，卸载插件时自动取消
+TEST(TestUnloadPluginCancelsTimers) {
+    PluginManager manager;
+    ASSERT_TRUE(manager.loadPlugin(pluginFileName("SamplePlugin")), "Plugin should load successfully");
+
+    std::atomic<int> ticks{ 0 };
+    manager.registerPluginEvent("SamplePlugin", "OnHeartbeat", [&](const EventPayload& payload) {
+        if (payload.as<TimerEvent>()) {
+            ++ticks;
+        }
+    });
+    TimerId heartbeat = manager.schedulePluginTimer("SamplePlugin", "OnHeartbeat",
+        std::chrono::milliseconds(1), std::chrono::milliseconds(1));
+    ASSERT_TRUE(heartbeat.valid(), "Timer should be scheduled for a loaded plugin");
+    ASSERT_TRUE(!manager.schedulePluginTimer("MissingPlugin", "OnHeartbeat", std::chrono::milliseconds(1)).valid(),
+        "Timers need a loaded plugin");
+
+    for (int i = 0; i < 2000 && ticks.load() < 3; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(ticks.load() >= 3, "Heartbeat timer should fire repeatedly");
+
+    ASSERT_TRUE(manager.unloadPlugin("SamplePlugin"), "Plugin should unload");
+    ASSERT_EQ(manager.getTimerStats().pending, static_cast<size_t>(0), "Unloading should cancel the plugin's timers");
+    ASSERT_TRUE(!manager.cancelPluginTimer(heartbeat), "The cancelled timer id should be stale");
+}
+
+// 测试插件经宿主在共享总线上订阅与发布（负载按引用转发）；热重载只保留新实例经宿主建立的订阅
+TEST(TestPluginPublishesThroughHost) {
+    PluginManager manager;
+    std::string anotherPath = pluginPath("AnotherPlugin");
+    ASSERT_TRUE(manager.loadPlugin(getPluginPath()) && manager.loadPlugin(anotherPath), "Plugins should load successfully");
+    ASSERT_EQ(manager.getSubscriptionCount("AnotherPlugin"), static_cast<size_t>(1), "The plugin should subscribe through its host");
+
+    int pongs = 0;
+    const void* forwarded = nullptr;
+    manager.registerPluginEvent("SamplePlugin", "AnotherPlugin.Pong", [&](const EventPayload& payload) {
+        forwarded = payload.as<int>();
+        ++pongs;
+    });
+    EventId pingId = manager.resolvePluginEvent("AnotherPlugin.Ping");
+    int value = 42;
+    manager.triggerPluginEvent(pingId, EventPayload::view(value));
+    ASSERT_EQ(pongs, 1, "The plugin should publish on the shared bus");
+    ASSERT_TRUE(forwarded == &value, "The payload should be forwarded by reference");
+
+    std::filesystem::path reloadPath = std::filesystem::temp_directory_path() / ("reload_" + pluginFileName("AnotherPlugin"));
+    std::filesystem::copy_file(anotherPath, reloadPath, std::filesystem::copy_options::overwrite_existing);
+    ASSERT_TRUE(manager.reloadPlugin("AnotherPlugin", reloadPath.string()), "Plugin should reload");
+    ASSERT_EQ(manager.getSubscriptionCount("AnotherPlugin"), static_cast<size_t>(1), "The old instance's host subscriptions should be revoked");
+    manager.triggerPluginEvent(pingId, EventPayload::view(value));
+    ASSERT_EQ(pongs, 2, "Only the new instance should answer");
+
+    ASSERT_TRUE(manager.unloadPlugin("AnotherPlugin"), "Plugin should unload");
+    manager.triggerPluginEvent(pingId, EventPayload::view(value));
+    ASSERT_EQ(pongs, 2, "An unloaded plugin should no longer answer");
+    std::filesystem::remove(reloadPath);
+}
+
+// 测试在回调内卸载插件：插件经宿主建立的回调仍在已退役的快照中，库须在快照释放之后才关闭
+TEST(TestUnloadPluginFromCallback) {
+    PluginManager manager;
+    std::string anotherPath = pluginPath("AnotherPlugin");
+    ASSERT_TRUE(manager.loadPlugin(getPluginPath()) && manager.loadPlugin(anotherPath), "Plugins should load successfully");
+
+    bool unloaded = false;
+    manager.registerPluginEvent("SamplePlugin", "Unload.Another", [&](const EventPayload&) {
+        unloaded = manager.unloadPlugin("AnotherPlugin");
+    });
+    manager.triggerPluginEvent("Unload.Another", EventPayload{});
+    ASSERT_TRUE(unloaded && manager.getSubscriptionCount("AnotherPlugin") == 0, "A plugin should unload from inside a callback");
+
+    // 之后的写操作回收旧快照，其中的回调管理函数位于已卸载插件的库中
+    int pongs = 0;
+    manager.registerPluginEvent("SamplePlugin", "AnotherPlugin.Pong", [&](const EventPayload&) { ++pongs; });
+    manager.registerPluginEvent("SamplePlugin", "AnotherPlugin.Ping", [](const EventPayload&) {});
+    manager.triggerPluginEvent("AnotherPlugin.Ping", EventPayload{});
+    ASSERT_EQ(pongs, 0, "The unloaded plugin should no longer answer");
+    ASSERT_TRUE(manager.loadPlugin(anotherPath), "The plugin should load again after a deferred unload");
+}
+
+// 测试异步分发先排空高优先级的队列；截止时间在真实回调返回处检查（含带投递策略的订阅）并按插件报告
+TEST(TestAsyncDispatchDrainsHigherPriorityFirst) {
+    PluginManager manager;
+    ASSERT_TRUE(manager.loadPlugin(getPluginPath()), "Plugin should load successfully");
+    ASSERT_TRUE(manager.startAsyncDispatch(1, 1024), "Async dispatch should start");
+
+    // 阻塞唯一的分发线程，使之后的事件在各优先级队列中积压
+    std::mutex gate;
+    std::unique_lock<std::mutex> hold(gate);
+    std::atomic<bool> blocked{ false };
+    EventId gateId = manager.resolvePluginEvent("Priority.Gate");
+    manager.registerPluginEvent("SamplePlugin", gateId, [&](const EventPayload&) {
+        blocked = true;
+        std::lock_guard<std::mutex> wait(gate);
+    });
+
+    std::vector<std::string> order;  // 只在分发线程上写入
+    SubscriptionOptions critical;
+    critical.priority = PriorityClass::Critical;
+    critical.deadline = std::chrono::seconds(10);
+    EventId riskId = manager.resolvePluginEvent("Priority.Risk");
+    manager.registerPluginEvent("SamplePlugin", riskId, [&](const EventPayload&) {
+        order.push_back("risk");
+    }, critical);
+    SubscriptionOptions background;
+    background.policy = DeliveryPolicy::DropNewest;
+    background.priority = PriorityClass::BestEffort;
+    background.deadline = std::chrono::microseconds(1);
+    EventId logId = manager.resolvePluginEvent("Priority.Log");
+    manager.registerPluginEvent("SamplePlugin", logId, [&](const EventPayload&) {
+        order.push_back("log");
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }, background);
+
+    ASSERT_TRUE(manager.publishAsync(gateId, EventPayload{}), "The gate event should enqueue");
+    while (!blocked.load()) {
+        std::this_thread::yield();
+    }
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(manager.publishAsync(logId, EventPayload{}), "Best-effort events should enqueue");
+        ASSERT_TRUE(manager.publishAsync(riskId, EventPayload{}), "Critical events should enqueue");
+    }
+    hold.unlock();
+    manager.flushAsync();
+    std::vector<std::string> expected = { "risk", "risk", "risk", "log", "log", "log" };
+    ASSERT_TRUE(order == expected, "Critical events should be drained ahead of best-effort ones");
+
+    DeadlineStats deadlines = manager.getDeadlineStats("SamplePlugin");
+    ASSERT_EQ(deadlines.checked, static_cast<uint64_t>(6), "Direct and mailbox deliveries should both be checked");
+    ASSERT_EQ(deadlines.missed, static_cast<uint64_t>(3), "Only the slow best-effort consumer should miss its deadline");
+    std::ostringstream dump;
+    manager.dumpStats(dump);
+    ASSERT_TRUE(dump.str().find("[deadlines]") != std::string::npos, "dumpStats should report deadline misses");
+    ASSERT_TRUE(manager.unloadPlugin("SamplePlugin"), "Plugin should unload successfully");
+}
+
+// 测试订阅变化提升事件的优先级类别时，已排队的事件与之后发布的事件仍按发布顺序分发；
+// 排队的事件全部分发后，新发布的事件才进入新类别的队列
+TEST(TestAsyncDispatchKeepsEventOrderWhenPriorityChanges) {
+    PluginManager manager;
+    ASSERT_TRUE(manager.loadPlugin(getPluginPath()), "Plugin should load successfully");
+    ASSERT_TRUE(manager.startAsyncDispatch(1, 1024), "Async dispatch should start");
+
+    std::mutex gate;
+    std::unique_lock<std::mutex> hold(gate);
+    std::atomic<bool> blocked{ false };
+    EventId gateId = manager.resolvePluginEvent("Priority.Gate");
+    manager.registerPluginEvent("SamplePlugin", gateId, [&](const EventPayload&) {
+        blocked = true;
+        std::lock_guard<std::mutex> wait(gate);
+    });
+    auto blockDispatcher = [&] {
+        blocked = false;
+        manager.publishAsync(gateId, EventPayload{});
+        while (!blocked.load()) {
+            std::this_thread::yield();
+        }
+    };
+
+    std::vector<std::string> order;  // 只在分发线程上写入
+    EventId quoteId = manager.resolvePluginEvent("Priority.Quote");
+    manager.registerPluginEvent("SamplePlugin", quoteId, [&](const EventPayload& payload) {
+        order.push_back("quote" + std::to_string(*payload.as<uint64_t>()));
+    });
+    EventId otherId = manager.resolvePluginEvent("Priority.Other");
+    manager.registerPluginEvent("SamplePlugin", otherId, [&](const EventPayload&) { order.push_back("other"); });
+
+    blockDispatcher();
+    for (uint64_t sequence = 1; sequence <= 3; ++sequence) {
+        ASSERT_TRUE(manager.publishAsync(quoteId, EventPayload::view(sequence)), "Quotes should enqueue");
+    }
+    // 积压期间出现关键订阅者，事件的类别随之提升
+    SubscriptionOptions critical;
+    critical.priority = PriorityClass::Critical;
+    manager.registerPluginEvent("SamplePlugin", quoteId, [](const EventPayload&) {}, critical);
+    for (uint64_t sequence = 4; sequence <= 6; ++sequence) {
+        ASSERT_TRUE(manager.publishAsync(quoteId, EventPayload::view(sequence)), "Quotes should enqueue");
+    }
+    hold.unlock();
+    manager.flushAsync();
+    std::vector<std::string> expected = { "quote1", "quote2", "quote3", "quote4", "quote5", "quote6" };
+    ASSERT_TRUE(order == expected, "A priority change should not reorder the same event");
+
+    // 积压排空后，新发布的事件按提升后的类别越过普通事件
+    order.clear();
+    hold.lock();
+    blockDispatcher();
+    ASSERT_TRUE(manager.publishAsync(otherId, EventPayload{}), "Normal events should enqueue");
+    uint64_t sequence = 7;
+    ASSERT_TRUE(manager.publishAsync(quoteId, EventPayload::view(sequence)), "Quotes should enqueue");
+    hold.unlock();
+    manager.flushAsync();
+    expected = { "quote7", "other" };
+    ASSERT_TRUE(order == expected, "Once drained the event should move to its new priority class");
+    ASSERT_TRUE(manager.unloadPlugin("SamplePlugin"), "Plugin should unload successfully");
+}
+
+// 测试同一分区键的事件不论类别都按发布顺序分发，优先级只让其他键的事件越过它们
+TEST(TestAsyncDispatchKeepsKeyOrderAcrossPriorities) {
+    PluginManager manager;
+    ASSERT_TRUE(manager.loadPlugin(getPluginPath()), "Plugin should load successfully");
+    ASSERT_TRUE(manager.startAsyncDispatch(1, 1024), "Async dispatch should start");
+
+    std::mutex gate;
+    std::unique_lock<std::mutex> hold(gate);
+    std::atomic<bool> blocked{ false };
+    EventId gateId = manager.resolvePluginEvent("Priority.Gate");
+    manager.registerPluginEvent("SamplePlugin", gateId, [&](const EventPayload&) {
+        blocked = true;
+        std::lock_guard<std::mutex> wait(gate);
+    });
+
+    std::vector<std::string> order;  // 只在分发线程上写入
+    EventId fillId = manager.resolvePluginEvent("Priority.Fill");
+    manager.registerPluginEvent("SamplePlugin", fillId, [&](const EventPayload& payload) {
+        order.push_back("fill:" + payload.toString());
+    });
+    SubscriptionOptions critical;
+    critical.priority = PriorityClass::Critical;
+    EventId cancelId = manager.resolvePluginEvent("Priority.Cancel");
+    manager.registerPluginEvent("SamplePlugin", cancelId, [&](const EventPayload& payload) {
+        order.push_back("cancel:" + payload.toString());
+    }, critical);
+
+    ASSERT_TRUE(manager.publishAsync(gateId, EventPayload{}), "The gate event should enqueue");
+    while (!blocked.load()) {
+        std::this_thread::yield();
+    }
+    // AAPL 的普通事件仍在排队，之后的关键事件排在它后面；MSFT 没有积压，关键事件越过 AAPL
+    manager.triggerPluginEvent(fillId, EventPayload::fromString("AAPL1"), "AAPL");
+    manager.triggerPluginEvent(cancelId, EventPayload::fromString("AAPL2"), "AAPL");
+    manager.triggerPluginEvent(fillId, EventPayload::fromString("AAPL3"), "AAPL");
+    manager.triggerPluginEvent(cancelId, EventPayload::fromString("MSFT1"), "MSFT");
+    hold.unlock();
+    manager.flushAsync();
+
+    std::vector<std::string> expected = { "cancel:MSFT1", "fill:AAPL1", "cancel:AAPL2", "fill:AAPL3" };
+    ASSERT_TRUE(order == expected, "Events of one key should keep publish order while other keys use their priority");
+    ASSERT_TRUE(manager.unloadPlugin("SamplePlugin"), "Plugin should unload successfully");
+}
+
+// 测试分发线程在回调中按键发布且队列已满时丢弃并计数，不越过已排队的事件同步分发
+TEST(TestKeyedPublishFromDispatcherDropsWhenFull) {
+    PluginManager manager;
+    ASSERT_TRUE(manager.loadPlugin(getPluginPath()), "Plugin should load successfully");
+    ASSERT_TRUE(manager.startAsyncDispatch(1, 2), "Async dispatch should start");
+
+    std::vector<uint64_t> echoes;  // 只在分发线程上写入
+    EventId echoId = manager.resolvePluginEvent("Reentrant.Echo");
+    manager.registerPluginEvent("SamplePlugin", echoId, [&](const EventPayload& payload) {
+        echoes.push_back(*payload.as<uint64_t>());
+    });
+    EventId triggerId = manager.resolvePluginEvent("Reentrant.Trigger");
+    manager.registerPluginEvent("SamplePlugin", triggerId, [&](const EventPayload&) {
+        for (uint64_t sequence = 0; sequence < 5; ++sequence) {
+            manager.triggerPluginEvent(echoId, EventPayload::view(sequence), "KEY");
+        }
+    });
+
+    ASSERT_TRUE(manager.publishAsync(triggerId, EventPayload{}), "The trigger should enqueue");
+    manager.flushAsync();
+
+    std::vector<uint64_t> expected = { 0, 1 };
+    ASSERT_TRUE(echoes == expected, "Events that fit should be delivered in order and the rest not run inline");
+    uint64_t dropped = 0;
+    for (const ShardStats& stats : manager.getShardStats()) {
+        dropped += stats.dropped;
+    }
+    ASSERT_EQ(dropped, static_cast<uint64_t>(3), "Events rejected on the dispatcher thread should count as dropped");
+    ASSERT_TRUE(manager.unloadPlugin("SamplePlugin"), "Plugin should unload successfully");
+}
@@ -0,0 +1,136 @@
+// tests/ReactorTests.cpp
+#include "../include/Test.h"
+#include "../include/PluginManager.h"
+#include "../include/PluginPath.h"
+#include "../include/Reactor.h"
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+// 测试回调在反应器线程上按顺序执行，关闭后不再调用，且关闭会等待正在执行的回调
+TEST(TestReactorRunsAndClosesCallbacks) {
+    Reactor reactor("ReactorTest", ExecutionPolicy::reactor(-1, std::chrono::microseconds(100)),
+        Logger::global().channel("ReactorTest"));
+    ASSERT_TRUE(reactor.start(), "The reactor should start");
+
+    std::vector<int> seen;
+    std::thread::id callbackThread;
+    Reactor::Target* target = nullptr;
+    PayloadCallback proxy = reactor.wrap([&](const EventPayload& payload) {
+        callbackThread = std::this_thread::get_id();
+        seen.push_back(*payload.as<int>());
+    }, target);
+    reactor.bind(target, 1);
+    for (int i = 0; i < 100; ++i) {
+        int value = i;
+        proxy(EventPayload::view(value));  // 视图负载在入队时保留
+    }
+    reactor.flush();
+    ASSERT_EQ(seen.size(), static_cast<size_t>(100), "Every posted event should run");
+    bool ordered = true;
+    for (int i = 0; i < 100; ++i) {
+        ordered = ordered && seen[i] == i;
+    }
+    ASSERT_TRUE(ordered, "Events should run in posting order");
+    ASSERT_TRUE(callbackThread != std::this_thread::get_id(), "Callbacks should run on the reactor thread");
+
+    // 关闭时回调正在执行：close 返回时回调已返回
+    std::atomic<bool> entered{ false };
+    std::atomic<bool> finished{ false };
+    Reactor::Target* slow = nullptr;
+    PayloadCallback slowProxy = reactor.wrap([&](const EventPayload&) {
+        entered.store(true);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        finished.store(true);
+    }, slow);
+    reactor.bind(slow, 2);
+    slowProxy(EventPayload{});
+    while (!entered.load()) {
+        std::this_thread::yield();
+    }
+    reactor.close(2);
+    ASSERT_TRUE(finished.load(), "close() should wait for the running callback");
+    slowProxy(EventPayload{});
+    reactor.close(1);
+    int value = 1000;
+    proxy(EventPayload::view(value));
+    reactor.flush();
+    ASSERT_EQ(seen.size(), static_cast<size_t>(100), "A closed callback should not run again");
+
+    // 回调抛出的异常被记录，反应器继续运行
+    Reactor::Target* throwing = nullptr;
+    PayloadCallback throwingProxy = reactor.wrap([](const EventPayload&) {
+        throw std::runtime_error("reactor test");
+    }, throwing);
+    reactor.bind(throwing, 3);
+    throwingProxy(EventPayload{});
+    reactor.flush();
+    ReactorStats stats = reactor.stats();
+    ASSERT_EQ(stats.events, static_cast<uint64_t>(102), "Executed callbacks should be counted");
+    ASSERT_EQ(stats.queueLatency.count, static_cast<uint64_t>(104), "Every dequeued event should record its queueing latency");
+    reactor.stop();
+}
+
+// 测试按 Reactor 策略加载的插件：经宿主与按名称建立的订阅都在反应器线程上执行，
+// 空闲超过忙等预算后阻塞等待，唤醒延迟与空闲开销经统计报告
+TEST(TestReactorPluginExecutionPolicy) {
+    PluginManager manager;
+    ASSERT_TRUE(manager.loadPlugin(pluginPath("SamplePlugin")), "SamplePlugin should load inline");
+    ExecutionPolicy policy = ExecutionPolicy::reactor(0, std::chrono::microseconds(200));
+    ASSERT_TRUE(manager.loadPlugin(pluginPath("AnotherPlugin"), policy), "AnotherPlugin should load on a reactor");
+    ASSERT_EQ(manager.getReactorStats("SamplePlugin").plugin, std::string(), "Inline plugins should have no reactor");
+
+    std::mutex mutex;
+    std::vector<std::thread::id> pongThreads;
+    manager.registerPluginEvent("SamplePlugin", "AnotherPlugin.Pong", [&](const EventPayload&) {
+        std::lock_guard<std::mutex> lock(mutex);
+        pongThreads.push_back(std::this_thread::get_id());
+    });
+    std::thread::id directThread;
+    SubscriptionToken direct = manager.subscribePluginEvent("AnotherPlugin", "AnotherPlugin.Ping", [&](const EventPayload&) {
+        directThread = std::this_thread::get_id();
+    });
+    ASSERT_TRUE(direct.valid(), "Subscribing by name should succeed");
+
+    EventId pingId = manager.resolvePluginEvent("AnotherPlugin.Ping");
+    manager.triggerPluginEvent(pingId, std::string("first"));
+    manager.flushAsync();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_EQ(pongThreads.size(), static_cast<size_t>(1), "The reactor plugin should answer");
+        ASSERT_TRUE(pongThreads[0] != std::this_thread::get_id(), "The plugin should react on its own thread");
+    }
+    ASSERT_TRUE(directThread == pongThreads[0], "All subscriptions of the plugin should share its reactor thread");
+
+    // 超过忙等预算后转入阻塞等待，之后的事件计入唤醒延迟
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    manager.triggerPluginEvent(pingId, std::string("second"));
+    manager.flushAsync();
+    ReactorStats stats = manager.getReactorStats("AnotherPlugin");
+    ASSERT_EQ(stats.plugin, std::string("AnotherPlugin"), "Reactor stats should name the plugin");
+    ASSERT_EQ(stats.cpu, 0, "The configured core should be reported");
+    ASSERT_EQ(stats.events, static_cast<uint64_t>(4), "Both subscriptions should run for both events");
+    ASSERT_TRUE(stats.sleeps >= 1 && stats.sleepSeconds > 0, "An idle reactor should block after its spin budget");
+    ASSERT_TRUE(stats.spinSeconds > 0, "Idle spinning should be accounted");
+    ASSERT_TRUE(stats.wakeupLatency.count >= 1, "Events that wake a blocked reactor should record wake-up latency");
+    std::ostringstream dump;
+    manager.dumpStats(dump);
+    ASSERT_TRUE(dump.str().find("[reactors]") != std::string::npos, "dumpStats should report reactors");
+
+    // 注销后回调不再执行
+    ASSERT_TRUE(manager.unsubscribePluginEvent(direct), "Unsubscribe should succeed");
+    directThread = std::thread::id();
+    manager.triggerPluginEvent(pingId, std::string("third"));
+    manager.flushAsync();
+    ASSERT_TRUE(directThread == std::thread::id(), "An unsubscribed callback should not run");
+    ASSERT_EQ(manager.getReactorStats("AnotherPlugin").events, static_cast<uint64_t>(5), "The host subscription should still run");
+
+    ASSERT_TRUE(manager.unloadPlugin("AnotherPlugin"), "The reactor plugin should unload");
+    ASSERT_EQ(manager.getReactorStats("AnotherPlugin").plugin, std::string(), "Unloading should stop the reactor");
+    manager.triggerPluginEvent(pingId, std::string("gone"));
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(pongThreads.size(), static_cast<size_t>(3), "An unloaded plugin should no longer answer");
+}
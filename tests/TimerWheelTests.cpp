@@ -0,0 +1,144 @@
+// tests/TimerWheelTests.cpp
+#include "../include/Test.h"
+#include "../include/TimerWheel.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// 轮询等待条件成立，最多等待 timeout
+template <typename Condition>
+bool waitFor(Condition condition, std::chrono::milliseconds timeout = std::chrono::milliseconds(2000)) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+// 测试单次与周期定时器以事件形式触发，周期定时器可取消
+TEST(TestTimerWheelFiresOneShotAndPeriodic) {
+    EventManager manager;
+    TimerWheel timers(manager);
+    PluginId pluginId = manager.resolvePlugin("TimerPlugin");
+    EventId onceId = manager.resolveEvent("OnTimerOnce");
+    EventId periodicId = manager.resolveEvent("OnTimerPeriodic");
+
+    std::atomic<int> once{ 0 };
+    std::atomic<uint64_t> lastFireCount{ 0 };
+    std::atomic<bool> early{ false };
+    manager.registerEvent(pluginId, onceId, [&](const EventPayload& payload) {
+        const TimerEvent* event = payload.as<TimerEvent>();
+        early = early || event->firedNs < event->deadlineNs;
+        ++once;
+    });
+    manager.registerEvent(pluginId, periodicId, [&](const EventPayload& payload) {
+        lastFireCount = payload.as<TimerEvent>()->fireCount;
+    });
+
+    TimerId oneShot = timers.schedule(pluginId, onceId, std::chrono::milliseconds(5));
+    TimerId periodic = timers.schedule(pluginId, periodicId, std::chrono::milliseconds(1), std::chrono::milliseconds(2));
+    ASSERT_TRUE(oneShot.valid() && periodic.valid(), "Scheduling should return valid timers");
+    ASSERT_TRUE(waitFor([&] { return once.load() == 1 && lastFireCount.load() >= 3; }), "Timers should fire");
+    ASSERT_TRUE(!early.load(), "A timer should never fire before its deadline");
+    ASSERT_TRUE(!timers.cancel(oneShot), "A fired one-shot timer can no longer be cancelled");
+    ASSERT_TRUE(timers.cancel(periodic), "A periodic timer should be cancellable");
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    uint64_t afterCancel = lastFireCount.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_EQ(lastFireCount.load(), afterCancel, "A cancelled timer should stop firing");
+
+    TimerStats stats = timers.stats();
+    ASSERT_EQ(stats.pending, static_cast<size_t>(0), "No timer should be pending");
+    ASSERT_TRUE(stats.jitter.count == stats.fired && stats.fired >= 4, "Every firing should record its jitter");
+}
+
+// 测试跨越多层的到期时间：小刻度下延迟跨越第 1、2 层的降级，全部按时触发且不提前
+TEST(TestTimerWheelCascadesAcrossLevels) {
+    EventManager manager;
+    TimerWheel timers(manager, std::chrono::microseconds(1));
+    PluginId pluginId = manager.resolvePlugin("TimerPlugin");
+    EventId eventId = manager.resolveEvent("OnTimerCascade");
+
+    constexpr int kTimers = 40;
+    std::atomic<int> fired{ 0 };
+    std::atomic<int> early{ 0 };
+    manager.registerEvent(pluginId, eventId, [&](const EventPayload& payload) {
+        const TimerEvent* event = payload.as<TimerEvent>();
+        if (event->firedNs < event->deadlineNs) {
+            ++early;
+        }
+        ++fired;
+    });
+    for (int i = 0; i < kTimers; ++i) {
+        // 0.1ms 到约 80ms，1 微秒刻度下第 1 层每 256us 降级一次，第 2 层每 65.5ms 降级一次
+        timers.schedule(pluginId, eventId, std::chrono::microseconds(100 + i * i * 50));
+    }
+    ASSERT_TRUE(waitFor([&] { return fired.load() == kTimers; }), "Every timer should fire");
+    ASSERT_EQ(early.load(), 0, "No timer should fire before its deadline");
+}
+
+// 测试大量定时器的调度与取消，以及按插件批量取消
+TEST(TestTimerWheelBulkScheduleAndCancel) {
+    EventManager manager;
+    TimerWheel timers(manager);
+    PluginId first = manager.resolvePlugin("FirstPlugin");
+    PluginId second = manager.resolvePlugin("SecondPlugin");
+    EventId eventId = manager.resolveEvent("OnTimerBulk");
+
+    constexpr int kTimers = 200000;
+    std::vector<TimerId> ids;
+    ids.reserve(kTimers);
+    for (int i = 0; i < kTimers; ++i) {
+        PluginId owner = i % 4 == 0 ? second : first;
+        ids.push_back(timers.schedule(owner, eventId, std::chrono::seconds(60 + i % 3600)));
+    }
+    ASSERT_EQ(timers.pending(), static_cast<size_t>(kTimers), "Every timer should be pending");
+
+    size_t cancelled = 0;
+    for (int i = 1; i < kTimers; i += 2) {
+        cancelled += timers.cancel(ids[i]) ? 1 : 0;
+    }
+    ASSERT_EQ(cancelled, static_cast<size_t>(kTimers / 2), "Every odd timer should be cancelled");
+    ASSERT_TRUE(!timers.cancel(ids[1]), "Cancelling twice should fail");
+
+    ASSERT_EQ(timers.cancelPluginTimers(second), static_cast<size_t>(kTimers / 4), "Plugin timers should be cancelled together");
+    ASSERT_EQ(timers.pending(), static_cast<size_t>(kTimers / 4), "Only the first plugin's even timers should remain");
+
+    // 复用的节点不会被旧标识取消
+    TimerId reused = timers.schedule(second, eventId, std::chrono::seconds(1));
+    size_t staleCancelled = 0;
+    for (int i = 0; i < kTimers; i += 4) {
+        staleCancelled += timers.cancel(ids[i]) ? 1 : 0;
+    }
+    ASSERT_EQ(staleCancelled, static_cast<size_t>(0), "Stale ids should not cancel reused nodes");
+    ASSERT_TRUE(timers.cancel(reused), "A fresh timer should be cancellable");
+}
+
+// 测试按实例取消：只取消属于该插件该实例的定时器，同一插件的其他实例不受影响
+TEST(TestTimerWheelCancelsByInstance) {
+    EventManager manager;
+    TimerWheel timers(manager);
+    PluginId pluginId = manager.resolvePlugin("ReloadedPlugin");
+    PluginId other = manager.resolvePlugin("OtherPlugin");
+    EventId eventId = manager.resolveEvent("OnInstanceTimer");
+
+    TimerId oldTimer = timers.schedule(pluginId, eventId, std::chrono::seconds(60), std::chrono::nanoseconds::zero(), 1);
+    TimerId newTimer = timers.schedule(pluginId, eventId, std::chrono::seconds(60), std::chrono::nanoseconds::zero(), 2);
+    TimerId foreign = timers.schedule(other, eventId, std::chrono::seconds(60), std::chrono::nanoseconds::zero(), 1);
+
+    ASSERT_TRUE(!timers.cancel(newTimer, pluginId, 1), "An instance should not cancel another instance's timer");
+    ASSERT_TRUE(!timers.cancel(foreign, pluginId, 1), "An instance should not cancel another plugin's timer");
+    ASSERT_EQ(timers.cancelPluginTimers(pluginId, 1), static_cast<size_t>(1), "Only the old instance's timer should be cancelled");
+    ASSERT_TRUE(!timers.isPending(oldTimer), "The old instance's timer should be gone");
+    ASSERT_TRUE(timers.cancel(newTimer, pluginId, 2), "The owning instance should cancel its own timer");
+    ASSERT_TRUE(timers.cancel(foreign), "Unchecked cancel should still work");
+}
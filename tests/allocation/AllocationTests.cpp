@@ -0,0 +1,196 @@
+// tests/allocation/AllocationTests.cpp
+#include "../../include/Test.h"
+#include "../../include/PluginManager.h"
+#include "../../include/PluginPath.h"
+#include "../../include/Reactor.h"
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+// 计数分配器：替换全局 operator new（含对齐版本），统计开启期间任何线程上的分配次数
+// 替换全局分配器会影响同一程序中的所有测试，因此单独构建为 AllocationTests
+namespace {
+
+std::atomic<bool> countingAllocations{ false };
+std::atomic<uint64_t> allocationCount{ 0 };
+
+void countAllocation() {
+    if (countingAllocations.load(std::memory_order_relaxed)) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void* countedAllocate(size_t size) {
+    countAllocation();
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* countedAllocate(size_t size, std::align_val_t alignment) {
+    countAllocation();
+    size_t align = static_cast<size_t>(alignment);
+    void* memory = nullptr;
+#if defined(_WIN32)
+    memory = _aligned_malloc(size ? size : 1, align);
+#else
+    if (posix_memalign(&memory, align < sizeof(void*) ? sizeof(void*) : align, size ? size : 1) != 0) {
+        memory = nullptr;
+    }
+#endif
+    if (memory) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void alignedFree(void* memory) {
+#if defined(_WIN32)
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+template <typename... Args>
+void* tryAllocate(Args... args) noexcept {
+    try {
+        return countedAllocate(args...);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+} // namespace
+
+void* operator new(size_t size) { return countedAllocate(size); }
+void* operator new[](size_t size) { return countedAllocate(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return tryAllocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return tryAllocate(size); }
+void* operator new(size_t size, std::align_val_t alignment) { return countedAllocate(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return countedAllocate(size, alignment); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return tryAllocate(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return tryAllocate(size, alignment); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { alignedFree(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { alignedFree(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { alignedFree(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { alignedFree(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(memory); }
+
+namespace {
+
+struct PoolQuote {
+    uint64_t instrument;
+    double bid;
+    double ask;
+};
+
+} // namespace
+
+// 测试稳态发布不调用 malloc：同步、批量、异步、分区、带策略邮箱与反应器路径在预热后零分配
+TEST(TestSteadyStatePublishingDoesNotAllocate) {
+    PluginManager manager;
+    ASSERT_TRUE(manager.loadPlugin(pluginPath("SamplePlugin")), "SamplePlugin should load");
+    ASSERT_TRUE(manager.startAsyncDispatch(1, 4096), "Async dispatch should start");
+
+    std::atomic<uint64_t> received{ 0 };
+    EventId quoteId = manager.resolvePluginEvent("Pool.Quote");
+    EventId textId = manager.resolvePluginEvent("Pool.Text");
+    manager.registerPluginEvent("SamplePlugin", quoteId, [&](const EventPayload& payload) {
+        if (payload.as<PoolQuote>()) {
+            received.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    manager.registerPluginEvent("SamplePlugin", textId, [&](const EventPayload& payload) {
+        if (payload.string()) {
+            received.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    manager.subscribePluginBatchEvent("SamplePlugin", quoteId, [&](const EventBatchView& batch) {
+        received.fetch_add(batch.size(), std::memory_order_relaxed);
+    });
+    SubscriptionOptions dropNewest;
+    dropNewest.policy = DeliveryPolicy::DropNewest;
+    dropNewest.capacity = 4096;
+    manager.registerPluginEvent("SamplePlugin", textId, [&](const EventPayload&) {
+        received.fetch_add(1, std::memory_order_relaxed);
+    }, dropNewest);
+    SubscriptionOptions conflate;
+    conflate.policy = DeliveryPolicy::Conflate;
+    conflate.conflationKey = [](const EventPayload& payload) {
+        const PoolQuote* quote = payload.as<PoolQuote>();
+        return quote ? quote->instrument : 0;
+    };
+    manager.registerPluginEvent("SamplePlugin", quoteId, [&](const EventPayload&) {
+        received.fetch_add(1, std::memory_order_relaxed);
+    }, conflate);
+
+    Reactor reactor("PoolReactor", ExecutionPolicy::reactor(-1, std::chrono::microseconds(50)),
+        Logger::global().channel("PoolReactor"));
+    reactor.start();
+    Reactor::Target* target = nullptr;
+    PayloadCallback reactorProxy = reactor.wrap([&](const EventPayload&) {
+        received.fetch_add(1, std::memory_order_relaxed);
+    }, target);
+    reactor.bind(target, 1);
+    Reactor::Target* batchTarget = nullptr;
+    BatchCallback reactorBatchProxy = reactor.wrap([&](const EventBatchView& batch) {
+        received.fetch_add(batch.size(), std::memory_order_relaxed);
+    }, batchTarget);
+    reactor.bind(batchTarget, 2);
+
+    const std::string text = "bid=100.25;ask=100.26;size=1000;venue=XNAS";
+    // flushEvery 控制积压深度：计数阶段每轮排空，积压不超过预热时的峰值
+    auto publishRound = [&](uint64_t round, uint64_t flushEvery) {
+        PoolQuote quote{ round % 8, 100.0 + round, 100.5 + round };
+        EventPayload view = EventPayload::view(quote);
+        manager.triggerPluginEvent(quoteId, view);
+        manager.triggerPluginEvent(textId, text);
+        manager.triggerPluginEvent(textId, EventPayload::copyOf(text));
+        BatchEvent batch[3] = { { quoteId, view }, { quoteId, view }, { textId, EventPayload::fromString(text) } };
+        manager.triggerPluginEvents(batch, 3);
+        manager.publishAsync(quoteId, view);
+        manager.publishAsync(textId, EventPayload::fromString(text));
+        manager.triggerPluginEvent(quoteId, view, std::string_view("AAPL"));
+        reactorProxy(view);
+        reactorBatchProxy(EventBatchView(batch, 2));
+        if (round % flushEvery == flushEvery - 1) {
+            manager.flushAsync();
+            reactor.flush();
+        }
+    };
+
+    // 预热：填充负载池、邮箱与合并表、统计分片与各环形队列
+    for (uint64_t round = 0; round < 4096; ++round) {
+        publishRound(round, 64);
+    }
+    manager.flushAsync();
+    reactor.flush();
+
+    uint64_t before = received.load();
+    allocationCount.store(0);
+    countingAllocations.store(true);
+    for (uint64_t round = 0; round < 4096; ++round) {
+        publishRound(round, 1);
+    }
+    manager.flushAsync();
+    reactor.flush();
+    countingAllocations.store(false);
+
+    ASSERT_TRUE(received.load() > before, "Events should be delivered while counting");
+    ASSERT_EQ(allocationCount.load(), static_cast<uint64_t>(0), "Steady-state publishing should not allocate");
+    reactor.stop();
+}
@@ -0,0 +1,39 @@
+// tests/plugins/DependentPlugin/DependentPlugin.cpp
+#include "../../../include/IPlugin.h"
+#include "../../../include/IPluginHost.h"
+#include "../../../include/Logger.h"
+
+// 仅供测试：声明依赖 SamplePlugin，用于批量加载、卸载顺序与隔离加载的依赖检查
+class DependentPlugin : public IPlugin {
+public:
+    DependentPlugin() {}
+    ~DependentPlugin() override {}
+
+    bool initialize(IPluginHost& host) override {
+        host_ = &host;
+        host.logger().logf(LogLevel::Info, "DependentPlugin initialized.");
+        return true;
+    }
+
+    void shutdown() override {
+        if (host_) {
+            host_->logger().logf(LogLevel::Info, "DependentPlugin shutdown.");
+        }
+    }
+
+    std::string getName() const override {
+        return "DependentPlugin";
+    }
+
+    std::vector<std::string> getDependencies() const override {
+        return { "SamplePlugin" };
+    }
+
+private:
+    IPluginHost* host_ = nullptr;
+};
+
+// 使用导出宏确保函数被正确导出
+extern "C" PLUGIN_API IPlugin* CreatePlugin() {
+    return new DependentPlugin();
+}